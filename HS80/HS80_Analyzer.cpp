@@ -3,6 +3,26 @@
 // ============================================================================
 
 #include "HS80_Library.h"
+#include "HS80_Simulation.h"
+#include "HS80_Animation.h"
+#include "HS80_Color.h"
+#include "HS80_Compositor.h"
+#include "HS80_Keyframes.h"
+#include "HS80_FrameTables.h"
+#include "HS80_Audio.h"
+#include "HS80_Canvas.h"
+#include "HS80_FrameClock.h"
+#include "HS80_Rules.h"
+#include "HS80_Script.h"
+#include "HS80_EffectCache.h"
+#include "HS80_Transition.h"
+#include "HS80_Dither.h"
+#include "HS80_FadePlanner.h"
+#include "HS80_Calibration.h"
+#include "HS80_Notification.h"
+#include "HS80_OfflineRenderer.h"
+#include "HS80_Plugin.h"
+#include <cstdio>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -10,6 +30,8 @@
 #include <chrono>
 #include <ctime>
 #include <algorithm>
+#include <cmath>
+#include <thread>
 #include <conio.h>
 
 using namespace HS80;
@@ -76,6 +98,11 @@ void analyzeEvent(const HeadsetEvent& event) {
     // Deutsche Beschreibung
     ss << event.getDescription();
     
+    // Zeit seit Abschluss des Reads (monotone Uhr, nicht die Log-Uhrzeit)
+    auto sinceRead = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - event.timestamp).count();
+    ss << " | +" << sinceRead << "us seit Read";
+    
     // Detaillierte Werte
     if (actualType == EventType::Mute) {
         ss << " | Byte[5]=" << (event.isMuted() ? "0x01 (STUMM)" : "0x00 (AKTIV)");
@@ -103,6 +130,33 @@ void analyzeEvent(const HeadsetEvent& event) {
     }
 }
 
+// Latenz-Statistik ausgeben
+void printLatencySnapshot(const std::string& name, const LatencySnapshot& snap) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << "  " << std::left << std::setw(18) << name << std::right
+       << " n=" << std::setw(5) << snap.count
+       << "  p50=" << std::setw(8) << snap.p50Us << "us"
+       << "  p99=" << std::setw(8) << snap.p99Us << "us"
+       << "  p99.9=" << std::setw(8) << snap.p999Us << "us"
+       << "  max=" << std::setw(8) << snap.maxUs << "us";
+    logEvent(ss.str());
+}
+
+void printEventLatencyStats(const EventMonitor& events) {
+    EventLatencyStats stats = events.getLatencyStats();
+    logEvent("[LATENZ] Read -> Dispatch -> Handler-Return:");
+    printLatencySnapshot("Read->Dispatch", stats.readToDispatch);
+    printLatencySnapshot("Dispatch->Return", stats.dispatchToReturn);
+    printLatencySnapshot("Read->Return", stats.readToReturn);
+    
+    EventFilterStats filter = events.getFilterStats();
+    std::stringstream ss;
+    ss << "[FILTER] Empfangen=" << filter.received << ", Ausgeliefert=" << filter.delivered
+       << ", Duplikate=" << filter.suppressedDuplicates << ", Zusammengefasst=" << filter.coalesced;
+    logEvent(ss.str());
+}
+
 // Zeige alle verfügbaren Devices
 void showAllDevices() {
     std::cout << "\n========================================" << std::endl;
@@ -252,6 +306,7 @@ void eventMonitorTest(EventMonitor& events) {
     std::cout << "\nDruecke 'Q' zum Abbrechen...\n" << std::endl;
     
     logEvent("[EVENT MONITOR] Starte 30s Test");
+    events.resetLatencyStats();
     
     if (!events.startMonitoring(analyzeEvent)) {
         std::cout << "[FEHLER] Konnte Monitoring nicht starten!" << std::endl;
@@ -282,80 +337,2846 @@ void eventMonitorTest(EventMonitor& events) {
     
     events.stopMonitoring();
     logEvent("[EVENT MONITOR] Test beendet");
+    printEventLatencyStats(events);
 }
 
-// Hauptmenü
-void printMainMenu() {
+// ============================================================================
+// Simulation (ohne Hardware)
+// ============================================================================
+
+// Simulierte Handler-Arbeit (z.B. UI-Update) pro Callback-Aufruf
+static void simulateHandlerWork(int microseconds) {
+    auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(microseconds);
+    while (std::chrono::steady_clock::now() < end) {
+    }
+}
+
+struct BurstResult {
+    uint64_t injected;
+    uint64_t dropped;
+    uint64_t handled;
+    EventReadStats read;
+};
+
+static BurstResult runBurstSimulation(unsigned long inputBuffers, bool batched, const BurstConfig& burst, int handlerCostUs) {
+    auto device = std::make_shared<SimulatedDevice>(inputBuffers);
+    EventMonitor events;
+    events.setInputBufferCount(inputBuffers);
+    events.setDrainReports(batched);
+    events.setEventFilter(EventFilterConfig());
+    events.connect(device);
+    
+    std::atomic<uint64_t> handled(0);
+    if (batched) {
+        events.startBatchMonitoring([&](const HeadsetEvent*, size_t count) {
+            simulateHandlerWork(handlerCostUs);
+            handled.fetch_add(count);
+        });
+    } else {
+        events.startMonitoring([&](const HeadsetEvent&) {
+            simulateHandlerWork(handlerCostUs);
+            handled.fetch_add(1);
+        });
+    }
+    
+    device->startBurstGenerator(burst);
+    device->waitBurstGenerator();
+    
+    // Restliche Reports abarbeiten lassen
+    while (device->pendingReports() > 0) {
+        Sleep(10);
+    }
+    Sleep(50);
+    events.stopMonitoring();
+    
+    BurstResult result;
+    result.injected = device->injectedReports();
+    result.dropped = device->droppedReports();
+    result.handled = handled.load();
+    result.read = events.getReadStats();
+    events.disconnect();
+    return result;
+}
+
+static void printBurstResult(const std::string& name, const BurstResult& result) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2)
+       << "  " << std::left << std::setw(26) << name << std::right
+       << " gesendet=" << std::setw(6) << result.injected
+       << "  verworfen=" << std::setw(6) << result.dropped
+       << " (" << std::setw(6) << (result.injected ? 100.0 * result.dropped / result.injected : 0.0) << "%)"
+       << "  verarbeitet=" << std::setw(6) << result.handled
+       << "  Wakeups=" << std::setw(6) << result.read.wakeups
+       << "  max. Batch=" << result.read.maxBatch;
+    logEvent(ss.str());
+}
+
+// Event-Bursts gegen simuliertes Gerät: Drops mit/ohne Batch-Lesepfad
+void eventBurstSimulation() {
     std::cout << "\n========================================" << std::endl;
-    std::cout << "  HS80 Analyzer v1.0" << std::endl;
+    std::cout << "  Simulation: Event-Bursts" << std::endl;
     std::cout << "========================================" << std::endl;
-    std::cout << "1. Zeige alle HID-Geraete" << std::endl;
-    std::cout << "2. Zeige HS80 Interfaces" << std::endl;
-    std::cout << "3. RGB Test-Suite" << std::endl;
-    std::cout << "4. Event Monitor Test" << std::endl;
-    std::cout << "5. Vollstaendiger Test (RGB + Events)" << std::endl;
-    std::cout << "L. Logging " << (enableLogging ? "AUS" : "AN") << std::endl;
-    std::cout << "Q. Beenden" << std::endl;
+    
+    BurstConfig burst;
+    burst.bursts = 50;
+    burst.reportsPerBurst = 60;
+    burst.intervalMs = 20;
+    const int handlerCostUs = 500;
+    
+    std::stringstream ss;
+    ss << "[SIM] " << burst.bursts << " Bursts x " << burst.reportsPerBurst << " Reports, alle "
+       << burst.intervalMs << "ms, Handler-Kosten " << handlerCostUs << "us pro Aufruf";
+    logEvent(ss.str());
+    
+    printBurstResult("32 Puffer, Einzel-Read", runBurstSimulation(32, false, burst, handlerCostUs));
+    printBurstResult("32 Puffer, Batch-Read", runBurstSimulation(32, true, burst, handlerCostUs));
+    printBurstResult(std::to_string(DEFAULT_INPUT_BUFFERS) + " Puffer, Batch-Read",
+                     runBurstSimulation(DEFAULT_INPUT_BUFFERS, true, burst, handlerCostUs));
+    
+    // nextEventAsync: jeder angenommene Warter wird abgeschlossen (sonst hängt eine Coroutine)
+    auto device = std::make_shared<SimulatedDevice>();
+    EventMonitor events;
+    events.connect(device);
+    InlineExecutor inlineExecutor;
+    std::atomic<int> delivered(0), cancelled(0);
+    auto completion = [&](bool ok, const HeadsetEvent&) { (ok ? delivered : cancelled).fetch_add(1); };
+    bool acceptedIdle = events.nextEventAsync(EventType::Mute, inlineExecutor, completion);
+    events.startMonitoring([](const HeadsetEvent&) {});
+    bool acceptedRunning = events.nextEventAsync(EventType::Mute, inlineExecutor, completion);
+    device->injectEvent(EventType::Mute, 1);
+    for (int i = 0; i < 100 && delivered.load() == 0; i++) Sleep(5);
+    events.nextEventAsync(EventType::Battery, inlineExecutor, completion);
+    events.stopMonitoring();
+    events.disconnect();
+    ss.str("");
+    ss << "[SIM] nextEventAsync: ohne Monitoring " << (acceptedIdle ? "ANGENOMMEN (haengt)" : "abgelehnt")
+       << ", laufend " << (acceptedRunning ? "angenommen" : "ABGELEHNT") << ", geliefert " << delivered.load()
+       << ", bei stopMonitoring abgebrochen " << cancelled.load()
+       << (!acceptedIdle && delivered.load() == 1 && cancelled.load() == 1 ? " (korrekt)" : " (FEHLER)");
+    logEvent(ss.str());
+}
+
+// Animation-Timing gegen simuliertes Gerät: Gesamtdauer, Frames, Jitter
+void animationTimingSimulation() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Simulation: Animation-Timing" << std::endl;
     std::cout << "========================================" << std::endl;
-    std::cout << "\nWaehlen Sie: ";
+    
+    auto device = std::make_shared<SimulatedDevice>();
+    RGBController rgb;
+    rgb.connect(device);
+    rgb.initialize();
+    
+    const int durationMs = 3000;
+    const int stepMs = 20;
+    
+    rgb.animation().resetStats();
+    auto start = std::chrono::steady_clock::now();
+    rgb.rainbow(durationMs, stepMs);
+    auto elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    AnimationStats stats = rgb.animation().getStats();
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << "[ANIM] Regenbogen " << durationMs << "ms @ " << stepMs << "ms: Dauer=" << elapsedMs
+       << "ms, Frames=" << stats.frames << " (erwartet " << durationMs / stepMs << ")"
+       << ", uebersprungen=" << stats.skippedFrames << ", Fehler=" << stats.sendErrors;
+    logEvent(ss.str());
+    printLatencySnapshot("Weck-Jitter", stats.wakeJitter);
+    printLatencySnapshot("Frame-Zeit", stats.frameTime);
+    
+    // Start/Stop dürfen nicht blockieren
+    start = std::chrono::steady_clock::now();
+    rgb.startPulse(RGBColor(255, 0, 0), 0, stepMs);
+    Sleep(200);
+    rgb.stopEffect();
+    auto stopUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() - 200000.0;
+    rgb.waitEffect();
+    
+    ss.str("");
+    ss << std::fixed << std::setprecision(1) << "[ANIM] Start+Stop ohne Sleep: ~" << stopUs << "us";
+    logEvent(ss.str());
+    
+    rgb.disconnect();
 }
 
-int main() {
-    std::cout << "HS80 Analyzer v1.0" << std::endl;
-    std::cout << "==================" << std::endl;
-    std::cout << "\nDieses Tool analysiert die RGB- und Event-Interfaces" << std::endl;
-    std::cout << "des Corsair HS80 RGB Wireless Gaming Headsets.\n" << std::endl;
+static void printRateStats(const std::string& label, const AnimationStats& stats) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << "[ANIM] " << std::left << std::setw(22) << label << std::right
+       << " Intervall=" << stats.requestedIntervalMs << "->" << stats.effectiveIntervalMs << "ms"
+       << ", FPS=" << stats.achievedFps
+       << ", Schreiben=" << stats.writeEwmaUs / 1000.0 << "ms"
+       << ", Auslastung=" << stats.linkSaturation * 100.0 << "%"
+       << ", uebersprungen=" << stats.skippedFrames
+       << ", Anpassungen=" << stats.rateChanges
+       << ", Ueberlaeufe=" << stats.overrunFrames;
+    logEvent(ss.str());
+}
+
+// Backpressure: Framerate folgt der Schreiblatenz des (simulierten) Links
+void adaptiveRateSimulation() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Simulation: Adaptive Framerate" << std::endl;
+    std::cout << "========================================" << std::endl;
     
-    HeadsetManager manager;
-    bool connected = false;
+    struct Phase {
+        const char* name;
+        DWORD latencyUs;
+        DWORD jitterUs;
+    };
+    const Phase phases[] = {
+        { "Kabel (1.5ms)", 1500, 300 },
+        { "Funk (30ms)", 30000, 8000 },
+        { "Funk gestoert (60ms)", 60000, 15000 },
+        { "Kabel (1.5ms)", 1500, 300 },
+    };
+    const int stepMs = 20;
+    const DWORD phaseMs = 2000;
     
-    while (true) {
-        printMainMenu();
+    auto device = std::make_shared<SimulatedDevice>();
+    RGBController rgb;
+    rgb.connect(device);
+    rgb.initialize();
+    
+    logEvent("[ANIM] Regenbogen @ " + std::to_string(stepMs) + "ms, " + std::to_string(phaseMs) + "ms pro Phase");
+    rgb.startRainbow(0, stepMs);
+    for (const Phase& phase : phases) {
+        device->setWriteLatency(phase.latencyUs, phase.jitterUs);
+        rgb.animation().resetStats();
+        Sleep(phaseMs);
+        printRateStats(phase.name, rgb.animation().getStats());
+    }
+    rgb.stopEffect();
+    rgb.waitEffect();
+    
+    // Vergleich: gleicher Funk-Link ohne Backpressure
+    RateControlConfig config = rgb.animation().getRateControl();
+    config.enabled = false;
+    rgb.animation().setRateControl(config);
+    device->setWriteLatency(phases[1].latencyUs, phases[1].jitterUs);
+    rgb.animation().resetStats();
+    rgb.startRainbow(0, stepMs);
+    Sleep(phaseMs);
+    printRateStats("Funk ohne Backpressure", rgb.animation().getStats());
+    rgb.stopEffect();
+    rgb.waitEffect();
+    
+    rgb.disconnect();
+}
+
+// Bisherige Float-Rechnung aus rainbow()/pulse() als Referenz
+static RGBColor floatHueToRgb(float hue) {
+    float r = 0, g = 0, b = 0;
+    if (hue < 60) { r = 255; g = (hue / 60) * 255; }
+    else if (hue < 120) { r = ((120 - hue) / 60) * 255; g = 255; }
+    else if (hue < 180) { g = 255; b = ((hue - 120) / 60) * 255; }
+    else if (hue < 240) { g = ((240 - hue) / 60) * 255; b = 255; }
+    else if (hue < 300) { b = 255; r = ((hue - 240) / 60) * 255; }
+    else { b = ((360 - hue) / 60) * 255; r = 255; }
+    return RGBColor((unsigned char)r, (unsigned char)g, (unsigned char)b);
+}
+
+static RGBColor floatScale(RGBColor color, float factor) {
+    return RGBColor((unsigned char)(color.r * factor), (unsigned char)(color.g * factor), (unsigned char)(color.b * factor));
+}
+
+// Laufzeit in ns pro Frame
+template <typename Func>
+static double benchmarkNsPerFrame(size_t frames, int rounds, Func func) {
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        func(round);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return elapsed / (static_cast<double>(frames) * rounds);
+}
+
+static void printBenchmark(const std::string& name, double floatNs, double tableNs, const char* baseLabel = "Float") {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2)
+       << "  " << std::left << std::setw(22) << name << std::right
+       << " " << baseLabel << "=" << std::setw(7) << floatNs << "ns"
+       << "  Tabelle=" << std::setw(7) << tableNs << "ns"
+       << "  Faktor=" << std::setw(6) << (tableNs > 0 ? floatNs / tableNs : 0.0) << "x";
+    logEvent(ss.str());
+}
+
+// Farb-Pipeline: Float pro Aufruf gegen Festkomma-Tabellen/SSE2 im Batch
+void colorPipelineBenchmark() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Benchmark: Farb-Pipeline" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    const size_t frameCount = 4096;
+    const int rounds = 500;
+    std::vector<LEDZones> frames(frameCount);
+    std::vector<uint16_t> levels(frameCount);
+    for (size_t i = 0; i < frameCount; i++) {
+        levels[i] = static_cast<uint16_t>(i % 257);
+    }
+    volatile unsigned char sink = 0;
+    
+    logEvent("[BENCH] " + std::to_string(frameCount) + " Frames x " + std::to_string(rounds) + " Runden, ns pro Frame");
+    
+    // Farbkreis
+    double floatHue = benchmarkNsPerFrame(frameCount, rounds, [&](int round) {
+        for (size_t i = 0; i < frameCount; i++) {
+            float hue = ((i + round) % 360) * 1.0f;
+            frames[i] = LEDZones(floatHueToRgb(hue));
+        }
+        sink = sink + frames[frameCount - 1].logo.r;
+    });
+    double tableHue = benchmarkNsPerFrame(frameCount, rounds, [&](int round) {
+        Color::hueFrames(static_cast<uint32_t>(round) << 8, (Color::HUE_STEPS << 8) / 360, frames.data(), frameCount);
+        sink = sink + frames[frameCount - 1].logo.r;
+    });
+    printBenchmark("Farbkreis", floatHue, tableHue);
+    
+    // Fade (Puls)
+    const RGBColor base(0, 155, 222);
+    double floatFade = benchmarkNsPerFrame(frameCount, rounds, [&](int) {
+        for (size_t i = 0; i < frameCount; i++) {
+            frames[i] = LEDZones(floatScale(base, levels[i] / 256.0f));
+        }
+        sink = sink + frames[frameCount - 1].logo.g;
+    });
+    double tableFade = benchmarkNsPerFrame(frameCount, rounds, [&](int) {
+        Color::fadeFrames(LEDZones(base), levels.data(), frames.data(), frameCount);
+        sink = sink + frames[frameCount - 1].logo.g;
+    });
+    printBenchmark("Fade", floatFade, tableFade);
+    
+    // Globale Helligkeit
+    double floatScaleNs = benchmarkNsPerFrame(frameCount, rounds, [&](int) {
+        for (size_t i = 0; i < frameCount; i++) {
+            frames[i].logo = floatScale(frames[i].logo, 0.75f);
+            frames[i].power = floatScale(frames[i].power, 0.75f);
+            frames[i].mic = floatScale(frames[i].mic, 0.75f);
+        }
+        sink = sink + frames[frameCount - 1].mic.b;
+    });
+    double tableScaleNs = benchmarkNsPerFrame(frameCount, rounds, [&](int) {
+        Color::scaleFrames(frames.data(), frameCount, 192);
+        sink = sink + frames[frameCount - 1].mic.b;
+    });
+    printBenchmark("Helligkeit", floatScaleNs, tableScaleNs);
+}
+
+// Compositor: Grund-Effekt + Overlays, Kosten pro Frame und Cache-Trefferquote
+void compositorBenchmark() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Benchmark: Compositor" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    Compositor compositor;
+    int base = compositor.addLayer(0);
+    int dim = compositor.addLayer(10, BlendMode::Multiply);
+    int mute = compositor.addLayer(20, BlendMode::Alpha, ZONE_MASK_MIC);
+    int battery = compositor.addLayer(30, BlendMode::Max, ZONE_MASK_POWER);
+    compositor.setLayerColor(dim, RGBColor(200, 200, 200));
+    compositor.setLayerColor(mute, RGBColor(255, 0, 0));
+    compositor.setLayerColor(battery, RGBColor(255, 120, 0));
+    
+    const int frames = 200000;
+    FrameContext frame;
+    frame.frameIntervalMs = 16;
+    frame.skippedFrames = 0;
+    LEDZones zones;
+    volatile unsigned char sink = 0;
+    
+    // Nur statische Ebenen: nach dem ersten Frame kommt alles aus dem Cache
+    CompositorStats before = compositor.getStats();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        frame.frameIndex = i;
+        frame.timeMs = i * frame.frameIntervalMs;
+        compositor.render(frame, zones);
+        sink = sink + zones.mic.r;
+    }
+    double staticNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+    CompositorStats staticStats = compositor.getStats();
+    
+    // Animierte Grund-Ebene: jede Frame mischt alle Ebenen ab Ebene 0 neu
+    compositor.setLayerSource(base, std::make_shared<RainbowEffect>(5000));
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        frame.frameIndex = i;
+        frame.timeMs = i * frame.frameIntervalMs;
+        compositor.render(frame, zones);
+        sink = sink + zones.mic.r;
+    }
+    double animatedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+    CompositorStats animatedStats = compositor.getStats();
+    
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2)
+       << "[BENCH] 4 Ebenen, statisch: " << staticNs << "ns/Frame, Mischungen="
+       << (staticStats.layerBlends - before.layerBlends) << ", Cache-Frames=" << (staticStats.cachedFrames - before.cachedFrames);
+    logEvent(ss.str());
+    ss.str("");
+    ss << std::fixed << std::setprecision(2)
+       << "[BENCH] 4 Ebenen, animierte Basis: " << animatedNs << "ns/Frame, Mischungen/Frame="
+       << static_cast<double>(animatedStats.layerBlends - staticStats.layerBlends) / frames;
+    logEvent(ss.str());
+}
+
+// Keyframe-Bibliothek: Öffnen und Nachschlagen bei vielen Animationen
+void keyframeLibraryBenchmark() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Benchmark: Keyframe-Bibliothek" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    const char* textPath = "HS80_Bench_Keyframes.txt";
+    const char* binaryPath = "HS80_Bench_Keyframes.hs8k";
+    const int animations = 2000;
+    const int keysPerTrack = 200;
+    
+    {
+        std::ofstream text(textPath);
+        for (int a = 0; a < animations; a++) {
+            text << "animation anim" << a << "\nduration " << keysPerTrack * 10 << "\nloop 0 " << keysPerTrack * 10 << " 0\n";
+            for (int k = 0; k < keysPerTrack; k++) {
+                text << "key all " << k * 10 << " " << (k * 7) % 256 << " " << (k * 13) % 256 << " " << (k * 29) % 256 << "\n";
+            }
+            text << "end\n";
+        }
+    }
+    
+    std::string error;
+    auto start = std::chrono::steady_clock::now();
+    bool converted = convertKeyframeText(textPath, binaryPath, error);
+    double convertMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::remove(textPath);
+    if (!converted) {
+        logEvent("[BENCH] Konvertierung fehlgeschlagen: " + error);
+        return;
+    }
+    
+    auto library = std::make_shared<KeyframeLibrary>();
+    start = std::chrono::steady_clock::now();
+    bool opened = library->open(binaryPath);
+    double openUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    
+    if (opened) {
+        start = std::chrono::steady_clock::now();
+        KeyframeAnimation animation = library->find("anim1234");
+        double findUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
         
-        char choice = _getch();
-        choice = toupper(choice);
-        std::cout << choice << std::endl;
+        // Abspielen: Frames direkt aus dem Mapping
+        KeyframeEffect effect(library, animation);
+        FrameContext frame;
+        frame.frameIntervalMs = 16;
+        frame.skippedFrames = 0;
+        LEDZones zones;
+        volatile unsigned char sink = 0;
+        const int frames = 100000;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; i++) {
+            frame.frameIndex = i;
+            frame.timeMs = i * frame.frameIntervalMs;
+            effect.render(frame, zones);
+            sink = sink + zones.logo.r;
+        }
+        double frameNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
         
-        switch (choice) {
-        case '1':
-            showAllDevices();
-            break;
-            
-        case '2':
-            showHS80Interfaces();
-            break;
-            
-        case '3':
-            if (!connected) {
-                std::cout << "\nVerbinde mit HS80..." << std::endl;
-                connected = manager.connect();
-            }
-            if (connected) {
-                rgbTestSuite(manager.rgb());
-            }
-            break;
-            
-        case '4':
-            if (!connected) {
-                std::cout << "\nVerbinde mit HS80..." << std::endl;
-                connected = manager.connect();
-            }
-            if (connected) {
-                eventMonitorTest(manager.events());
-            }
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1)
+           << "[BENCH] " << animations << " Animationen x " << keysPerTrack << " Keys: Konvertieren=" << convertMs
+           << "ms, Oeffnen=" << openUs << "us, Suchen=" << findUs << "us, Frame=" << frameNs << "ns";
+        logEvent(ss.str());
+    } else {
+        logEvent("[BENCH] Bibliothek konnte nicht geoeffnet werden");
+    }
+    
+    library->close();
+    std::remove(binaryPath);
+}
+
+// Render-Kosten eines Effekts in ns pro Frame
+static double effectNsPerFrame(Effect& effect, int frames, double intervalMs) {
+    FrameContext frame;
+    frame.frameIntervalMs = intervalMs;
+    frame.skippedFrames = 0;
+    LEDZones zones;
+    volatile unsigned char sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        frame.frameIndex = i;
+        frame.timeMs = i * intervalMs;
+        effect.render(frame, zones);
+        sink = sink + zones.logo.r;
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+// Frame-Tabellen: Erzeugung zur Laufzeit vs. Compile-Zeit, Kosten pro Frame, Größe
+void frameTableBenchmark() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Benchmark: Frame-Tabellen" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    const int rounds = 2000;
+    const int frames = 200000;
+    std::vector<uint8_t> rgb;
+    
+    // Erzeugung: statische Tabellen kosten zur Laufzeit nichts (liegen in .rdata)
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        buildRainbowFrames(10000, 0, 50, rgb);
+    }
+    double rainbowBuildUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+    size_t rainbowBytes = rgb.size();
+    
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        buildPulseFrames(RGBColor(255, 0, 0), 0, rgb);
+    }
+    double pulseBuildUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+    size_t pulseBytes = rgb.size();
+    
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2)
+       << "[BENCH] Erzeugung Regenbogen 10s/50ms: Laufzeit=" << rainbowBuildUs << "us (" << rainbowBytes
+       << " Bytes), Compile-Zeit=0us";
+    logEvent(ss.str());
+    ss.str("");
+    ss << std::fixed << std::setprecision(2)
+       << "[BENCH] Erzeugung Puls rot: Laufzeit=" << pulseBuildUs << "us (" << pulseBytes
+       << " Bytes), Compile-Zeit=0us";
+    logEvent(ss.str());
+    
+    // Pro Frame: Effekt rechnen vs. Tabelle lesen
+    FrameTableView view;
+    RainbowEffect rainbow(10000);
+    if (findRainbowTable(10000, 0, 50, view)) {
+        TableEffect table(view);
+        printBenchmark("Regenbogen/Frame", effectNsPerFrame(rainbow, frames, 50), effectNsPerFrame(table, frames, 50), "Effekt");
+    }
+    PulseEffect pulse(RGBColor(255, 0, 0), 36 * 30);
+    if (findPulseTable(RGBColor(255, 0, 0), 0, 30, view)) {
+        TableEffect table(view);
+        printBenchmark("Puls/Frame", effectNsPerFrame(pulse, frames, 30), effectNsPerFrame(table, frames, 30), "Effekt");
+    }
+    
+    // Binärgröße: alle statischen Tabellen zusammen
+    logEvent("[BENCH] Statische Frame-Tabellen im Binary: " + std::to_string(staticFrameTableBytes()) + " Bytes");
+}
+
+// Audio-Quelle für die Latenzmessung: schreibt PCM in Echtzeit in eine Pipe,
+// alle burstEveryMs ein kurzer Bass-Burst
+struct AudioWriterContext {
+    HANDLE pipe;
+    uint32_t sampleRate;
+    size_t chunkFrames;
+    int durationMs;
+    int burstEveryMs;
+    int burstLengthMs;
+    std::vector<int64_t> burstTicks;    // QPC direkt vor dem Schreiben des ersten Burst-Chunks
+};
+
+static DWORD WINAPI AudioWriterThreadProc(LPVOID param) {
+    AudioWriterContext* ctx = static_cast<AudioWriterContext*>(param);
+    LARGE_INTEGER frequency, start, now;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&start);
+    
+    std::vector<int16_t> chunk(ctx->chunkFrames);
+    const uint64_t totalFrames = static_cast<uint64_t>(ctx->durationMs) * ctx->sampleRate / 1000;
+    const uint64_t burstEvery = static_cast<uint64_t>(ctx->burstEveryMs) * ctx->sampleRate / 1000;
+    const uint64_t burstLength = static_cast<uint64_t>(ctx->burstLengthMs) * ctx->sampleRate / 1000;
+    
+    for (uint64_t frame = 0; frame < totalFrames; frame += ctx->chunkFrames) {
+        // Im Abspieltempo schreiben
+        int64_t due = start.QuadPart + static_cast<int64_t>(frame * frequency.QuadPart / ctx->sampleRate);
+        QueryPerformanceCounter(&now);
+        while (now.QuadPart < due) {
+            Sleep(due - now.QuadPart > frequency.QuadPart / 500 ? 1 : 0);
+            QueryPerformanceCounter(&now);
+        }
+        
+        bool burstStart = false;
+        for (size_t i = 0; i < ctx->chunkFrames; i++) {
+            uint64_t position = (frame + i) % burstEvery;
+            bool inBurst = frame + i >= burstEvery && position < burstLength;
+            burstStart |= inBurst && position == 0;
+            chunk[i] = inBurst ? static_cast<int16_t>(20000 * std::sin(2.0 * 3.14159265 * 80.0 * position / ctx->sampleRate)) : 0;
+        }
+        if (burstStart) {
+            QueryPerformanceCounter(&now);
+            ctx->burstTicks.push_back(now.QuadPart);
+        }
+        
+        DWORD written = 0;
+        if (!WriteFile(ctx->pipe, chunk.data(), static_cast<DWORD>(chunk.size() * sizeof(int16_t)), &written, nullptr)) {
             break;
-            
-        case '5':
-            if (!connected) {
-                std::cout << "\nVerbinde mit HS80..." << std::endl;
-                connected = manager.connect();
-            }
-            if (connected) {
-                rgbTestSuite(manager.rgb());
-                std::cout << "\n\nDruecke eine Taste fuer Event-Test..." << std::endl;
-                _getch();
-                eventMonitorTest(manager.events());
+        }
+    }
+    
+    CloseHandle(ctx->pipe);     // Ende der Quelle
+    return 0;
+}
+
+// Audio-Pipeline: Durchsatz der FFT-Analyse und Latenz Audio -> Report
+void audioPipelineBenchmark() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Benchmark: Audio-Pipeline" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    const uint32_t sampleRate = 48000;
+    AudioConfig config;
+    
+    // Durchsatz: 60s Audio so schnell wie möglich analysieren
+    {
+        std::vector<float> samples(sampleRate * 60);
+        for (size_t i = 0; i < samples.size(); i++) {
+            samples[i] = 0.4f * std::sin(2.0f * 3.14159265f * 80.0f * i / sampleRate)
+                       + 0.2f * std::sin(2.0f * 3.14159265f * 2500.0f * i / sampleRate);
+        }
+        AudioAnalyzer analyzer(sampleRate, config);
+        auto start = std::chrono::steady_clock::now();
+        analyzer.process(samples.data(), samples.size());
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1)
+           << "[BENCH] FFT " << config.fftSize << "/Hop " << config.hopSize << ": "
+           << samples.size() / seconds / 1e6 << " Mio. Samples/s (" << samples.size() / seconds / sampleRate
+           << "x Echtzeit), " << seconds * 1e6 / analyzer.bands().hop << "us pro Spektrum";
+        logEvent(ss.str());
+    }
+    
+    // Ende-zu-Ende: Pipe -> Analyse -> Effekt -> Report am simulierten Gerät
+    HANDLE readPipe = INVALID_HANDLE_VALUE, writePipe = INVALID_HANDLE_VALUE;
+    if (!CreatePipe(&readPipe, &writePipe, nullptr, 1 << 16)) {
+        logEvent("[BENCH] CreatePipe fehlgeschlagen");
+        return;
+    }
+    
+    auto device = std::make_shared<SimulatedDevice>();
+    RGBController rgb;
+    rgb.connect(device);
+    rgb.initialize();
+    
+    // Erster Report, in dem das Logo (Bass) nach einem dunklen Report aufleuchtet
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    CRITICAL_SECTION seenLock;
+    InitializeCriticalSection(&seenLock);
+    std::vector<int64_t> seenTicks;
+    bool logoDark = true;
+    device->setWriteObserver([&](const unsigned char* data, size_t size) {
+        if (size < 9 || data[2] != 0x06) {
+            return;
+        }
+        bool lit = data[8] >= 64;     // Logo-R >= 25%
+        if (lit && logoDark) {
+            LARGE_INTEGER now;
+            QueryPerformanceCounter(&now);
+            EnterCriticalSection(&seenLock);
+            seenTicks.push_back(now.QuadPart);
+            LeaveCriticalSection(&seenLock);
+        }
+        logoDark = !lit;
+    });
+    
+    auto source = std::unique_ptr<PipePcmSource>(new PipePcmSource(sampleRate, 1, PcmSampleFormat::Int16));
+    source->attach(readPipe);
+    auto pipeline = std::make_shared<AudioPipeline>(config);
+    pipeline->start(std::move(source));
+    
+    const int frameIntervalMs = 5;
+    auto effect = std::make_shared<AudioReactiveEffect>(pipeline);
+    rgb.startEffect(effect, frameIntervalMs);
+    
+    AudioWriterContext writer;
+    writer.pipe = writePipe;
+    writer.sampleRate = sampleRate;
+    writer.chunkFrames = 64;
+    writer.durationMs = 5000;
+    writer.burstEveryMs = 250;
+    writer.burstLengthMs = 60;
+    HANDLE writerThread = CreateThread(nullptr, 0, AudioWriterThreadProc, &writer, 0, nullptr);
+    if (writerThread) {
+        WaitForSingleObject(writerThread, INFINITE);
+        CloseHandle(writerThread);
+    } else {
+        CloseHandle(writePipe);
+    }
+    
+    pipeline->wait(2000);
+    rgb.waitEffect(2000);
+    rgb.stopEffect();
+    device->setWriteObserver(nullptr);
+    
+    // Bursts und Reaktionen paarweise zuordnen
+    LatencyHistogram endToEnd;
+    size_t matched = 0;
+    size_t next = 0;
+    for (int64_t burst : writer.burstTicks) {
+        while (next < seenTicks.size() && seenTicks[next] < burst) {
+            next++;
+        }
+        if (next < seenTicks.size()) {
+            endToEnd.record(static_cast<uint64_t>((seenTicks[next] - burst) * 1000000000LL / frequency.QuadPart));
+            matched++;
+            next++;
+        }
+    }
+    DeleteCriticalSection(&seenLock);
+    
+    AudioPipelineStats stats = pipeline->getStats();
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(0)
+       << "[BENCH] Pipe @ " << sampleRate << " Hz, Frame-Intervall " << frameIntervalMs << "ms: "
+       << stats.samples << " Samples, " << stats.hops << " Spektren, " << stats.samplesPerSecond << " Samples/s, Bursts "
+       << matched << "/" << writer.burstTicks.size() << " erkannt";
+    logEvent(ss.str());
+    printLatencySnapshot("Analyse", stats.analyzeTime);
+    printLatencySnapshot("Audio->Frame", effect->audioToFrame());
+    printLatencySnapshot("Audio->Report", endToEnd.snapshot());
+    
+    // attach() übernimmt die Pipe nicht
+    pipeline->stop();
+    CloseHandle(readPipe);
+    rgb.disconnect();
+}
+
+// Erzeuger für den Canvas-Benchmark: Bilder mit fester Rate ins Shared Memory
+struct CanvasProducerContext {
+    CanvasWriter* writer;
+    DWORD frameIntervalMs;
+    DWORD durationMs;
+    uint32_t frames;
+};
+
+static DWORD WINAPI CanvasProducerThreadProc(LPVOID param) {
+    CanvasProducerContext* ctx = static_cast<CanvasProducerContext*>(param);
+    uint32_t width = ctx->writer->width();
+    uint32_t height = ctx->writer->height();
+    uint32_t stride = ctx->writer->stride();
+    
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(ctx->durationMs)) {
+        // Links rot, Mitte grün, rechts blau (BGRA); Helligkeit wechselt pro Bild
+        uint8_t level = static_cast<uint8_t>(128 + (ctx->frames % 2) * 127);
+        uint8_t* pixels = ctx->writer->beginFrame();
+        for (uint32_t y = 0; y < height; y++) {
+            uint32_t* row = reinterpret_cast<uint32_t*>(pixels + static_cast<size_t>(y) * stride);
+            for (uint32_t x = 0; x < width; x++) {
+                uint32_t third = x * 3 / width;
+                uint32_t shift = third == 0 ? 16 : (third == 1 ? 8 : 0);
+                row[x] = 0xFF000000u | (static_cast<uint32_t>(level) << shift);
             }
+        }
+        ctx->writer->endFrame();
+        ctx->frames++;
+        Sleep(ctx->frameIntervalMs);
+    }
+    return 0;
+}
+
+// Canvas: SIMD-Mittelung direkt im Mapping, Bild -> Zonen -> Report
+void canvasSamplerBenchmark() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Benchmark: Canvas-Sampling" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    const uint32_t width = 1920;
+    const uint32_t height = 1080;
+    const char* name = "Local\\HS80CanvasBench";
+    
+    CanvasWriter writer;
+    if (!writer.create(name, width, height, CanvasPixelFormat::BGRA)) {
+        logEvent("[BENCH] Canvas konnte nicht angelegt werden");
+        return;
+    }
+    
+    // Kernel: ganzes Bild, skalar vs. SSE2
+    {
+        uint8_t* pixels = writer.beginFrame();
+        uint32_t seed = 12345;
+        for (size_t i = 0; i < static_cast<size_t>(writer.stride()) * height; i++) {
+            seed = seed * 1103515245u + 12345u;
+            pixels[i] = static_cast<uint8_t>(seed >> 24);
+        }
+        writer.endFrame();
+        
+        const int iterations = 20;
+        uint64_t scalarSums[4], simdSums[4];
+        uint64_t count = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            count = CanvasSampler::sumRectScalar(pixels, writer.stride(), 0, 0, width, height, 1, scalarSums);
+        }
+        double scalarMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+        
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            CanvasSampler::sumRect(pixels, writer.stride(), 0, 0, width, height, 1, simdSums);
+        }
+        double simdMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+        
+        bool identical = memcmp(scalarSums, simdSums, sizeof(scalarSums)) == 0;
+        double megapixels = count / 1e6;
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2)
+           << "[BENCH] Mittelung " << width << "x" << height << ": Skalar " << scalarMs << "ms ("
+           << megapixels / scalarMs * 1000.0 << " MPixel/s), SSE2 " << simdMs << "ms ("
+           << megapixels / simdMs * 1000.0 << " MPixel/s), Faktor " << scalarMs / simdMs
+           << (identical ? ", identisch" : ", ABWEICHUNG!");
+        logEvent(ss.str());
+    }
+    
+    // Live: Erzeuger mit 60 Bildern/s, Sampler pusht jedes Bild an das Gerät
+    CanvasSampler sampler;
+    if (!sampler.openShared(name)) {
+        logEvent("[BENCH] Canvas konnte nicht geoeffnet werden");
+        return;
+    }
+    
+    auto device = std::make_shared<SimulatedDevice>();
+    RGBController rgb;
+    rgb.connect(device);
+    rgb.initialize();
+    
+    for (uint32_t rowStep : { 1u, 4u }) {
+        CanvasSampleConfig config;
+        config.rowStep = rowStep;
+        sampler.setConfig(config);
+        sampler.resetStats();
+        
+        LEDZones last;
+        sampler.start([&](const LEDZones& zones) {
+            rgb.setColors(zones);
+            last = zones;
+        });
+        
+        CanvasProducerContext producer;
+        producer.writer = &writer;
+        producer.frameIntervalMs = 16;
+        producer.durationMs = 2000;
+        producer.frames = 0;
+        HANDLE producerThread = CreateThread(nullptr, 0, CanvasProducerThreadProc, &producer, 0, nullptr);
+        if (producerThread) {
+            WaitForSingleObject(producerThread, INFINITE);
+            CloseHandle(producerThread);
+        }
+        Sleep(50);
+        sampler.stop();
+        
+        CanvasSamplerStats stats = sampler.getStats();
+        std::stringstream ss;
+        ss << "[BENCH] Canvas @ ~60 Bilder/s, jede " << rowStep << ". Zeile: " << producer.frames << " Bilder, "
+           << stats.frames << " gepusht, " << stats.skippedFrames << " verpasst, " << stats.tornReads
+           << " verworfen; letzte Zonen Power=" << (int)last.power.r << "/" << (int)last.power.g << "/" << (int)last.power.b
+           << " Logo=" << (int)last.logo.r << "/" << (int)last.logo.g << "/" << (int)last.logo.b
+           << " Mic=" << (int)last.mic.r << "/" << (int)last.mic.g << "/" << (int)last.mic.b;
+        logEvent(ss.str());
+        printLatencySnapshot("Mittelung", stats.sampleTime);
+        printLatencySnapshot("Bild->Push", stats.publishToPush);
+    }
+    
+    rgb.disconnect();
+}
+
+// Versatz pro Frame: Abstand zwischen frühestem und spätestem k-ten Report aller Geräte
+static LatencySnapshot frameSpread(const std::vector<std::vector<int64_t>>& writes, const LARGE_INTEGER& frequency) {
+    size_t frames = SIZE_MAX;
+    for (const auto& device : writes) {
+        frames = std::min(frames, device.size());
+    }
+    LatencyHistogram spread;
+    for (size_t k = 0; k < frames && frames != SIZE_MAX; k++) {
+        int64_t first = writes[0][k], last = writes[0][k];
+        for (const auto& device : writes) {
+            first = std::min(first, device[k]);
+            last = std::max(last, device[k]);
+        }
+        spread.record(static_cast<uint64_t>((last - first) * 1000000000LL / frequency.QuadPart));
+    }
+    return spread.snapshot();
+}
+
+// Mehrere Headsets: eigene Engines vs. gemeinsamer FrameClock
+void frameClockSimulation() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Simulation: Gemeinsamer Frame-Takt" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    const size_t deviceCount = 24;
+    const int stepMs = 20;
+    const DWORD runMs = 3000;
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    
+    std::vector<std::shared_ptr<SimulatedDevice>> devices;
+    std::vector<std::unique_ptr<RGBController>> controllers;
+    std::vector<std::vector<int64_t>> writes(deviceCount);
+    CRITICAL_SECTION writesLock;
+    InitializeCriticalSection(&writesLock);
+    for (size_t i = 0; i < deviceCount; i++) {
+        auto device = std::make_shared<SimulatedDevice>();
+        device->setWriteLatency(300, 100);     // USB-Dongle
+        std::unique_ptr<RGBController> rgb(new RGBController());
+        rgb->connect(device);
+        rgb->initialize();
+        device->setWriteObserver([&writes, &writesLock, i](const unsigned char* data, size_t size) {
+            if (size < 3 || data[2] != 0x06) {
+                return;
+            }
+            LARGE_INTEGER now;
+            QueryPerformanceCounter(&now);
+            EnterCriticalSection(&writesLock);
+            writes[i].push_back(now.QuadPart);
+            LeaveCriticalSection(&writesLock);
+        });
+        devices.push_back(device);
+        controllers.push_back(std::move(rgb));
+    }
+    
+    // Jedes Headset mit eigenem Animation-Thread
+    for (auto& rgb : controllers) {
+        rgb->startRainbow(0, stepMs);
+    }
+    Sleep(runMs);
+    for (auto& rgb : controllers) {
+        rgb->stopEffect();
+    }
+    for (auto& rgb : controllers) {
+        rgb->waitEffect();
+    }
+    EnterCriticalSection(&writesLock);
+    LatencySnapshot separate = frameSpread(writes, frequency);
+    for (auto& device : writes) {
+        device.clear();
+    }
+    LeaveCriticalSection(&writesLock);
+    
+    // Ein Takt, ein Render, Writes direkt nacheinander
+    FrameClock clock;
+    for (auto& rgb : controllers) {
+        clock.subscribe(*rgb);
+    }
+    clock.start(createRainbowEffect(10000, 0, stepMs), stepMs);
+    Sleep(runMs);
+    clock.stop();
+    clock.wait();
+    EnterCriticalSection(&writesLock);
+    LatencySnapshot shared = frameSpread(writes, frequency);
+    LeaveCriticalSection(&writesLock);
+    
+    FrameClockStats stats = clock.getStats();
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << "[ANIM] " << deviceCount << " Geraete @ " << stepMs << "ms, eigene Engines: Versatz p50="
+       << separate.p50Us / 1000.0 << "ms max=" << separate.maxUs / 1000.0 << "ms";
+    logEvent(ss.str());
+    ss.str("");
+    ss << std::fixed << std::setprecision(1)
+       << "[ANIM] " << deviceCount << " Geraete @ " << stepMs << "ms, FrameClock: " << stats.ticks << " Ticks, Versatz p50="
+       << shared.p50Us / 1000.0 << "ms max=" << shared.maxUs / 1000.0 << "ms, uebersprungen=" << stats.clock.skippedFrames;
+    logEvent(ss.str());
+    printLatencySnapshot("Skew pro Tick", stats.skew);
+    printLatencySnapshot("Fan-Out", stats.fanOutTime);
+    printLatencySnapshot("Weck-Jitter", stats.clock.wakeJitter);
+    
+    const FrameClockDeviceStats& lastDevice = stats.devices.back();
+    ss.str("");
+    ss << std::fixed << std::setprecision(0)
+       << "[ANIM] Letztes Geraet: Ø " << lastDevice.meanOffsetUs << "us nach dem fruehesten (max " << lastDevice.maxOffsetUs << "us)";
+    logEvent(ss.str());
+    
+    // Skalierung: Kosten pro Gerät und Tick ohne Link-Latenz
+    for (auto& device : devices) {
+        device->setWriteLatency(0, 0);
+        device->setWriteObserver(nullptr);
+    }
+    clock.resetStats();
+    clock.start(createRainbowEffect(10000, 0, 5), 5);
+    Sleep(1000);
+    clock.stop();
+    clock.wait();
+    stats = clock.getStats();
+    ss.str("");
+    ss << std::fixed << std::setprecision(2)
+       << "[ANIM] Ohne Link-Latenz @ 5ms: " << stats.ticks << " Ticks, Fan-Out p50=" << stats.fanOutTime.p50Us
+       << "us (" << stats.fanOutTime.p50Us / deviceCount << "us pro Geraet)";
+    logEvent(ss.str());
+    
+    for (auto& rgb : controllers) {
+        clock.unsubscribe(*rgb);
+        rgb->disconnect();
+    }
+    DeleteCriticalSection(&writesLock);
+}
+
+// Mute-Reflex: Mute-Event -> Mic-Farbe während eines Effekts und trotz langsamem Handler
+void muteReflexSimulation() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Simulation: Mute-Reflex" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    // Farben, die der Regenbogen nie erzeugt (dort ist immer ein Kanal 255)
+    const RGBColor mutedColor(200, 10, 10);
+    const RGBColor unmutedColor(10, 200, 10);
+    const int toggles = 40;
+    const DWORD toggleMs = 150;
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    
+    auto rgbDevice = std::make_shared<SimulatedDevice>();
+    auto eventDevice = std::make_shared<SimulatedDevice>();
+    rgbDevice->setWriteLatency(1000, 200);     // USB-Dongle, 1kHz Polling
+    
+    HeadsetManager manager;
+    manager.rgb().connect(rgbDevice);
+    manager.rgb().initialize();
+    manager.events().connect(eventDevice);
+    
+    MuteReflexConfig reflex;
+    reflex.enabled = true;
+    reflex.mutedColor = mutedColor;
+    reflex.showUnmuted = true;
+    reflex.unmutedColor = unmutedColor;
+    manager.setMuteReflex(reflex);
+    
+    // Erster Report mit der erwarteten Mic-Farbe nach jedem Umschalten;
+    // danach zählt jeder Report mit anderer Mic-Farbe als Aussetzer
+    CRITICAL_SECTION lock;
+    InitializeCriticalSection(&lock);
+    int expected = -1;
+    bool seen = true;
+    int64_t toggleTicks = 0;
+    uint64_t glitches = 0;
+    LatencyHistogram injectToReport;
+    rgbDevice->setWriteObserver([&](const unsigned char* data, size_t size) {
+        if (size < 17 || data[2] != 0x06) {
+            return;
+        }
+        RGBColor mic(data[10], data[13], data[16]);
+        const RGBColor& want = expected == 1 ? mutedColor : unmutedColor;
+        bool match = mic.r == want.r && mic.g == want.g && mic.b == want.b;
+        
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        EnterCriticalSection(&lock);
+        if (expected >= 0 && !seen && match) {
+            injectToReport.record(static_cast<uint64_t>((now.QuadPart - toggleTicks) * 1000000000LL / frequency.QuadPart));
+            seen = true;
+        } else if (expected >= 0 && seen && !match) {
+            glitches++;
+        }
+        LeaveCriticalSection(&lock);
+    });
+    
+    // Absichtlich langsamer Handler: der Reflex darf nicht auf ihn warten
+    manager.startEventMonitoring([](const HeadsetEvent&) { Sleep(30); });
+    manager.rgb().startRainbow(0, 33);
+    Sleep(200);
+    
+    for (int i = 0; i < toggles; i++) {
+        int muted = (i + 1) & 1;
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        EnterCriticalSection(&lock);
+        expected = muted;
+        seen = false;
+        toggleTicks = now.QuadPart;
+        LeaveCriticalSection(&lock);
+        eventDevice->injectEvent(EventType::Mute, muted);
+        Sleep(toggleMs);
+    }
+    
+    manager.rgb().stopEffect();
+    manager.rgb().waitEffect();
+    rgbDevice->setWriteObserver(nullptr);
+    MuteReflexStats stats = manager.getMuteReflexStats();
+    
+    // Gescheitertes Senden: der nächste Report mit gleichem Zustand muss es erneut versuchen
+    manager.rgb().disconnect();
+    eventDevice->injectEvent(EventType::Mute, 1);
+    Sleep(50);
+    manager.rgb().connect(rgbDevice);
+    manager.rgb().initialize();
+    MuteReflexStats failed = manager.getMuteReflexStats();
+    eventDevice->injectEvent(EventType::Mute, 1);
+    Sleep(50);
+    MuteReflexStats retried = manager.getMuteReflexStats();
+    bool retryOk = failed.sendErrors == stats.sendErrors + 1 && retried.triggered == failed.triggered + 1 &&
+                   retried.sendErrors == failed.sendErrors;
+    logEvent(std::string("[EVENT] Mute-Reflex nach Sendefehler: ") +
+             (retryOk ? "beim naechsten Report wiederholt (korrekt)" : "NICHT wiederholt (FEHLER)"));
+    manager.events().stopMonitoring();
+    
+    LatencySnapshot endToEnd = injectToReport.snapshot();
+    std::stringstream ss;
+    ss << "[EVENT] Mute-Reflex bei Regenbogen @ 33ms, Handler 30ms: " << toggles << " Wechsel, "
+       << stats.triggered << " Reflex-Reports, " << endToEnd.count << " erkannt, "
+       << glitches << " Aussetzer, " << stats.sendErrors << " Fehler";
+    logEvent(ss.str());
+    printLatencySnapshot("Read->Report", stats.eventToPacket);
+    printLatencySnapshot("Inject->Report", endToEnd);
+    printLatencySnapshot("Handler (Read->zurueck)", manager.events().getLatencyStats().readToReturn);
+    
+    DeleteCriticalSection(&lock);
+    manager.disconnect();
+}
+
+static HeadsetEvent makeSimulatedEvent(EventType type, int value) {
+    HeadsetEvent event;
+    event.type = EventType::EventPacket;
+    event.dataSize = buildEventReport(type, value, event.data, sizeof(event.data));
+    event.timestamp = std::chrono::steady_clock::now();
+    return event;
+}
+
+static std::string zoneText(const RGBColor& color) {
+    std::stringstream ss;
+    ss << "(" << int(color.r) << "," << int(color.g) << "," << int(color.b) << ")";
+    return ss.str();
+}
+
+// Regel-Engine: Kompilieren, Tabelle gegen lineare Auswertung, Hot-Reload
+void ruleEngineBenchmark() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Benchmark: Regel-Engine" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    const char* rulesPath = "HS80_Bench_Rules.txt";
+    const char* baseRules =
+        "layer status 10 power\n"
+        "layer mic 20 mic\n"
+        "layer flash 30 mic\n"
+        "rule akku_kritisch status\n  charging discharging unknown\n  battery 0 14\n  blink 255 0 0 500\nend\n"
+        "rule akku_niedrig status\n  charging discharging unknown\n  battery 15 29\n  color 255 120 0\nend\n"
+        "rule laden status\n  charging charging\n  breathe 0 255 0 2000\nend\n"
+        "rule stumm mic\n  muted yes\n  color 255 0 0\nend\n"
+        "rule mute_wechsel flash\n  on mute\n  color 255 255 255\n  hold 300\nend\n";
+    {
+        std::ofstream out(rulesPath, std::ios::trunc);
+        out << baseRules;
+    }
+    
+    // Großer Regelsatz: 16 Ebenen, 256 Regeln mit zufälligen Bedingungen
+    std::stringstream large;
+    uint32_t seed = 0x2545F491u;
+    auto next = [&seed](uint32_t range) { seed = seed * 1664525u + 1013904223u; return (seed >> 8) % range; };
+    const char* chargingWords[] = { "unknown", "charging", "discharging", "full" };
+    const char* muteWords[] = { "unknown", "no", "yes" };
+    for (int i = 0; i < 16; i++) {
+        large << "layer l" << i << " " << i << " all\n";
+    }
+    for (int i = 0; i < 256; i++) {
+        large << "rule r" << i << " l" << (i % 16) << "\n";
+        if (next(2)) large << "  muted " << muteWords[next(3)] << " " << muteWords[next(3)] << "\n";
+        if (next(2)) large << "  charging " << chargingWords[next(4)] << " " << chargingWords[next(4)] << "\n";
+        int low = static_cast<int>(next(100));
+        large << "  battery " << low << " " << low + static_cast<int>(next(101 - low)) << "\n";
+        if (i % 8 == 7) large << "  on mute battery\n  hold 200\n";
+        large << "  color " << next(256) << " " << next(256) << " " << next(256) << "\nend\n";
+    }
+    
+    RuleSet small, big;
+    std::string error;
+    LARGE_INTEGER frequency, t0, t1, t2;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&t0);
+    bool smallOk = small.loadFile(rulesPath, error);
+    QueryPerformanceCounter(&t1);
+    bool bigOk = big.parse(large, error);
+    QueryPerformanceCounter(&t2);
+    if (!smallOk || !bigOk) {
+        logEvent("[RULES] Regelsatz fehlerhaft: " + error);
+        return;
+    }
+    
+    const RuleSet* sets[] = { &small, &big };
+    const double compileUs[] = {
+        (t1.QuadPart - t0.QuadPart) * 1000000.0 / frequency.QuadPart,
+        (t2.QuadPart - t1.QuadPart) * 1000000.0 / frequency.QuadPart
+    };
+    for (int s = 0; s < 2; s++) {
+        const RuleSet& rules = *sets[s];
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1)
+           << "[RULES] " << rules.ruleCount() << " Regeln, " << rules.layerCount() << " Ebenen -> "
+           << rules.cellCount() << " Zellen, " << rules.tableBytes() / 1024.0 << " KB, Kompilieren " << compileUs[s] << "us";
+        logEvent(ss.str());
+    }
+    
+    // Kommentare am Zeilenende nach Modus bzw. Deckkraft
+    std::stringstream commented(
+        "layer a 1 mic add   # nach Modus\n"
+        "layer b 2 all max 128 # nach Deckkraft\n"
+        "layer c 3 power\t# ohne Modus\n"
+        "rule r a\n  color 1 2 3  # Farbe\nend\n");
+    RuleSet commentedRules;
+    bool commentedOk = commentedRules.parse(commented, error);
+    logEvent(std::string("[RULES] Kommentar am Zeilenende: ") +
+             (commentedOk && commentedRules.layerCount() == 3 ? "akzeptiert (korrekt)" : "FEHLER: " + error));
+    
+    // Abgleich: jede Zustandskombination und jeder Auslöser
+    size_t mismatches = 0, combinations = 0;
+    uint16_t linearState[RULE_MAX_LAYERS], linearEvent[RULE_MAX_LAYERS];
+    for (const RuleSet* rules : sets) {
+        for (int muted = -1; muted <= 1; muted++) {
+            for (int charging = 0; charging < 4; charging++) {
+                for (int level = -1; level <= 100; level++) {
+                    HeadsetState state;
+                    state.muted = muted;
+                    state.charging = static_cast<ChargingState>(charging);
+                    state.batteryLevel = level;
+                    for (int trigger = 0; trigger < static_cast<int>(RuleTrigger::Count); trigger++) {
+                        RuleTrigger t = static_cast<RuleTrigger>(trigger);
+                        rules->resolveLinear(state, t, linearState, linearEvent);
+                        size_t cell = rules->cellIndex(state);
+                        const uint16_t* stateRow = rules->stateRow(cell);
+                        const uint16_t* eventRow = rules->eventRow(t, cell);
+                        for (size_t i = 0; i < rules->layerCount(); i++) {
+                            uint16_t expectedEvent = t == RuleTrigger::None ? RULE_NONE : linearEvent[i];
+                            if (stateRow[i] != linearState[i] || eventRow[i] != expectedEvent) {
+                                mismatches++;
+                            }
+                        }
+                        combinations++;
+                    }
+                }
+            }
+        }
+    }
+    logEvent("[RULES] Abgleich Tabelle/linear: " + std::to_string(combinations) + " Kombinationen, " +
+             std::to_string(mismatches) + " Abweichungen");
+    
+    // Auswertung: Tabelle gegen lineare Suche über alle Regeln
+    const size_t stateCount = 4096;
+    const int rounds = 200;
+    std::vector<HeadsetState> states(stateCount);
+    for (HeadsetState& state : states) {
+        state.muted = static_cast<int>(next(3)) - 1;
+        state.charging = static_cast<ChargingState>(next(4));
+        state.batteryLevel = static_cast<int>(next(102)) - 1;
+    }
+    volatile uint32_t sink = 0;
+    for (int s = 0; s < 2; s++) {
+        const RuleSet& rules = *sets[s];
+        size_t layers = rules.layerCount();
+        double linearNs = benchmarkNsPerFrame(stateCount, rounds, [&](int) {
+            uint32_t sum = 0;
+            for (const HeadsetState& state : states) {
+                rules.resolveLinear(state, RuleTrigger::Mute, linearState, linearEvent);
+                for (size_t i = 0; i < layers; i++) sum += linearState[i] ^ linearEvent[i];
+            }
+            sink = sink + sum;
+        });
+        double tableNs = benchmarkNsPerFrame(stateCount, rounds, [&](int) {
+            uint32_t sum = 0;
+            for (const HeadsetState& state : states) {
+                size_t cell = rules.cellIndex(state);
+                const uint16_t* stateRow = rules.stateRow(cell);
+                const uint16_t* eventRow = rules.eventRow(RuleTrigger::Mute, cell);
+                for (size_t i = 0; i < layers; i++) sum += stateRow[i] ^ eventRow[i];
+            }
+            sink = sink + sum;
+        });
+        printBenchmark(std::to_string(rules.ruleCount()) + " Regeln", linearNs, tableNs, "Linear");
+    }
+    
+    // Engine am Compositor: Zustände durchspielen
+    Compositor compositor;
+    compositor.setBackground(LEDZones(RGBColor(0, 0, 40)));
+    RuleEngine engine(compositor);
+    if (!engine.loadFile(rulesPath, error)) {
+        logEvent("[RULES] " + error);
+        return;
+    }
+    engine.start(rulesPath, 50);
+    
+    struct Step { const char* label; EventType type; int value; };
+    const Step steps[] = {
+        { "Akku 50%, entlaedt", EventType::Battery, 500 },
+        { "Akku 20%",           EventType::Battery, 200 },
+        { "Akku 10%",           EventType::Battery, 100 },
+        { "Laden",              EventType::Charging, 1 },
+        { "Stumm",              EventType::Mute, 1 },
+    };
+    engine.onEvent(makeSimulatedEvent(EventType::Charging, 0));
+    for (const Step& step : steps) {
+        engine.onEvent(makeSimulatedEvent(step.type, step.value));
+        LEDZones zones = compositor.compose();
+        logEvent(std::string("[RULES] ") + step.label + ": Power=" + zoneText(zones.power) + " Mic=" + zoneText(zones.mic));
+    }
+    Sleep(400);
+    LEDZones afterHold = compositor.compose();
+    logEvent("[RULES] Nach hold (300ms): Mic=" + zoneText(afterHold.mic));
+    
+    // Eventlast: Werte wechseln, Ebenen ändern sich nur bei neuer Regel
+    engine.onEvent(makeSimulatedEvent(EventType::Charging, 0));
+    engine.resetStats();
+    for (int i = 0; i < 100000; i++) {
+        engine.onEvent(makeSimulatedEvent(EventType::Battery, (i * 37) % 1001));
+    }
+    RuleEngineStats stats = engine.getStats();
+    logEvent("[RULES] " + std::to_string(stats.events) + " Events, " + std::to_string(stats.layerUpdates) + " Ebenen-Wechsel");
+    printLatencySnapshot("Event->Ebenen", stats.evalTime);
+    
+    // Hot-Reload: Farbe ändern, dann fehlerhafte Datei
+    engine.onEvent(makeSimulatedEvent(EventType::Battery, 200));
+    std::string changed = baseRules;
+    changed.replace(changed.find("255 120 0"), 9, "255 200 0 # gelber");
+    auto reloadStart = std::chrono::steady_clock::now();
+    {
+        std::ofstream out(rulesPath, std::ios::trunc);
+        out << changed;
+    }
+    while (compositor.compose().power.g != 200 &&
+           std::chrono::steady_clock::now() - reloadStart < std::chrono::seconds(3)) {
+        Sleep(5);
+    }
+    double reloadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - reloadStart).count();
+    {
+        std::ofstream out(rulesPath, std::ios::trunc);
+        out << changed << "rule kaputt status\n  blink 1 2\nend\n";
+    }
+    Sleep(200);
+    engine.stop();
+    
+    stats = engine.getStats();
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(0)
+       << "[RULES] Hot-Reload: Power=" << zoneText(compositor.compose().power) << " nach " << reloadMs
+       << "ms (Poll 50ms), Reloads=" << stats.reloads << ", verworfen=" << stats.reloadErrors
+       << " (" << engine.lastError() << ")";
+    logEvent(ss.str());
+    remove(rulesPath);
+}
+
+// Skript-VM: Kompilieren, Durchsatz gegen native Effekte, Abgleich
+void scriptEffectBenchmark() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Benchmark: Skript-Effekte" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    struct ScriptCase {
+        const char* name;
+        const char* source;
+        std::shared_ptr<Effect> native;
+    };
+    const ScriptCase cases[] = {
+        { "Regenbogen",
+          "let h = frac(t / 10)\n"
+          "r = 255 * clamp(abs(h * 6 - 3) - 1, 0, 1)\n"
+          "g = 255 * clamp(2 - abs(h * 6 - 2), 0, 1)\n"
+          "b = 255 * clamp(2 - abs(h * 6 - 4), 0, 1)\n",
+          std::make_shared<RainbowEffect>(10000) },
+        { "Puls",
+          "let l = wave(t / 1.8)\n"
+          "let l = l * l            # ~Gamma\n"
+          "g = 155 * l\n"
+          "b = 222 * l\n",
+          std::make_shared<PulseEffect>(RGBColor(0, 155, 222), 1800) },
+        { "Regenbogen versetzt",
+          "let h = frac(t / 10 + zone / 3)\n"
+          "r = 255 * clamp(abs(h * 6 - 3) - 1, 0, 1)\n"
+          "g = 255 * clamp(2 - abs(h * 6 - 2), 0, 1)\n"
+          "b = 255 * clamp(2 - abs(h * 6 - 4), 0, 1)\n",
+          nullptr },
+        { "Zustand",
+          "let warn = (battery >= 0 && battery < 15 && charging != 1) * step(0.5, frac(t * 2))\n"
+          "let mute = zone == 2 && muted == 1\n"
+          "r = mute ? 255 : 255 * warn\n"
+          "g = mute ? 0 : (charging == 1 ? 255 * wave(t / 2) : 60)\n"
+          "b = mute ? 0 : 120 * (1 - warn)\n",
+          nullptr },
+    };
+    
+    const int frames = 200000;
+    const double intervalMs = 16.0;
+    HeadsetStateCache state;
+    BatteryStatus battery;
+    battery.valid = true;
+    battery.levelRaw = 100;
+    battery.state = ChargingState::Discharging;
+    state.applyBattery(battery);
+    state.applyMuted(true);
+    
+    for (const ScriptCase& test : cases) {
+        auto program = std::make_shared<ScriptProgram>();
+        std::string error;
+        auto compileStart = std::chrono::steady_clock::now();
+        if (!program->compile(test.source, error)) {
+            logEvent(std::string("[SCRIPT] ") + test.name + ": " + error);
+            continue;
+        }
+        double compileUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - compileStart).count();
+        
+        ScriptEffect effect(program, &state);
+        double scriptNs = effectNsPerFrame(effect, frames, intervalMs);
+        
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1)
+           << "[SCRIPT] " << std::left << std::setw(20) << test.name << std::right
+           << " Befehle " << program->frameInstructions() << "+3x" << program->zoneInstructions()
+           << ", Register " << program->registerCount() << ", Kompilieren " << compileUs << "us, "
+           << std::setprecision(2) << scriptNs << "ns/Frame (" << std::setprecision(0) << 1000000.0 / scriptNs << " Frames/ms)";
+        if (test.native) {
+            double nativeNs = effectNsPerFrame(*test.native, frames, intervalMs);
+            ss << std::setprecision(2) << ", nativ " << nativeNs << "ns";
+            
+            // Abweichung zum nativen Effekt (gleiche Formel, andere Rundung/Gamma)
+            int maxDiff = 0;
+            FrameContext frame;
+            frame.frameIntervalMs = intervalMs;
+            frame.skippedFrames = 0;
+            for (int i = 0; i < 2000; i++) {
+                frame.frameIndex = i;
+                frame.timeMs = i * 7.0;
+                LEDZones a, b;
+                effect.render(frame, a);
+                test.native->render(frame, b);
+                const uint8_t* pa = &a.logo.r;
+                const uint8_t* pb = &b.logo.r;
+                for (int c = 0; c < 9; c++) maxDiff = std::max(maxDiff, std::abs(int(pa[c]) - int(pb[c])));
+            }
+            ss << ", max. Abweichung " << maxDiff;
+        }
+        logEvent(ss.str());
+    }
+    
+    // Sandbox: Fehler im Quelltext, Division durch 0, NaN
+    ScriptProgram program;
+    std::string error;
+    program.compile("let x = 1 +\nr = 255", error);
+    logEvent("[SCRIPT] Fehlerhaftes Skript: " + error);
+    program.compile("r = 255 / (zone - zone)\ng = sqrt(-1) * 255\nb = 1e30 * 1e30 - 1e30 * 1e30", error);
+    LEDZones zones;
+    program.run(ScriptInputs(), zones);
+    logEvent("[SCRIPT] Division durch 0 / sqrt(-1) / Inf-Inf -> " + std::to_string(zones.logo.r) + "," +
+             std::to_string(zones.logo.g) + "," + std::to_string(zones.logo.b));
+    program.compile("r = 1e30 * 1e30 * (zone + 1)\ng = -1e30 * 1e30\nb = 255", error);
+    program.run(ScriptInputs(), zones);
+    logEvent("[SCRIPT] +Inf / -Inf / 255 -> " + std::to_string(zones.logo.r) + "," + std::to_string(zones.logo.g) + "," +
+             std::to_string(zones.logo.b) + (zones.logo.r == 0 && zones.logo.g == 0 && zones.logo.b == 255 ? " (korrekt)" : " (FEHLER)"));
+    
+    // Zweite Zuweisung an einen Ausgang würde nicht in Quelltext-Reihenfolge wirken
+    const char* reassigned[] = { "r = t\nr = 5", "r = zone\nr = t", "r = 5\ng = 0\nr = zone" };
+    int rejected = 0;
+    for (const char* source : reassigned) {
+        if (!program.compile(source, error)) rejected++;
+    }
+    bool single = program.compile("let x = t\nr = x\ng = zone\nb = 5", error);
+    logEvent("[SCRIPT] Doppelte Zuweisung an r/g/b: " + std::to_string(rejected) + "/3 abgelehnt" +
+             (rejected == 3 && single ? " (korrekt)" : " (FEHLER)") + ", z.B. \"" + (program.compile(reassigned[0], error), error) + "\"");
+}
+
+// Effekt-Cache: kalt rendern vs. gemappt abspielen, Prüfsumme, Aufräumen
+void effectCacheBenchmark() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Benchmark: Effekt-Cache" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    const char* directory = "HS80_Bench_Cache";
+    const char* source =
+        "let h = frac(t / 10 + zone / 3 + noise(floor(t * 4) + zone) * 0.05)\n"
+        "let l = 0.6 + 0.4 * wave(t / 2.5)\n"
+        "r = 255 * l * clamp(abs(h * 6 - 3) - 1, 0, 1)\n"
+        "g = 255 * l * clamp(2 - abs(h * 6 - 2), 0, 1)\n"
+        "b = 255 * l * clamp(2 - abs(h * 6 - 4), 0, 1)\n";
+    auto program = std::make_shared<ScriptProgram>();
+    std::string error;
+    if (!program->compile(source, error)) {
+        logEvent("[CACHE] " + error);
+        return;
+    }
+    
+    // Eine Periode (10s) bei 20ms
+    EffectCacheKey key("script", source, 20000, 500);
+    EffectFactory factory = [&]() { return std::make_shared<ScriptEffect>(program); };
+    
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    {
+        EffectCache cache(directory, 1024 * 1024);
+        cache.clear();
+        
+        auto start = std::chrono::steady_clock::now();
+        auto cold = cache.load(key, factory);
+        double coldMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        
+        start = std::chrono::steady_clock::now();
+        auto warm = cache.load(key, factory);
+        LEDZones first;
+        FrameContext frame = {};
+        frame.frameIntervalMs = 20.0;
+        warm->render(frame, first);
+        double warmUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        
+        EffectCacheStats stats = cache.getStats();
+        ss << "[CACHE] Kalt (rendern + schreiben): " << coldMs << "ms (davon Rendern " << stats.lastRenderMs
+           << "ms), warm bis erster Frame: " << warmUs << "us (Mappen + Pruefen " << stats.lastOpenUs << "us)";
+        logEvent(ss.str());
+        
+        // Abspielen: gleiche Soll-Zeiten wie beim Rendern -> identische Frames
+        ScriptEffect live(program);
+        int mismatches = 0;
+        for (int i = 0; i < 1500; i++) {
+            frame.frameIndex = i;
+            frame.timeMs = (i % 500) * 20.0;
+            LEDZones a, b;
+            warm->render(frame, a);
+            live.render(frame, b);
+            if (memcmp(&a, &b, sizeof(LEDZones)) != 0) mismatches++;
+        }
+        double liveNs = effectNsPerFrame(live, 200000, 20.0);
+        double cachedNs = effectNsPerFrame(*warm, 200000, 20.0);
+        ss.str("");
+        ss << "[CACHE] Abspielen " << cachedNs << "ns/Frame vs. Skript " << liveNs
+           << "ns/Frame, Abweichungen " << mismatches << "/1500";
+        logEvent(ss.str());
+    }
+    
+    // Defekte Datei: ein Byte in den Frames kippen
+    {
+        char name[24];
+        snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key.hash()));
+        std::string path = std::string(directory) + "\\" + name + ".hs8f";
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(sizeof(EffectCacheHeader) + 1000);
+            file.put(0x5A);
+        }
+        EffectCache cache(directory, 1024 * 1024);
+        bool found = cache.find(key) != nullptr;
+        EffectCacheStats stats = cache.getStats();
+        logEvent(std::string("[CACHE] Gekipptes Byte: ") + (found ? "NICHT erkannt" : "erkannt") +
+                 ", verworfen " + std::to_string(stats.corrupt));
+        
+        // Neue Bibliotheksversion bzw. andere Parameter -> anderer Schlüssel
+        EffectCacheKey other = key;
+        other.frameIntervalUs = 16000;
+        logEvent(std::string("[CACHE] Anderer Frame-Abstand -> ") + (other.hash() != key.hash() ? "neuer Schluessel" : "GLEICHER Schluessel"));
+    }
+    
+    // Aufräumen: Platz für etwa drei Dateien, zehn verschiedene Effekte
+    {
+        uint64_t fileBytes = sizeof(EffectCacheHeader) + 500 * sizeof(LEDZones);
+        EffectCache cache(directory, fileBytes * 3);
+        for (int i = 0; i < 10; i++) {
+            RainbowEffect rainbow(5000 + i * 1000);
+            cache.store(EffectCacheKey("rainbow", std::to_string(5000 + i * 1000), 20000, 500), rainbow);
+            if (i >= 1) {
+                // Den ersten Effekt weiter benutzen: bleibt als zuletzt genutzter erhalten
+                cache.find(EffectCacheKey("rainbow", "5000", 20000, 500));
+            }
+        }
+        bool firstKept = cache.find(EffectCacheKey("rainbow", "5000", 20000, 500)) != nullptr;
+        EffectCacheStats stats = cache.getStats();
+        ss.str("");
+        ss << "[CACHE] 10 Effekte, Limit 3 Dateien: " << stats.evictions << " geloescht, belegt "
+           << stats.bytes << "/" << fileBytes * 3 << " Bytes, meistgenutzter " << (firstKept ? "behalten" : "GELOESCHT");
+        logEvent(ss.str());
+        cache.clear();
+    }
+    RemoveDirectoryA(directory);
+}
+
+// OKLab in Double (Referenz für Genauigkeit und Schrittweiten)
+struct FloatLab {
+    double L, a, b;
+};
+
+static double floatLinear(double c) {
+    return c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+}
+
+// sRGB-Kanäle 0-1 (ungerundet)
+static FloatLab floatToOkLab(double red, double green, double blue) {
+    double r = floatLinear(red), g = floatLinear(green), b = floatLinear(blue);
+    double l = std::cbrt(0.4122214708 * r + 0.5363325363 * g + 0.0514459929 * b);
+    double m = std::cbrt(0.2119034982 * r + 0.6806995451 * g + 0.1073969566 * b);
+    double s = std::cbrt(0.0883024619 * r + 0.2817188376 * g + 0.6299787005 * b);
+    return FloatLab{ 0.2104542553 * l + 0.7936177850 * m - 0.0040720468 * s,
+                     1.9779984951 * l - 2.4285922050 * m + 0.4505937099 * s,
+                     0.0259040371 * l + 0.7827717662 * m - 0.8086757660 * s };
+}
+
+static FloatLab floatToOkLab(RGBColor color) {
+    return floatToOkLab(color.r / 255.0, color.g / 255.0, color.b / 255.0);
+}
+
+static RGBColor floatFromOkLab(const FloatLab& lab) {
+    double l = lab.L + 0.3963377774 * lab.a + 0.2158037573 * lab.b;
+    double m = lab.L - 0.1055613458 * lab.a - 0.0638541728 * lab.b;
+    double s = lab.L - 0.0894841775 * lab.a - 1.2914855480 * lab.b;
+    l = l * l * l; m = m * m * m; s = s * s * s;
+    double linear[3] = { 4.0767416621 * l - 3.3077115913 * m + 0.2309699292 * s,
+                         -1.2684380046 * l + 2.6097574011 * m - 0.3413193965 * s,
+                         -0.0041960863 * l - 0.7034186147 * m + 1.7076147010 * s };
+    uint8_t out[3];
+    for (int i = 0; i < 3; i++) {
+        double x = std::min(1.0, std::max(0.0, linear[i]));
+        double c = x <= 0.0031308 ? x * 12.92 : 1.055 * std::pow(x, 1.0 / 2.4) - 0.055;
+        out[i] = static_cast<uint8_t>(c * 255.0 + 0.5);
+    }
+    return RGBColor(out[0], out[1], out[2]);
+}
+
+static double okLabDistance(const FloatLab& a, const FloatLab& b) {
+    return std::sqrt((a.L - b.L) * (a.L - b.L) + (a.a - b.a) * (a.a - b.a) + (a.b - b.b) * (a.b - b.b));
+}
+
+// Größter sichtbarer Sprung zwischen zwei Frames einer Überblendung mit steps Schritten
+template <typename Mix>
+static double maxStep(int steps, Mix mix) {
+    double worst = 0;
+    FloatLab previous = mix(0.0);
+    for (int i = 1; i <= steps; i++) {
+        FloatLab current = mix(static_cast<double>(i) / steps);
+        worst = std::max(worst, okLabDistance(previous, current));
+        previous = current;
+    }
+    return worst;
+}
+
+// Übergänge: OKLab-Festkomma gegen Float, Frames pro Überblendung OKLab vs. sRGB
+void transitionBenchmark() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Benchmark: Uebergaenge (OKLab)" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    // Genauigkeit: Hin- und Rückweg gegen Double, jede 3. Stufe pro Kanal
+    int maxRoundTrip = 0, maxVsFloat = 0;
+    for (int r = 0; r < 256; r += 3) {
+        for (int g = 0; g < 256; g += 3) {
+            for (int b = 0; b < 256; b += 3) {
+                RGBColor color(r, g, b);
+                RGBColor back = Color::fromOkLab(Color::toOkLab(color));
+                maxRoundTrip = std::max({ maxRoundTrip, std::abs(back.r - r), std::abs(back.g - g), std::abs(back.b - b) });
+                
+                // Mischung mit einer festen Gegenfarbe bei 1/3
+                RGBColor fixed = Color::mixOkLab(color, RGBColor(255, 40, 0), Color::MIX_ONE / 3);
+                FloatLab from = floatToOkLab(color), to = floatToOkLab(RGBColor(255, 40, 0));
+                double t = (Color::MIX_ONE / 3) / static_cast<double>(Color::MIX_ONE);
+                RGBColor reference = floatFromOkLab(FloatLab{ from.L + (to.L - from.L) * t, from.a + (to.a - from.a) * t,
+                                                              from.b + (to.b - from.b) * t });
+                maxVsFloat = std::max({ maxVsFloat, std::abs(fixed.r - reference.r), std::abs(fixed.g - reference.g),
+                                        std::abs(fixed.b - reference.b) });
+            }
+        }
+    }
+    logEvent("[BENCH] OKLab Festkomma: Hin-/Rueckweg max. " + std::to_string(maxRoundTrip) +
+             " Stufe(n), Mischung vs. Double max. " + std::to_string(maxVsFloat) + " Stufe(n)");
+    
+    // Durchsatz (pro Zonen-Farbe)
+    const size_t count = 4096;
+    const int rounds = 200;
+    std::vector<RGBColor> colors(count);
+    for (size_t i = 0; i < count; i++) {
+        colors[i] = RGBColor(static_cast<uint8_t>(i * 7), static_cast<uint8_t>(i * 13), static_cast<uint8_t>(i * 29));
+    }
+    std::vector<Color::OkLab> labs(count);
+    std::vector<FloatLab> floatLabs(count);
+    volatile int sink = 0;
+    
+    double floatTo = benchmarkNsPerFrame(count, rounds, [&](int) {
+        for (size_t i = 0; i < count; i++) floatLabs[i] = floatToOkLab(colors[i]);
+        sink = sink + static_cast<int>(floatLabs[count - 1].L * 1000);
+    });
+    double tableTo = benchmarkNsPerFrame(count, rounds, [&](int) {
+        for (size_t i = 0; i < count; i++) labs[i] = Color::toOkLab(colors[i]);
+        sink = sink + labs[count - 1].L;
+    });
+    printBenchmark("sRGB -> OKLab", floatTo, tableTo);
+    
+    double floatFrom = benchmarkNsPerFrame(count, rounds, [&](int) {
+        for (size_t i = 0; i < count; i++) colors[i] = floatFromOkLab(floatLabs[i]);
+        sink = sink + colors[count - 1].g;
+    });
+    double tableFrom = benchmarkNsPerFrame(count, rounds, [&](int) {
+        for (size_t i = 0; i < count; i++) colors[i] = Color::fromOkLab(labs[i]);
+        sink = sink + colors[count - 1].g;
+    });
+    printBenchmark("OKLab -> sRGB", floatFrom, tableFrom);
+    
+    // Überblendung zwischen zwei festen Zuständen (Endpunkte einmal umgerechnet)
+    TransitionEffect fade(LEDZones(RGBColor(0, 155, 222)), LEDZones(RGBColor(255, 60, 0)), 1000.0, Color::Easing::EaseInOut);
+    double fadeNs = effectNsPerFrame(fade, 200000, 0.005);
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << "[BENCH] Umrechnungen: " << 1000.0 / tableTo << " Mio./s hin, " << 1000.0 / tableFrom
+       << " Mio./s zurueck; Ueberblendung " << std::setprecision(2) << fadeNs << "ns/Frame (3 Zonen)";
+    logEvent(ss.str());
+    
+    // Frames, bis kein Schritt mehr als etwa eine gerade sichtbare Stufe ist.
+    // Ungerundet gerechnet: die 8-Bit-Stufen nahe Schwarz (0 -> 1 sind schon
+    // ~0.07) begrenzen beide Verfahren gleich und verdecken den Unterschied.
+    const double visibleStep = 0.02;    // OKLab-Abstand
+    struct Pair {
+        const char* name;
+        RGBColor from;
+        RGBColor to;
+    };
+    const Pair pairs[] = {
+        { "Schwarz -> Weiss", RGBColor(0, 0, 0), RGBColor(255, 255, 255) },
+        { "Schwarz -> Corsair-Blau", RGBColor(0, 0, 0), RGBColor(0, 155, 222) },
+        { "Blau -> Gelb", RGBColor(0, 0, 255), RGBColor(255, 255, 0) },
+        { "Rot -> Cyan", RGBColor(255, 0, 0), RGBColor(0, 255, 255) },
+        { "Corsair-Blau -> Rot", RGBColor(0, 155, 222), RGBColor(255, 0, 0) },
+    };
+    logEvent("[BENCH] Frames pro Ueberblendung ohne sichtbaren Sprung (Schritt <= 0.02 OKLab, linear):");
+    const int maxSteps = 1000;
+    int totalSrgb = 0, totalOkLab = 0;
+    for (const Pair& pair : pairs) {
+        auto srgbMix = [&](double t) {
+            auto channel = [&](uint8_t a, uint8_t b) { return (a + (b - a) * t) / 255.0; };
+            return floatToOkLab(channel(pair.from.r, pair.to.r), channel(pair.from.g, pair.to.g), channel(pair.from.b, pair.to.b));
+        };
+        FloatLab from = floatToOkLab(pair.from), to = floatToOkLab(pair.to);
+        auto okLabMix = [&](double t) {
+            return FloatLab{ from.L + (to.L - from.L) * t, from.a + (to.a - from.a) * t, from.b + (to.b - from.b) * t };
+        };
+        int srgbSteps = 1, okLabSteps = 1;
+        while (srgbSteps < maxSteps && maxStep(srgbSteps, srgbMix) > visibleStep) srgbSteps++;
+        while (okLabSteps < maxSteps && maxStep(okLabSteps, okLabMix) > visibleStep) okLabSteps++;
+        totalSrgb += srgbSteps;
+        totalOkLab += okLabSteps;
+        
+        ss.str("");
+        ss << "  " << std::left << std::setw(26) << pair.name << std::right
+           << " sRGB " << std::setw(5) << (srgbSteps >= maxSteps ? ">" + std::to_string(maxSteps) : std::to_string(srgbSteps))
+           << "  OKLab " << std::setw(5) << okLabSteps;
+        logEvent(ss.str());
+    }
+    ss.str("");
+    ss << std::fixed << std::setprecision(0) << "[BENCH] Pakete gesamt: sRGB mind. " << totalSrgb << ", OKLab " << totalOkLab
+       << " (" << 100.0 - 100.0 * totalOkLab / totalSrgb << "% weniger)";
+    logEvent(ss.str());
+}
+
+// Dithering: zeitlich gemittelte Geräteausgabe (Farbwert x Hardware-Helligkeit) gegen das Ziel
+void ditherSimulation() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Simulation: Dithering (Helligkeit + Fehlerdiffusion)" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    auto device = std::make_shared<SimulatedDevice>();
+    RGBController rgb;
+    rgb.connect(device, true);
+    rgb.initialize();
+    
+    // Mitschnitt: Lichtmenge pro Kanal = Farbwert * Hardware-Helligkeit, relativ zur eingestellten
+    struct Output {
+        int brightness;
+        int userBrightness;
+        double sum[9];
+        uint64_t frames;
+        uint64_t brightnessPackets;
+        LEDZones last;
+    } output = {};
+    output.brightness = 1000;
+    output.userBrightness = 1000;
+    device->setWriteObserver([&](const unsigned char* data, size_t size) {
+        if (size < 17) return;
+        if (data[2] == 0x01 && data[3] == 0x02) {
+            output.brightness = data[5] | (data[6] << 8);
+            output.brightnessPackets++;
+        } else if (data[2] == 0x06) {
+            // Paket: R(Logo, Power, Mic), G(...), B(...) -> Kanal-Reihenfolge wie HighResZones
+            for (int zone = 0; zone < 3; zone++) {
+                for (int c = 0; c < 3; c++) {
+                    output.sum[zone * 3 + c] += data[8 + c * 3 + zone] * static_cast<double>(output.brightness) / output.userBrightness;
+                }
+            }
+            output.last.logo = RGBColor(data[8], data[11], data[14]);
+            output.last.power = RGBColor(data[9], data[12], data[15]);
+            output.last.mic = RGBColor(data[10], data[13], data[16]);
+            output.frames++;
+        }
+    });
+    auto resetOutput = [&]() {
+        memset(output.sum, 0, sizeof(output.sum));
+        output.frames = 0;
+        output.brightnessPackets = 0;
+    };
+    
+    // Feste Zielwerte in 8-Bit-Stufen: Mittel über 256 Frames nach dem Einschwingen
+    const double targets[] = { 0.1, 0.25, 0.5, 1.3, 2.7, 5.5, 12.25, 100.6 };
+    const int userBrightness[] = { 1000, 500 };
+    int failures = 0;
+    for (int user : userBrightness) {
+        rgb.setBrightnessRaw(user);
+        output.userBrightness = user;
+        logEvent("[DITHER] Eingestellte Helligkeit " + std::to_string(user / 10) + "%:");
+        for (double target : targets) {
+            HighResZones zones;
+            uint16_t value = static_cast<uint16_t>(target * 256 + 0.5);
+            for (int i = 0; i < 9; i++) zones.channel[i] = value;
+            
+            for (int i = 0; i < 32; i++) rgb.setColorsHighRes(zones);     // Helligkeit absenken (holdFrames)
+            resetOutput();
+            for (int i = 0; i < 256; i++) rgb.setColorsHighRes(zones);
+            
+            double exact = value / 256.0;
+            double mean = output.sum[0] / output.frames;
+            double worst = 0;
+            for (int i = 0; i < 9; i++) worst = std::max(worst, std::abs(output.sum[i] / output.frames - exact));
+            double rounded = std::min(255.0, std::floor(exact + 0.5));
+            bool ok = worst <= 0.02;
+            if (!ok) failures++;
+            
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(3)
+               << "  Ziel " << std::setw(8) << exact << "  Mittel " << std::setw(8) << mean
+               << "  Fehler " << std::setw(6) << worst << " (8 Bit: " << std::setw(6) << std::abs(rounded - exact) << ")"
+               << "  Hardware " << std::setw(4) << output.brightness << "  " << (ok ? "OK" : "ABWEICHUNG");
+            logEvent(ss.str());
+        }
+    }
+    rgb.setBrightnessRaw(1000);
+    output.userBrightness = 1000;
+    
+    // Fade nahe Schwarz: 0 -> 25% (wahrnehmungs-linear), 4s bei 20ms
+    FadeEffect fade(RGBColor(0, 155, 222), 0.0, 0.25, 4000.0);
+    const int fadeFrames = 200;
+    const int window = 8;
+    std::vector<double> targetBlue(fadeFrames), ditheredBlue(fadeFrames), roundedBlue(fadeFrames);
+    resetOutput();
+    FrameContext frame = {};
+    frame.frameIntervalMs = 20.0;
+    for (int i = 0; i < fadeFrames; i++) {
+        frame.frameIndex = i;
+        frame.timeMs = i * 20.0;
+        HighResZones zones;
+        fade.renderHighRes(frame, zones);
+        double before = output.sum[2];
+        rgb.setColorsHighRes(zones);
+        targetBlue[i] = zones.channel[2] / 256.0;
+        ditheredBlue[i] = output.sum[2] - before;
+        roundedBlue[i] = std::min(255, (zones.channel[2] + 128) >> 8);
+    }
+    double worstDithered = 0, worstRounded = 0;
+    for (int i = 0; i + window <= fadeFrames; i++) {
+        double t = 0, d = 0, r = 0;
+        for (int k = i; k < i + window; k++) {
+            t += targetBlue[k];
+            d += ditheredBlue[k];
+            r += roundedBlue[k];
+        }
+        worstDithered = std::max(worstDithered, std::abs(d - t) / window);
+        worstRounded = std::max(worstRounded, std::abs(r - t) / window);
+    }
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3)
+       << "[DITHER] Fade 0 -> 25% (Blau bis " << targetBlue[fadeFrames - 1] << "): max. Abweichung im "
+       << window << "-Frame-Mittel " << worstDithered << " Stufen (8 Bit: " << worstRounded << "), "
+       << output.frames << " Farbpakete + " << output.brightnessPackets << " Helligkeitspakete";
+    logEvent(ss.str());
+    
+    // getColors() (Startwert von Übergängen) ist die sichtbare Farbe, nicht der hochskalierte Gerätewert
+    double lastBlue = targetBlue[fadeFrames - 1];
+    int hardware = output.brightness;
+    LEDZones visible = rgb.getColors();
+    ss.str("");
+    ss << std::fixed << std::setprecision(2)
+       << "[DITHER] getColors() bei Hardware " << hardware << ": Blau " << int(visible.power.b) << " (Ziel " << lastBlue
+       << ", Geraetewert " << int(output.last.power.b) << ")" << (std::abs(visible.power.b - lastBlue) <= 1.0 ? " (korrekt)" : " (FEHLER)");
+    logEvent(ss.str());
+    
+    // Einzelne Zone bei abgesenkter Hardware-Helligkeit: volle Farbe, die übrigen bleiben gleich hell
+    rgb.setLogoColor(RGBColor(255, 0, 0));
+    ss.str("");
+    ss << "[DITHER] setLogoColor() bei Hardware " << hardware << ": Logo " << zoneText(output.last.logo) << ", Power-Blau "
+       << int(output.last.power.b) << " bei Hardware " << output.brightness
+       << (output.last.logo.r == 255 && output.brightness == 1000 && std::abs(output.last.power.b - lastBlue) <= 1.0 ? " (korrekt)" : " (FEHLER)");
+    logEvent(ss.str());
+    
+    // Normales setColors() stellt die eingestellte Helligkeit wieder her
+    rgb.setColors(LEDZones(RGBColor(10, 10, 10)));
+    logEvent(std::string("[DITHER] Nach setColors(): Hardware-Helligkeit ") + std::to_string(output.brightness) +
+             (output.brightness == 1000 ? " (wiederhergestellt)" : " (FEHLER)"));
+    logEvent(failures == 0 ? "[DITHER] Alle Mittelwerte innerhalb 0.02 Stufen" :
+             "[DITHER] " + std::to_string(failures) + " Abweichung(en)!");
+    
+    device->setWriteObserver(nullptr);
+    rgb.disconnect();
+}
+
+// Globale Blenden: Farbpakete (bisheriger Puls) gegen Helligkeitspakete/FadePlanner
+void fadePlannerSimulation() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Simulation: Helligkeits-Blenden (Pakete pro Effekt-Sekunde)" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    auto device = std::make_shared<SimulatedDevice>();
+    RGBController rgb;
+    rgb.connect(device, true);
+    rgb.initialize();
+    
+    // Gerätezustand aus den Paketen: Ausgabe = Farbwert * Hardware-Helligkeit / eingestellte
+    struct Output {
+        unsigned char zones[9];
+        int brightness;
+        uint64_t colorPackets;
+        uint64_t brightnessPackets;
+    } output = {};
+    output.brightness = 1000;
+    device->setWriteObserver([&](const unsigned char* data, size_t size) {
+        if (size < 17) return;
+        if (data[2] == 0x01 && data[3] == 0x02) {
+            output.brightness = data[5] | (data[6] << 8);
+            output.brightnessPackets++;
+        } else if (data[2] == 0x06) {
+            for (int zone = 0; zone < 3; zone++) {
+                for (int c = 0; c < 3; c++) {
+                    output.zones[zone * 3 + c] = data[8 + c * 3 + zone];
+                }
+            }
+            output.colorPackets++;
+        }
+    });
+    
+    struct Scenario {
+        const char* name;
+        RGBColor color;
+        int periodMs;
+        int stepMs;
+        int userBrightness;
+    };
+    const Scenario scenarios[] = {
+        { "Puls Rot, 1.8s / 50ms (wie pulse())", RGBColor(255, 0, 0), 1800, 50, 1000 },
+        { "Puls Orange, 1.8s / 50ms", RGBColor(255, 128, 0), 1800, 50, 1000 },
+        { "Puls Weiss, 1.8s / 20ms", RGBColor(255, 255, 255), 1800, 20, 1000 },
+        { "Atmen Blau, 6s / 20ms", RGBColor(0, 155, 222), 6000, 20, 1000 },
+        { "Atmen Rot, 6s / 10ms", RGBColor(255, 0, 0), 6000, 10, 1000 },
+        { "Atmen Rot, 6s / 10ms, Helligkeit 15%", RGBColor(255, 0, 0), 6000, 10, 150 },
+    };
+    const int cycles = 2;
+    
+    // -1 = bisheriger Puls über setColors(), sonst FadeMode
+    const int modes[] = { -1, static_cast<int>(FadeMode::Color), static_cast<int>(FadeMode::Brightness), static_cast<int>(FadeMode::Auto) };
+    const char* modeNames[] = { "vorher (Farbpakete)", "Color", "Brightness", "Auto" };
+    
+    for (const Scenario& scenario : scenarios) {
+        logEvent(std::string("[FADE] ") + scenario.name + ":");
+        rgb.setBrightnessRaw(scenario.userBrightness);
+        int frameCount = cycles * scenario.periodMs / scenario.stepMs;
+        double effectSeconds = cycles * scenario.periodMs / 1000.0;
+        
+        for (int m = 0; m < 4; m++) {
+            PulseEffect pulse(scenario.color, scenario.periodMs, cycles);
+            if (modes[m] >= 0) {
+                FadePlanConfig config;
+                config.mode = static_cast<FadeMode>(modes[m]);
+                rgb.setFadePlanConfig(config);
+                rgb.resetFadePlanStats();
+            }
+            rgb.setColors(LEDZones(RGBColor(0, 0, 0)));
+            output.colorPackets = 0;
+            output.brightnessPackets = 0;
+            
+            double worst = 0, total = 0;
+            FrameContext frame = {};
+            frame.frameIntervalMs = scenario.stepMs;
+            for (int i = 0; i < frameCount; i++) {
+                frame.frameIndex = i;
+                frame.timeMs = i * static_cast<double>(scenario.stepMs);
+                LEDZones base, zones;
+                uint32_t level = 0;
+                pulse.renderLevel(frame, base, level);
+                if (modes[m] < 0) {
+                    pulse.render(frame, zones);
+                    rgb.setColors(zones);
+                } else {
+                    rgb.setColorsLevel(base, level);
+                }
+                
+                // Abweichung von der exakten Kurve (8-Bit-Stufen)
+                const unsigned char* baseValues = reinterpret_cast<const unsigned char*>(&base);
+                double frameError = 0;
+                for (int c = 0; c < 9; c++) {
+                    double target = baseValues[c] * static_cast<double>(level) / LEVEL_ONE;
+                    double shown = output.zones[c] * static_cast<double>(output.brightness) / scenario.userBrightness;
+                    frameError = std::max(frameError, std::abs(shown - target));
+                }
+                worst = std::max(worst, frameError);
+                total += frameError;
+            }
+            
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(1)
+               << "  " << std::left << std::setw(20) << modeNames[m] << std::right
+               << std::setw(6) << (output.colorPackets + output.brightnessPackets) / effectSeconds << " Pakete/s ("
+               << output.colorPackets << " Farbe + " << output.brightnessPackets << " Helligkeit)"
+               << std::setprecision(3) << "  max. Fehler " << worst << "  Ø " << total / frameCount;
+            logEvent(ss.str());
+        }
+    }
+    
+    // Über den Animation-Thread: startPulse() im Modus Auto, danach setColors()
+    rgb.setBrightnessRaw(1000);
+    rgb.setFadePlanConfig(FadePlanConfig());
+    rgb.resetFadePlanStats();
+    output.colorPackets = 0;
+    output.brightnessPackets = 0;
+    rgb.pulse(RGBColor(0, 155, 222), 1, 10);
+    FadePlanStats stats = rgb.getFadePlanStats();
+    logEvent("[FADE] pulse() im Modus Auto: " + std::to_string(stats.frames) + " Frames, " +
+             std::to_string(output.colorPackets) + " Farb- + " + std::to_string(output.brightnessPackets) +
+             " Helligkeitspakete, " + std::to_string(stats.skippedFrames) + " ohne Report");
+    
+    // Mic stumm (Override Rot) während pulse() im Standardmodus: die Mic-LED
+    // darf nicht mitpulsieren, also keine abgesenkte Hardware-Helligkeit
+    rgb.setColors(LEDZones(RGBColor(0, 0, 0)));
+    rgb.setMicOverride(RGBColor(255, 0, 0));
+    int dimmedPackets = 0;
+    double darkestMic = 255;
+    device->setWriteObserver([&](const unsigned char* data, size_t size) {
+        if (size < 17) return;
+        if (data[2] == 0x01 && data[3] == 0x02) {
+            output.brightness = data[5] | (data[6] << 8);
+            if (output.brightness < 1000) dimmedPackets++;
+        } else if (data[2] == 0x06) {
+            double mic = data[8 + 2] * output.brightness / 1000.0;
+            darkestMic = std::min(darkestMic, mic);
+        }
+    });
+    rgb.pulse(RGBColor(0, 155, 222), 1, 10);
+    device->setWriteObserver(nullptr);
+    rgb.clearMicOverride();
+    logEvent("[FADE] pulse() bei stummem Mic: Mic-Rot min. " + std::to_string(static_cast<int>(darkestMic)) +
+             ", " + std::to_string(dimmedPackets) + " abgesenkte Helligkeitspakete" +
+             (darkestMic == 255 && dimmedPackets == 0 ? " (korrekt)" : " (FEHLER: Mic-LED pulsiert mit)"));
+    
+    device->setWriteObserver([&](const unsigned char* data, size_t size) {
+        if (size >= 17 && data[2] == 0x01 && data[3] == 0x02) output.brightness = data[5] | (data[6] << 8);
+    });
+    rgb.setColors(LEDZones(RGBColor(10, 10, 10)));
+    logEvent(std::string("[FADE] Nach setColors(): Hardware-Helligkeit ") + std::to_string(output.brightness) +
+             (output.brightness == 1000 ? " (wiederhergestellt)" : " (FEHLER)"));
+    
+    device->setWriteObserver(nullptr);
+    rgb.disconnect();
+}
+
+// Kalibrierung: Genauigkeit der Tabellen, Kosten im Sendepfad, Profile pro Gerät
+static double calibrationReference(const ZoneCalibration& calibration, int out, const unsigned char* in) {
+    double x = 0;
+    for (int c = 0; c < 3; c++) {
+        x += calibration.matrix[out][c] * in[c] / 255.0;
+    }
+    x = std::max(0.0, std::min(1.0, x));
+    return std::min(255.0, calibration.gain[out] * std::pow(x, static_cast<double>(calibration.gamma[out])) * 255.0);
+}
+
+void calibrationBenchmark() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Benchmark: Kalibrierung (Tabellen im Sendepfad)" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    const char* text =
+        "logo  matrix 1 0 0  0 0.94 0.02  0 0.03 0.82\n"
+        "power gain 1 0.9 0.95\n"
+        "mic   matrix 0.97 0.05 0  0 1 0  0 0 0.9\n"
+        "mic   gamma 1 1.05 0.9\n";
+    CalibrationProfile profile;
+    std::string error;
+    std::istringstream input(text);
+    if (!profile.parse(input, error)) {
+        logEvent("[CALIB] " + error);
+        return;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    CalibrationTables tables(profile);
+    double compileUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    CalibrationTables identity((CalibrationProfile()));
+    
+    // Genauigkeit gegen Gleitkomma, Identität muss exakt sein
+    uint32_t seed = 12345;
+    auto next = [&]() { seed = seed * 1664525u + 1013904223u; return static_cast<unsigned char>(seed >> 24); };
+    double worst = 0;
+    int identityErrors = 0;
+    const int samples = 200000;
+    for (int i = 0; i < samples; i++) {
+        unsigned char rgb[9], calibrated[9], same[9];
+        for (int c = 0; c < 9; c++) rgb[c] = next();
+        memcpy(calibrated, rgb, 9);
+        memcpy(same, rgb, 9);
+        tables.apply(calibrated);
+        identity.apply(same);
+        if (memcmp(same, rgb, 9) != 0) identityErrors++;
+        for (int zone = 0; zone < 3; zone++) {
+            const unsigned char in[3] = { rgb[zone], rgb[3 + zone], rgb[6 + zone] };
+            for (int out = 0; out < 3; out++) {
+                double reference = calibrationReference(profile.zones[zone], out, in);
+                worst = std::max(worst, std::abs(calibrated[out * 3 + zone] - reference));
+            }
+        }
+    }
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3)
+       << "[CALIB] Tabellen gebaut in " << compileUs << " us (" << sizeof(CalibrationTables) / 1024 << " KB), "
+       << "max. Abweichung zu Float " << worst << " Stufen, Identitaet: "
+       << (identityErrors == 0 ? "exakt" : std::to_string(identityErrors) + " Fehler");
+    logEvent(ss.str());
+    
+    // Kosten: apply() allein und setColors() über das simulierte Gerät
+    const size_t frames = 4096;
+    std::vector<unsigned char> packets(frames * 9);
+    for (auto& value : packets) value = next();
+    volatile unsigned char sink = 0;
+    double applyNs = benchmarkNsPerFrame(frames, 200, [&](int) {
+        for (size_t f = 0; f < frames; f++) {
+            tables.apply(&packets[f * 9]);
+        }
+        sink = sink + packets[0];
+    });
+    
+    auto device = std::make_shared<SimulatedDevice>();
+    RGBController rgb;
+    rgb.connect(device, true, "SIM-A");
+    rgb.initialize();
+    std::vector<LEDZones> zones(frames);
+    memcpy(zones.data(), packets.data(), packets.size());
+    auto sendAll = [&](int) {
+        for (size_t f = 0; f < frames; f++) {
+            rgb.setColors(zones[f]);
+        }
+    };
+    rgb.setCalibration(CalibrationProfile());
+    double plainNs = benchmarkNsPerFrame(frames, 20, sendAll);
+    rgb.setCalibration(profile);
+    double calibratedNs = benchmarkNsPerFrame(frames, 20, sendAll);
+    
+    ss.str("");
+    ss << std::fixed << std::setprecision(1)
+       << "[CALIB] apply(): " << applyNs << " ns/Paket | setColors() " << plainNs << " ns -> " << calibratedNs
+       << " ns mit Kalibrierung (Budget bei 120 fps: 8333333 ns, Anteil "
+       << std::setprecision(5) << (calibratedNs - plainNs) / 8333333.0 * 100.0 << "%)";
+    logEvent(ss.str());
+    
+    // Dithering senkt die Hardware-Helligkeit und skaliert die Farbwerte hoch:
+    // die Kurve muss auf den sichtbaren Wert wirken, nicht auf den Gerätewert
+    {
+        CalibrationProfile curved;
+        std::istringstream curvedInput("all gamma 1.5 1.5 1.5\n");
+        curved.parse(curvedInput, error);
+        auto ditherDevice = std::make_shared<SimulatedDevice>();
+        RGBController dithered;
+        dithered.connect(ditherDevice, true);
+        dithered.initialize();
+        dithered.setCalibration(curved);
+        
+        int brightness = 1000;
+        double visibleSum = 0;
+        int visibleFrames = 0;
+        ditherDevice->setWriteObserver([&](const unsigned char* data, size_t size) {
+            if (size < 17) return;
+            if (data[2] == 0x01 && data[3] == 0x02) {
+                brightness = data[5] | (data[6] << 8);
+            } else if (data[2] == 0x06) {
+                visibleSum += data[8] * brightness / 1000.0;
+                visibleFrames++;
+            }
+        });
+        HighResZones zones;
+        for (int i = 0; i < 9; i++) zones.channel[i] = static_cast<uint16_t>(10.4 * 256 + 0.5);
+        for (int i = 0; i < 32; i++) dithered.setColorsHighRes(zones);   // Helligkeit absenken
+        visibleSum = 0;
+        visibleFrames = 0;
+        for (int i = 0; i < 256; i++) dithered.setColorsHighRes(zones);
+        ditherDevice->setWriteObserver(nullptr);
+        
+        double target = zones.channel[0] / 256.0;
+        double reference = 255.0 * std::pow(target / 255.0, 1.5);
+        double mean = visibleSum / visibleFrames;
+        ss.str("");
+        ss << std::fixed << std::setprecision(2)
+           << "[CALIB] gamma 1.5 bei Dithering (Hardware " << brightness << "): Ziel " << target
+           << " -> sichtbar " << mean << " (Soll " << reference << ")"
+           << (std::abs(mean - reference) <= 0.25 ? " (korrekt)" : " (FEHLER: Kurve auf Geraetewert)");
+        logEvent(ss.str());
+        dithered.disconnect();
+    }
+    
+    // Profile pro Gerät: speichern für SIM-A, SIM-B hat keins, SIM-A lädt es wieder
+    const char* directory = "HS80_Bench_Calib";
+    bool saved = rgb.saveCalibration(profile, directory, error);
+    
+    RGBController other;
+    other.connect(std::make_shared<SimulatedDevice>(), true, "SIM-B");
+    std::string otherError;
+    bool otherLoaded = other.loadCalibration(directory, otherError);
+    
+    RGBController again;
+    auto againDevice = std::make_shared<SimulatedDevice>();
+    againDevice->setRecordWrites(true);
+    again.connect(againDevice, true, "SIM-A");
+    bool againLoaded = again.loadCalibration(directory, error);
+    again.setColors(LEDZones(RGBColor(200, 200, 200)));
+    std::vector<unsigned char> packetAgain = againDevice->writtenReports().back();
+    
+    logEvent(std::string("[CALIB] Profil pro Geraet: gespeichert ") + (saved ? "ja" : "NEIN (" + error + ")") +
+             ", SIM-B geladen: " + (otherLoaded ? "ja (FEHLER)" : "nein (korrekt)") +
+             ", SIM-A erneut: " + (againLoaded ? "ja" : "NEIN") +
+             ", Logo weiss 200 -> " + std::to_string(packetAgain[8]) + "/" + std::to_string(packetAgain[11]) + "/" + std::to_string(packetAgain[14]));
+    
+    DeleteFileA(CalibrationProfile::pathFor(directory, "SIM-A").c_str());
+    RemoveDirectoryA(directory);
+    rgb.disconnect();
+    other.disconnect();
+    again.disconnect();
+}
+
+// Zähler-Effekt: Logo-Rot = Effekt-Zeit / 20ms, G = 50 markiert den Grundzustand
+class NotificationProbeEffect : public Effect {
+public:
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override {
+        zones.logo = RGBColor(static_cast<uint8_t>(static_cast<uint64_t>(frame.timeMs / 20.0) & 0xFF), 50, 50);
+        zones.power = RGBColor(0, 0, 200);
+        zones.mic = RGBColor(0, 200, 0);
+        return EffectStatus::Running;
+    }
+};
+
+void notificationSimulation() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Simulation: Benachrichtigungen (Vorrang, Wiederherstellung)" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    auto device = std::make_shared<SimulatedDevice>();
+    RGBController rgb;
+    rgb.connect(device, true);
+    rgb.initialize();
+    
+    // Jedes Paket mit Zeitstempel (Notification- und Animation-Thread schreiben)
+    struct Packet {
+        double timeMs;
+        unsigned char zones[9];     // Logo RGB, Power RGB, Mic RGB
+        int brightness;
+    };
+    std::vector<Packet> packets;
+    int brightness = 1000;
+    CRITICAL_SECTION packetsLock;
+    InitializeCriticalSection(&packetsLock);
+    auto origin = std::chrono::steady_clock::now();
+    device->setWriteObserver([&](const unsigned char* data, size_t size) {
+        if (size < 17) return;
+        EnterCriticalSection(&packetsLock);
+        if (data[2] == 0x01 && data[3] == 0x02) {
+            brightness = data[5] | (data[6] << 8);
+        } else if (data[2] == 0x06) {
+            Packet packet;
+            packet.timeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - origin).count();
+            for (int zone = 0; zone < 3; zone++) {
+                for (int c = 0; c < 3; c++) {
+                    packet.zones[zone * 3 + c] = data[8 + c * 3 + zone];
+                }
+            }
+            packet.brightness = brightness;
+            packets.push_back(packet);
+        }
+        LeaveCriticalSection(&packetsLock);
+    });
+    auto lastPacket = [&]() {
+        EnterCriticalSection(&packetsLock);
+        Packet packet = packets.back();
+        packet.brightness = brightness;     // Gerätezustand, auch nach einem späteren Helligkeitspaket
+        LeaveCriticalSection(&packetsLock);
+        return packet;
+    };
+    auto postTimed = [&](const Notification& notification) {
+        auto start = std::chrono::steady_clock::now();
+        rgb.notify(notification);
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    };
+    std::stringstream ss;
+    
+    // 1. Statische Farben: Anruf blinkt 3x, danach wieder Blau
+    rgb.setColors(LEDZones(RGBColor(0, 0, 200)));
+    EnterCriticalSection(&packetsLock);
+    packets.clear();
+    LeaveCriticalSection(&packetsLock);
+    double postUs = postTimed(Notification("call", RGBColor(255, 0, 0), NotificationPattern::Blink, 200, 3, 5));
+    Sleep(800);
+    Packet restored = lastPacket();
+    bool blueAgain = true;
+    for (int i = 0; i < 9; i++) {
+        blueAgain = blueAgain && restored.zones[i] == (i % 3 == 2 ? 200 : 0);
+    }
+    NotificationStats stats = rgb.notifications().getStats();
+    ss << std::fixed << std::setprecision(1)
+       << "[NOTIFY] Statisch: post() " << postUs << " us, " << packets.size() << " Pakete fuer 3x Blinken, "
+       << "danach " << (blueAgain ? "wieder Blau (korrekt)" : "NICHT Blau (FEHLER)")
+       << ", beendet: " << stats.completed;
+    logEvent(ss.str());
+    
+    // 2. Laufender Effekt: Akku (Power, Puls) wird vom Anruf (alle Zonen) verdrängt
+    rgb.notifications().resetStats();
+    const int stepMs = 20;
+    rgb.startEffect(std::make_shared<NotificationProbeEffect>(), stepMs);
+    Sleep(200);
+    EnterCriticalSection(&packetsLock);
+    packets.clear();
+    LeaveCriticalSection(&packetsLock);
+    auto effectStart = std::chrono::steady_clock::now() - std::chrono::milliseconds(200);
+    double batteryUs = postTimed(Notification("battery", RGBColor(255, 140, 0), NotificationPattern::Pulse, 300, 2, 1, ZONE_MASK_POWER));
+    Sleep(100);
+    double callUs = postTimed(Notification("call", RGBColor(255, 0, 0), NotificationPattern::Blink, 200, 2, 5));
+    Sleep(1100);
+    double effectMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - effectStart).count();
+    
+    // Phasen aus den Paketen: Logo-G != 50 = Anruf, sonst Power != Blau = Akku
+    std::string phases;
+    std::string previous;
+    double batteryEndMs = 0;
+    int lastCounter = -1;
+    bool counterRestarted = false;
+    EnterCriticalSection(&packetsLock);
+    double firstMs = packets.empty() ? 0 : packets.front().timeMs;
+    for (const Packet& packet : packets) {
+        std::string phase;
+        if (packet.zones[1] != 50) {
+            phase = "Anruf";
+        } else if (packet.zones[3] != 0 || packet.zones[4] != 0 || packet.zones[5] != 200) {
+            phase = "Akku";
+            batteryEndMs = packet.timeMs - firstMs;
+        } else {
+            phase = "Effekt";
+        }
+        if (phase != "Anruf") {
+            // Zähler darf nur weiterlaufen (8 Bit, Überlauf erlaubt), nie neu starten
+            int counter = packet.zones[0];
+            if (lastCounter >= 0 && ((counter - lastCounter) & 0xFF) > 64) {
+                counterRestarted = true;
+            }
+            lastCounter = counter;
+        }
+        if (phase != previous) {
+            phases += (phases.empty() ? "" : " -> ") + phase;
+            previous = phase;
+        }
+    }
+    LeaveCriticalSection(&packetsLock);
+    int expectedCounter = static_cast<int>(effectMs / stepMs) & 0xFF;
+    stats = rgb.notifications().getStats();
+    rgb.stopEffect();
+    rgb.waitEffect(1000);
+    
+    ss.str("");
+    ss << std::fixed << std::setprecision(1)
+       << "[NOTIFY] Effekt: " << phases << " | post() " << batteryUs << " / " << callUs << " us, verdraengt: "
+       << stats.preempted << ", Akku-Ende nach " << batteryEndMs << " ms (Soll ~1000: 600 sichtbar + 400 Anruf)";
+    logEvent(ss.str());
+    ss.str("");
+    ss << "[NOTIFY] Effekt-Zustand: Zaehler am Ende " << lastCounter << ", Soll ~" << expectedCounter
+       << (counterRestarted ? " - NEU GESTARTET (FEHLER)" : " - lief durch (korrekt)");
+    logEvent(ss.str());
+    
+    // 3. Zusammenfassen: 1000x dieselbe Art, 4 Threads gleichzeitig
+    rgb.notifications().resetStats();
+    const int postsPerThread = 250;
+    std::vector<double> latencies(4 * postsPerThread);
+    std::vector<std::thread> posters;
+    for (int t = 0; t < 4; t++) {
+        posters.emplace_back([&, t]() {
+            for (int i = 0; i < postsPerThread; i++) {
+                latencies[t * postsPerThread + i] = postTimed(Notification("message", RGBColor(0, 255, 0), NotificationPattern::Solid, 100, 1, 2, ZONE_MASK_MIC));
+            }
+        });
+    }
+    for (auto& poster : posters) {
+        poster.join();
+    }
+    size_t pending = rgb.notifications().pending();
+    std::sort(latencies.begin(), latencies.end());
+    Sleep(250);
+    stats = rgb.notifications().getStats();
+    ss.str("");
+    ss << std::fixed << std::setprecision(1)
+       << "[NOTIFY] 1000x 'message': " << pending << " Eintrag, zusammengefasst " << stats.coalesced
+       << ", post() p50 " << latencies[latencies.size() / 2] << " us / p99 " << latencies[latencies.size() * 99 / 100]
+       << " us, Pakete " << stats.frames;
+    logEvent(ss.str());
+    
+    // 4. Abgesenkte Hardware-Helligkeit (Blende auf 25%): Hinweis in voller Helligkeit, danach wieder 25%
+    FadePlanConfig fadeConfig = rgb.getFadePlanConfig();
+    FadePlanConfig brightnessOnly = fadeConfig;
+    brightnessOnly.mode = FadeMode::Brightness;
+    rgb.setFadePlanConfig(brightnessOnly);
+    rgb.setColorsLevel(LEDZones(RGBColor(200, 200, 200)), LEVEL_ONE / 4);
+    rgb.setFadePlanConfig(fadeConfig);
+    Packet dimmed = lastPacket();
+    rgb.notify(Notification("alarm", RGBColor(255, 255, 255), NotificationPattern::Solid, 150, 1, 9, ZONE_MASK_LOGO));
+    Sleep(60);
+    Packet during = lastPacket();
+    Sleep(200);
+    Packet after = lastPacket();
+    auto visible = [](const Packet& packet, int index) { return packet.zones[index] * packet.brightness / 1000.0; };
+    ss.str("");
+    ss << std::fixed << std::setprecision(1)
+       << "[NOTIFY] Blende 25%: vorher Power " << visible(dimmed, 3) << " (HW " << dimmed.brightness << ")"
+       << ", Hinweis Logo " << visible(during, 0) << " (HW " << during.brightness << ")"
+       << ", danach Power " << visible(after, 3) << ", Logo " << visible(after, 0) << " (HW " << after.brightness << ")";
+    logEvent(ss.str());
+    
+    // 5. Hinweise gegen eine laufende Blende über die Helligkeit (2ms-Frames):
+    //    kein Helligkeitspaket unter 1000, solange der Hinweis sichtbar ist
+    std::atomic<bool> overlayVisible(false);
+    std::atomic<int> dimmedDuring(0), overlayPackets(0);
+    device->setWriteObserver([&](const unsigned char* data, size_t size) {
+        if (size < 17) return;
+        if (data[2] == 0x06) {
+            bool white = data[8] == 255 && data[11] == 255 && data[14] == 255;
+            overlayVisible = white;
+            if (white) overlayPackets++;
+        } else if (data[2] == 0x01 && data[3] == 0x02 && overlayVisible && (data[5] | (data[6] << 8)) < 1000) {
+            dimmedDuring++;
+        }
+    });
+    rgb.startEffect(std::make_shared<PulseEffect>(RGBColor(0, 0, 255), 300), 2);
+    for (int i = 0; i < 50; i++) {
+        rgb.notify(Notification("alarm", RGBColor(255, 255, 255), NotificationPattern::Solid, 20, 1, 9, ZONE_MASK_LOGO));
+        Sleep(30 + i % 7);
+    }
+    rgb.stopEffect();
+    rgb.waitEffect(1000);
+    ss.str("");
+    ss << "[NOTIFY] 50 Hinweise ueber Puls (Helligkeitspfad, 2ms): " << overlayPackets.load() << " Hinweis-Pakete, "
+       << "abgesenkt waehrend Hinweis: " << dimmedDuring.load() << (dimmedDuring.load() == 0 ? " (korrekt)" : " (FEHLER)");
+    logEvent(ss.str());
+    
+    device->setWriteObserver(nullptr);
+    DeleteCriticalSection(&packetsLock);
+    rgb.disconnect();
+}
+
+// Eine Stunde Regenbogen + Keep-Alive + Akku-Hinweis an der VirtualClock
+struct OfflineRenderResult {
+    uint64_t checksum;
+    size_t packets;
+    size_t keepAlive;       // Wiederholung des letzten Pakets im 5s-Raster
+    size_t notification;    // Power weicht vom Regenbogen ab (Akku-Hinweis)
+    double notificationFromMs;
+    double notificationToMs;
+    double realMs;
+    double virtualMs;
+};
+
+static bool renderOfflineHour(OfflineRenderResult& result, const std::string& dumpPath) {
+    const int stepMs = 33;
+    const double hourMs = 3600000.0;
+    auto start = std::chrono::steady_clock::now();
+    
+    OfflineRenderer renderer;
+    if (!renderer.open()) {
+        return false;
+    }
+    RGBController& rgb = renderer.rgb();
+    rgb.startRainbow(0, stepMs);
+    rgb.startKeepAlive(5000);
+    renderer.run(hourMs / 2);
+    rgb.notify(Notification("battery", RGBColor(255, 140, 0), NotificationPattern::Pulse, 1000, 5, 1, ZONE_MASK_POWER));
+    renderer.run(hourMs / 2);
+    rgb.stopKeepAlive();
+    rgb.stopEffect();
+    
+    result.realMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.virtualMs = renderer.elapsedMs();
+    result.checksum = renderer.checksum();
+    
+    std::vector<RenderedFrame> frames = renderer.frames();
+    result.packets = frames.size();
+    result.keepAlive = result.notification = 0;
+    result.notificationFromMs = result.notificationToMs = -1;
+    const RenderedFrame* previous = nullptr;
+    for (const RenderedFrame& frame : frames) {
+        if (frame.kind != 'C') continue;
+        if (previous && frame.timeNs % (5000 * Clock::NS_PER_MS) == 0 &&
+            memcmp(&frame.zones, &previous->zones, sizeof(LEDZones)) == 0) {
+            result.keepAlive++;
+        }
+        // Regenbogen: alle Zonen gleich, nur der Hinweis färbt Power anders
+        if (memcmp(&frame.zones.power, &frame.zones.logo, sizeof(RGBColor)) != 0) {
+            double timeMs = frame.timeNs / static_cast<double>(Clock::NS_PER_MS);
+            if (result.notification++ == 0) result.notificationFromMs = timeMs;
+            result.notificationToMs = timeMs;
+        }
+        previous = &frame;
+    }
+    
+    std::string error;
+    if (!dumpPath.empty() && !renderer.dump(dumpPath, error)) {
+        logEvent("[RENDER] " + error);
+    }
+    return true;
+}
+
+void offlineRenderSimulation() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Simulation: Virtuelle Zeit (Offline-Rendering)" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    OfflineRenderResult first, second;
+    if (!renderOfflineHour(first, "offline_render.txt") || !renderOfflineHour(second, "")) {
+        logEvent("[RENDER] Offline-Renderer konnte nicht geoeffnet werden");
+        return;
+    }
+    
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(0)
+       << "[RENDER] " << first.virtualMs / 60000.0 << " min virtuell in " << first.realMs << " ms ("
+       << first.virtualMs / first.realMs << "x Echtzeit), " << first.packets << " Pakete -> offline_render.txt";
+    logEvent(ss.str());
+    ss.str("");
+    ss << std::fixed << std::setprecision(0)
+       << "[RENDER] Keep-Alive-Wiederholungen: " << first.keepAlive << " (Soll " << static_cast<int>(first.virtualMs / 5000)
+       << "), Akku-Hinweis: " << first.notification << " Frames von " << first.notificationFromMs << " bis "
+       << first.notificationToMs << " ms (Soll 1800000 bis 1805000, 5x 1s Puls)";
+    logEvent(ss.str());
+    ss.str("");
+    ss << std::hex << std::setfill('0')
+       << "[RENDER] Pruefsumme Lauf 1 " << std::setw(16) << first.checksum << ", Lauf 2 " << std::setw(16) << second.checksum
+       << (first.checksum == second.checksum && first.packets == second.packets ? " - identisch (korrekt)" : " - ABWEICHUNG (FEHLER)");
+    logEvent(ss.str());
+}
+
+void pluginSimulation() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Simulation: Native Plugins (Hot-Swap, Budget)" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    // Beispiel-Plugin neben der exe bzw. im Build-Verzeichnis (build_library.bat / CMake)
+    std::string path;
+    std::string error;
+    std::shared_ptr<PluginModule> module;
+    for (const char* candidate : { "HS80_ExamplePlugin.dll", "HS80\\Debug\\HS80_ExamplePlugin.dll" }) {
+        module = PluginModule::load(candidate, error);
+        if (module) {
+            path = candidate;
+            break;
+        }
+    }
+    if (!module) {
+        logEvent("[PLUGIN] HS80_ExamplePlugin.dll nicht geladen: " + error);
+        return;
+    }
+    
+    auto device = std::make_shared<SimulatedDevice>();
+    RGBController rgb;
+    rgb.connect(device, true);
+    rgb.initialize();
+    
+    // Abstand aufeinanderfolgender Farbpakete (Lücken beim Tausch?)
+    CRITICAL_SECTION gapLock;
+    InitializeCriticalSection(&gapLock);
+    int64_t lastPacketNs = 0;
+    int64_t maxGapNs = 0;
+    uint64_t packets = 0;
+    device->setWriteObserver([&](const unsigned char* data, size_t size) {
+        if (size < 17 || data[2] != 0x06) return;
+        int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        EnterCriticalSection(&gapLock);
+        if (lastPacketNs != 0) maxGapNs = std::max(maxGapNs, now - lastPacketNs);
+        lastPacketNs = now;
+        packets++;
+        LeaveCriticalSection(&gapLock);
+    });
+    auto resetGaps = [&]() {
+        EnterCriticalSection(&gapLock);
+        lastPacketNs = maxGapNs = 0;
+        packets = 0;
+        LeaveCriticalSection(&gapLock);
+    };
+    std::stringstream ss;
+    
+    // 1. Aufrufkosten: nativer Code im Animation-Thread
+    const int stepMs = 10;
+    auto effect = std::make_shared<PluginEffect>();
+    effect->load(module, "period=1000", error);
+    module.reset();
+    rgb.startEffect(effect, stepMs);
+    Sleep(1000);
+    PluginEffectStats stats = effect->getStats();
+    ss << std::fixed << std::setprecision(2)
+       << "[PLUGIN] '" << effect->name() << "' @ " << stepMs << "ms: " << stats.calls << " Aufrufe, p50 "
+       << stats.callTime.p50Us << " us / p99 " << stats.callTime.p99Us << " us pro Frame";
+    logEvent(ss.str());
+    
+    // 2. Hot-Swap: 20x neu laden (jeweils neue DLL-Kopie + Instanz), Effekt läuft weiter
+    resetGaps();
+    effect->resetStats();
+    AnimationStats before = rgb.animation().getStats();
+    std::vector<double> swapUs;
+    const char* colors[2] = { "color=FF4000", "color=00FF80" };
+    for (int i = 0; i < 20; i++) {
+        auto start = std::chrono::steady_clock::now();
+        bool ok = effect->loadFile(path, std::string("period=1000 ") + colors[i % 2], error);
+        swapUs.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        if (!ok) {
+            logEvent("[PLUGIN] Tausch fehlgeschlagen: " + error);
+            break;
+        }
+        Sleep(50);
+    }
+    AnimationStats after = rgb.animation().getStats();
+    stats = effect->getStats();
+    std::sort(swapUs.begin(), swapUs.end());
+    EnterCriticalSection(&gapLock);
+    double maxGapMs = maxGapNs / 1e6;
+    LeaveCriticalSection(&gapLock);
+    ss.str("");
+    ss << std::fixed << std::setprecision(1)
+       << "[PLUGIN] Hot-Swap: " << stats.swaps << " Tausche, loadFile() p50 " << swapUs[swapUs.size() / 2] << " us, "
+       << "groesste Paketluecke " << maxGapMs << " ms (Intervall " << stepMs << "), uebersprungen "
+       << (after.skippedFrames - before.skippedFrames) << ", Effekt "
+       << (rgb.isEffectRunning() ? "lief durch (korrekt)" : "GESTOPPT (FEHLER)");
+    logEvent(ss.str());
+    
+    // 3. Budget: 3ms pro Aufruf bei 1ms Budget -> nur jeder 3. Frame wird gerechnet
+    PluginBudget budget;
+    budget.frameUs = 1000;
+    budget.stopUs = 20000;
+    effect->setBudget(budget);
+    effect->loadFile(path, "cost=3000", error);
+    Sleep(100);
+    effect->resetStats();
+    Sleep(1000);
+    stats = effect->getStats();
+    double perFrameUs = stats.frames ? stats.callTime.meanUs * stats.calls / stats.frames : 0;
+    ss.str("");
+    ss << std::fixed << std::setprecision(0)
+       << "[PLUGIN] Budget 1000 us, Plugin 3000 us/Aufruf: jeder " << stats.stride << ". Frame gerechnet ("
+       << stats.calls << "/" << stats.frames << "), im Mittel " << perFrameUs << " us pro Frame"
+       << (perFrameUs <= budget.frameUs * 1.2 ? " (korrekt)" : " (UEBER BUDGET)");
+    logEvent(ss.str());
+    
+    // 4. Ausreißer: 10. Aufruf braucht 50ms > stopUs -> Instanz angehalten, letzter Frame bleibt
+    effect->loadFile(path, "stall=50000", error);
+    Sleep(500);
+    stats = effect->getStats();
+    ss.str("");
+    ss << "[PLUGIN] Ausreisser 50ms: " << (stats.stopped ? "angehalten" : "NICHT angehalten (FEHLER)")
+       << ", Effekt " << (rgb.isEffectRunning() ? "laeuft weiter mit letztem Frame" : "gestoppt");
+    logEvent(ss.str());
+    
+    rgb.stopEffect();
+    rgb.waitEffect(1000);
+    device->setWriteObserver(nullptr);
+    DeleteCriticalSection(&gapLock);
+    rgb.disconnect();
+}
+
+void printSimulationMenu() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  Simulation & Benchmarks (ohne Hardware)" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "1. Event-Bursts (Drops, Batch-Read)" << std::endl;
+    std::cout << "2. Animation-Timing (Dauer, Jitter)" << std::endl;
+    std::cout << "3. Farb-Pipeline (Float vs. Tabellen)" << std::endl;
+    std::cout << "4. Compositor (Ebenen, Cache)" << std::endl;
+    std::cout << "5. Keyframe-Bibliothek (Oeffnen, Abspielen)" << std::endl;
+    std::cout << "6. Frame-Tabellen (Compile-Zeit vs. Laufzeit)" << std::endl;
+    std::cout << "7. Adaptive Framerate (Link-Latenz)" << std::endl;
+    std::cout << "8. Audio-Pipeline (FFT-Durchsatz, Latenz)" << std::endl;
+    std::cout << "9. Canvas-Sampling (SIMD-Mittelung, Shared Memory)" << std::endl;
+    std::cout << "A. Mehrere Headsets (gemeinsamer Frame-Takt)" << std::endl;
+    std::cout << "B. Mute-Reflex (Event -> Mic-LED)" << std::endl;
+    std::cout << "C. Regel-Engine (Entscheidungstabelle, Hot-Reload)" << std::endl;
+    std::cout << "D. Skript-Effekte (Bytecode-VM vs. nativ)" << std::endl;
+    std::cout << "E. Effekt-Cache (vorgerendert, gemappt)" << std::endl;
+    std::cout << "F. Uebergaenge (OKLab vs. sRGB)" << std::endl;
+    std::cout << "G. Dithering (Helligkeit + Fehlerdiffusion)" << std::endl;
+    std::cout << "H. Helligkeits-Blenden (Pakete pro Effekt-Sekunde)" << std::endl;
+    std::cout << "I. Kalibrierung (Tabellen im Sendepfad)" << std::endl;
+    std::cout << "J. Benachrichtigungen (Vorrang, Wiederherstellung)" << std::endl;
+    std::cout << "K. Virtuelle Zeit (1h Effekt offline, deterministisch)" << std::endl;
+    std::cout << "L. Native Plugins (Hot-Swap, Budget pro Plugin)" << std::endl;
+    std::cout << "Q. Zurueck" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "\nWaehlen Sie: ";
+}
+
+void simulationMenu() {
+    while (true) {
+        printSimulationMenu();
+        
+        char choice = _getch();
+        choice = toupper(choice);
+        std::cout << choice << std::endl;
+        
+        switch (choice) {
+        case '1':
+            eventBurstSimulation();
+            break;
+            
+        case '2':
+            animationTimingSimulation();
+            break;
+            
+        case '3':
+            colorPipelineBenchmark();
+            break;
+            
+        case '4':
+            compositorBenchmark();
+            break;
+            
+        case '5':
+            keyframeLibraryBenchmark();
+            break;
+            
+        case '6':
+            frameTableBenchmark();
+            break;
+            
+        case '7':
+            adaptiveRateSimulation();
+            break;
+            
+        case '8':
+            audioPipelineBenchmark();
+            break;
+            
+        case '9':
+            canvasSamplerBenchmark();
+            break;
+            
+        case 'A':
+            frameClockSimulation();
+            break;
+            
+        case 'B':
+            muteReflexSimulation();
+            break;
+            
+        case 'C':
+            ruleEngineBenchmark();
+            break;
+            
+        case 'D':
+            scriptEffectBenchmark();
+            break;
+            
+        case 'E':
+            effectCacheBenchmark();
+            break;
+            
+        case 'F':
+            transitionBenchmark();
+            break;
+            
+        case 'G':
+            ditherSimulation();
+            break;
+            
+        case 'H':
+            fadePlannerSimulation();
+            break;
+            
+        case 'I':
+            calibrationBenchmark();
+            break;
+            
+        case 'J':
+            notificationSimulation();
+            break;
+            
+        case 'K':
+            offlineRenderSimulation();
+            break;
+            
+        case 'L':
+            pluginSimulation();
+            break;
+            
+        case 'Q':
+            return;
+            
+        default:
+            std::cout << "Ungueltige Auswahl!" << std::endl;
+            break;
+        }
+    }
+}
+
+// Hauptmenü
+void printMainMenu() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  HS80 Analyzer v1.0" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "1. Zeige alle HID-Geraete" << std::endl;
+    std::cout << "2. Zeige HS80 Interfaces" << std::endl;
+    std::cout << "3. RGB Test-Suite" << std::endl;
+    std::cout << "4. Event Monitor Test" << std::endl;
+    std::cout << "5. Vollstaendiger Test (RGB + Events)" << std::endl;
+    std::cout << "S. Simulation & Benchmarks (ohne Hardware)" << std::endl;
+    std::cout << "L. Logging " << (enableLogging ? "AUS" : "AN") << std::endl;
+    std::cout << "Q. Beenden" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "\nWaehlen Sie: ";
+}
+
+int main() {
+    std::cout << "HS80 Analyzer v1.0" << std::endl;
+    std::cout << "==================" << std::endl;
+    std::cout << "\nDieses Tool analysiert die RGB- und Event-Interfaces" << std::endl;
+    std::cout << "des Corsair HS80 RGB Wireless Gaming Headsets.\n" << std::endl;
+    
+    HeadsetManager manager;
+    bool connected = false;
+    
+    while (true) {
+        printMainMenu();
+        
+        char choice = _getch();
+        choice = toupper(choice);
+        std::cout << choice << std::endl;
+        
+        switch (choice) {
+        case '1':
+            showAllDevices();
+            break;
+            
+        case '2':
+            showHS80Interfaces();
+            break;
+            
+        case '3':
+            if (!connected) {
+                std::cout << "\nVerbinde mit HS80..." << std::endl;
+                connected = manager.connect();
+            }
+            if (connected) {
+                rgbTestSuite(manager.rgb());
+            }
+            break;
+            
+        case '4':
+            if (!connected) {
+                std::cout << "\nVerbinde mit HS80..." << std::endl;
+                connected = manager.connect();
+            }
+            if (connected) {
+                eventMonitorTest(manager.events());
+            }
+            break;
+            
+        case '5':
+            if (!connected) {
+                std::cout << "\nVerbinde mit HS80..." << std::endl;
+                connected = manager.connect();
+            }
+            if (connected) {
+                rgbTestSuite(manager.rgb());
+                std::cout << "\n\nDruecke eine Taste fuer Event-Test..." << std::endl;
+                _getch();
+                eventMonitorTest(manager.events());
+            }
+            break;
+            
+        case 'S':
+            simulationMenu();
             break;
             
         case 'L':
@@ -0,0 +1,515 @@
+#include "HS80_Animation.h"
+#include "HS80_Color.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace HS80 {
+
+// ============================================================================
+// Effekte
+// ============================================================================
+
+RainbowEffect::RainbowEffect(int periodMs, int durationMs)
+    : m_periodMs(periodMs > 0 ? periodMs : 1)
+    , m_durationMs(durationMs > 0 ? durationMs : 0) {
+}
+
+EffectStatus RainbowEffect::render(const FrameContext& frame, LEDZones& zones) {
+    // Farbkreis-Tabelle statt Float-HSV; Phase in µs für feine Stufen
+    uint64_t timeUs = static_cast<uint64_t>(frame.timeMs * 1000.0);
+    uint64_t periodUs = static_cast<uint64_t>(m_periodMs * 1000.0);
+    zones = LEDZones(Color::hueToRgb(Color::hueFromPhase(timeUs, periodUs)));
+
+    // Letzter Frame liegt ein Intervall vor dem Ende (wie die alte Schleife)
+    if (m_durationMs > 0 && frame.timeMs + frame.frameIntervalMs >= m_durationMs) {
+        return EffectStatus::Finished;
+    }
+    return EffectStatus::Running;
+}
+
+PulseEffect::PulseEffect(RGBColor color, int periodMs, int cycles)
+    : m_color(color)
+    , m_periodMs(periodMs > 0 ? periodMs : 1)
+    , m_cycles(cycles > 0 ? cycles : 0) {
+}
+
+EffectStatus PulseEffect::render(const FrameContext& frame, LEDZones& zones) {
+    bool finished = m_cycles > 0 && frame.timeMs >= m_cycles * m_periodMs;
+
+    // Dreieck 0 -> 256 -> 0 (Q8) pro Periode, endet dunkel
+    uint16_t level = 0;
+    if (!finished) {
+        uint64_t timeUs = static_cast<uint64_t>(frame.timeMs * 1000.0);
+        uint64_t periodUs = static_cast<uint64_t>(m_periodMs * 1000.0);
+        uint32_t phase = static_cast<uint32_t>(((timeUs % periodUs) * 512) / periodUs);
+        level = static_cast<uint16_t>(phase < 256 ? phase : 512 - phase);
+    }
+
+    // Gamma auf den Verlauf, damit das Ein-/Ausblenden gleichmäßig wirkt
+    uint16_t perceived = level >= Color::BRIGHTNESS_ONE ? Color::BRIGHTNESS_ONE : Color::gamma(static_cast<uint8_t>(level));
+    zones = LEDZones(Color::scale(m_color, perceived));
+
+    return finished ? EffectStatus::Finished : EffectStatus::Running;
+}
+
+EffectStatus PulseEffect::renderLevel(const FrameContext& frame, LEDZones& base, uint32_t& level) {
+    bool finished = m_cycles > 0 && frame.timeMs >= m_cycles * m_periodMs;
+
+    // Wie render(), aber ohne 8-Bit-Stufen: Dreieck 0 -> 1 -> 0, Gamma 2.2
+    double perceived = 0;
+    if (!finished) {
+        double phase = std::fmod(frame.timeMs, m_periodMs) * 2.0 / m_periodMs;
+        perceived = std::pow(phase < 1.0 ? phase : 2.0 - phase, 2.2);
+    }
+    base = LEDZones(m_color);
+    level = static_cast<uint32_t>(perceived * LEVEL_ONE + 0.5);
+
+    return finished ? EffectStatus::Finished : EffectStatus::Running;
+}
+
+EffectStatus LevelEffect::render(const FrameContext& frame, LEDZones& zones) {
+    uint32_t level = 0;
+    EffectStatus status = renderLevel(frame, zones, level);
+    unsigned char* out = reinterpret_cast<unsigned char*>(&zones);
+    for (int i = 0; i < 9; i++) {
+        out[i] = static_cast<unsigned char>((out[i] * level + LEVEL_ONE / 2) / LEVEL_ONE);
+    }
+    return status;
+}
+
+EffectStatus HighResEffect::render(const FrameContext& frame, LEDZones& zones) {
+    HighResZones highRes;
+    EffectStatus status = renderHighRes(frame, highRes);
+    unsigned char* out = reinterpret_cast<unsigned char*>(&zones);
+    for (int i = 0; i < 9; i++) {
+        out[i] = static_cast<unsigned char>(std::min(255, (highRes.channel[i] + 128) >> 8));
+    }
+    return status;
+}
+
+// ============================================================================
+// FrameRateController
+// ============================================================================
+
+FrameRateController::FrameRateController()
+    : m_requestedMs(33)
+    , m_intervalMs(33)
+    , m_ewmaUs(0)
+    , m_samples(0)
+    , m_framesSinceChange(0) {
+}
+
+void FrameRateController::reset(int requestedIntervalMs) {
+    m_requestedMs = requestedIntervalMs > 0 ? requestedIntervalMs : 1;
+    m_intervalMs = m_requestedMs;
+    m_ewmaUs = 0;
+    m_samples = 0;
+    m_framesSinceChange = 0;
+}
+
+bool FrameRateController::recordWrite(uint64_t writeNs) {
+    double sampleUs = writeNs / 1000.0;
+    m_ewmaUs = m_samples == 0 ? sampleUs : m_ewmaUs + m_config.smoothing * (sampleUs - m_ewmaUs);
+    m_samples++;
+    m_framesSinceChange++;
+
+    if (!m_config.enabled) {
+        return false;
+    }
+
+    // Kleinstes Intervall (ganze ms), das der Link mit Reserve schafft
+    int needed = static_cast<int>(std::ceil(m_ewmaUs * m_config.headroom / 1000.0));
+    needed = std::max(needed, m_requestedMs);
+    needed = std::min(needed, std::max(m_config.maxIntervalMs, m_requestedMs));
+
+    // Drosseln sofort (sonst laufen Deadlines davon), Beschleunigen erst nach
+    // recoverFrames ruhigen Frames und mit Hysterese gegen Pendeln
+    if (needed > m_intervalMs) {
+        // 1/8 Zuschlag, damit Jitter nicht jede ms einzeln nachzieht
+        m_intervalMs = std::min(needed + needed / 8, std::max(m_config.maxIntervalMs, m_requestedMs));
+        m_framesSinceChange = 0;
+        return true;
+    }
+    if (needed < m_intervalMs && m_framesSinceChange >= m_config.recoverFrames &&
+        m_ewmaUs * m_config.headroom < m_intervalMs * 800.0) {
+        m_intervalMs = needed;
+        m_framesSinceChange = 0;
+        return true;
+    }
+    return false;
+}
+
+double FrameRateController::saturation() const {
+    return m_intervalMs > 0 ? m_ewmaUs / (m_intervalMs * 1000.0) : 0.0;
+}
+
+// ============================================================================
+// AnimationEngine
+// ============================================================================
+
+AnimationEngine::AnimationEngine(FrameSink sink, HighResFrameSink highResSink, LevelFrameSink levelSink)
+    : m_sink(sink)
+    , m_highResSink(highResSink)
+    , m_levelSink(levelSink)
+    , m_thread(nullptr)
+    , m_wakeEvent(nullptr)
+    , m_idleEvent(nullptr)
+    , m_timer(nullptr)
+    , m_hasCommand(false)
+    , m_shutdown(false)
+    , m_pendingIntervalMs(33)
+    , m_running(false)
+    , m_clock(systemClock())
+    , m_clockTicket(0)
+    , m_statFrames(0)
+    , m_statSkipped(0)
+    , m_statErrors(0)
+    , m_statRateChanges(0)
+    , m_statOverruns(0)
+    , m_rateRequestedMs(0)
+    , m_rateEffectiveMs(0)
+    , m_rateEwmaUs(0)
+    , m_rateSaturation(0)
+    , m_rateFrames(0)
+    , m_rateFirstNs(0)
+    , m_rateLastNs(0)
+    , m_currentTimeMs(0)
+{
+    InitializeCriticalSection(&m_lock);
+    m_wakeEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    m_idleEvent = CreateEvent(nullptr, TRUE, TRUE, nullptr);
+
+    // Hochauflösender Timer ab Windows 10 1803, sonst normaler Timer (~1-15ms Auflösung)
+    m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (!m_timer) {
+        m_timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+    }
+}
+
+AnimationEngine::~AnimationEngine() {
+    shutdown();
+    if (m_timer) CloseHandle(m_timer);
+    if (m_idleEvent) CloseHandle(m_idleEvent);
+    if (m_wakeEvent) CloseHandle(m_wakeEvent);
+    DeleteCriticalSection(&m_lock);
+}
+
+bool AnimationEngine::ensureThread() {
+    if (m_thread) {
+        return true;
+    }
+
+    m_clockTicket = m_clock->threadCreated();
+    m_thread = CreateThread(nullptr, 0, AnimationThreadProc, this, 0, nullptr);
+    if (!m_thread) {
+        m_clock->threadCancelled();
+        std::cerr << "[ANIM] Fehler beim Erstellen des Animation-Threads!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void AnimationEngine::shutdown() {
+    if (!m_thread) {
+        return;
+    }
+
+    EnterCriticalSection(&m_lock);
+    m_shutdown = true;
+    LeaveCriticalSection(&m_lock);
+    m_clock->signal(m_wakeEvent);
+
+    WaitForSingleObject(m_thread, INFINITE);
+    CloseHandle(m_thread);
+    m_thread = nullptr;
+    m_running = false;
+    SetEvent(m_idleEvent);
+}
+
+bool AnimationEngine::start(std::shared_ptr<Effect> effect, int frameIntervalMs) {
+    if (!effect || frameIntervalMs <= 0) {
+        return false;
+    }
+
+    EnterCriticalSection(&m_lock);
+    m_pendingEffect = effect;
+    m_pendingIntervalMs = frameIntervalMs;
+    m_hasCommand = true;
+    m_running = true;
+    ResetEvent(m_idleEvent);
+    LeaveCriticalSection(&m_lock);
+
+    if (!ensureThread()) {
+        EnterCriticalSection(&m_lock);
+        m_pendingEffect.reset();
+        m_hasCommand = false;
+        m_running = false;
+        SetEvent(m_idleEvent);
+        LeaveCriticalSection(&m_lock);
+        return false;
+    }
+
+    m_clock->signal(m_wakeEvent);
+    return true;
+}
+
+void AnimationEngine::stop() {
+    EnterCriticalSection(&m_lock);
+    m_pendingEffect.reset();
+    m_hasCommand = true;
+    m_running = false;
+    LeaveCriticalSection(&m_lock);
+    m_clock->signal(m_wakeEvent);
+}
+
+std::shared_ptr<Effect> AnimationEngine::current(double& timeMs) const {
+    EnterCriticalSection(&m_lock);
+    std::shared_ptr<Effect> effect = m_currentEffect;
+    timeMs = m_currentTimeMs;
+    LeaveCriticalSection(&m_lock);
+    return effect;
+}
+
+bool AnimationEngine::wait(DWORD timeoutMs) {
+    return m_clock->waitForEvent(m_idleEvent, timeoutMs);
+}
+
+void AnimationEngine::setClock(std::shared_ptr<Clock> clock) {
+    if (!clock || clock == m_clock) {
+        return;
+    }
+    shutdown();
+
+    EnterCriticalSection(&m_lock);
+    m_shutdown = false;
+    m_pendingEffect.reset();
+    m_hasCommand = false;
+    m_currentEffect.reset();
+    LeaveCriticalSection(&m_lock);
+    m_clock = clock;
+}
+
+void AnimationEngine::setRateControl(const RateControlConfig& config) {
+    EnterCriticalSection(&m_lock);
+    m_rateConfig = config;
+    LeaveCriticalSection(&m_lock);
+}
+
+RateControlConfig AnimationEngine::getRateControl() const {
+    EnterCriticalSection(&m_lock);
+    RateControlConfig config = m_rateConfig;
+    LeaveCriticalSection(&m_lock);
+    return config;
+}
+
+DWORD WINAPI AnimationEngine::AnimationThreadProc(LPVOID param) {
+    AnimationEngine* engine = static_cast<AnimationEngine*>(param);
+    ClockThreadScope scope(*engine->m_clock, engine->m_clockTicket);
+    engine->animationLoop();
+    return 0;
+}
+
+void AnimationEngine::animationLoop() {
+    std::shared_ptr<Effect> effect;
+    HighResEffect* highRes = nullptr;       // effect als HighResEffect, falls ausgegeben
+    LevelEffect* levelEffect = nullptr;     // effect als LevelEffect, falls ausgegeben
+    int64_t intervalNs = 1;
+    double intervalMs = 0;
+    uint64_t frameIndex = 0;
+    uint64_t skippedBefore = 0;
+
+    // Deadlines gelten ab dem Segment-Start; ändert die Backpressure das
+    // Intervall, beginnt am aktuellen Frame ein neues Segment
+    int64_t segmentNs = 0;
+    double segmentTimeMs = 0;
+    uint64_t segmentFrame = 0;
+
+    while (true) {
+        EnterCriticalSection(&m_lock);
+        if (m_shutdown) {
+            LeaveCriticalSection(&m_lock);
+            break;
+        }
+        if (m_hasCommand) {
+            effect = m_pendingEffect;
+            m_pendingEffect.reset();
+            m_hasCommand = false;
+            highRes = m_highResSink ? dynamic_cast<HighResEffect*>(effect.get()) : nullptr;
+            levelEffect = m_levelSink ? dynamic_cast<LevelEffect*>(effect.get()) : nullptr;
+
+            if (effect) {
+                int64_t now = m_clock->nowNs();
+                m_rate.configure(m_rateConfig);
+                m_rate.reset(m_pendingIntervalMs);
+                intervalMs = m_rate.intervalMs();
+                intervalNs = m_rate.intervalMs() * Clock::NS_PER_MS;
+                if (intervalNs <= 0) intervalNs = 1;
+                frameIndex = 0;
+                skippedBefore = 0;
+                segmentNs = now;
+                segmentTimeMs = 0;
+                segmentFrame = 0;
+
+                m_rateRequestedMs = m_rate.requestedIntervalMs();
+                m_rateEffectiveMs = m_rate.intervalMs();
+                m_rateEwmaUs = 0;
+                m_rateSaturation = 0;
+                m_rateFrames = 0;
+            }
+        }
+        if (!effect) {
+            m_running = false;
+            m_currentEffect.reset();
+            SetEvent(m_idleEvent);
+        }
+        LeaveCriticalSection(&m_lock);
+
+        if (!effect) {
+            m_clock->waitUntil(Clock::FOREVER, m_wakeEvent);
+            continue;
+        }
+
+        // Absolute Deadline des Frames - unabhängig von bisherigen Sendezeiten
+        int64_t deadline = segmentNs + static_cast<int64_t>(segmentFrame) * intervalNs;
+        if (!m_clock->waitUntil(deadline, m_wakeEvent, m_timer)) {
+            continue;  // Neues Kommando
+        }
+
+        // Zu frühes Wecken (Timer-Auflösung) zählt als 0, nicht als Unterlauf
+        int64_t wake = m_clock->nowNs();
+        m_wakeJitter.record(static_cast<uint64_t>(std::max<int64_t>(wake - deadline, 0)));
+
+        // Mehr als ein Intervall verspätet: auf den aktuellen Frame springen
+        uint64_t currentFrame = static_cast<uint64_t>((wake - segmentNs) / intervalNs);
+        if (currentFrame > segmentFrame) {
+            uint64_t skipped = currentFrame - segmentFrame;
+            m_statSkipped.fetch_add(skipped, std::memory_order_relaxed);
+            skippedBefore += skipped;
+            frameIndex += skipped;
+            segmentFrame = currentFrame;
+            deadline = segmentNs + static_cast<int64_t>(segmentFrame) * intervalNs;
+        }
+
+        FrameContext frame;
+        frame.frameIndex = frameIndex;
+        frame.timeMs = segmentTimeMs + segmentFrame * intervalMs;
+        frame.frameIntervalMs = intervalMs;
+        frame.skippedFrames = skippedBefore;
+
+        LEDZones zones;
+        HighResZones highResZones;
+        uint32_t level = 0;
+        EffectStatus status;
+        if (highRes) {
+            status = highRes->renderHighRes(frame, highResZones);
+        } else if (levelEffect) {
+            status = levelEffect->renderLevel(frame, zones, level);
+        } else {
+            status = effect->render(frame, zones);
+        }
+
+        int64_t sendStart = m_clock->nowNs();
+        bool sent;
+        if (highRes) {
+            sent = m_highResSink(highResZones);
+        } else if (levelEffect) {
+            sent = m_levelSink(zones, level);
+        } else {
+            sent = m_sink && m_sink(zones);
+        }
+        if (!sent) {
+            m_statErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_statFrames.fetch_add(1, std::memory_order_relaxed);
+
+        int64_t done = m_clock->nowNs();
+        uint64_t writeNs = static_cast<uint64_t>(done - sendStart);
+        m_writeTime.record(writeNs);
+        m_frameTime.record(static_cast<uint64_t>(done - wake));
+        if (writeNs > static_cast<uint64_t>(m_rate.requestedIntervalMs()) * 1000000ULL) {
+            m_statOverruns.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (status == EffectStatus::Finished) {
+            effect.reset();
+            highRes = nullptr;
+            levelEffect = nullptr;
+        }
+        frameIndex++;
+        segmentFrame++;
+
+        // Backpressure: neues Intervall ab dem nächsten Frame
+        if (m_rate.recordWrite(writeNs)) {
+            segmentNs = deadline;
+            segmentTimeMs = frame.timeMs;
+            segmentFrame = 1;
+            intervalMs = m_rate.intervalMs();
+            intervalNs = m_rate.intervalMs() * Clock::NS_PER_MS;
+            if (intervalNs <= 0) intervalNs = 1;
+            m_statRateChanges.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        EnterCriticalSection(&m_lock);
+        if (m_rateFrames == 0) {
+            m_rateFirstNs = done;
+        }
+        m_rateFrames++;
+        m_rateLastNs = done;
+        m_rateEffectiveMs = m_rate.intervalMs();
+        m_rateEwmaUs = m_rate.writeEwmaUs();
+        m_rateSaturation = m_rate.saturation();
+        m_currentEffect = effect;
+        m_currentTimeMs = frame.timeMs + intervalMs;
+        LeaveCriticalSection(&m_lock);
+    }
+}
+
+// ============================================================================
+// Statistik
+// ============================================================================
+
+AnimationStats AnimationEngine::getStats() const {
+    AnimationStats stats;
+    stats.frames = m_statFrames.load(std::memory_order_relaxed);
+    stats.skippedFrames = m_statSkipped.load(std::memory_order_relaxed);
+    stats.sendErrors = m_statErrors.load(std::memory_order_relaxed);
+    stats.wakeJitter = m_wakeJitter.snapshot();
+    stats.frameTime = m_frameTime.snapshot();
+    stats.writeTime = m_writeTime.snapshot();
+    stats.rateChanges = m_statRateChanges.load(std::memory_order_relaxed);
+    stats.overrunFrames = m_statOverruns.load(std::memory_order_relaxed);
+
+    EnterCriticalSection(&m_lock);
+    stats.requestedIntervalMs = m_rateRequestedMs;
+    stats.effectiveIntervalMs = m_rateEffectiveMs;
+    stats.writeEwmaUs = m_rateEwmaUs;
+    stats.linkSaturation = m_rateSaturation;
+    stats.achievedFps = 0;
+    if (m_rateFrames > 1 && m_rateLastNs > m_rateFirstNs) {
+        stats.achievedFps = (m_rateFrames - 1) * 1e9 / (m_rateLastNs - m_rateFirstNs);
+    }
+    LeaveCriticalSection(&m_lock);
+    return stats;
+}
+
+void AnimationEngine::resetStats() {
+    m_statFrames = 0;
+    m_statSkipped = 0;
+    m_statErrors = 0;
+    m_statRateChanges = 0;
+    m_statOverruns = 0;
+    m_wakeJitter.reset();
+    m_frameTime.reset();
+    m_writeTime.reset();
+
+    EnterCriticalSection(&m_lock);
+    m_rateFrames = 0;
+    LeaveCriticalSection(&m_lock);
+}
+
+} // namespace HS80
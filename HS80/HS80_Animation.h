@@ -0,0 +1,233 @@
+#pragma once
+
+#include "HS80_Library.h"
+#include "HS80_Clock.h"
+
+// ============================================================================
+// HS80 Animation - Effekte im Hintergrund mit driftfreiem Frame-Timing
+// ============================================================================
+//
+// Der AnimationEngine-Thread berechnet jede Frame-Deadline absolut ab dem
+// Effekt-Start (Clock, Standard: QueryPerformanceCounter) und wartet mit einem
+// hochauflösenden Waitable Timer darauf. Sendezeiten verschieben daher keine späteren Frames.
+// Kommt der Thread mehr als ein Intervall zu spät, werden Frames übersprungen
+// statt nachgeholt.
+//
+// Effekte rechnen zeitbasiert (FrameContext::timeMs), nicht frame-basiert:
+// übersprungene Frames ändern weder Verlauf noch Gesamtdauer.
+//
+// Backpressure: Die Engine misst pro Frame die Schreibzeit des Reports (Sink)
+// und vergrößert das Frame-Intervall, sobald der Link die angeforderte Rate
+// nicht schafft (FrameRateController). Wird der Link wieder schneller, geht das
+// Intervall schrittweise auf den angeforderten Wert zurück.
+// ============================================================================
+
+namespace HS80 {
+
+// Zeitpunkt eines Frames
+struct FrameContext {
+    uint64_t frameIndex;        // Frame-Nummer seit Effekt-Start
+    double timeMs;              // Soll-Zeit des Frames seit Effekt-Start
+    double frameIntervalMs;     // Frame-Abstand
+    uint64_t skippedFrames;     // Vor diesem Frame übersprungene Frames
+};
+
+enum class EffectStatus {
+    Running,
+    Finished    // Letzter Frame: wird noch gesendet, danach ist der Effekt beendet
+};
+
+// Basisklasse für Effekte (render läuft im Animation-Thread)
+class Effect {
+public:
+    virtual ~Effect() = default;
+    virtual EffectStatus render(const FrameContext& frame, LEDZones& zones) = 0;
+};
+
+// Regenbogen: ein Farbkreis-Durchlauf pro periodMs, durationMs = 0 läuft endlos
+class RainbowEffect : public Effect {
+private:
+    double m_periodMs;
+    double m_durationMs;
+
+public:
+    RainbowEffect(int periodMs = 10000, int durationMs = 0);
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override;
+};
+
+// Globale Blende: feste Grundfarbe * Pegel (Q16). Mit Pegel-Ausgabe
+// (RGBController: FadePlanner) kann der Pegel über die Hardware-Helligkeit
+// laufen, sonst skaliert render() die Farben.
+constexpr uint32_t LEVEL_ONE = 65536;
+
+class LevelEffect : public Effect {
+public:
+    virtual EffectStatus renderLevel(const FrameContext& frame, LEDZones& base, uint32_t& level) = 0;
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override;
+};
+
+// Puls: Ein-/Ausblenden einer Farbe, cycles = 0 läuft endlos
+class PulseEffect : public LevelEffect {
+private:
+    RGBColor m_color;
+    double m_periodMs;
+    int m_cycles;
+
+public:
+    PulseEffect(RGBColor color, int periodMs = 1800, int cycles = 0);
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override;
+    EffectStatus renderLevel(const FrameContext& frame, LEDZones& base, uint32_t& level) override;
+};
+
+// Effekt mit Nachkommastellen (Q8.8). Mit HighRes-Ausgabe (RGBController:
+// Dithering) gehen die Frames unverändert raus, sonst gerundet über render().
+class HighResEffect : public Effect {
+public:
+    virtual EffectStatus renderHighRes(const FrameContext& frame, HighResZones& zones) = 0;
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override;
+};
+
+// Frame-Ausgabe (z.B. RGBController::setColors), false = Sendefehler
+using FrameSink = std::function<bool(const LEDZones&)>;
+using HighResFrameSink = std::function<bool(const HighResZones&)>;
+using LevelFrameSink = std::function<bool(const LEDZones& base, uint32_t level)>;
+
+// Anpassung der Framerate an die gemessene Schreibzeit
+struct RateControlConfig {
+    bool enabled;
+    double headroom;            // Intervall >= Schreibzeit * headroom
+    double smoothing;           // EWMA-Gewicht neuer Messungen (0-1)
+    int maxIntervalMs;          // Obergrenze für das gedrosselte Intervall
+    int recoverFrames;          // Frames ohne Änderung, bevor wieder beschleunigt wird
+
+    RateControlConfig() : enabled(true), headroom(1.25), smoothing(0.125), maxIntervalMs(500), recoverFrames(8) {}
+};
+
+// Entscheidet aus den Schreibzeiten über das Frame-Intervall (nur im Animation-Thread)
+class FrameRateController {
+private:
+    RateControlConfig m_config;
+    int m_requestedMs;
+    int m_intervalMs;
+    double m_ewmaUs;
+    uint64_t m_samples;
+    int m_framesSinceChange;
+
+public:
+    FrameRateController();
+
+    void configure(const RateControlConfig& config) { m_config = config; }
+    void reset(int requestedIntervalMs);
+
+    // Schreibzeit eines Reports; true = Intervall geändert
+    bool recordWrite(uint64_t writeNs);
+
+    int requestedIntervalMs() const { return m_requestedMs; }
+    int intervalMs() const { return m_intervalMs; }
+    double writeEwmaUs() const { return m_ewmaUs; }
+    double saturation() const;  // Ø Schreibzeit / Intervall, >= 1 = Link ausgelastet
+};
+
+struct AnimationStats {
+    uint64_t frames;            // Gesendete Frames
+    uint64_t skippedFrames;     // Wegen Verspätung ausgelassene Frames
+    uint64_t sendErrors;
+    LatencySnapshot wakeJitter; // Ist-Weckzeit minus Deadline
+    LatencySnapshot frameTime;  // Render + Senden
+    LatencySnapshot writeTime;  // Nur Senden (Sink)
+
+    // Backpressure (aktueller bzw. letzter Effekt)
+    int requestedIntervalMs;
+    int effectiveIntervalMs;
+    double achievedFps;
+    double writeEwmaUs;
+    double linkSaturation;      // Ø Schreibzeit / effektives Intervall
+    uint64_t rateChanges;       // Anpassungen des Intervalls
+    uint64_t overrunFrames;     // Schreibzeit länger als das angeforderte Intervall
+};
+
+class AnimationEngine {
+private:
+    FrameSink m_sink;
+    HighResFrameSink m_highResSink;     // Optional, für HighResEffect
+    LevelFrameSink m_levelSink;         // Optional, für LevelEffect
+
+    HANDLE m_thread;
+    HANDLE m_wakeEvent;         // Auto-Reset: neues Kommando
+    HANDLE m_idleEvent;         // Manual-Reset: kein Effekt aktiv
+    HANDLE m_timer;             // Hochauflösender Waitable Timer (falls verfügbar)
+    mutable CRITICAL_SECTION m_lock;
+
+    // Kommando an den Thread (unter m_lock)
+    bool m_hasCommand;
+    bool m_shutdown;
+    std::shared_ptr<Effect> m_pendingEffect;
+    int m_pendingIntervalMs;
+
+    std::atomic<bool> m_running;
+    std::shared_ptr<Clock> m_clock;     // Nur ohne laufenden Thread austauschbar
+    int m_clockTicket;
+
+    // Backpressure (Konfiguration unter m_lock, Controller nur im Thread)
+    RateControlConfig m_rateConfig;
+    FrameRateController m_rate;
+
+    // Statistik
+    LatencyHistogram m_wakeJitter;
+    LatencyHistogram m_frameTime;
+    LatencyHistogram m_writeTime;
+    std::atomic<uint64_t> m_statFrames;
+    std::atomic<uint64_t> m_statSkipped;
+    std::atomic<uint64_t> m_statErrors;
+    std::atomic<uint64_t> m_statRateChanges;
+    std::atomic<uint64_t> m_statOverruns;
+
+    // Backpressure-Momentaufnahme (unter m_lock, einmal pro Frame)
+    int m_rateRequestedMs;
+    int m_rateEffectiveMs;
+    double m_rateEwmaUs;
+    double m_rateSaturation;
+    uint64_t m_rateFrames;          // Frames seit Effekt-Start
+    int64_t m_rateFirstNs;          // Sendezeit des ersten Frames
+    int64_t m_rateLastNs;           // Sendezeit des letzten Frames
+
+    // Laufender Effekt (unter m_lock, für Übergänge aus dem laufenden Effekt)
+    std::shared_ptr<Effect> m_currentEffect;
+    double m_currentTimeMs;         // Soll-Zeit des nächsten Frames
+
+    static DWORD WINAPI AnimationThreadProc(LPVOID param);
+    void animationLoop();
+    bool ensureThread();
+    void shutdown();
+
+public:
+    explicit AnimationEngine(FrameSink sink, HighResFrameSink highResSink = nullptr, LevelFrameSink levelSink = nullptr);
+    ~AnimationEngine();
+
+    AnimationEngine(const AnimationEngine&) = delete;
+    AnimationEngine& operator=(const AnimationEngine&) = delete;
+
+    // Nicht-blockierend: ersetzt einen laufenden Effekt sofort
+    bool start(std::shared_ptr<Effect> effect, int frameIntervalMs = 33);
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    // Laufender Effekt und Soll-Zeit seines nächsten Frames (nullptr = keiner)
+    std::shared_ptr<Effect> current(double& timeMs) const;
+
+    // Wartet, bis der Effekt beendet oder gestoppt ist (VirtualClock: simuliert bis dahin)
+    bool wait(DWORD timeoutMs = INFINITE);
+
+    // Zeitquelle (Standard: systemClock()); beendet den Thread, stoppt den Effekt
+    void setClock(std::shared_ptr<Clock> clock);
+    Clock& clock() { return *m_clock; }
+
+    // Gilt ab dem nächsten start()
+    void setRateControl(const RateControlConfig& config);
+    RateControlConfig getRateControl() const;
+
+    AnimationStats getStats() const;
+    void resetStats();
+};
+
+} // namespace HS80
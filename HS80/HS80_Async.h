@@ -0,0 +1,134 @@
+#pragma once
+
+#include "HS80_Library.h"
+#include <optional>
+
+// ============================================================================
+// HS80 Async - C++20 Coroutine-Awaitables für Events und Geräte-Kommandos
+// ============================================================================
+//
+// Benötigt C++20 (/std:c++20 bzw. -std=c++20). Die Library selbst bleibt C++17;
+// die Awaitables sind dünne Hüllen um die Callback-API (nextEventAsync,
+// setColorsAsync, queryBatteryAsync) von HeadsetManager.
+//
+// Kein Thread blockiert pro ausstehender Operation: Event-Warter liegen nur in
+// einer Liste des EventMonitors, Kommandos teilen sich einen Command-Thread pro
+// Headset. Die Coroutine wird über den übergebenen Executor fortgesetzt.
+//
+//   AsyncHeadset headset(manager, executor);
+//   auto event   = co_await headset.nextEvent(EventType::Mute);
+//   bool ok      = co_await headset.setColorsAsync(zones);
+//   auto battery = co_await headset.queryBattery();
+// ============================================================================
+
+#if defined(__cpp_impl_coroutine) || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+
+#include <coroutine>
+
+namespace HS80 {
+
+// Wartet auf das nächste Event eines Typs (leer bei Abbruch)
+class EventAwaitable {
+private:
+    HeadsetManager& m_manager;
+    Executor& m_executor;
+    EventType m_type;
+    std::optional<HeadsetEvent> m_result;
+
+public:
+    EventAwaitable(HeadsetManager& manager, Executor& executor, EventType type)
+        : m_manager(manager), m_executor(executor), m_type(type) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        // false = Registrierung fehlgeschlagen, Coroutine läuft sofort weiter
+        return m_manager.nextEventAsync(m_type, m_executor,
+            [this, handle](bool ok, const HeadsetEvent& event) {
+                if (ok) {
+                    m_result = event;
+                }
+                handle.resume();
+            });
+    }
+
+    std::optional<HeadsetEvent> await_resume() { return m_result; }
+};
+
+// Setzt die LED-Farben im Command-Thread
+class SetColorsAwaitable {
+private:
+    HeadsetManager& m_manager;
+    Executor& m_executor;
+    LEDZones m_zones;
+    bool m_result;
+
+public:
+    SetColorsAwaitable(HeadsetManager& manager, Executor& executor, const LEDZones& zones)
+        : m_manager(manager), m_executor(executor), m_zones(zones), m_result(false) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        return m_manager.setColorsAsync(m_zones, m_executor,
+            [this, handle](bool ok) {
+                m_result = ok;
+                handle.resume();
+            });
+    }
+
+    bool await_resume() const { return m_result; }
+};
+
+// Fragt Akkustand und Lade-Status ab (BatteryStatus::valid=false bei Fehler)
+class BatteryAwaitable {
+private:
+    HeadsetManager& m_manager;
+    Executor& m_executor;
+    BatteryStatus m_result;
+
+public:
+    BatteryAwaitable(HeadsetManager& manager, Executor& executor)
+        : m_manager(manager), m_executor(executor) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        return m_manager.queryBatteryAsync(m_executor,
+            [this, handle](bool ok, const BatteryStatus& status) {
+                if (ok) {
+                    m_result = status;
+                }
+                handle.resume();
+            });
+    }
+
+    BatteryStatus await_resume() const { return m_result; }
+};
+
+// Bindet Manager und Executor für kurze co_await-Ausdrücke
+class AsyncHeadset {
+private:
+    HeadsetManager& m_manager;
+    Executor& m_executor;
+
+public:
+    AsyncHeadset(HeadsetManager& manager, Executor& executor)
+        : m_manager(manager), m_executor(executor) {}
+
+    EventAwaitable nextEvent(EventType type = EventType::Unknown) {
+        return EventAwaitable(m_manager, m_executor, type);
+    }
+
+    SetColorsAwaitable setColorsAsync(const LEDZones& zones) {
+        return SetColorsAwaitable(m_manager, m_executor, zones);
+    }
+
+    BatteryAwaitable queryBattery() {
+        return BatteryAwaitable(m_manager, m_executor);
+    }
+};
+
+} // namespace HS80
+
+#endif // C++20 Coroutines
@@ -0,0 +1,128 @@
+// ============================================================================
+// HS80 Async Demo - C++20 Coroutines mit HS80_Async.h
+// ============================================================================
+//
+// Eigenes Ziel mit /std:c++20 (Library und übrige Programme bleiben C++17),
+// damit die Awaitables bei jedem Build mitkompiliert werden.
+//
+// 1. Ohne Headset: jedes Awaitable muss sofort zurückkehren (kein Hängen)
+// 2. Mit Headset: Farben setzen, Akku abfragen, auf Mute warten, Abbruch
+// ============================================================================
+
+#include "HS80_Async.h"
+#include <exception>
+#include <iostream>
+#include <conio.h>
+
+#if !defined(__cpp_impl_coroutine) && !(defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#error "HS80_AsyncDemo benötigt C++20 (/std:c++20)"
+#endif
+
+using namespace HS80;
+
+// Fire-and-forget: läuft bis zum ersten co_await im Aufrufer, danach im Executor
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+// Ohne Verbindung: Registrierung scheitert, Coroutine läuft sofort weiter
+DetachedTask offlineChecks(HeadsetManager& manager, Executor& executor, HANDLE done, int& passed) {
+    AsyncHeadset headset(manager, executor);
+
+    auto event = co_await headset.nextEvent(EventType::Mute);
+    if (!event) passed++;
+    bool ok = co_await headset.setColorsAsync(LEDZones(RGBColor(255, 0, 0)));
+    if (!ok) passed++;
+    auto battery = co_await headset.queryBattery();
+    if (!battery.valid) passed++;
+
+    SetEvent(done);
+}
+
+DetachedTask headsetSession(HeadsetManager& manager, Executor& executor, HANDLE done) {
+    AsyncHeadset headset(manager, executor);
+
+    bool ok = co_await headset.setColorsAsync(LEDZones(RGBColor(0, 80, 255)));
+    std::cout << "[ASYNC] Farben gesetzt: " << (ok ? "ja" : "FEHLER") << std::endl;
+
+    auto battery = co_await headset.queryBattery();
+    if (battery.valid) {
+        std::cout << "[ASYNC] Akku: " << battery.level << "%" << std::endl;
+    } else {
+        std::cout << "[ASYNC] Akku: keine Antwort" << std::endl;
+    }
+
+    std::cout << "[ASYNC] Mikrofon-Taste druecken (beliebige Taste = Abbruch)..." << std::endl;
+    auto event = co_await headset.nextEvent(EventType::Mute);
+    if (event) {
+        std::cout << "[ASYNC] Mute-Event: " << (event->isMuted() ? "STUMM" : "AKTIV") << std::endl;
+    } else {
+        std::cout << "[ASYNC] Warten abgebrochen (Monitoring gestoppt)" << std::endl;
+    }
+
+    SetEvent(done);
+}
+
+int main() {
+    std::cout << "HS80 Async Demo (C++20 Coroutines)" << std::endl;
+    std::cout << "==================================" << std::endl;
+
+    ThreadPoolExecutor executor;
+    HANDLE done = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+    // 1. Nicht verbunden: alle drei Awaitables kehren sofort zurück
+    {
+        HeadsetManager offline;
+        int passed = 0;
+        offlineChecks(offline, executor, done, passed);
+        bool finished = WaitForSingleObject(done, 1000) == WAIT_OBJECT_0;
+        std::cout << "[ASYNC] Ohne Verbindung: " << passed << "/3 sofort abgeschlossen"
+                  << (finished && passed == 3 ? " (korrekt)" : " (FEHLER: Coroutine haengt)") << std::endl;
+        ResetEvent(done);
+    }
+
+    // 2. Mit Headset
+    HeadsetManager manager;
+    if (!manager.connect(false)) {
+        std::cout << "[ASYNC] Kein Headset verbunden - Ende." << std::endl;
+        CloseHandle(done);
+        return 0;
+    }
+    manager.rgb().initialize();
+
+    // Ohne laufendes Monitoring darf nextEvent nicht hängen
+    {
+        AsyncHeadset headset(manager, executor);
+        int passed = 0;
+        [](AsyncHeadset& headset, HANDLE done, int& passed) -> DetachedTask {
+            auto event = co_await headset.nextEvent();
+            if (!event) passed++;
+            SetEvent(done);
+        }(headset, done, passed);
+        bool finished = WaitForSingleObject(done, 1000) == WAIT_OBJECT_0;
+        std::cout << "[ASYNC] Ohne Monitoring: nextEvent "
+                  << (finished && passed == 1 ? "sofort leer (korrekt)" : "HAENGT (FEHLER)") << std::endl;
+        ResetEvent(done);
+    }
+
+    manager.startEventMonitoring([](const HeadsetEvent&) {});
+    headsetSession(manager, executor, done);
+
+    // Taste: Monitoring stoppen -> wartende Coroutine wird mit leerem Ergebnis fortgesetzt
+    while (WaitForSingleObject(done, 100) == WAIT_TIMEOUT) {
+        if (_kbhit()) {
+            _getch();
+            manager.events().stopMonitoring();
+        }
+    }
+
+    manager.disconnect();
+    CloseHandle(done);
+    return 0;
+}
@@ -0,0 +1,687 @@
+#include "HS80_Audio.h"
+#include "HS80_Color.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define HS80_AUDIO_SSE 1
+#endif
+
+namespace HS80 {
+
+static const double PI = 3.14159265358979323846;
+
+// ============================================================================
+// RealFFT
+// ============================================================================
+
+RealFFT::RealFFT(size_t size) {
+    m_size = 16;
+    while (m_size < size) {
+        m_size <<= 1;
+    }
+    m_half = m_size / 2;
+
+    int bits = 0;
+    while ((static_cast<size_t>(1) << bits) < m_half) {
+        bits++;
+    }
+    m_bitReverse.resize(m_half);
+    for (size_t i = 0; i < m_half; i++) {
+        uint32_t reversed = 0;
+        for (int b = 0; b < bits; b++) {
+            if (i & (static_cast<size_t>(1) << b)) {
+                reversed |= 1u << (bits - 1 - b);
+            }
+        }
+        m_bitReverse[i] = reversed;
+    }
+
+    // Stufe mit Halblänge h beginnt bei Index h - 1
+    for (size_t half = 1; half < m_half; half <<= 1) {
+        for (size_t j = 0; j < half; j++) {
+            double angle = -PI * j / half;
+            m_stageRe.push_back(static_cast<float>(std::cos(angle)));
+            m_stageIm.push_back(static_cast<float>(std::sin(angle)));
+        }
+    }
+
+    m_splitRe.resize(m_half + 1);
+    m_splitIm.resize(m_half + 1);
+    for (size_t k = 0; k <= m_half; k++) {
+        double angle = -2.0 * PI * k / m_size;
+        m_splitRe[k] = static_cast<float>(std::cos(angle));
+        m_splitIm[k] = static_cast<float>(std::sin(angle));
+    }
+
+    m_workRe.resize(m_half);
+    m_workIm.resize(m_half);
+    m_outRe.resize(m_half + 1);
+    m_outIm.resize(m_half + 1);
+}
+
+void RealFFT::forward(const float* input, float* re, float* im) {
+    float* wr = m_workRe.data();
+    float* wi = m_workIm.data();
+    const size_t m = m_half;
+
+    // Gerade/ungerade Samples als Real-/Imaginärteil, gleich in Bit-Reverse-Reihenfolge
+    for (size_t i = 0; i < m; i++) {
+        uint32_t j = m_bitReverse[i];
+        wr[j] = input[2 * i];
+        wi[j] = input[2 * i + 1];
+    }
+
+    // Radix-2-Butterflies; ab Halblänge 4 vier Butterflies pro SSE-Schritt
+    for (size_t half = 1; half < m; half <<= 1) {
+        const float* tr = &m_stageRe[half - 1];
+        const float* ti = &m_stageIm[half - 1];
+        for (size_t start = 0; start < m; start += 2 * half) {
+            float* ar = wr + start;
+            float* ai = wi + start;
+            float* br = ar + half;
+            float* bi = ai + half;
+            size_t j = 0;
+#ifdef HS80_AUDIO_SSE
+            for (; j + 4 <= half; j += 4) {
+                __m128 xr = _mm_loadu_ps(br + j);
+                __m128 xi = _mm_loadu_ps(bi + j);
+                __m128 cr = _mm_loadu_ps(tr + j);
+                __m128 ci = _mm_loadu_ps(ti + j);
+                __m128 pr = _mm_sub_ps(_mm_mul_ps(xr, cr), _mm_mul_ps(xi, ci));
+                __m128 pi = _mm_add_ps(_mm_mul_ps(xr, ci), _mm_mul_ps(xi, cr));
+                __m128 ur = _mm_loadu_ps(ar + j);
+                __m128 ui = _mm_loadu_ps(ai + j);
+                _mm_storeu_ps(ar + j, _mm_add_ps(ur, pr));
+                _mm_storeu_ps(ai + j, _mm_add_ps(ui, pi));
+                _mm_storeu_ps(br + j, _mm_sub_ps(ur, pr));
+                _mm_storeu_ps(bi + j, _mm_sub_ps(ui, pi));
+            }
+#endif
+            for (; j < half; j++) {
+                float pr = br[j] * tr[j] - bi[j] * ti[j];
+                float pi = br[j] * ti[j] + bi[j] * tr[j];
+                float ur = ar[j];
+                float ui = ai[j];
+                ar[j] = ur + pr;
+                ai[j] = ui + pi;
+                br[j] = ur - pr;
+                bi[j] = ui - pi;
+            }
+        }
+    }
+
+    // Zerlegung: X[k] = E[k] + W^k * O[k] mit E/O aus Z[k] und conj(Z[m-k])
+    re[0] = wr[0] + wi[0];
+    im[0] = 0.0f;
+    re[m] = wr[0] - wi[0];
+    im[m] = 0.0f;
+    for (size_t k = 1; k < m; k++) {
+        float zr = wr[k], zi = wi[k];
+        float cr = wr[m - k], ci = -wi[m - k];
+        float er = 0.5f * (zr + cr);
+        float ei = 0.5f * (zi + ci);
+        float orr = 0.5f * (zi - ci);
+        float oi = -0.5f * (zr - cr);
+        re[k] = er + m_splitRe[k] * orr - m_splitIm[k] * oi;
+        im[k] = ei + m_splitRe[k] * oi + m_splitIm[k] * orr;
+    }
+}
+
+void RealFFT::power(const float* input, float* power) {
+    forward(input, m_outRe.data(), m_outIm.data());
+
+    const float* re = m_outRe.data();
+    const float* im = m_outIm.data();
+    const size_t count = m_half + 1;
+    size_t k = 0;
+#ifdef HS80_AUDIO_SSE
+    for (; k + 4 <= count; k += 4) {
+        __m128 r = _mm_loadu_ps(re + k);
+        __m128 i = _mm_loadu_ps(im + k);
+        _mm_storeu_ps(power + k, _mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(i, i)));
+    }
+#endif
+    for (; k < count; k++) {
+        power[k] = re[k] * re[k] + im[k] * im[k];
+    }
+}
+
+// ============================================================================
+// AudioAnalyzer
+// ============================================================================
+
+static float sumRange(const float* values, size_t begin, size_t end) {
+    float sum = 0.0f;
+    size_t i = begin;
+#ifdef HS80_AUDIO_SSE
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= end; i += 4) {
+        acc = _mm_add_ps(acc, _mm_loadu_ps(values + i));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < end; i++) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+AudioAnalyzer::AudioAnalyzer(uint32_t sampleRate, const AudioConfig& config)
+    : m_config(config)
+    , m_sampleRate(sampleRate > 0 ? sampleRate : 48000)
+    , m_fft(config.fftSize)
+    , m_filled(0)
+{
+    const size_t n = m_fft.size();
+    m_config.fftSize = n;
+    m_config.hopSize = std::max<size_t>(1, std::min(m_config.hopSize, n));
+
+    m_history.assign(n, 0.0f);
+    m_windowed.resize(n);
+    m_power.resize(m_fft.bins());
+
+    // Hann (periodisch)
+    m_window.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        m_window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * PI * i / n));
+    }
+
+    // Bin-Grenzen (DC auslassen), streng steigend und innerhalb des Spektrums
+    auto binFor = [&](float hz) {
+        size_t bin = static_cast<size_t>(hz * n / m_sampleRate) + 1;
+        return std::min(bin, m_fft.bins());
+    };
+    m_bandBins[0] = 1;
+    m_bandBins[1] = std::max(binFor(m_config.bassMaxHz), m_bandBins[0] + 1);
+    m_bandBins[2] = std::max(binFor(m_config.midMaxHz), m_bandBins[1] + 1);
+    m_bandBins[3] = std::max(binFor(m_config.trebleMaxHz), m_bandBins[2] + 1);
+    for (size_t& bin : m_bandBins) {
+        bin = std::min(bin, m_fft.bins());
+    }
+
+    for (int i = 0; i < 3; i++) {
+        m_peak[i] = 0.0f;
+        m_level[i] = 0.0f;
+    }
+}
+
+bool AudioAnalyzer::process(const float* samples, size_t count, int64_t sourceTicks) {
+    const size_t n = m_history.size();
+    const size_t hop = m_config.hopSize;
+    bool analyzed = false;
+
+    while (count > 0) {
+        size_t take = std::min(count, hop - m_filled);
+        memcpy(&m_history[n - hop + m_filled], samples, take * sizeof(float));
+        m_filled += take;
+        samples += take;
+        count -= take;
+
+        if (m_filled == hop) {
+            analyzeHop(sourceTicks);
+            memmove(m_history.data(), m_history.data() + hop, (n - hop) * sizeof(float));
+            m_filled = 0;
+            analyzed = true;
+        }
+    }
+    return analyzed;
+}
+
+void AudioAnalyzer::analyzeHop(int64_t sourceTicks) {
+    const size_t n = m_history.size();
+    const float* in = m_history.data();
+    const float* window = m_window.data();
+    float* out = m_windowed.data();
+
+    size_t i = 0;
+#ifdef HS80_AUDIO_SSE
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(in + i), _mm_loadu_ps(window + i)));
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = in[i] * window[i];
+    }
+
+    m_fft.power(out, m_power.data());
+
+    // Sinus mit Amplitude 1 ergibt ~1 pro Band (Hann-Fenster: |X| ~ n/4)
+    const float normalize = 16.0f / (static_cast<float>(n) * n);
+    const float minPeak = 1e-4f;   // -40 dB: Rauschen nicht hochregeln
+    float* levels[3] = { &m_bands.bass, &m_bands.mid, &m_bands.treble };
+    for (int band = 0; band < 3; band++) {
+        float energy = sumRange(m_power.data(), m_bandBins[band], m_bandBins[band + 1]) * normalize;
+
+        m_peak[band] = std::max(std::max(energy, m_peak[band] * m_config.peakDecay), minPeak);
+        float level = std::min(std::sqrt(energy / m_peak[band]), 1.0f);
+
+        // Sofortiger Anstieg, gleitendes Abklingen
+        if (level >= m_level[band]) {
+            m_level[band] = level;
+        } else {
+            m_level[band] = m_level[band] * m_config.release + level * (1.0f - m_config.release);
+        }
+        *levels[band] = m_level[band];
+    }
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    m_bands.hop++;
+    m_bands.sourceTicks = sourceTicks;
+    m_bands.publishTicks = now.QuadPart;
+}
+
+// ============================================================================
+// PCM-Quellen
+// ============================================================================
+
+HandlePcmSource::HandlePcmSource()
+    : m_handle(INVALID_HANDLE_VALUE)
+    , m_ownsHandle(false)
+    , m_sampleRate(48000)
+    , m_channels(2)
+    , m_format(PcmSampleFormat::Int16)
+    , m_remainingBytes(UINT64_MAX)
+    , m_rawBytes(0) {
+}
+
+HandlePcmSource::~HandlePcmSource() {
+    close();
+}
+
+void HandlePcmSource::close() {
+    if (m_handle != INVALID_HANDLE_VALUE && m_ownsHandle) {
+        CloseHandle(m_handle);
+    }
+    m_handle = INVALID_HANDLE_VALUE;
+    m_ownsHandle = false;
+    m_rawBytes = 0;
+}
+
+size_t HandlePcmSource::frameBytes() const {
+    return m_channels * (m_format == PcmSampleFormat::Int16 ? 2 : 4);
+}
+
+size_t HandlePcmSource::read(float* samples, size_t maxFrames) {
+    if (m_handle == INVALID_HANDLE_VALUE || maxFrames == 0 || m_channels == 0) {
+        return 0;
+    }
+
+    const size_t frame = frameBytes();
+    const size_t wanted = maxFrames * frame;
+    if (m_raw.size() < wanted) {
+        m_raw.resize(wanted);
+    }
+
+    // Pipes liefern, was gerade anliegt - auch halbe Frames
+    while (m_rawBytes < frame) {
+        uint64_t toRead = std::min<uint64_t>(wanted - m_rawBytes, m_remainingBytes);
+        if (toRead == 0) {
+            return 0;
+        }
+        DWORD got = 0;
+        if (!ReadFile(m_handle, m_raw.data() + m_rawBytes, static_cast<DWORD>(toRead), &got, nullptr) || got == 0) {
+            return 0;   // Ende, Pipe geschlossen oder abgebrochen
+        }
+        m_rawBytes += got;
+        if (m_remainingBytes != UINT64_MAX) {
+            m_remainingBytes -= got;
+        }
+    }
+
+    const size_t frames = m_rawBytes / frame;
+    const float channelScale = 1.0f / m_channels;
+    const uint8_t* raw = m_raw.data();
+    for (size_t f = 0; f < frames; f++) {
+        float sum = 0.0f;
+        for (uint16_t c = 0; c < m_channels; c++) {
+            if (m_format == PcmSampleFormat::Int16) {
+                int16_t value;
+                memcpy(&value, raw + (f * m_channels + c) * 2, sizeof(value));
+                sum += value * (1.0f / 32768.0f);
+            } else {
+                float value;
+                memcpy(&value, raw + (f * m_channels + c) * 4, sizeof(value));
+                sum += value;
+            }
+        }
+        samples[f] = sum * channelScale;
+    }
+
+    size_t leftover = m_rawBytes - frames * frame;
+    memmove(m_raw.data(), m_raw.data() + frames * frame, leftover);
+    m_rawBytes = leftover;
+    return frames;
+}
+
+PipePcmSource::PipePcmSource(uint32_t sampleRate, uint16_t channels, PcmSampleFormat format) {
+    m_sampleRate = sampleRate;
+    m_channels = channels;
+    m_format = format;
+}
+
+bool PipePcmSource::open(const std::string& path) {
+    close();
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        std::cerr << "[AUDIO] Pipe konnte nicht geoeffnet werden: " << path << std::endl;
+        return false;
+    }
+    m_handle = handle;
+    m_ownsHandle = true;
+    return true;
+}
+
+bool PipePcmSource::attach(HANDLE handle) {
+    close();
+    if (handle == INVALID_HANDLE_VALUE || handle == nullptr) {
+        return false;
+    }
+    m_handle = handle;
+    m_ownsHandle = false;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// WAV
+// ---------------------------------------------------------------------------
+
+static bool readExact(HANDLE handle, void* buffer, DWORD size) {
+    uint8_t* out = static_cast<uint8_t*>(buffer);
+    while (size > 0) {
+        DWORD got = 0;
+        if (!ReadFile(handle, out, size, &got, nullptr) || got == 0) {
+            return false;
+        }
+        out += got;
+        size -= got;
+    }
+    return true;
+}
+
+WavFileSource::WavFileSource()
+    : m_realtime(false)
+    , m_startTicks(0)
+    , m_delivered(0) {
+    QueryPerformanceFrequency(&m_qpcFrequency);
+}
+
+bool WavFileSource::open(const std::string& path) {
+    close();
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        std::cerr << "[AUDIO] WAV-Datei nicht gefunden: " << path << std::endl;
+        return false;
+    }
+    m_handle = handle;
+    m_ownsHandle = true;
+
+    uint8_t riff[12];
+    if (!readExact(handle, riff, sizeof(riff)) || memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0) {
+        std::cerr << "[AUDIO] Keine WAV-Datei: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    bool haveFormat = false;
+    while (true) {
+        uint8_t chunk[8];
+        if (!readExact(handle, chunk, sizeof(chunk))) {
+            break;
+        }
+        uint32_t size;
+        memcpy(&size, chunk + 4, sizeof(size));
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16 && size <= 64) {
+            uint8_t fmt[64];
+            if (!readExact(handle, fmt, size + (size & 1))) {
+                break;
+            }
+            uint16_t tag, channels, bits;
+            uint32_t rate;
+            memcpy(&tag, fmt, 2);
+            memcpy(&channels, fmt + 2, 2);
+            memcpy(&rate, fmt + 4, 4);
+            memcpy(&bits, fmt + 14, 2);
+            if (tag == 0xFFFE && size >= 26) {
+                memcpy(&tag, fmt + 24, 2);  // WAVE_FORMAT_EXTENSIBLE: Subformat
+            }
+
+            if (tag == 1 && bits == 16) {
+                m_format = PcmSampleFormat::Int16;
+            } else if (tag == 3 && bits == 32) {
+                m_format = PcmSampleFormat::Float32;
+            } else {
+                std::cerr << "[AUDIO] Nicht unterstuetztes WAV-Format (Tag " << tag << ", " << bits << " Bit)" << std::endl;
+                close();
+                return false;
+            }
+            m_channels = channels;
+            m_sampleRate = rate;
+            haveFormat = channels > 0 && rate > 0;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!haveFormat) {
+                break;
+            }
+            m_remainingBytes = size;
+            m_rawBytes = 0;
+            m_delivered = 0;
+            m_startTicks = 0;
+            return true;
+        } else {
+            // Unbekannter Chunk (LIST, fact, ...): überspringen, Größe ist gerade aufgefüllt
+            uint8_t skip[256];
+            uint32_t left = size + (size & 1);
+            while (left > 0) {
+                DWORD part = std::min<uint32_t>(left, sizeof(skip));
+                if (!readExact(handle, skip, part)) {
+                    left = 0;
+                    break;
+                }
+                left -= part;
+            }
+        }
+    }
+
+    std::cerr << "[AUDIO] WAV-Datei ohne fmt/data: " << path << std::endl;
+    close();
+    return false;
+}
+
+size_t WavFileSource::read(float* samples, size_t maxFrames) {
+    if (m_realtime) {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        if (m_startTicks == 0) {
+            m_startTicks = now.QuadPart;
+        }
+
+        // Nicht schneller liefern als abgespielt wird
+        int64_t due = m_startTicks + static_cast<int64_t>(m_delivered * m_qpcFrequency.QuadPart / m_sampleRate);
+        if (due > now.QuadPart) {
+            Sleep(static_cast<DWORD>((due - now.QuadPart) * 1000 / m_qpcFrequency.QuadPart));
+        }
+    }
+
+    size_t frames = HandlePcmSource::read(samples, maxFrames);
+    m_delivered += frames;
+    return frames;
+}
+
+// ============================================================================
+// AudioPipeline
+// ============================================================================
+
+AudioPipeline::AudioPipeline(const AudioConfig& config)
+    : m_config(config)
+    , m_thread(nullptr)
+    , m_stop(false)
+    , m_running(false)
+    , m_startTicks(0)
+    , m_lastTicks(0)
+    , m_statSamples(0)
+{
+    InitializeCriticalSection(&m_lock);
+    QueryPerformanceFrequency(&m_qpcFrequency);
+}
+
+AudioPipeline::~AudioPipeline() {
+    stop();
+    DeleteCriticalSection(&m_lock);
+}
+
+bool AudioPipeline::start(std::unique_ptr<PcmSource> source) {
+    if (!source) {
+        return false;
+    }
+    stop();
+
+    m_source = std::move(source);
+    m_analyzer.reset(new AudioAnalyzer(m_source->sampleRate(), m_config));
+
+    EnterCriticalSection(&m_lock);
+    m_bands = AudioBands();
+    m_startTicks = 0;
+    m_lastTicks = 0;
+    LeaveCriticalSection(&m_lock);
+    m_statSamples = 0;
+    m_analyzeTime.reset();
+
+    m_stop = false;
+    m_running = true;
+    m_thread = CreateThread(nullptr, 0, AudioThreadProc, this, 0, nullptr);
+    if (!m_thread) {
+        std::cerr << "[AUDIO] Fehler beim Erstellen des Audio-Threads!" << std::endl;
+        m_running = false;
+        return false;
+    }
+    return true;
+}
+
+void AudioPipeline::stop() {
+    if (!m_thread) {
+        return;
+    }
+
+    m_stop = true;
+    // Blockierendes ReadFile auf der Pipe abbrechen. Ein Abbruch wirkt nur auf
+    // ein bereits laufendes ReadFile - steht der Thread zwischen Prüfung von
+    // m_stop und Aufruf, wiederholen, bis er endet.
+    do {
+        CancelSynchronousIo(m_thread);
+    } while (WaitForSingleObject(m_thread, 10) == WAIT_TIMEOUT);
+    CloseHandle(m_thread);
+    m_thread = nullptr;
+    m_source.reset();
+}
+
+bool AudioPipeline::wait(DWORD timeoutMs) {
+    if (!m_thread) {
+        return true;
+    }
+    return WaitForSingleObject(m_thread, timeoutMs) == WAIT_OBJECT_0;
+}
+
+DWORD WINAPI AudioPipeline::AudioThreadProc(LPVOID param) {
+    static_cast<AudioPipeline*>(param)->audioLoop();
+    return 0;
+}
+
+void AudioPipeline::audioLoop() {
+    // Ein Hop pro Lesevorgang: neue Samples werden sofort analysiert
+    std::vector<float> buffer(m_analyzer->config().hopSize);
+
+    while (!m_stop) {
+        size_t frames = m_source->read(buffer.data(), buffer.size());
+        if (frames == 0) {
+            break;
+        }
+
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        bool analyzed = m_analyzer->process(buffer.data(), frames, now.QuadPart);
+        m_statSamples.fetch_add(frames, std::memory_order_relaxed);
+
+        EnterCriticalSection(&m_lock);
+        if (m_startTicks == 0) {
+            m_startTicks = now.QuadPart;
+        }
+        m_lastTicks = now.QuadPart;
+        if (analyzed) {
+            m_bands = m_analyzer->bands();
+        }
+        LeaveCriticalSection(&m_lock);
+
+        if (analyzed) {
+            const AudioBands& bands = m_analyzer->bands();
+            m_analyzeTime.record(static_cast<uint64_t>((bands.publishTicks - bands.sourceTicks) * 1000000000LL / m_qpcFrequency.QuadPart));
+        }
+    }
+
+    m_running = false;
+}
+
+AudioBands AudioPipeline::latest() const {
+    EnterCriticalSection(&m_lock);
+    AudioBands bands = m_bands;
+    LeaveCriticalSection(&m_lock);
+    return bands;
+}
+
+AudioPipelineStats AudioPipeline::getStats() const {
+    AudioPipelineStats stats;
+    stats.samples = m_statSamples.load(std::memory_order_relaxed);
+    stats.analyzeTime = m_analyzeTime.snapshot();
+
+    EnterCriticalSection(&m_lock);
+    stats.hops = m_bands.hop;
+    int64_t elapsed = m_lastTicks - m_startTicks;
+    LeaveCriticalSection(&m_lock);
+
+    stats.samplesPerSecond = elapsed > 0 ? stats.samples * static_cast<double>(m_qpcFrequency.QuadPart) / elapsed : 0.0;
+    return stats;
+}
+
+// ============================================================================
+// AudioReactiveEffect
+// ============================================================================
+
+AudioReactiveEffect::AudioReactiveEffect(std::shared_ptr<AudioPipeline> pipeline, const AudioZoneColors& colors)
+    : m_pipeline(pipeline)
+    , m_colors(colors)
+    , m_lastHop(0) {
+    QueryPerformanceFrequency(&m_qpcFrequency);
+}
+
+static uint16_t levelToBrightness(float level) {
+    return static_cast<uint16_t>(std::min(std::max(level, 0.0f), 1.0f) * Color::BRIGHTNESS_ONE + 0.5f);
+}
+
+EffectStatus AudioReactiveEffect::render(const FrameContext&, LEDZones& zones) {
+    if (!m_pipeline || !m_pipeline->isRunning()) {
+        zones = LEDZones(RGBColor(0, 0, 0));
+        return EffectStatus::Finished;
+    }
+
+    AudioBands bands = m_pipeline->latest();
+    zones.logo = Color::scale(m_colors.bass, levelToBrightness(bands.bass));
+    zones.power = Color::scale(m_colors.mid, levelToBrightness(bands.mid));
+    zones.mic = Color::scale(m_colors.treble, levelToBrightness(bands.treble));
+
+    // Alter des Spektrums beim ersten Frame, der es zeigt
+    if (bands.hop != m_lastHop && bands.sourceTicks != 0) {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        m_audioToFrame.record(static_cast<uint64_t>((now.QuadPart - bands.sourceTicks) * 1000000000LL / m_qpcFrequency.QuadPart));
+        m_lastHop = bands.hop;
+    }
+    return EffectStatus::Running;
+}
+
+} // namespace HS80
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "HS80_Animation.h"
+#include <string>
+#include <vector>
+
+// ============================================================================
+// HS80 Audio - Audio-reaktive Beleuchtung
+// ============================================================================
+//
+// PCM-Quelle (WAV-Datei oder Pipe) -> AudioPipeline-Thread -> AudioAnalyzer
+// (Hann-Fenster, reelle FFT mit SSE, Bandenergien) -> AudioReactiveEffect im
+// Animation-Thread:
+//
+//   Bass   (bis 250 Hz)     -> Logo
+//   Mitten (bis 4 kHz)      -> Power
+//   Höhen  (bis 16 kHz)     -> Mic
+//
+// Latenz: Der Analyzer rechnet alle hopSize Samples (128 @ 48 kHz = 2.7 ms)
+// ein neues Spektrum über die letzten fftSize Samples (512 = 10.7 ms). Der
+// Effekt liest beim Rendern nur das zuletzt veröffentlichte Ergebnis; die
+// zusätzliche Latenz ist also Hop + Rechenzeit (µs) + höchstens ein
+// Frame-Intervall. Für < 10 ms den Effekt mit 5 ms Intervall starten.
+// ============================================================================
+
+namespace HS80 {
+
+// ---------------------------------------------------------------------------
+// Reelle FFT (Länge n = Zweierpotenz) über eine komplexe FFT der Länge n/2
+// ---------------------------------------------------------------------------
+class RealFFT {
+private:
+    size_t m_size;                  // n (reell)
+    size_t m_half;                  // n/2 (komplex)
+    std::vector<uint32_t> m_bitReverse;
+    std::vector<float> m_stageRe;   // Twiddles pro Stufe, zusammenhängend (SSE-Loads)
+    std::vector<float> m_stageIm;
+    std::vector<float> m_splitRe;   // W_n^k für die Zerlegung in das reelle Spektrum
+    std::vector<float> m_splitIm;
+    std::vector<float> m_workRe;
+    std::vector<float> m_workIm;
+    std::vector<float> m_outRe;
+    std::vector<float> m_outIm;
+
+public:
+    explicit RealFFT(size_t size = 1024);
+
+    size_t size() const { return m_size; }
+    size_t bins() const { return m_half + 1; }
+
+    // Spektrum X[0..n/2] (re/im je bins() Einträge)
+    void forward(const float* input, float* re, float* im);
+
+    // |X[k]|^2 für k = 0..n/2
+    void power(const float* input, float* power);
+};
+
+// ---------------------------------------------------------------------------
+// Analyse
+// ---------------------------------------------------------------------------
+
+struct AudioConfig {
+    size_t fftSize;         // Fensterlänge (Zweierpotenz)
+    size_t hopSize;         // Neues Spektrum alle hopSize Samples
+    float bassMaxHz;
+    float midMaxHz;
+    float trebleMaxHz;
+    float release;          // Abklingen pro Hop (0-1), Anstieg ist sofort
+    float peakDecay;        // Abklingen der Auto-Gain-Spitze pro Hop
+
+    AudioConfig() : fftSize(512), hopSize(128), bassMaxHz(250.0f), midMaxHz(4000.0f),
+                    trebleMaxHz(16000.0f), release(0.8f), peakDecay(0.999f) {}
+};
+
+// Pegel 0-1 pro Band (auto-normalisiert)
+struct AudioBands {
+    float bass;
+    float mid;
+    float treble;
+    uint64_t hop;           // Laufende Nummer, 0 = noch keine Analyse
+    int64_t sourceTicks;    // QPC: letzte Samples dieses Hops gelesen
+    int64_t publishTicks;   // QPC: Ergebnis veröffentlicht
+
+    AudioBands() : bass(0), mid(0), treble(0), hop(0), sourceTicks(0), publishTicks(0) {}
+};
+
+// FFT + Bänder, ohne Threads (füttert AudioPipeline, auch direkt nutzbar)
+class AudioAnalyzer {
+private:
+    AudioConfig m_config;
+    uint32_t m_sampleRate;
+    RealFFT m_fft;
+
+    std::vector<float> m_history;   // Letzte fftSize Samples
+    size_t m_filled;                // Neue Samples seit dem letzten Hop
+    std::vector<float> m_window;    // Hann
+    std::vector<float> m_windowed;
+    std::vector<float> m_power;
+
+    size_t m_bandBins[4];           // Bin-Grenzen: [0]-[1] Bass, [1]-[2] Mitten, [2]-[3] Höhen
+    float m_peak[3];
+    float m_level[3];
+    AudioBands m_bands;
+
+    void analyzeHop(int64_t sourceTicks);
+
+public:
+    AudioAnalyzer(uint32_t sampleRate, const AudioConfig& config = AudioConfig());
+
+    // Mono-Samples (-1..1); true = mindestens ein neues Spektrum
+    bool process(const float* samples, size_t count, int64_t sourceTicks = 0);
+
+    const AudioBands& bands() const { return m_bands; }
+    uint32_t sampleRate() const { return m_sampleRate; }
+    const AudioConfig& config() const { return m_config; }
+};
+
+// ---------------------------------------------------------------------------
+// PCM-Quellen
+// ---------------------------------------------------------------------------
+
+enum class PcmSampleFormat {
+    Int16,
+    Float32
+};
+
+class PcmSource {
+public:
+    virtual ~PcmSource() = default;
+    virtual uint32_t sampleRate() const = 0;
+
+    // Bis zu maxFrames Mono-Samples (-1..1), blockiert; 0 = Ende oder Fehler
+    virtual size_t read(float* samples, size_t maxFrames) = 0;
+};
+
+// Gemeinsamer Lesepfad für Dateien und Pipes (ReadFile auf einem HANDLE)
+class HandlePcmSource : public PcmSource {
+protected:
+    HANDLE m_handle;
+    bool m_ownsHandle;
+    uint32_t m_sampleRate;
+    uint16_t m_channels;
+    PcmSampleFormat m_format;
+    uint64_t m_remainingBytes;          // Datenende (WAV), sonst unbegrenzt
+    std::vector<uint8_t> m_raw;
+    size_t m_rawBytes;                  // Angefangener Frame aus dem letzten ReadFile
+
+    size_t frameBytes() const;
+
+public:
+    HandlePcmSource();
+    ~HandlePcmSource();
+
+    HandlePcmSource(const HandlePcmSource&) = delete;
+    HandlePcmSource& operator=(const HandlePcmSource&) = delete;
+
+    void close();
+    bool isOpen() const { return m_handle != INVALID_HANDLE_VALUE; }
+
+    uint32_t sampleRate() const override { return m_sampleRate; }
+    uint16_t channels() const { return m_channels; }
+    size_t read(float* samples, size_t maxFrames) override;
+};
+
+// Rohes PCM (ohne Header) aus einer Named Pipe, stdin oder einem Pipe-HANDLE
+class PipePcmSource : public HandlePcmSource {
+public:
+    PipePcmSource(uint32_t sampleRate = 48000, uint16_t channels = 2,
+                  PcmSampleFormat format = PcmSampleFormat::Int16);
+
+    bool open(const std::string& path);     // z.B. \\.\pipe\hs80audio
+    bool attach(HANDLE handle);             // Wird nicht geschlossen (stdin, CreatePipe)
+};
+
+// WAV (PCM 16 Bit oder Float 32 Bit, beliebige Kanalzahl -> Mono)
+class WavFileSource : public HandlePcmSource {
+private:
+    bool m_realtime;
+    int64_t m_startTicks;
+    uint64_t m_delivered;
+    LARGE_INTEGER m_qpcFrequency;
+
+public:
+    WavFileSource();
+
+    bool open(const std::string& path);
+    void setRealtime(bool realtime) { m_realtime = realtime; }  // Lesen im Abspieltempo
+    size_t read(float* samples, size_t maxFrames) override;
+};
+
+// ---------------------------------------------------------------------------
+// Pipeline und Effekt
+// ---------------------------------------------------------------------------
+
+struct AudioPipelineStats {
+    uint64_t samples;
+    uint64_t hops;
+    double samplesPerSecond;        // Durchsatz seit start()
+    LatencySnapshot analyzeTime;    // Samples gelesen -> Bänder veröffentlicht
+};
+
+// Liest eine PcmSource in einem eigenen Thread und veröffentlicht die Bänder
+class AudioPipeline {
+private:
+    AudioConfig m_config;
+    std::unique_ptr<PcmSource> m_source;
+    std::unique_ptr<AudioAnalyzer> m_analyzer;
+
+    HANDLE m_thread;
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_running;
+    mutable CRITICAL_SECTION m_lock;
+    AudioBands m_bands;
+
+    LARGE_INTEGER m_qpcFrequency;
+    int64_t m_startTicks;
+    int64_t m_lastTicks;
+    std::atomic<uint64_t> m_statSamples;
+    LatencyHistogram m_analyzeTime;
+
+    static DWORD WINAPI AudioThreadProc(LPVOID param);
+    void audioLoop();
+
+public:
+    explicit AudioPipeline(const AudioConfig& config = AudioConfig());
+    ~AudioPipeline();
+
+    AudioPipeline(const AudioPipeline&) = delete;
+    AudioPipeline& operator=(const AudioPipeline&) = delete;
+
+    bool start(std::unique_ptr<PcmSource> source);
+    void stop();
+    bool wait(DWORD timeoutMs = INFINITE);
+    bool isRunning() const { return m_running; }
+
+    AudioBands latest() const;
+    AudioPipelineStats getStats() const;
+};
+
+// Farben pro Zone, skaliert mit dem Pegel des zugeordneten Bands
+struct AudioZoneColors {
+    RGBColor bass;      // Logo
+    RGBColor mid;       // Power
+    RGBColor treble;    // Mic
+
+    AudioZoneColors() : bass(255, 0, 0), mid(0, 255, 0), treble(0, 80, 255) {}
+};
+
+class AudioReactiveEffect : public Effect {
+private:
+    std::shared_ptr<AudioPipeline> m_pipeline;
+    AudioZoneColors m_colors;
+    LARGE_INTEGER m_qpcFrequency;
+    LatencyHistogram m_audioToFrame;    // Samples gelesen -> Frame gerendert
+    uint64_t m_lastHop;
+
+public:
+    AudioReactiveEffect(std::shared_ptr<AudioPipeline> pipeline, const AudioZoneColors& colors = AudioZoneColors());
+
+    // Endet mit einem dunklen Frame, sobald die Quelle zu Ende ist
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override;
+
+    LatencySnapshot audioToFrame() const { return m_audioToFrame.snapshot(); }
+};
+
+} // namespace HS80
@@ -0,0 +1,230 @@
+#include "HS80_Calibration.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace HS80 {
+
+// ============================================================================
+// Profil
+// ============================================================================
+
+ZoneCalibration::ZoneCalibration() {
+    for (int out = 0; out < 3; out++) {
+        for (int in = 0; in < 3; in++) {
+            matrix[out][in] = out == in ? 1.0f : 0.0f;
+        }
+        gain[out] = 1.0f;
+        gamma[out] = 1.0f;
+    }
+}
+
+bool ZoneCalibration::isIdentity() const {
+    for (int out = 0; out < 3; out++) {
+        for (int in = 0; in < 3; in++) {
+            if (matrix[out][in] != (out == in ? 1.0f : 0.0f)) return false;
+        }
+        if (gain[out] != 1.0f || gamma[out] != 1.0f) return false;
+    }
+    return true;
+}
+
+bool CalibrationProfile::isIdentity() const {
+    return zones[0].isIdentity() && zones[1].isIdentity() && zones[2].isIdentity();
+}
+
+bool CalibrationProfile::parse(std::istream& input, std::string& error) {
+    *this = CalibrationProfile();
+
+    std::string line;
+    int lineNumber = 0;
+
+    auto fail = [&](const std::string& message) {
+        error = "Zeile " + std::to_string(lineNumber) + ": " + message;
+        *this = CalibrationProfile();
+        return false;
+    };
+
+    while (std::getline(input, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+
+        std::istringstream words(line);
+        std::string zone, command;
+        if (!(words >> zone)) {
+            continue;
+        }
+
+        int first, last;
+        if (zone == "logo")       first = last = 0;
+        else if (zone == "power") first = last = 1;
+        else if (zone == "mic")   first = last = 2;
+        else if (zone == "all")   { first = 0; last = 2; }
+        else return fail("Unbekannte Zone '" + zone + "'");
+
+        if (!(words >> command)) {
+            return fail("Erwartet: <zone> matrix|gain|gamma <werte>");
+        }
+
+        float values[9];
+        int count = command == "matrix" ? 9 : 3;
+        for (int i = 0; i < count; i++) {
+            if (!(words >> values[i])) {
+                return fail(std::to_string(count) + " Zahlen nach '" + command + "' erwartet");
+            }
+        }
+        std::string extra;
+        if (words >> extra) {
+            return fail("Unerwartet: '" + extra + "'");
+        }
+
+        for (int z = first; z <= last; z++) {
+            ZoneCalibration& calibration = zones[z];
+            if (command == "matrix") {
+                for (int i = 0; i < 9; i++) {
+                    if (values[i] < -4.0f || values[i] > 4.0f) return fail("Matrix-Werte -4 bis 4 erwartet");
+                    calibration.matrix[i / 3][i % 3] = values[i];
+                }
+            } else if (command == "gain") {
+                for (int i = 0; i < 3; i++) {
+                    if (values[i] < 0.0f || values[i] > 4.0f) return fail("gain 0 bis 4 erwartet");
+                    calibration.gain[i] = values[i];
+                }
+            } else if (command == "gamma") {
+                for (int i = 0; i < 3; i++) {
+                    if (values[i] < 0.2f || values[i] > 5.0f) return fail("gamma 0.2 bis 5 erwartet");
+                    calibration.gamma[i] = values[i];
+                }
+            } else {
+                return fail("Unbekannter Befehl '" + command + "'");
+            }
+        }
+    }
+    return true;
+}
+
+bool CalibrationProfile::loadFile(const std::string& path, std::string& error) {
+    std::ifstream input(path);
+    if (!input.is_open()) {
+        error = "Kann " + path + " nicht oeffnen";
+        *this = CalibrationProfile();
+        return false;
+    }
+    return parse(input, error);
+}
+
+void CalibrationProfile::write(std::ostream& output) const {
+    static const char* names[3] = { "logo", "power", "mic" };
+    output << "# HS80 Kalibrierung (Format siehe HS80_Calibration.h)\n";
+    for (int z = 0; z < 3; z++) {
+        const ZoneCalibration& calibration = zones[z];
+        output << std::setprecision(6) << names[z] << " matrix";
+        for (int i = 0; i < 9; i++) {
+            output << (i % 3 == 0 ? "  " : " ") << calibration.matrix[i / 3][i % 3];
+        }
+        output << "\n" << names[z] << " gain " << calibration.gain[0] << " " << calibration.gain[1] << " " << calibration.gain[2];
+        output << "\n" << names[z] << " gamma " << calibration.gamma[0] << " " << calibration.gamma[1] << " " << calibration.gamma[2] << "\n";
+    }
+}
+
+bool CalibrationProfile::saveFile(const std::string& path, std::string& error) const {
+    // Erst vollständig schreiben, dann ersetzen: ein laufender loadFile() sieht nie eine halbe Datei
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream output(temp, std::ios::trunc);
+        if (!output.is_open()) {
+            error = "Kann " + temp + " nicht schreiben";
+            return false;
+        }
+        write(output);
+        if (!output.good()) {
+            error = "Fehler beim Schreiben von " + temp;
+            return false;
+        }
+    }
+    if (!MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        error = "Kann " + path + " nicht ersetzen (Fehler " + std::to_string(GetLastError()) + ")";
+        DeleteFileA(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::string CalibrationProfile::pathFor(const std::string& directory, const std::string& deviceId) {
+    std::string name;
+    for (char c : deviceId) {
+        bool safe = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-' || c == '_';
+        name += safe ? c : '_';
+    }
+    if (name.empty()) {
+        name = "unbekannt";
+    }
+    return directory + "\\" + name + ".txt";
+}
+
+// ============================================================================
+// Tabellen
+// ============================================================================
+
+CalibrationTables::CalibrationTables(const CalibrationProfile& profile) {
+    for (int z = 0; z < 3; z++) {
+        const ZoneCalibration& calibration = profile.zones[z];
+
+        // Matrix: Beitrag jedes Eingangswerts zu jedem Ausgang, vorskaliert in Q4
+        for (int in = 0; in < 3; in++) {
+            for (int value = 0; value < 256; value++) {
+                for (int out = 0; out < 3; out++) {
+                    m_mix[z][in][value][out] = static_cast<int16_t>(std::lround(calibration.matrix[out][in] * value * 16.0f));
+                }
+                m_mix[z][in][value][3] = 0;
+            }
+        }
+
+        // Kurve pro Ausgang über die Summe (Q4)
+        for (int out = 0; out < 3; out++) {
+            for (int sum = 0; sum < CURVE_SIZE; sum++) {
+                double x = sum / (16.0 * 255.0);
+                double y = calibration.gain[out] * std::pow(std::min(1.0, x), static_cast<double>(calibration.gamma[out]));
+                m_curve[z][out][sum] = static_cast<uint16_t>(std::min(255.0 * 256.0, std::floor(y * 255.0 * 256.0 + 0.5)));
+            }
+        }
+    }
+}
+
+void CalibrationTables::apply(unsigned char* rgb) const {
+    for (int z = 0; z < 3; z++) {
+        const int16_t* r = m_mix[z][0][rgb[z]];
+        const int16_t* g = m_mix[z][1][rgb[3 + z]];
+        const int16_t* b = m_mix[z][2][rgb[6 + z]];
+        for (int out = 0; out < 3; out++) {
+            int sum = std::max(0, std::min(CURVE_SIZE - 1, r[out] + g[out] + b[out]));
+            rgb[out * 3 + z] = static_cast<unsigned char>((m_curve[z][out][sum] + 128) >> 8);
+        }
+    }
+}
+
+void CalibrationTables::apply(unsigned char* rgb, int hardware, int user) const {
+    if (hardware <= 0 || user <= 0 || hardware == user) {
+        apply(rgb);
+        return;
+    }
+    for (int z = 0; z < 3; z++) {
+        const int16_t* r = m_mix[z][0][rgb[z]];
+        const int16_t* g = m_mix[z][1][rgb[3 + z]];
+        const int16_t* b = m_mix[z][2][rgb[6 + z]];
+        for (int out = 0; out < 3; out++) {
+            // Summe sichtbar machen, Kurve, zurück auf die Hardware-Helligkeit
+            int sum = std::max(0, r[out] + g[out] + b[out]);
+            sum = std::min(CURVE_SIZE - 1, (sum * hardware + user / 2) / user);
+            int value = (m_curve[z][out][sum] * user + 128 * hardware) / (256 * hardware);
+            rgb[out * 3 + z] = static_cast<unsigned char>(std::min(255, value));
+        }
+    }
+}
+
+} // namespace HS80
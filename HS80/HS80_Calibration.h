@@ -0,0 +1,81 @@
+#pragma once
+
+#include "HS80_Library.h"
+#include <istream>
+#include <ostream>
+
+// ============================================================================
+// HS80 Calibration - Farbkorrektur pro Zone und Gerät
+// ============================================================================
+//
+// Logo-, Power- und Mic-LED haben unterschiedliche Weißpunkte (und streuen
+// von Headset zu Headset). Ein Kalibrierprofil beschreibt pro Zone:
+//
+//   Ausgang = gain * (matrix * Eingang) ^ gamma      (pro Kanal, Werte 0-1)
+//
+// Die Matrix korrigiert Weißpunkt und Übersprechen, gain/gamma die Kennlinie
+// der einzelnen LED. CalibrationTables kompiliert das Profil in Tabellen:
+// pro Zone und Eingangskanal die vorskalierten Beiträge zu R, G, B (Q4) und
+// pro Ausgangskanal die Kurve (Q8.8). Ein Farbpaket kostet damit immer 27 + 9
+// Tabellenzugriffe, unabhängig vom Profil - keine Gleitkommarechnung pro Frame.
+//
+// Die Kurve gilt für sichtbare Werte: ist die Hardware-Helligkeit unter die
+// eingestellte abgesenkt (Dithering), wird die Summe vorher auf die eingestellte
+// Helligkeit umgerechnet und das Ergebnis wieder zurück (gamma ist nicht
+// skalierungs-invariant).
+//
+// Profile liegen pro physischem Gerät als Textdatei <Verzeichnis>\<deviceId>.txt
+// (deviceId = HID-Seriennummer, siehe RGBController::deviceId()):
+//
+//   # Weißpunkt Logo zu blau, Mic-LED zu hell
+//   logo  matrix 1 0 0  0 0.94 0  0 0 0.82
+//   mic   gain 0.9 0.9 0.9
+//   power gamma 1 1 1.1
+//   all   gain 1 1 1               # all = alle drei Zonen
+// ============================================================================
+
+namespace HS80 {
+
+constexpr const char* CALIBRATION_DIRECTORY = "calibration";
+
+struct ZoneCalibration {
+    float matrix[3][3];         // Zeile = Ausgang R/G/B, Spalte = Eingang R/G/B
+    float gain[3];
+    float gamma[3];
+
+    ZoneCalibration();          // Identität
+    bool isIdentity() const;
+};
+
+struct CalibrationProfile {
+    ZoneCalibration zones[3];   // Logo, Power, Mic
+
+    bool isIdentity() const;
+
+    // Text-Format siehe oben; bei Fehler bleibt das Profil die Identität
+    bool parse(std::istream& input, std::string& error);
+    bool loadFile(const std::string& path, std::string& error);
+    void write(std::ostream& output) const;
+    bool saveFile(const std::string& path, std::string& error) const;
+
+    // Datei des Geräts (deviceId auf Dateinamen-Zeichen reduziert)
+    static std::string pathFor(const std::string& directory, const std::string& deviceId);
+};
+
+class CalibrationTables {
+public:
+    static constexpr int CURVE_SIZE = 4096;     // Summe in Q4 (0-255.9375)
+
+    explicit CalibrationTables(const CalibrationProfile& profile);
+
+    // 9 Bytes in Paket-Reihenfolge: R(Logo, Power, Mic), G(...), B(...)
+    void apply(unsigned char* rgb) const;
+    // Gerätewerte bei Hardware-Helligkeit hardware, sichtbar bei user (0-1000)
+    void apply(unsigned char* rgb, int hardware, int user) const;
+
+private:
+    int16_t m_mix[3][3][256][4];                // [Zone][Eingang][Wert] -> Beitrag zu R, G, B (Q4)
+    uint16_t m_curve[3][3][CURVE_SIZE];         // [Zone][Ausgang][Summe] -> Q8.8
+};
+
+} // namespace HS80
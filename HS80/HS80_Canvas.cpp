@@ -0,0 +1,581 @@
+#include "HS80_Canvas.h"
+#include <iostream>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HS80_CANVAS_SSE2 1
+#endif
+
+namespace HS80 {
+
+// Mittelung, bei der der Schreiber dazwischenkam, so oft wiederholen
+static constexpr int MAX_TORN_RETRIES = 3;
+
+// Ohne neues Bild wacht der Sampler trotz Frame-Event regelmäßig auf
+static constexpr DWORD EVENT_FALLBACK_MS = 100;
+
+static std::string frameEventName(const std::string& name) {
+    return name + "_Frame";
+}
+
+static uint32_t canvasStride(uint32_t width) {
+    return (width * 4 + 15) & ~15u;     // Zeilen 16-Byte-ausgerichtet
+}
+
+// ============================================================================
+// Mitteln (SSE2)
+// ============================================================================
+//
+// 4 Pixel pro Load, Bytes -> 16 Bit, beide Hälften addiert ergeben 8 Lanes
+// (R,G,B,A,R,G,B,A). Nach höchstens 128 Loads (2 * 128 * 255 < 65536) werden
+// die 16-Bit-Summen auf 32 Bit erweitert, am Zeilenende auf 64 Bit.
+
+uint64_t CanvasSampler::sumRectScalar(const uint8_t* pixels, uint32_t stride, uint32_t x, uint32_t y,
+                                      uint32_t width, uint32_t height, uint32_t rowStep, uint64_t sums[4]) {
+    sums[0] = sums[1] = sums[2] = sums[3] = 0;
+    uint64_t count = 0;
+    if (rowStep == 0) {
+        rowStep = 1;
+    }
+
+    for (uint32_t row = 0; row < height; row += rowStep) {
+        const uint8_t* p = pixels + static_cast<size_t>(y + row) * stride + static_cast<size_t>(x) * 4;
+        for (uint32_t i = 0; i < width; i++) {
+            sums[0] += p[i * 4 + 0];
+            sums[1] += p[i * 4 + 1];
+            sums[2] += p[i * 4 + 2];
+            sums[3] += p[i * 4 + 3];
+        }
+        count += width;
+    }
+    return count;
+}
+
+uint64_t CanvasSampler::sumRect(const uint8_t* pixels, uint32_t stride, uint32_t x, uint32_t y,
+                                uint32_t width, uint32_t height, uint32_t rowStep, uint64_t sums[4]) {
+#ifdef HS80_CANVAS_SSE2
+    sums[0] = sums[1] = sums[2] = sums[3] = 0;
+    uint64_t count = 0;
+    if (rowStep == 0) {
+        rowStep = 1;
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+    for (uint32_t row = 0; row < height; row += rowStep) {
+        const uint8_t* p = pixels + static_cast<size_t>(y + row) * stride + static_cast<size_t>(x) * 4;
+        __m128i acc32 = zero;
+        __m128i acc16 = zero;
+        uint32_t loads = 0;
+        uint32_t i = 0;
+
+        for (; i + 4 <= width; i += 4) {
+            __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 4));
+            acc16 = _mm_add_epi16(acc16, _mm_add_epi16(_mm_unpacklo_epi8(px, zero), _mm_unpackhi_epi8(px, zero)));
+            if (++loads == 128) {
+                acc32 = _mm_add_epi32(acc32, _mm_add_epi32(_mm_unpacklo_epi16(acc16, zero), _mm_unpackhi_epi16(acc16, zero)));
+                acc16 = zero;
+                loads = 0;
+            }
+        }
+        acc32 = _mm_add_epi32(acc32, _mm_add_epi32(_mm_unpacklo_epi16(acc16, zero), _mm_unpackhi_epi16(acc16, zero)));
+
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc32);
+        for (; i < width; i++) {
+            lanes[0] += p[i * 4 + 0];
+            lanes[1] += p[i * 4 + 1];
+            lanes[2] += p[i * 4 + 2];
+            lanes[3] += p[i * 4 + 3];
+        }
+        sums[0] += lanes[0];
+        sums[1] += lanes[1];
+        sums[2] += lanes[2];
+        sums[3] += lanes[3];
+        count += width;
+    }
+    return count;
+#else
+    return sumRectScalar(pixels, stride, x, y, width, height, rowStep, sums);
+#endif
+}
+
+// ============================================================================
+// CanvasWriter
+// ============================================================================
+
+CanvasWriter::CanvasWriter()
+    : m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(nullptr)
+    , m_frameEvent(nullptr)
+    , m_view(nullptr)
+    , m_header(nullptr) {
+}
+
+CanvasWriter::~CanvasWriter() {
+    close();
+}
+
+bool CanvasWriter::createMapping(HANDLE file, const std::string& name, uint32_t width, uint32_t height, CanvasPixelFormat format) {
+    if (width == 0 || height == 0 || width > CANVAS_MAX_SIZE || height > CANVAS_MAX_SIZE) {
+        std::cerr << "[CANVAS] Ungueltige Groesse: " << width << "x" << height << std::endl;
+        return false;
+    }
+
+    uint32_t stride = canvasStride(width);
+    uint64_t size = sizeof(CanvasHeader) + static_cast<uint64_t>(stride) * height;
+    m_mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32),
+                                   static_cast<DWORD>(size), name.empty() ? nullptr : name.c_str());
+    if (m_mapping && GetLastError() == ERROR_ALREADY_EXISTS) {
+        std::cerr << "[CANVAS] Canvas existiert bereits: " << name << std::endl;
+        close();
+        return false;
+    }
+    if (m_mapping) {
+        m_view = static_cast<uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+    }
+    if (!m_view) {
+        std::cerr << "[CANVAS] Mapping fehlgeschlagen! Error: " << GetLastError() << std::endl;
+        close();
+        return false;
+    }
+
+    m_header = reinterpret_cast<CanvasHeader*>(m_view);
+    memset(m_view, 0, static_cast<size_t>(size));
+    m_header->magic = CANVAS_MAGIC;
+    m_header->version = CANVAS_VERSION;
+    m_header->format = static_cast<uint16_t>(format);
+    m_header->width = width;
+    m_header->height = height;
+    m_header->stride = stride;
+    m_header->dataOffset = sizeof(CanvasHeader);
+    m_header->sequence = 0;             // 0 = noch kein Bild
+    return true;
+}
+
+bool CanvasWriter::create(const std::string& name, uint32_t width, uint32_t height, CanvasPixelFormat format) {
+    close();
+    if (!createMapping(INVALID_HANDLE_VALUE, name, width, height, format)) {
+        return false;
+    }
+
+    m_frameEvent = CreateEventA(nullptr, FALSE, FALSE, frameEventName(name).c_str());
+    return true;
+}
+
+bool CanvasWriter::createFile(const std::string& path, uint32_t width, uint32_t height, CanvasPixelFormat format) {
+    close();
+
+    m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                         nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        std::cerr << "[CANVAS] Datei kann nicht angelegt werden: " << path << std::endl;
+        return false;
+    }
+    return createMapping(m_file, std::string(), width, height, format);
+}
+
+void CanvasWriter::close() {
+    if (m_view) {
+        UnmapViewOfFile(m_view);
+        m_view = nullptr;
+        m_header = nullptr;
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_frameEvent) {
+        CloseHandle(m_frameEvent);
+        m_frameEvent = nullptr;
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+}
+
+uint8_t* CanvasWriter::beginFrame() {
+    if (!m_header) {
+        return nullptr;
+    }
+    // Ungerade: Leser verwerfen alles, was sie ab jetzt mitteln
+    m_header->sequence = m_header->sequence + 1;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return m_view + m_header->dataOffset;
+}
+
+void CanvasWriter::endFrame() {
+    if (!m_header) {
+        return;
+    }
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    m_header->publishTicks = now.QuadPart;
+
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->sequence = m_header->sequence + 1;
+    if (m_frameEvent) {
+        SetEvent(m_frameEvent);
+    }
+}
+
+// ============================================================================
+// CanvasSampler
+// ============================================================================
+
+CanvasSampler::CanvasSampler()
+    : m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(nullptr)
+    , m_frameEvent(nullptr)
+    , m_view(nullptr)
+    , m_header(nullptr)
+    , m_width(0)
+    , m_height(0)
+    , m_stride(0)
+    , m_dataOffset(0)
+    , m_bgra(false)
+    , m_thread(nullptr)
+    , m_stopEvent(nullptr)
+    , m_running(false)
+    , m_statFrames(0)
+    , m_statSkipped(0)
+    , m_statTorn(0)
+{
+    InitializeCriticalSection(&m_lock);
+    QueryPerformanceFrequency(&m_qpcFrequency);
+    memset(m_rects, 0, sizeof(m_rects));
+}
+
+CanvasSampler::~CanvasSampler() {
+    close();
+    DeleteCriticalSection(&m_lock);
+}
+
+bool CanvasSampler::attachView(const std::string& source, size_t mappedSize) {
+    const CanvasHeader* header = reinterpret_cast<const CanvasHeader*>(m_view);
+    if (mappedSize < sizeof(CanvasHeader) || header->magic != CANVAS_MAGIC || header->version != CANVAS_VERSION) {
+        std::cerr << "[CANVAS] Kein gueltiges Canvas: " << source << std::endl;
+        return false;
+    }
+
+    // Einmal kopieren, dann prüfen: der Erzeuger darf den Header jederzeit ändern
+    uint32_t width = header->width;
+    uint32_t height = header->height;
+    uint32_t stride = header->stride;
+    uint32_t dataOffset = header->dataOffset;
+    uint16_t format = header->format;
+
+    uint64_t end = dataOffset + static_cast<uint64_t>(stride) * height;
+    if (width == 0 || height == 0 || width > CANVAS_MAX_SIZE ||
+        height > CANVAS_MAX_SIZE || stride < width * 4 ||
+        dataOffset < sizeof(CanvasHeader) || end > mappedSize ||
+        format > static_cast<uint16_t>(CanvasPixelFormat::BGRA)) {
+        std::cerr << "[CANVAS] Ungueltiger Canvas-Header: " << source << std::endl;
+        return false;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_stride = stride;
+    m_dataOffset = dataOffset;
+    m_bgra = format == static_cast<uint16_t>(CanvasPixelFormat::BGRA);
+    m_header = header;
+    EnterCriticalSection(&m_lock);
+    updateRects();
+    LeaveCriticalSection(&m_lock);
+
+    std::cout << "[CANVAS] " << source << ": " << width << "x" << height
+              << (m_frameEvent ? " (Frame-Event)" : " (Polling)") << std::endl;
+    return true;
+}
+
+bool CanvasSampler::openShared(const std::string& name) {
+    close();
+
+    m_mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+    if (m_mapping) {
+        m_view = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    MEMORY_BASIC_INFORMATION info;
+    if (!m_view || VirtualQuery(m_view, &info, sizeof(info)) == 0) {
+        std::cerr << "[CANVAS] Shared Memory nicht gefunden: " << name << std::endl;
+        close();
+        return false;
+    }
+
+    // Ohne Event (älterer Erzeuger) wird gepollt
+    m_frameEvent = OpenEventA(SYNCHRONIZE, FALSE, frameEventName(name).c_str());
+
+    if (!attachView(name, static_cast<size_t>(info.RegionSize))) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool CanvasSampler::openFile(const std::string& path) {
+    close();
+
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        std::cerr << "[CANVAS] Datei nicht gefunden: " << path << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(CanvasHeader)) {
+        std::cerr << "[CANVAS] Ungueltige Dateigroesse: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping) {
+        m_view = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (!m_view) {
+        std::cerr << "[CANVAS] Mapping fehlgeschlagen! Error: " << GetLastError() << std::endl;
+        close();
+        return false;
+    }
+
+    if (!attachView(path, static_cast<size_t>(fileSize.QuadPart))) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void CanvasSampler::close() {
+    stop();
+
+    m_header = nullptr;
+    if (m_view) {
+        UnmapViewOfFile(m_view);
+        m_view = nullptr;
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_frameEvent) {
+        CloseHandle(m_frameEvent);
+        m_frameEvent = nullptr;
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+}
+
+// Aufruf mit m_lock
+void CanvasSampler::updateRects() {
+    if (!m_header) {
+        return;
+    }
+
+    const CanvasRegion* regions[3] = { &m_config.logo, &m_config.power, &m_config.mic };
+    uint32_t canvasWidth = m_width;
+    uint32_t canvasHeight = m_height;
+
+    for (int i = 0; i < 3; i++) {
+        const CanvasRegion& region = *regions[i];
+        auto axis = [](float center, float size, uint32_t extent, uint32_t& start, uint32_t& length) {
+            float clampedCenter = std::min(std::max(center, 0.0f), 1.0f);
+            float clampedSize = std::min(std::max(size, 0.0f), 1.0f);
+            length = std::max<uint32_t>(1, static_cast<uint32_t>(clampedSize * extent + 0.5f));
+            length = std::min(length, extent);
+            float first = clampedCenter * extent - length * 0.5f;
+            start = static_cast<uint32_t>(std::min(std::max(first, 0.0f), static_cast<float>(extent - length)));
+        };
+        axis(region.x, region.width, canvasWidth, m_rects[i].x, m_rects[i].width);
+        axis(region.y, region.height, canvasHeight, m_rects[i].y, m_rects[i].height);
+    }
+}
+
+void CanvasSampler::setConfig(const CanvasSampleConfig& config) {
+    EnterCriticalSection(&m_lock);
+    m_config = config;
+    updateRects();
+    LeaveCriticalSection(&m_lock);
+}
+
+CanvasSampleConfig CanvasSampler::getConfig() const {
+    EnterCriticalSection(&m_lock);
+    CanvasSampleConfig config = m_config;
+    LeaveCriticalSection(&m_lock);
+    return config;
+}
+
+bool CanvasSampler::sampleFrame(LEDZones& zones, uint64_t& sequence, int64_t& publishTicks) {
+    if (!m_header) {
+        return false;
+    }
+
+    EnterCriticalSection(&m_lock);
+    PixelRect rects[3] = { m_rects[0], m_rects[1], m_rects[2] };
+    uint32_t rowStep = m_config.rowStep;
+    LeaveCriticalSection(&m_lock);
+
+    const uint8_t* pixels = m_view + m_dataOffset;
+    uint32_t stride = m_stride;
+    bool bgra = m_bgra;
+
+    LARGE_INTEGER start, end;
+    QueryPerformanceCounter(&start);
+
+    for (int attempt = 0; attempt <= MAX_TORN_RETRIES; attempt++) {
+        uint64_t before = m_header->sequence;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (before & 1) {
+            m_statTorn.fetch_add(1, std::memory_order_relaxed);
+            YieldProcessor();
+            continue;
+        }
+
+        RGBColor colors[3];
+        for (int i = 0; i < 3; i++) {
+            uint64_t sums[4];
+            uint64_t count = sumRect(pixels, stride, rects[i].x, rects[i].y, rects[i].width, rects[i].height, rowStep, sums);
+            if (count == 0) {
+                continue;
+            }
+            uint8_t c0 = static_cast<uint8_t>((sums[0] + count / 2) / count);
+            uint8_t c1 = static_cast<uint8_t>((sums[1] + count / 2) / count);
+            uint8_t c2 = static_cast<uint8_t>((sums[2] + count / 2) / count);
+            colors[i] = bgra ? RGBColor(c2, c1, c0) : RGBColor(c0, c1, c2);
+        }
+        int64_t ticks = m_header->publishTicks;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_header->sequence != before) {
+            m_statTorn.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        zones.logo = colors[0];
+        zones.power = colors[1];
+        zones.mic = colors[2];
+        sequence = before;
+        publishTicks = ticks;
+
+        QueryPerformanceCounter(&end);
+        m_sampleTime.record(static_cast<uint64_t>((end.QuadPart - start.QuadPart) * 1000000000LL / m_qpcFrequency.QuadPart));
+        return true;
+    }
+    return false;
+}
+
+bool CanvasSampler::sample(LEDZones& zones) {
+    uint64_t sequence;
+    int64_t publishTicks;
+    return sampleFrame(zones, sequence, publishTicks);
+}
+
+bool CanvasSampler::start(CanvasCallback callback) {
+    if (!m_header || !callback) {
+        return false;
+    }
+    stop();
+
+    m_callback = callback;
+    m_stopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    m_running = true;
+    m_thread = CreateThread(nullptr, 0, SamplerThreadProc, this, 0, nullptr);
+    if (!m_thread) {
+        std::cerr << "[CANVAS] Fehler beim Erstellen des Sampler-Threads!" << std::endl;
+        m_running = false;
+        CloseHandle(m_stopEvent);
+        m_stopEvent = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void CanvasSampler::stop() {
+    if (!m_thread) {
+        return;
+    }
+
+    SetEvent(m_stopEvent);
+    WaitForSingleObject(m_thread, INFINITE);
+    CloseHandle(m_thread);
+    CloseHandle(m_stopEvent);
+    m_thread = nullptr;
+    m_stopEvent = nullptr;
+    m_callback = nullptr;
+}
+
+DWORD WINAPI CanvasSampler::SamplerThreadProc(LPVOID param) {
+    static_cast<CanvasSampler*>(param)->samplerLoop();
+    return 0;
+}
+
+void CanvasSampler::samplerLoop() {
+    HANDLE handles[2] = { m_stopEvent, m_frameEvent };
+    uint64_t lastSequence = 0;
+
+    while (true) {
+        DWORD result;
+        if (m_frameEvent) {
+            result = WaitForMultipleObjects(2, handles, FALSE, EVENT_FALLBACK_MS);
+        } else {
+            result = WaitForSingleObject(m_stopEvent, getConfig().pollIntervalMs);
+        }
+        if (result == WAIT_OBJECT_0) {
+            break;
+        }
+
+        // Kein neues Bild oder Schreiber mitten im Bild (Event folgt)
+        uint64_t current = m_header->sequence;
+        if (current == lastSequence || (current & 1)) {
+            continue;
+        }
+
+        LEDZones zones;
+        uint64_t sequence;
+        int64_t publishTicks;
+        if (!sampleFrame(zones, sequence, publishTicks)) {
+            continue;
+        }
+
+        // Pro Bild steigt sequence um 2
+        if (lastSequence != 0 && sequence > lastSequence + 2) {
+            m_statSkipped.fetch_add((sequence - lastSequence) / 2 - 1, std::memory_order_relaxed);
+        }
+        lastSequence = sequence;
+
+        m_callback(zones);
+        m_statFrames.fetch_add(1, std::memory_order_relaxed);
+
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        if (publishTicks > 0 && now.QuadPart >= publishTicks) {
+            m_publishToPush.record(static_cast<uint64_t>((now.QuadPart - publishTicks) * 1000000000LL / m_qpcFrequency.QuadPart));
+        }
+    }
+
+    m_running = false;
+}
+
+CanvasSamplerStats CanvasSampler::getStats() const {
+    CanvasSamplerStats stats;
+    stats.frames = m_statFrames.load(std::memory_order_relaxed);
+    stats.skippedFrames = m_statSkipped.load(std::memory_order_relaxed);
+    stats.tornReads = m_statTorn.load(std::memory_order_relaxed);
+    stats.sampleTime = m_sampleTime.snapshot();
+    stats.publishToPush = m_publishToPush.snapshot();
+    return stats;
+}
+
+void CanvasSampler::resetStats() {
+    m_statFrames = 0;
+    m_statSkipped = 0;
+    m_statTorn = 0;
+    m_sampleTime.reset();
+    m_publishToPush.reset();
+}
+
+} // namespace HS80
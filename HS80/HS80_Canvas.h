@@ -0,0 +1,209 @@
+#pragma once
+
+#include "HS80_Animation.h"
+#include <string>
+
+// ============================================================================
+// HS80 Canvas - Zonenfarben aus einem geteilten RGBA-Framebuffer
+// ============================================================================
+//
+// Gegenstück zu device.color(x, y) im SignalRGB-Plugin: Ein Erzeuger (Ambient-
+// Lighting, Bildschirm-Capture, Spiel-Overlay) schreibt ein Bild in Shared
+// Memory (CreateFileMapping mit Namen) oder eine gemappte Datei. Der Sampler
+// mittelt pro Zone einen Bildbereich (SSE2) und liefert LEDZones, sobald ein
+// neues Bild fertig ist.
+//
+// Das Bild wird nie kopiert: Gemittelt wird direkt im Mapping. Konsistenz über
+// ein Seqlock im Header - der Schreiber setzt sequence vor dem Schreiben auf
+// ungerade und danach auf gerade; der Leser verwirft Ergebnisse, bei denen sich
+// sequence während des Mittelns geändert hat.
+//
+// Layout (Little Endian):
+//
+//   CanvasHeader (64 Bytes)
+//   Pixel ab dataOffset: height Zeilen zu je stride Bytes, 4 Bytes pro Pixel
+//
+// Bei Shared Memory signalisiert der Schreiber jedes Bild zusätzlich über das
+// Auto-Reset-Event "<Name>_Frame" (ein Sampler pro Canvas); gemappte Dateien
+// werden im Abstand pollIntervalMs auf eine neue sequence geprüft.
+// ============================================================================
+
+namespace HS80 {
+
+constexpr uint32_t CANVAS_MAGIC = 0x43385348;       // "HS8C"
+constexpr uint16_t CANVAS_VERSION = 1;
+constexpr uint32_t CANVAS_MAX_SIZE = 8192;          // Breite/Höhe
+
+enum class CanvasPixelFormat : uint16_t {
+    RGBA = 0,
+    BGRA = 1            // GDI/DXGI-Capture
+};
+
+struct CanvasHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t format;                // CanvasPixelFormat
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;                // Bytes pro Zeile (>= width * 4)
+    uint32_t dataOffset;            // Ab Mapping-Anfang
+    volatile uint64_t sequence;     // Seqlock: ungerade = Schreiber aktiv
+    volatile int64_t publishTicks;  // QPC beim Fertigstellen des Bildes
+    uint32_t reserved[6];
+};
+static_assert(sizeof(CanvasHeader) == 64, "CanvasHeader muss 64 Bytes groß sein");
+
+// Bereich in Canvas-Koordinaten (0-1, Mittelpunkt + Größe);
+// width/height = 0 -> einzelnes Pixel wie device.color(x, y)
+struct CanvasRegion {
+    float x;
+    float y;
+    float width;
+    float height;
+
+    CanvasRegion(float x = 0.5f, float y = 0.5f, float width = 0.0f, float height = 0.0f)
+        : x(x), y(y), width(width), height(height) {}
+};
+
+struct CanvasSampleConfig {
+    CanvasRegion logo;              // Ohrmuschel: Bildmitte
+    CanvasRegion power;             // Linker Rand
+    CanvasRegion mic;               // Rechter Rand
+    uint32_t rowStep;               // Nur jede n-te Zeile mitteln (große Bereiche)
+    uint32_t pollIntervalMs;        // Ohne Frame-Event (gemappte Datei)
+
+    CanvasSampleConfig()
+        : logo(0.5f, 0.5f, 0.5f, 0.5f), power(0.1f, 0.5f, 0.2f, 1.0f), mic(0.9f, 0.5f, 0.2f, 1.0f),
+          rowStep(1), pollIntervalMs(5) {}
+};
+
+struct CanvasSamplerStats {
+    uint64_t frames;                // Gesampelte Bilder (Callback aufgerufen)
+    uint64_t skippedFrames;         // Bilder, die der Sampler nie gesehen hat
+    uint64_t tornReads;             // Verworfene Mittelungen (Schreiber war aktiv)
+    LatencySnapshot sampleTime;     // Mitteln aller Zonen
+    LatencySnapshot publishToPush;  // Bild fertig (publishTicks) -> Callback zurück
+};
+
+using CanvasCallback = std::function<void(const LEDZones& zones)>;
+
+// ---------------------------------------------------------------------------
+// Schreiber (Erzeuger-Seite, auch für Tests und Benchmarks)
+// ---------------------------------------------------------------------------
+class CanvasWriter {
+private:
+    HANDLE m_file;
+    HANDLE m_mapping;
+    HANDLE m_frameEvent;
+    uint8_t* m_view;
+    CanvasHeader* m_header;
+
+    bool createMapping(HANDLE file, const std::string& name, uint32_t width, uint32_t height, CanvasPixelFormat format);
+
+public:
+    CanvasWriter();
+    ~CanvasWriter();
+
+    CanvasWriter(const CanvasWriter&) = delete;
+    CanvasWriter& operator=(const CanvasWriter&) = delete;
+
+    // Shared Memory, z.B. "Local\\HS80Canvas"
+    bool create(const std::string& name, uint32_t width, uint32_t height,
+                CanvasPixelFormat format = CanvasPixelFormat::BGRA);
+    // Gemappte Datei (wird angelegt/überschrieben)
+    bool createFile(const std::string& path, uint32_t width, uint32_t height,
+                    CanvasPixelFormat format = CanvasPixelFormat::BGRA);
+    void close();
+
+    uint32_t width() const { return m_header ? m_header->width : 0; }
+    uint32_t height() const { return m_header ? m_header->height : 0; }
+    uint32_t stride() const { return m_header ? m_header->stride : 0; }
+
+    // Direkt ins Mapping schreiben: beginFrame() -> Pixel -> endFrame()
+    uint8_t* beginFrame();
+    void endFrame();
+};
+
+// ---------------------------------------------------------------------------
+// Sampler (Leser-Seite)
+// ---------------------------------------------------------------------------
+class CanvasSampler {
+private:
+    struct PixelRect {
+        uint32_t x, y, width, height;
+    };
+
+    HANDLE m_file;
+    HANDLE m_mapping;
+    HANDLE m_frameEvent;            // Nur bei Shared Memory
+    const uint8_t* m_view;
+    const CanvasHeader* m_header;
+
+    // Beim Öffnen geprüfte Geometrie. Der Erzeuger kann den Header danach
+    // weiter beschreiben - gelesen werden nur noch sequence/publishTicks.
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_stride;
+    uint32_t m_dataOffset;
+    bool m_bgra;
+
+    mutable CRITICAL_SECTION m_lock;
+    CanvasSampleConfig m_config;
+    PixelRect m_rects[3];           // Logo, Power, Mic in Pixeln
+
+    HANDLE m_thread;
+    HANDLE m_stopEvent;
+    std::atomic<bool> m_running;
+    CanvasCallback m_callback;
+
+    LARGE_INTEGER m_qpcFrequency;
+    std::atomic<uint64_t> m_statFrames;
+    std::atomic<uint64_t> m_statSkipped;
+    std::atomic<uint64_t> m_statTorn;
+    LatencyHistogram m_sampleTime;
+    LatencyHistogram m_publishToPush;
+
+    bool attachView(const std::string& source, size_t mappedSize);
+    void updateRects();
+    bool sampleFrame(LEDZones& zones, uint64_t& sequence, int64_t& publishTicks);
+
+    static DWORD WINAPI SamplerThreadProc(LPVOID param);
+    void samplerLoop();
+
+public:
+    CanvasSampler();
+    ~CanvasSampler();
+
+    CanvasSampler(const CanvasSampler&) = delete;
+    CanvasSampler& operator=(const CanvasSampler&) = delete;
+
+    bool openShared(const std::string& name);
+    bool openFile(const std::string& path);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    uint32_t width() const { return m_header ? m_width : 0; }
+    uint32_t height() const { return m_header ? m_height : 0; }
+
+    void setConfig(const CanvasSampleConfig& config);
+    CanvasSampleConfig getConfig() const;
+
+    // Einmal mitteln (aktuelles Bild); false = nicht offen oder Schreiber blieb aktiv
+    bool sample(LEDZones& zones);
+
+    // Eigener Thread: Callback pro neuem Bild
+    bool start(CanvasCallback callback);
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    CanvasSamplerStats getStats() const;
+    void resetStats();
+
+    // Kanal-Summen (4 Bytes pro Pixel) über ein Rechteck; liefert die Pixelzahl
+    static uint64_t sumRect(const uint8_t* pixels, uint32_t stride, uint32_t x, uint32_t y,
+                            uint32_t width, uint32_t height, uint32_t rowStep, uint64_t sums[4]);
+    static uint64_t sumRectScalar(const uint8_t* pixels, uint32_t stride, uint32_t x, uint32_t y,
+                                  uint32_t width, uint32_t height, uint32_t rowStep, uint64_t sums[4]);
+};
+
+} // namespace HS80
@@ -0,0 +1,293 @@
+#include "HS80_Clock.h"
+#include <algorithm>
+
+namespace HS80 {
+
+// ============================================================================
+// SystemClock
+// ============================================================================
+
+int64_t SystemClock::nowNs() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool SystemClock::waitUntil(int64_t deadlineNs, HANDLE event, HANDLE timer) {
+    if (deadlineNs == FOREVER) {
+        return !event || WaitForSingleObject(event, INFINITE) != WAIT_OBJECT_0;
+    }
+
+    while (true) {
+        int64_t remaining = deadlineNs - nowNs();
+        if (remaining <= 0) {
+            return true;
+        }
+
+        DWORD result;
+        if (timer) {
+            // Relative Fälligkeit in 100ns-Einheiten, jedes Mal neu aus der absoluten Deadline berechnet
+            LARGE_INTEGER due;
+            due.QuadPart = -(remaining / 100);
+            if (due.QuadPart == 0) {
+                return true;
+            }
+            SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE);
+
+            HANDLE handles[2] = { event, timer };
+            result = event ? WaitForMultipleObjects(2, handles, FALSE, INFINITE) : WaitForSingleObject(timer, INFINITE) + 1;
+        } else {
+            DWORD waitMs = static_cast<DWORD>((remaining + NS_PER_MS - 1) / NS_PER_MS);
+            if (event) {
+                result = WaitForSingleObject(event, waitMs);
+            } else {
+                Sleep(waitMs);
+                result = WAIT_TIMEOUT;
+            }
+        }
+
+        if (event && result == WAIT_OBJECT_0) {
+            return false;
+        }
+    }
+}
+
+void SystemClock::signal(HANDLE event) {
+    SetEvent(event);
+}
+
+bool SystemClock::waitForEvent(HANDLE event, DWORD timeoutMs) {
+    return WaitForSingleObject(event, timeoutMs) == WAIT_OBJECT_0;
+}
+
+std::shared_ptr<Clock> systemClock() {
+    static std::shared_ptr<Clock> clock = std::make_shared<SystemClock>();
+    return clock;
+}
+
+// ============================================================================
+// VirtualClock
+// ============================================================================
+
+// Anmeldung des aktuellen Threads (ein Thread wartet nur an einer Clock)
+static thread_local int t_ticket = -1;
+static thread_local HANDLE t_release = nullptr;
+
+VirtualClock::VirtualClock(int64_t startNs)
+    : m_nowNs(startNs)
+    , m_registered(0)
+    , m_running(0)
+    , m_nextTicket(0)
+    , m_quietEvent(CreateEvent(nullptr, TRUE, TRUE, nullptr))
+    , m_statWakeups(0)
+    , m_statSignals(0) {
+    InitializeCriticalSection(&m_lock);
+}
+
+VirtualClock::~VirtualClock() {
+    if (m_quietEvent) {
+        CloseHandle(m_quietEvent);
+    }
+    DeleteCriticalSection(&m_lock);
+}
+
+void VirtualClock::setRunningLocked(int delta) {
+    m_running += delta;
+    if (m_running == 0) {
+        SetEvent(m_quietEvent);
+    } else {
+        ResetEvent(m_quietEvent);
+    }
+}
+
+int VirtualClock::threadCreated() {
+    EnterCriticalSection(&m_lock);
+    m_registered++;
+    setRunningLocked(1);    // Zählt als laufend, bis er das erste Mal wartet
+    int ticket = m_nextTicket++;
+    LeaveCriticalSection(&m_lock);
+    return ticket;
+}
+
+void VirtualClock::threadCancelled() {
+    EnterCriticalSection(&m_lock);
+    m_registered--;
+    setRunningLocked(-1);
+    LeaveCriticalSection(&m_lock);
+}
+
+void VirtualClock::threadStarted(int ticket) {
+    t_ticket = ticket;
+    t_release = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+}
+
+void VirtualClock::threadFinished() {
+    EnterCriticalSection(&m_lock);
+    m_registered--;
+    setRunningLocked(-1);
+    LeaveCriticalSection(&m_lock);
+
+    if (t_release) {
+        CloseHandle(t_release);
+    }
+    t_release = nullptr;
+    t_ticket = -1;
+}
+
+bool VirtualClock::takeSignalLocked(HANDLE event) {
+    auto it = std::find(m_signaled.begin(), m_signaled.end(), event);
+    if (it == m_signaled.end()) {
+        return false;
+    }
+    m_signaled.erase(it);
+    return true;
+}
+
+// Früheste Deadline <= limitNs, bei Gleichstand der zuerst erzeugte Thread
+VirtualClock::Waiter* VirtualClock::nextDueLocked(int64_t limitNs) {
+    Waiter* next = nullptr;
+    for (Waiter* waiter : m_waiters) {
+        if (waiter->deadlineNs == FOREVER || waiter->deadlineNs > limitNs) {
+            continue;
+        }
+        if (!next || waiter->deadlineNs < next->deadlineNs ||
+            (waiter->deadlineNs == next->deadlineNs && waiter->ticket < next->ticket)) {
+            next = waiter;
+        }
+    }
+    return next;
+}
+
+void VirtualClock::releaseLocked(Waiter* waiter, bool bySignal) {
+    m_waiters.erase(std::find(m_waiters.begin(), m_waiters.end(), waiter));
+    waiter->bySignal = bySignal;
+    setRunningLocked(1);
+    if (bySignal) {
+        m_statSignals++;
+    } else {
+        m_statWakeups++;
+    }
+    SetEvent(waiter->release);     // waiter liegt auf dem Stack des Wartenden: danach nicht mehr anfassen
+}
+
+bool VirtualClock::waitUntil(int64_t deadlineNs, HANDLE event, HANDLE timer) {
+    (void)timer;
+    if (t_ticket < 0 || !t_release) {
+        // Treiber: Simulation bis zur Deadline bzw. zum Event ablaufen lassen
+        return !runUntil(deadlineNs, event, false);
+    }
+
+    EnterCriticalSection(&m_lock);
+    if (event && takeSignalLocked(event)) {
+        LeaveCriticalSection(&m_lock);
+        return false;
+    }
+    if (deadlineNs <= m_nowNs.load(std::memory_order_relaxed)) {
+        LeaveCriticalSection(&m_lock);
+        return true;
+    }
+    Waiter waiter;
+    waiter.deadlineNs = deadlineNs;
+    waiter.event = event;
+    waiter.ticket = t_ticket;
+    waiter.release = t_release;
+    waiter.bySignal = false;
+    m_waiters.push_back(&waiter);
+    setRunningLocked(-1);
+    LeaveCriticalSection(&m_lock);
+
+    WaitForSingleObject(waiter.release, INFINITE);
+    return !waiter.bySignal;
+}
+
+void VirtualClock::signal(HANDLE event) {
+    EnterCriticalSection(&m_lock);
+    Waiter* target = nullptr;
+    for (Waiter* waiter : m_waiters) {
+        if (waiter->event == event && (!target || waiter->ticket < target->ticket)) {
+            target = waiter;
+        }
+    }
+    if (target) {
+        releaseLocked(target, true);
+    } else if (std::find(m_signaled.begin(), m_signaled.end(), event) == m_signaled.end()) {
+        m_signaled.push_back(event);
+    }
+    LeaveCriticalSection(&m_lock);
+}
+
+void VirtualClock::settle() {
+    while (true) {
+        WaitForSingleObject(m_quietEvent, INFINITE);
+        EnterCriticalSection(&m_lock);
+        bool quiet = m_running == 0;
+        LeaveCriticalSection(&m_lock);
+        if (quiet) {
+            return;
+        }
+    }
+}
+
+// Weckt fällige Threads einzeln bis targetNs oder bis event gesetzt ist
+// (per signal(), bei manualEvent per SetEvent); true = event
+bool VirtualClock::runUntil(int64_t targetNs, HANDLE event, bool manualEvent) {
+    while (true) {
+        settle();
+        if (event && manualEvent && WaitForSingleObject(event, 0) == WAIT_OBJECT_0) {
+            return true;
+        }
+        EnterCriticalSection(&m_lock);
+        if (event && !manualEvent && takeSignalLocked(event)) {
+            LeaveCriticalSection(&m_lock);
+            return true;
+        }
+        Waiter* next = nextDueLocked(targetNs);
+        if (!next) {
+            // Nichts mehr fällig: Zeit springt auf das Ziel (FOREVER: alles wartet nur noch auf Events)
+            if (targetNs != FOREVER && targetNs > m_nowNs.load(std::memory_order_relaxed)) {
+                m_nowNs.store(targetNs, std::memory_order_release);
+            }
+            LeaveCriticalSection(&m_lock);
+            return event && manualEvent && WaitForSingleObject(event, 0) == WAIT_OBJECT_0;
+        }
+        if (next->deadlineNs > m_nowNs.load(std::memory_order_relaxed)) {
+            m_nowNs.store(next->deadlineNs, std::memory_order_release);
+        }
+        releaseLocked(next, false);
+        LeaveCriticalSection(&m_lock);
+    }
+}
+
+void VirtualClock::advance(int64_t ns) {
+    int64_t now = nowNs();
+    int64_t target = ns >= FOREVER - now ? FOREVER - 1 : now + std::max<int64_t>(0, ns);
+    runUntil(target, nullptr, false);
+    settle();
+}
+
+bool VirtualClock::waitForEvent(HANDLE event, DWORD timeoutMs) {
+    int64_t target = timeoutMs == INFINITE ? FOREVER : nowNs() + static_cast<int64_t>(timeoutMs) * NS_PER_MS;
+    return runUntil(target, event, true);
+}
+
+int64_t VirtualClock::nextDeadline() const {
+    EnterCriticalSection(&m_lock);
+    int64_t next = FOREVER;
+    for (const Waiter* waiter : m_waiters) {
+        next = std::min(next, waiter->deadlineNs);
+    }
+    LeaveCriticalSection(&m_lock);
+    return next;
+}
+
+VirtualClockStats VirtualClock::getStats() const {
+    VirtualClockStats stats;
+    EnterCriticalSection(&m_lock);
+    stats.wakeups = m_statWakeups;
+    stats.signals = m_statSignals;
+    stats.registeredThreads = m_registered;
+    stats.waitingThreads = static_cast<int>(m_waiters.size());
+    LeaveCriticalSection(&m_lock);
+    return stats;
+}
+
+} // namespace HS80
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "HS80_Library.h"
+#include <vector>
+
+// ============================================================================
+// HS80 Clock - Zeitquelle für Animation, Keep-Alive und Abfrage-Threads
+// ============================================================================
+//
+// Alle zeitgesteuerten Threads der Library warten über eine Clock statt über
+// Sleep/QueryPerformanceCounter. SystemClock ist die echte Zeit (Standard).
+// VirtualClock läuft nur, wenn sie vorgestellt wird:
+//
+//   auto clock = std::make_shared<VirtualClock>();
+//   rgb.setClock(clock);
+//   rgb.startRainbow(10000, 20);
+//   clock->advance(10000 * Clock::NS_PER_MS);    // 10s Effekt in Millisekunden
+//
+// advance() weckt die wartenden Threads streng nacheinander in Deadline-
+// Reihenfolge (Gleichstand: Reihenfolge der Thread-Erzeugung) und wartet
+// jeweils, bis alle angemeldeten Threads wieder in waitUntil() stehen. Damit
+// ist die Ausgabe bei gleicher Eingabe jedes Mal identisch.
+//
+// Regeln für zeitgesteuerte Threads:
+//   - threadCreated() vor CreateThread, threadStarted()/threadFinished() im
+//     Thread (ClockThreadScope). Nur angemeldete Threads zählen für advance().
+//   - Warten nur über waitUntil() und nie unter einer Sperre, die ein anderer
+//     angemeldeter Thread braucht. Events, auf die so gewartet wird, werden
+//     mit signal() gesetzt (Auto-Reset-Semantik).
+//   - Nicht angemeldete Threads (Aufrufer, Testtreiber) stellen die Zeit vor:
+//     sleep() und waitForEvent() laufen bei VirtualClock die Simulation ab,
+//     statt echte Zeit zu warten.
+// ============================================================================
+
+namespace HS80 {
+
+class Clock {
+public:
+    static constexpr int64_t NS_PER_MS = 1000000;
+    static constexpr int64_t FOREVER = INT64_MAX;
+
+    virtual ~Clock() = default;
+
+    virtual int64_t nowNs() const = 0;      // Monoton, ns
+    double nowMs() const { return nowNs() / static_cast<double>(NS_PER_MS); }
+
+    // Wartet bis deadlineNs (FOREVER = nur Event) oder bis event per signal()
+    // gesetzt ist. true = Deadline erreicht, false = Event. event darf nullptr
+    // sein; timer (optional) = hochauflösender Waitable Timer des Aufrufers.
+    virtual bool waitUntil(int64_t deadlineNs, HANDLE event, HANDLE timer = nullptr) = 0;
+    virtual void signal(HANDLE event) = 0;
+
+    // Nicht angemeldeter Thread wartet auf ein Manual-Reset-Event (z.B. Effekt-Ende)
+    virtual bool waitForEvent(HANDLE event, DWORD timeoutMs) = 0;
+
+    // Ersatz für Sleep()
+    void sleep(DWORD ms) { waitUntil(nowNs() + static_cast<int64_t>(ms) * NS_PER_MS, nullptr); }
+
+    // Anmeldung zeitgesteuerter Threads (siehe oben)
+    virtual int threadCreated() { return 0; }
+    virtual void threadCancelled() {}       // CreateThread fehlgeschlagen
+    virtual void threadStarted(int ticket) { (void)ticket; }
+    virtual void threadFinished() {}
+};
+
+// Echte Zeit: steady_clock (QueryPerformanceCounter), Warten mit Waitable Timer
+class SystemClock : public Clock {
+public:
+    int64_t nowNs() const override;
+    bool waitUntil(int64_t deadlineNs, HANDLE event, HANDLE timer = nullptr) override;
+    void signal(HANDLE event) override;
+    bool waitForEvent(HANDLE event, DWORD timeoutMs) override;
+};
+
+// Gemeinsame Instanz (Standard aller Komponenten)
+std::shared_ptr<Clock> systemClock();
+
+struct VirtualClockStats {
+    uint64_t wakeups;           // Per Deadline geweckte Threads
+    uint64_t signals;           // Per signal() geweckte Threads
+    int registeredThreads;
+    int waitingThreads;
+};
+
+// Simulierte Zeit, nur durch advance()/sleep()/waitForEvent() des Treibers
+class VirtualClock : public Clock {
+private:
+    struct Waiter {
+        int64_t deadlineNs;
+        HANDLE event;
+        int ticket;
+        HANDLE release;
+        bool bySignal;
+    };
+
+    mutable CRITICAL_SECTION m_lock;
+    std::atomic<int64_t> m_nowNs;
+    int m_registered;
+    int m_running;                  // Angemeldet und gerade nicht in waitUntil()
+    int m_nextTicket;
+    std::vector<Waiter*> m_waiters;
+    std::vector<HANDLE> m_signaled; // Gesetzte Events ohne Wartenden
+    HANDLE m_quietEvent;            // Manual-Reset: m_running == 0
+    uint64_t m_statWakeups;
+    uint64_t m_statSignals;
+
+    void setRunningLocked(int delta);
+    Waiter* nextDueLocked(int64_t limitNs);
+    bool takeSignalLocked(HANDLE event);
+    void releaseLocked(Waiter* waiter, bool bySignal);
+    bool runUntil(int64_t targetNs, HANDLE event, bool manualEvent);
+
+public:
+    explicit VirtualClock(int64_t startNs = 0);
+    ~VirtualClock();
+
+    VirtualClock(const VirtualClock&) = delete;
+    VirtualClock& operator=(const VirtualClock&) = delete;
+
+    int64_t nowNs() const override { return m_nowNs.load(std::memory_order_acquire); }
+    bool waitUntil(int64_t deadlineNs, HANDLE event, HANDLE timer = nullptr) override;
+    void signal(HANDLE event) override;
+    bool waitForEvent(HANDLE event, DWORD timeoutMs) override;
+
+    int threadCreated() override;
+    void threadCancelled() override;
+    void threadStarted(int ticket) override;
+    void threadFinished() override;
+
+    // Treiber (nicht angemeldete Threads)
+    void settle();                          // Bis alle angemeldeten Threads warten
+    void advance(int64_t ns);               // Zeit vorstellen, fällige Threads nacheinander
+    void advanceMs(double ms) { advance(static_cast<int64_t>(ms * NS_PER_MS)); }
+    int64_t nextDeadline() const;           // FOREVER = kein Thread mit Deadline
+
+    VirtualClockStats getStats() const;
+};
+
+// Meldet den aktuellen Thread für die Dauer des Scopes an der Clock an
+class ClockThreadScope {
+private:
+    Clock& m_clock;
+
+public:
+    ClockThreadScope(Clock& clock, int ticket) : m_clock(clock) { m_clock.threadStarted(ticket); }
+    ~ClockThreadScope() { m_clock.threadFinished(); }
+
+    ClockThreadScope(const ClockThreadScope&) = delete;
+    ClockThreadScope& operator=(const ClockThreadScope&) = delete;
+};
+
+} // namespace HS80
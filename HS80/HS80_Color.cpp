@@ -0,0 +1,334 @@
+#include "HS80_Color.h"
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HS80_COLOR_SSE2 1
+#endif
+
+namespace HS80 {
+namespace Color {
+
+static_assert(sizeof(RGBColor) == 3, "RGBColor muss 3 gepackte Bytes sein");
+static_assert(sizeof(LEDZones) == 9, "LEDZones muss 9 gepackte Bytes sein");
+
+// ============================================================================
+// Tabellen
+// ============================================================================
+
+// Farbkreis: 6 Sektoren zu je 256 Stufen, zur Compile-Zeit berechnet
+static constexpr std::array<uint8_t, HUE_STEPS * 3> buildHueTable() {
+    std::array<uint8_t, HUE_STEPS * 3> table = {};
+    for (int hue = 0; hue < HUE_STEPS; hue++) {
+        uint8_t r = 0, g = 0, b = 0;
+        detail::hueToRgb(static_cast<uint16_t>(hue), r, g, b);
+        table[hue * 3 + 0] = r;
+        table[hue * 3 + 1] = g;
+        table[hue * 3 + 2] = b;
+    }
+    return table;
+}
+
+static constexpr std::array<uint8_t, 256> buildGammaTable() {
+    std::array<uint8_t, 256> table = {};
+    for (int i = 0; i < 256; i++) {
+        table[i] = detail::gamma22(i);
+    }
+    return table;
+}
+
+static constexpr std::array<uint8_t, HUE_STEPS * 3> s_hueTable = buildHueTable();
+static constexpr std::array<uint8_t, 256> s_gammaTable = buildGammaTable();
+
+// Easing: 256 Abschnitte pro Kurve (+ Endpunkt), Q12, dazwischen linear
+constexpr int EASE_STEPS = 256;
+
+static constexpr std::array<uint16_t, (EASE_STEPS + 1) * 4> buildEaseTable() {
+    std::array<uint16_t, (EASE_STEPS + 1) * 4> table = {};
+    for (int i = 0; i <= EASE_STEPS; i++) {
+        double t = static_cast<double>(i) / EASE_STEPS;
+        double u = 1.0 - t;
+        double values[4] = { t, t * t * t, 1.0 - u * u * u, t * t * (3.0 - 2.0 * t) };
+        for (int curve = 0; curve < 4; curve++) {
+            table[curve * (EASE_STEPS + 1) + i] = static_cast<uint16_t>(values[curve] * MIX_ONE + 0.5);
+        }
+    }
+    return table;
+}
+
+static constexpr std::array<uint16_t, (EASE_STEPS + 1) * 4> s_easeTable = buildEaseTable();
+
+// OKLab: sRGB-Kurve und Kubikwurzel brauchen std::pow/std::cbrt (nicht
+// constexpr) - einmalig beim ersten Aufruf berechnet, danach nur Lookups.
+// Hinweg: linear in Q15, LMS in Q19 (Kubikwurzel ist bei 0 steil). Rückweg:
+// LMS in Q20, weil die Matrix nach linearem RGB Differenzen großer Werte
+// bildet (sonst 2 Stufen Fehler bei gesättigten Farben mit einem Kanal nahe 0).
+constexpr int32_t LINEAR_ONE = 1 << 15;                             // Q15
+constexpr int LMS_IN_SHIFT = 19;                                    // Hinweg
+constexpr int LMS_SHIFT = 20;                                       // Rückweg
+constexpr int SRGB_SHIFT = 2;                                       // Linear Q15 >> 2 -> sRGB-Tabelle
+constexpr int CBRT_SHIFT = 3;                                       // Grobe Kubikwurzel: Schritte von 8
+constexpr int CBRT_FINE = 2048;                                     // Darunter direkte Tabelle
+
+struct OkLabTables {
+    uint16_t toLinear[256];                                         // sRGB -> linear Q15
+    uint8_t toSrgb[(LINEAR_ONE >> SRGB_SHIFT) + 1];                 // linear Q15 >> 2 -> sRGB
+    uint32_t cbrtFine[CBRT_FINE + 1];                               // x^(1/3) in Q17, x <= 2048 (steil bei 0)
+    uint32_t cbrtCoarse[(LINEAR_ONE >> CBRT_SHIFT) + 2];            // x^(1/3) in Q17, Schritte von 8
+
+    OkLabTables() {
+        for (int i = 0; i < 256; i++) {
+            double c = i / 255.0;
+            double linear = c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+            toLinear[i] = static_cast<uint16_t>(linear * LINEAR_ONE + 0.5);
+        }
+        for (int i = 0; i <= (LINEAR_ONE >> SRGB_SHIFT); i++) {
+            double linear = static_cast<double>(i << SRGB_SHIFT) / LINEAR_ONE;
+            double c = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+            toSrgb[i] = static_cast<uint8_t>(std::min(255.0, c * 255.0 + 0.5));
+        }
+        for (int i = 0; i <= CBRT_FINE; i++) {
+            cbrtFine[i] = static_cast<uint32_t>(std::cbrt(static_cast<double>(i) / LINEAR_ONE) * OKLAB_ONE + 0.5);
+        }
+        for (int i = 0; i < (LINEAR_ONE >> CBRT_SHIFT) + 2; i++) {
+            double x = static_cast<double>(i << CBRT_SHIFT) / LINEAR_ONE;
+            cbrtCoarse[i] = static_cast<uint32_t>(std::cbrt(x) * OKLAB_ONE + 0.5);
+        }
+    }
+};
+
+static const OkLabTables& okLabTables() {
+    static const OkLabTables tables;
+    return tables;
+}
+
+// Matrizen (Ottosson) im Q16-Format, Summen in 64 Bit
+static const int64_t s_rgbToLms[9] = {
+    27015, 35149, 3372,         // 0.4122214708 0.5363325363 0.0514459929
+    13887, 44610, 7038,         // 0.2119034982 0.6806995451 0.1073969566
+    5787, 18463, 41286          // 0.0883024619 0.2817188376 0.6299787005
+};
+static const int64_t s_lmsToLab[9] = {
+    13792, 52011, -267,         // 0.2104542553  0.7936177850 -0.0040720468
+    129630, -159160, 29530,     // 1.9779984951 -2.4285922050  0.4505937099
+    1698, 51300, -52997         // 0.0259040371  0.7827717662 -0.8086757660
+};
+static const int64_t s_labToLms[6] = {
+    25974, 14143,               // l_ = L + 0.3963377774 a + 0.2158037573 b
+    -6918, -4185,               // m_ = L - 0.1055613458 a - 0.0638541728 b
+    -5864, -84639               // s_ = L - 0.0894841775 a - 1.2914855480 b
+};
+static const int64_t s_lmsToRgb[9] = {
+    267173, -216774, 15137,     //  4.0767416621 -3.3077115913  0.2309699292
+    -83128, 171033, -22369,     // -1.2684380046  2.6097574011 -0.3413193965
+    -275, -46099, 111910        // -0.0041960863 -0.7034186147  1.7076147010
+};
+
+static inline int32_t roundQ16(int64_t value) {
+    return static_cast<int32_t>((value + 32768) >> 16);
+}
+
+// Linear Q15 x Matrix Q16 -> LMS Q19
+static inline int32_t roundLms(int64_t value) {
+    constexpr int shift = 15 + 16 - LMS_IN_SHIFT;
+    return static_cast<int32_t>((value + (1 << (shift - 1))) >> shift);
+}
+
+// LMS Q19 -> LMS' Q17, zwischen den Tabellenwerten linear interpoliert
+static inline int32_t cubeRoot(const OkLabTables& tables, int32_t x) {
+    constexpr int fineShift = LMS_IN_SHIFT - 15;
+    constexpr int coarseShift = fineShift + CBRT_SHIFT;
+    if (x <= 0) {
+        return 0;
+    }
+    const uint32_t* table = tables.cbrtFine;
+    int shift = fineShift;
+    if (x >= (CBRT_FINE << fineShift)) {
+        if (x > (LINEAR_ONE << fineShift)) {
+            x = LINEAR_ONE << fineShift;
+        }
+        table = tables.cbrtCoarse;
+        shift = coarseShift;
+    }
+    int32_t i = x >> shift;
+    int32_t f = x & ((1 << shift) - 1);
+    int32_t lo = static_cast<int32_t>(table[i]);
+    int32_t hi = static_cast<int32_t>(table[i + 1]);
+    return lo + (((hi - lo) * f) >> shift);
+}
+
+// Linear Q20 -> sRGB
+static inline uint8_t toSrgb(const OkLabTables& tables, int32_t linear) {
+    constexpr int shift = LMS_SHIFT - 15 + SRGB_SHIFT;
+    if (linear <= 0) return 0;
+    if (linear >= (1 << LMS_SHIFT)) return 255;
+    return tables.toSrgb[(linear + (1 << (shift - 1))) >> shift];
+}
+
+static inline OkLab toOkLab(const OkLabTables& tables, RGBColor color) {
+    const int64_t r = tables.toLinear[color.r];
+    const int64_t g = tables.toLinear[color.g];
+    const int64_t b = tables.toLinear[color.b];
+    const int64_t l = cubeRoot(tables, roundLms(s_rgbToLms[0] * r + s_rgbToLms[1] * g + s_rgbToLms[2] * b));
+    const int64_t m = cubeRoot(tables, roundLms(s_rgbToLms[3] * r + s_rgbToLms[4] * g + s_rgbToLms[5] * b));
+    const int64_t s = cubeRoot(tables, roundLms(s_rgbToLms[6] * r + s_rgbToLms[7] * g + s_rgbToLms[8] * b));
+    return OkLab{ roundQ16(s_lmsToLab[0] * l + s_lmsToLab[1] * m + s_lmsToLab[2] * s),
+                  roundQ16(s_lmsToLab[3] * l + s_lmsToLab[4] * m + s_lmsToLab[5] * s),
+                  roundQ16(s_lmsToLab[6] * l + s_lmsToLab[7] * m + s_lmsToLab[8] * s) };
+}
+
+static inline RGBColor fromOkLab(const OkLabTables& tables, const OkLab& lab) {
+    int64_t lms[3];
+    for (int i = 0; i < 3; i++) {
+        int64_t root = lab.L + roundQ16(s_labToLms[i * 2] * lab.a + s_labToLms[i * 2 + 1] * lab.b);
+        if (root < 0) root = 0;                         // Außerhalb des Gamuts (Rundung)
+        lms[i] = (root * root * root) >> (3 * 17 - LMS_SHIFT);     // Q17^3 -> Q20
+    }
+    return RGBColor(toSrgb(tables, roundQ16(s_lmsToRgb[0] * lms[0] + s_lmsToRgb[1] * lms[1] + s_lmsToRgb[2] * lms[2])),
+                    toSrgb(tables, roundQ16(s_lmsToRgb[3] * lms[0] + s_lmsToRgb[4] * lms[1] + s_lmsToRgb[5] * lms[2])),
+                    toSrgb(tables, roundQ16(s_lmsToRgb[6] * lms[0] + s_lmsToRgb[7] * lms[1] + s_lmsToRgb[8] * lms[2])));
+}
+
+// ============================================================================
+// Einzelwerte
+// ============================================================================
+
+RGBColor hueToRgb(uint16_t hue) {
+    const uint8_t* entry = &s_hueTable[(hue % HUE_STEPS) * 3];
+    return RGBColor(entry[0], entry[1], entry[2]);
+}
+
+uint16_t hueFromDegrees(float degrees) {
+    float wrapped = std::fmod(degrees, 360.0f);
+    if (wrapped < 0) wrapped += 360.0f;
+    return static_cast<uint16_t>(wrapped * HUE_STEPS / 360.0f) % HUE_STEPS;
+}
+
+uint16_t hueFromPhase(uint64_t position, uint64_t period) {
+    if (period == 0) {
+        return 0;
+    }
+    return static_cast<uint16_t>(((position % period) * HUE_STEPS) / period);
+}
+
+uint8_t gamma(uint8_t value) {
+    return s_gammaTable[value];
+}
+
+RGBColor gamma(RGBColor color) {
+    return RGBColor(s_gammaTable[color.r], s_gammaTable[color.g], s_gammaTable[color.b]);
+}
+
+RGBColor scale(RGBColor color, uint16_t brightness) {
+    return RGBColor(scale(color.r, brightness), scale(color.g, brightness), scale(color.b, brightness));
+}
+
+OkLab toOkLab(RGBColor color) {
+    return toOkLab(okLabTables(), color);
+}
+
+RGBColor fromOkLab(const OkLab& lab) {
+    return fromOkLab(okLabTables(), lab);
+}
+
+RGBColor mixOkLab(RGBColor from, RGBColor to, uint16_t t) {
+    const OkLabTables& tables = okLabTables();
+    return fromOkLab(tables, mix(toOkLab(tables, from), toOkLab(tables, to), t));
+}
+
+void mixOkLab(const LEDZones& from, const LEDZones& to, uint16_t t, LEDZones& out) {
+    const OkLabTables& tables = okLabTables();
+    out.logo = fromOkLab(tables, mix(toOkLab(tables, from.logo), toOkLab(tables, to.logo), t));
+    out.power = fromOkLab(tables, mix(toOkLab(tables, from.power), toOkLab(tables, to.power), t));
+    out.mic = fromOkLab(tables, mix(toOkLab(tables, from.mic), toOkLab(tables, to.mic), t));
+}
+
+uint16_t ease(Easing easing, uint16_t progress) {
+    if (progress >= MIX_ONE) {
+        return MIX_ONE;
+    }
+    const uint16_t* curve = &s_easeTable[static_cast<size_t>(easing) * (EASE_STEPS + 1)];
+    int i = progress >> 4;                              // 4096 / 256 = 16 pro Abschnitt
+    int f = progress & 15;
+    return static_cast<uint16_t>(curve[i] + (((curve[i + 1] - curve[i]) * f) >> 4));
+}
+
+// ============================================================================
+// Batch-Verarbeitung
+// ============================================================================
+
+void hueFrames(uint32_t hueStartQ8, uint32_t hueStepQ8, LEDZones* frames, size_t count) {
+    uint32_t hue = hueStartQ8;
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* entry = &s_hueTable[((hue >> 8) % HUE_STEPS) * 3];
+        unsigned char* out = reinterpret_cast<unsigned char*>(&frames[i]);
+        for (int zone = 0; zone < 3; zone++) {
+            out[zone * 3 + 0] = entry[0];
+            out[zone * 3 + 1] = entry[1];
+            out[zone * 3 + 2] = entry[2];
+        }
+        hue += hueStepQ8;
+    }
+}
+
+void scaleFrames(LEDZones* frames, size_t count, uint16_t brightness) {
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(frames);
+    size_t total = count * sizeof(LEDZones);
+    size_t i = 0;
+
+#ifdef HS80_COLOR_SSE2
+    // 16 Bytes pro Schritt: auf 16 Bit erweitern, multiplizieren, >> 8, zurückpacken
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i factor = _mm_set1_epi16(static_cast<short>(brightness));
+    for (; i + 16 <= total; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), factor), 8);
+        __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), factor), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; i < total; i++) {
+        bytes[i] = scale(bytes[i], brightness);
+    }
+}
+
+void fadeFrames(const LEDZones& color, const uint16_t* levels, LEDZones* frames, size_t count) {
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(&color);
+    size_t i = 0;
+
+#ifdef HS80_COLOR_SSE2
+    // Ein Frame pro Schritt: 9 Farbbytes als 16-Bit-Lanes (8 + 1), Level als Broadcast.
+    // Der 16-Byte-Store schreibt 7 Bytes in den Folgeframe, der danach überschrieben wird;
+    // der letzte Frame läuft daher skalar.
+    const __m128i colorLo = _mm_setr_epi16(src[0], src[1], src[2], src[3], src[4], src[5], src[6], src[7]);
+    const __m128i colorHi = _mm_setr_epi16(src[8], 0, 0, 0, 0, 0, 0, 0);
+    for (; i + 1 < count; i++) {
+        __m128i level = _mm_set1_epi16(static_cast<short>(levels[i]));
+        __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(colorLo, level), 8);
+        __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(colorHi, level), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&frames[i]), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; i < count; i++) {
+        unsigned char* out = reinterpret_cast<unsigned char*>(&frames[i]);
+        for (size_t b = 0; b < sizeof(LEDZones); b++) {
+            out[b] = scale(src[b], levels[i]);
+        }
+    }
+}
+
+void gammaFrames(LEDZones* frames, size_t count) {
+    // 256er-Tabelle passt in kein SSE2-Register; skalarer Lookup über den gepackten Puffer
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(frames);
+    size_t total = count * sizeof(LEDZones);
+    for (size_t i = 0; i < total; i++) {
+        bytes[i] = s_gammaTable[bytes[i]];
+    }
+}
+
+} // namespace Color
+} // namespace HS80
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "HS80_Library.h"
+
+// ============================================================================
+// HS80 Color - Farb-Pipeline mit Festkomma-Tabellen
+// ============================================================================
+//
+// Ersetzt die Float-Rechnung in den Effekten durch vorberechnete Tabellen:
+//   - Farbkreis: 1536 Stufen (6 Sektoren x 256), direkt als RGB-Tabelle
+//   - Gamma: 256 Einträge, wahrnehmungs-lineare Helligkeit (Gamma 2.2)
+//   - Helligkeit: Q8-Faktor 0-256 (256 = unverändert)
+//   - OKLab: sRGB <-> OKLab in Festkomma (Q17) für wahrnehmungsgleiche
+//     Übergänge; Tabellen für sRGB-Kurve und Kubikwurzel, Matrizen als
+//     Ganzzahlen, keine Float-Rechnung pro Frame
+//
+// Die *Frames-Funktionen verarbeiten viele LEDZones am Stück. LEDZones ist
+// ein gepacktes 9-Byte-Array (3 Zonen x RGB), daher laufen Helligkeit und Fades
+// mit SSE2 über 16 Bytes pro Schritt, unabhängig von Frame-Grenzen.
+// ============================================================================
+
+namespace HS80 {
+namespace Color {
+
+constexpr uint16_t HUE_STEPS = 1536;        // Ein Farbkreis-Umlauf
+constexpr uint16_t BRIGHTNESS_ONE = 256;    // Q8: 1.0
+
+// Compile-Zeit-Varianten (Grundlage der Tabellen, auch für HS80_FrameTables.h)
+namespace detail {
+
+constexpr void hueToRgb(uint16_t hue, uint8_t& r, uint8_t& g, uint8_t& b) {
+    int f = hue & 0xFF;
+    switch ((hue % HUE_STEPS) >> 8) {
+    case 0:  r = 255;                         g = static_cast<uint8_t>(f);       b = 0;                         break;
+    case 1:  r = static_cast<uint8_t>(255 - f); g = 255;                         b = 0;                         break;
+    case 2:  r = 0;                           g = 255;                           b = static_cast<uint8_t>(f);   break;
+    case 3:  r = 0;                           g = static_cast<uint8_t>(255 - f); b = 255;                       break;
+    case 4:  r = static_cast<uint8_t>(f);     g = 0;                             b = 255;                       break;
+    default: r = 255;                         g = 0;                             b = static_cast<uint8_t>(255 - f); break;
+    }
+}
+
+// x^0.2 per Newton-Verfahren (std::pow ist nicht constexpr); konvergiert in <= 8 Schritten
+constexpr double fifthRoot(double x) {
+    if (x <= 0.0) {
+        return 0.0;
+    }
+    double y = x < 0.1 ? 0.5 : 1.0;
+    for (int i = 0; i < 40; i++) {
+        double next = 0.8 * y + x / (5.0 * y * y * y * y);
+        double delta = next - y;
+        y = next;
+        if (delta < 1e-12 && delta > -1e-12) {
+            break;
+        }
+    }
+    return y;
+}
+
+// Gamma 2.2 = x^2 * x^0.2, gerundet wie std::pow(x, 2.2) * 255 + 0.5
+constexpr uint8_t gamma22(int value) {
+    double x = value / 255.0;
+    return static_cast<uint8_t>(x * x * fifthRoot(x) * 255.0 + 0.5);
+}
+
+constexpr uint8_t scale(uint8_t value, uint16_t brightness) {
+    return static_cast<uint8_t>((value * brightness) >> 8);
+}
+
+} // namespace detail
+
+// Farbkreis-Position (0-1535) zu RGB bei voller Sättigung
+RGBColor hueToRgb(uint16_t hue);
+
+// Grad (0-360) bzw. Phase (pos/period) zu Farbkreis-Position
+uint16_t hueFromDegrees(float degrees);
+uint16_t hueFromPhase(uint64_t position, uint64_t period);
+
+// Wahrnehmungs-Gamma (2.2) pro Kanal
+uint8_t gamma(uint8_t value);
+RGBColor gamma(RGBColor color);
+
+// Helligkeit: brightness im Q8-Format (0-256)
+inline uint8_t scale(uint8_t value, uint16_t brightness) {
+    return static_cast<uint8_t>((value * brightness) >> 8);
+}
+RGBColor scale(RGBColor color, uint16_t brightness);
+
+// Prozent/Faktor zu Q8
+inline uint16_t brightnessFromPercent(int percent) {
+    if (percent <= 0) return 0;
+    if (percent >= 100) return BRIGHTNESS_ONE;
+    return static_cast<uint16_t>((percent * BRIGHTNESS_ONE + 50) / 100);
+}
+
+// ---------------------------------------------------------------------------
+// OKLab (Björn Ottosson, 2020) in Festkomma
+// ---------------------------------------------------------------------------
+//
+// L 0..OKLAB_ONE (schwarz..weiß), a/b etwa -0.4..0.4 * OKLAB_ONE. Gleiche
+// Abstände in OKLab wirken gleich groß - eine Überblendung mit gleichen
+// Schritten in OKLab braucht weniger Frames als in sRGB, bis kein Sprung mehr
+// sichtbar ist. Fehler gegenüber der Float-Rechnung: höchstens 1 Stufe.
+
+constexpr int32_t OKLAB_ONE = 1 << 17;      // Q17
+constexpr uint16_t MIX_ONE = 4096;          // Q12: Mischfaktor/Fortschritt 1.0
+
+struct OkLab {
+    int32_t L;
+    int32_t a;
+    int32_t b;
+};
+
+OkLab toOkLab(RGBColor color);
+RGBColor fromOkLab(const OkLab& lab);
+
+// t im Q12-Format (0 = from, MIX_ONE = to)
+inline OkLab mix(const OkLab& from, const OkLab& to, uint16_t t) {
+    return OkLab{ from.L + (((to.L - from.L) * t) >> 12),
+                  from.a + (((to.a - from.a) * t) >> 12),
+                  from.b + (((to.b - from.b) * t) >> 12) };
+}
+RGBColor mixOkLab(RGBColor from, RGBColor to, uint16_t t);
+void mixOkLab(const LEDZones& from, const LEDZones& to, uint16_t t, LEDZones& out);
+
+// Easing-Kurven für Übergänge: Fortschritt Q12 -> Mischfaktor Q12
+enum class Easing : uint8_t {
+    Linear,
+    EaseIn,             // Kubisch, langsamer Start
+    EaseOut,            // Kubisch, langsames Ende
+    EaseInOut           // Smoothstep
+};
+
+uint16_t ease(Easing easing, uint16_t progress);
+
+// ---------------------------------------------------------------------------
+// Batch-Verarbeitung (viele Frames pro Aufruf)
+// ---------------------------------------------------------------------------
+
+// Farbkreis-Frames: hue in 1/256 Stufen (Q8), alle Zonen gleich
+void hueFrames(uint32_t hueStartQ8, uint32_t hueStepQ8, LEDZones* frames, size_t count);
+
+// Alle Frames mit derselben Helligkeit skalieren (SSE2)
+void scaleFrames(LEDZones* frames, size_t count, uint16_t brightness);
+
+// Fade: frame[i] = color * levels[i] (Q8), alle Zonen gleich (SSE2)
+void fadeFrames(const LEDZones& color, const uint16_t* levels, LEDZones* frames, size_t count);
+
+// Gamma auf alle Kanäle anwenden (Tabelle, skalar)
+void gammaFrames(LEDZones* frames, size_t count);
+
+} // namespace Color
+} // namespace HS80
@@ -0,0 +1,343 @@
+#include "HS80_Compositor.h"
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HS80_COMPOSITOR_SSE2 1
+#endif
+
+namespace HS80 {
+
+static_assert(sizeof(LEDZones) == 9, "LEDZones muss 9 gepackte Bytes sein");
+
+uint8_t zoneMask(LEDZone zone) {
+    switch (zone) {
+    case LEDZone::Logo:  return ZONE_MASK_LOGO;
+    case LEDZone::Power: return ZONE_MASK_POWER;
+    case LEDZone::Mic:   return ZONE_MASK_MIC;
+    default:             return ZONE_MASK_ALL;
+    }
+}
+
+static void toBuffer(const LEDZones& zones, Compositor::PixelBuffer& buffer) {
+    memset(buffer.bytes, 0, sizeof(buffer.bytes));
+    memcpy(buffer.bytes, &zones, sizeof(LEDZones));
+}
+
+static LEDZones fromBuffer(const Compositor::PixelBuffer& buffer) {
+    LEDZones zones;
+    memcpy(&zones, buffer.bytes, sizeof(LEDZones));
+    return zones;
+}
+
+// ============================================================================
+// Mischen
+// ============================================================================
+//
+// Alle Modi: erst Ergebnis bei voller Deckkraft (blended), dann
+// out = (dst * (256 - a) + blended * a) >> 8. Alle Zwischenwerte passen in 16 Bit.
+
+void Compositor::blend(const PixelBuffer& dst, const PixelBuffer& src, const uint16_t* alpha,
+                       BlendMode mode, PixelBuffer& out) {
+#ifdef HS80_COMPOSITOR_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i d8 = _mm_load_si128(reinterpret_cast<const __m128i*>(dst.bytes));
+    const __m128i s8 = _mm_load_si128(reinterpret_cast<const __m128i*>(src.bytes));
+
+    __m128i dLo = _mm_unpacklo_epi8(d8, zero);
+    __m128i dHi = _mm_unpackhi_epi8(d8, zero);
+    __m128i bLo, bHi;
+
+    switch (mode) {
+    case BlendMode::Add: {
+        __m128i b8 = _mm_adds_epu8(d8, s8);
+        bLo = _mm_unpacklo_epi8(b8, zero);
+        bHi = _mm_unpackhi_epi8(b8, zero);
+        break;
+    }
+    case BlendMode::Multiply: {
+        // (d * s + 255) >> 8 ≈ d * s / 255
+        const __m128i round = _mm_set1_epi16(255);
+        bLo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(dLo, _mm_unpacklo_epi8(s8, zero)), round), 8);
+        bHi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(dHi, _mm_unpackhi_epi8(s8, zero)), round), 8);
+        break;
+    }
+    case BlendMode::Max: {
+        __m128i b8 = _mm_max_epu8(d8, s8);
+        bLo = _mm_unpacklo_epi8(b8, zero);
+        bHi = _mm_unpackhi_epi8(b8, zero);
+        break;
+    }
+    default:
+        bLo = _mm_unpacklo_epi8(s8, zero);
+        bHi = _mm_unpackhi_epi8(s8, zero);
+        break;
+    }
+
+    const __m128i full = _mm_set1_epi16(256);
+    __m128i aLo = _mm_load_si128(reinterpret_cast<const __m128i*>(alpha));
+    __m128i aHi = _mm_load_si128(reinterpret_cast<const __m128i*>(alpha + 8));
+    __m128i oLo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(dLo, _mm_sub_epi16(full, aLo)),
+                                               _mm_mullo_epi16(bLo, aLo)), 8);
+    __m128i oHi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(dHi, _mm_sub_epi16(full, aHi)),
+                                               _mm_mullo_epi16(bHi, aHi)), 8);
+    _mm_store_si128(reinterpret_cast<__m128i*>(out.bytes), _mm_packus_epi16(oLo, oHi));
+#else
+    for (size_t i = 0; i < sizeof(LEDZones); i++) {
+        unsigned d = dst.bytes[i];
+        unsigned s = src.bytes[i];
+        unsigned b;
+        switch (mode) {
+        case BlendMode::Add:      b = std::min(d + s, 255u); break;
+        case BlendMode::Multiply: b = (d * s + 255) >> 8; break;
+        case BlendMode::Max:      b = std::max(d, s); break;
+        default:                  b = s; break;
+        }
+        out.bytes[i] = static_cast<uint8_t>((d * (256 - alpha[i]) + b * alpha[i]) >> 8);
+    }
+    memset(out.bytes + sizeof(LEDZones), 0, sizeof(out.bytes) - sizeof(LEDZones));
+#endif
+}
+
+// ============================================================================
+// Compositor
+// ============================================================================
+
+Compositor::Compositor()
+    : m_firstDirty(0)
+    , m_nextId(1)
+    , m_statFrames(0)
+    , m_statBlends(0)
+    , m_statCached(0)
+{
+    InitializeCriticalSection(&m_lock);
+    toBuffer(LEDZones(RGBColor(0, 0, 0)), m_background);
+}
+
+Compositor::~Compositor() {
+    DeleteCriticalSection(&m_lock);
+}
+
+Compositor::Layer* Compositor::findLayer(int id) {
+    for (Layer& layer : m_layers) {
+        if (layer.id == id) {
+            return &layer;
+        }
+    }
+    return nullptr;
+}
+
+void Compositor::markDirty(size_t index) {
+    m_firstDirty = std::min(m_firstDirty, index);
+}
+
+void Compositor::markDirty(const Layer* layer) {
+    markDirty(static_cast<size_t>(layer - m_layers.data()));
+}
+
+void Compositor::updateAlpha(Layer& layer) {
+    // 255 -> 256, damit volle Deckkraft exakt ersetzt
+    uint16_t a = layer.visible ? static_cast<uint16_t>(layer.opacity + (layer.opacity >> 7)) : 0;
+    for (int zone = 0; zone < 3; zone++) {
+        uint16_t zoneAlpha = (layer.mask & (1 << zone)) ? a : 0;
+        for (int channel = 0; channel < 3; channel++) {
+            layer.alpha[zone * 3 + channel] = zoneAlpha;
+        }
+    }
+    for (size_t i = sizeof(LEDZones); i < 16; i++) {
+        layer.alpha[i] = 0;
+    }
+}
+
+int Compositor::addLayer(int order, BlendMode mode, uint8_t mask) {
+    Layer layer;
+    layer.order = order;
+    layer.mode = mode;
+    layer.mask = mask & ZONE_MASK_ALL;
+    layer.opacity = 255;
+    layer.visible = true;
+    toBuffer(LEDZones(RGBColor(0, 0, 0)), layer.colors);
+
+    EnterCriticalSection(&m_lock);
+    layer.id = m_nextId++;
+    updateAlpha(layer);
+
+    // Hinter allen Ebenen gleicher order einfügen
+    auto pos = std::upper_bound(m_layers.begin(), m_layers.end(), order,
+        [](int value, const Layer& other) { return value < other.order; });
+    size_t index = static_cast<size_t>(pos - m_layers.begin());
+    m_layers.insert(pos, layer);
+    m_prefix.resize(m_layers.size());
+    markDirty(index);
+    int id = layer.id;
+    LeaveCriticalSection(&m_lock);
+    return id;
+}
+
+bool Compositor::removeLayer(int id) {
+    EnterCriticalSection(&m_lock);
+    Layer* layer = findLayer(id);
+    if (!layer) {
+        LeaveCriticalSection(&m_lock);
+        return false;
+    }
+    size_t index = static_cast<size_t>(layer - m_layers.data());
+    m_layers.erase(m_layers.begin() + index);
+    m_prefix.resize(m_layers.size());
+    markDirty(index);
+    LeaveCriticalSection(&m_lock);
+    return true;
+}
+
+bool Compositor::setLayerColors(int id, const LEDZones& colors) {
+    EnterCriticalSection(&m_lock);
+    Layer* layer = findLayer(id);
+    if (layer) {
+        PixelBuffer buffer;
+        toBuffer(colors, buffer);
+        if (memcmp(buffer.bytes, layer->colors.bytes, sizeof(LEDZones)) != 0) {
+            layer->colors = buffer;
+            markDirty(layer);
+        }
+    }
+    LeaveCriticalSection(&m_lock);
+    return layer != nullptr;
+}
+
+bool Compositor::setLayerColor(int id, RGBColor color) {
+    return setLayerColors(id, LEDZones(color));
+}
+
+bool Compositor::setLayerSource(int id, std::shared_ptr<Effect> source) {
+    EnterCriticalSection(&m_lock);
+    Layer* layer = findLayer(id);
+    if (layer) {
+        layer->source = source;
+        markDirty(layer);
+    }
+    LeaveCriticalSection(&m_lock);
+    return layer != nullptr;
+}
+
+bool Compositor::setLayerMode(int id, BlendMode mode) {
+    EnterCriticalSection(&m_lock);
+    Layer* layer = findLayer(id);
+    if (layer && layer->mode != mode) {
+        layer->mode = mode;
+        markDirty(layer);
+    }
+    LeaveCriticalSection(&m_lock);
+    return layer != nullptr;
+}
+
+bool Compositor::setLayerMask(int id, uint8_t mask) {
+    EnterCriticalSection(&m_lock);
+    Layer* layer = findLayer(id);
+    if (layer && layer->mask != (mask & ZONE_MASK_ALL)) {
+        layer->mask = mask & ZONE_MASK_ALL;
+        updateAlpha(*layer);
+        markDirty(layer);
+    }
+    LeaveCriticalSection(&m_lock);
+    return layer != nullptr;
+}
+
+bool Compositor::setLayerOpacity(int id, uint8_t opacity) {
+    EnterCriticalSection(&m_lock);
+    Layer* layer = findLayer(id);
+    if (layer && layer->opacity != opacity) {
+        layer->opacity = opacity;
+        updateAlpha(*layer);
+        markDirty(layer);
+    }
+    LeaveCriticalSection(&m_lock);
+    return layer != nullptr;
+}
+
+bool Compositor::setLayerVisible(int id, bool visible) {
+    EnterCriticalSection(&m_lock);
+    Layer* layer = findLayer(id);
+    if (layer && layer->visible != visible) {
+        layer->visible = visible;
+        updateAlpha(*layer);
+        markDirty(layer);
+    }
+    LeaveCriticalSection(&m_lock);
+    return layer != nullptr;
+}
+
+void Compositor::setBackground(const LEDZones& colors) {
+    EnterCriticalSection(&m_lock);
+    toBuffer(colors, m_background);
+    markDirty(static_cast<size_t>(0));
+    LeaveCriticalSection(&m_lock);
+}
+
+// Animierte Ebenen rendern; nur tatsächlich geänderte Ebenen werden dirty
+void Compositor::renderSources(const FrameContext& frame) {
+    for (size_t i = 0; i < m_layers.size(); i++) {
+        Layer& layer = m_layers[i];
+        if (!layer.source || !layer.visible) {
+            continue;
+        }
+
+        LEDZones zones;
+        EffectStatus status = layer.source->render(frame, zones);
+        if (memcmp(&zones, layer.colors.bytes, sizeof(LEDZones)) != 0) {
+            memcpy(layer.colors.bytes, &zones, sizeof(LEDZones));
+            markDirty(i);
+        }
+
+        // Beendete Quelle: letzter Frame bleibt als statische Farbe stehen
+        if (status == EffectStatus::Finished) {
+            layer.source.reset();
+        }
+    }
+}
+
+LEDZones Compositor::composeLocked() {
+    m_statFrames++;
+    size_t count = m_layers.size();
+
+    if (m_firstDirty >= count) {
+        m_statCached++;
+        return fromBuffer(count > 0 ? m_prefix[count - 1] : m_background);
+    }
+
+    for (size_t i = m_firstDirty; i < count; i++) {
+        const PixelBuffer& below = (i == 0) ? m_background : m_prefix[i - 1];
+        const Layer& layer = m_layers[i];
+        blend(below, layer.colors, layer.alpha, layer.mode, m_prefix[i]);
+        m_statBlends++;
+    }
+    m_firstDirty = count;
+
+    return fromBuffer(m_prefix[count - 1]);
+}
+
+EffectStatus Compositor::render(const FrameContext& frame, LEDZones& zones) {
+    EnterCriticalSection(&m_lock);
+    renderSources(frame);
+    zones = composeLocked();
+    LeaveCriticalSection(&m_lock);
+    return EffectStatus::Running;
+}
+
+LEDZones Compositor::compose() {
+    EnterCriticalSection(&m_lock);
+    LEDZones zones = composeLocked();
+    LeaveCriticalSection(&m_lock);
+    return zones;
+}
+
+CompositorStats Compositor::getStats() const {
+    EnterCriticalSection(&m_lock);
+    CompositorStats stats;
+    stats.frames = m_statFrames;
+    stats.layerBlends = m_statBlends;
+    stats.cachedFrames = m_statCached;
+    LeaveCriticalSection(&m_lock);
+    return stats;
+}
+
+} // namespace HS80
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "HS80_Animation.h"
+#include <vector>
+
+// ============================================================================
+// HS80 Compositor - Mehrere Ebenen pro Zone überlagern
+// ============================================================================
+//
+// Mehrere unabhängige Erzeuger (Grund-Effekt, Mute-Anzeige, Akku-Warnung ...)
+// schreiben jeweils in eine eigene Ebene. Der Compositor mischt die Ebenen in
+// aufsteigender Reihenfolge (order) und ist selbst ein Effect, läuft also über
+// RGBController::startEffect() im Animation-Thread.
+//
+// Jede Ebene liegt als gepackter 16-Byte-Puffer vor (9 Bytes RGB für Logo,
+// Power, Mic + Padding), gemischt wird mit SSE2. Zwischenergebnisse werden pro
+// Ebene gecacht: ändert sich nur Ebene k, werden nur Ebenen ab k neu gemischt.
+// ============================================================================
+
+namespace HS80 {
+
+enum class BlendMode {
+    Alpha,      // Ebene ersetzt darunterliegende Farbe (mit Deckkraft)
+    Add,        // Kanäle addieren (sättigend)
+    Multiply,   // Kanäle multiplizieren (abdunkeln/einfärben)
+    Max         // Hellerer Kanal gewinnt
+};
+
+// Zonen-Masken (Bits entsprechend LEDZone)
+constexpr uint8_t ZONE_MASK_LOGO  = 0x01;
+constexpr uint8_t ZONE_MASK_POWER = 0x02;
+constexpr uint8_t ZONE_MASK_MIC   = 0x04;
+constexpr uint8_t ZONE_MASK_ALL   = 0x07;
+
+uint8_t zoneMask(LEDZone zone);
+
+struct CompositorStats {
+    uint64_t frames;            // render()/compose()-Aufrufe
+    uint64_t layerBlends;       // Tatsächlich gemischte Ebenen
+    uint64_t cachedFrames;      // Frames ohne Neuberechnung
+};
+
+class Compositor : public Effect {
+public:
+    // Gepackter Pixelpuffer: 9 Bytes LEDZones + 7 Bytes Padding
+    struct alignas(16) PixelBuffer {
+        uint8_t bytes[16];
+    };
+
+private:
+    struct Layer {
+        int id;
+        int order;
+        BlendMode mode;
+        uint8_t mask;
+        uint8_t opacity;
+        bool visible;
+        std::shared_ptr<Effect> source;     // Animierte Ebene (optional)
+        PixelBuffer colors;
+        alignas(16) uint16_t alpha[16];     // Deckkraft pro Byte, 0-256
+    };
+
+    mutable CRITICAL_SECTION m_lock;
+    std::vector<Layer> m_layers;            // Sortiert nach order
+    std::vector<PixelBuffer> m_prefix;      // Ergebnis nach Ebene i
+    PixelBuffer m_background;
+    size_t m_firstDirty;                    // Erste neu zu mischende Ebene
+    int m_nextId;
+
+    uint64_t m_statFrames;
+    uint64_t m_statBlends;
+    uint64_t m_statCached;
+
+    Layer* findLayer(int id);
+    void markDirty(size_t index);
+    void markDirty(const Layer* layer);
+    void updateAlpha(Layer& layer);
+    void renderSources(const FrameContext& frame);
+    LEDZones composeLocked();
+
+public:
+    Compositor();
+    ~Compositor();
+
+    Compositor(const Compositor&) = delete;
+    Compositor& operator=(const Compositor&) = delete;
+
+    // Ebenen (niedrige order unten); Rückgabe: Ebenen-ID
+    int addLayer(int order, BlendMode mode = BlendMode::Alpha, uint8_t mask = ZONE_MASK_ALL);
+    bool removeLayer(int id);
+
+    bool setLayerColors(int id, const LEDZones& colors);
+    bool setLayerColor(int id, RGBColor color);
+    bool setLayerSource(int id, std::shared_ptr<Effect> source);  // nullptr = statisch
+    bool setLayerMode(int id, BlendMode mode);
+    bool setLayerMask(int id, uint8_t mask);
+    bool setLayerOpacity(int id, uint8_t opacity);
+    bool setLayerVisible(int id, bool visible);
+
+    void setBackground(const LEDZones& colors);
+
+    // Effect: mischt alle Ebenen (läuft endlos)
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override;
+
+    // Aktuelles Ergebnis ohne Animation (nur statische Ebenen)
+    LEDZones compose();
+
+    CompositorStats getStats() const;
+
+    // Mischt src über dst (9 Bytes, Deckkraft pro Byte 0-256) nach out
+    static void blend(const PixelBuffer& dst, const PixelBuffer& src, const uint16_t* alpha,
+                      BlendMode mode, PixelBuffer& out);
+};
+
+} // namespace HS80
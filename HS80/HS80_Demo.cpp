@@ -3,6 +3,8 @@
 // ============================================================================
 
 #include "HS80_Library.h"
+#include "HS80_Keyframes.h"
+#include "HS80_Audio.h"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
@@ -80,8 +82,10 @@ void printMenu() {
     std::cout << "  8 - Corsair Blau" << std::endl;
     std::cout << "  9 - Aus" << std::endl;
     std::cout << "\nEffekte:" << std::endl;
-    std::cout << "  R - Regenbogen" << std::endl;
-    std::cout << "  P - Puls (Rot)" << std::endl;
+    std::cout << "  R - Regenbogen (bis Farbwahl)" << std::endl;
+    std::cout << "  P - Puls (Rot, bis Farbwahl)" << std::endl;
+    std::cout << "  K - Keyframe-Animation 'atmen' (animations\\beispiele.hs8k)" << std::endl;
+    std::cout << "  A - Audio-reaktiv (audio.wav: Bass/Mitten/Hoehen)" << std::endl;
     std::cout << "\nZonen-Test:" << std::endl;
     std::cout << "  Z - Verschiedene Farben pro Zone" << std::endl;
     std::cout << "  L - Nur Logo (Rot)" << std::endl;
@@ -92,6 +96,7 @@ void printMenu() {
     std::cout << "  - - Dunkler (-10%)" << std::endl;
     std::cout << "  B - Helligkeit setzen (0-100%)" << std::endl;
     std::cout << "\nSystem:" << std::endl;
+    std::cout << "  S - Headset-Zustand anzeigen" << std::endl;
     std::cout << "  H - Hardware-Modus" << std::endl;
     std::cout << "  Q - Beenden" << std::endl;
     std::cout << "========================================" << std::endl;
@@ -133,12 +138,21 @@ int main() {
         std::cerr << "WARNUNG: Keep-Alive konnte nicht gestartet werden!" << std::endl;
     }
     
+    // Nur echte Zustandswechsel anzeigen, Akku/Lade-Bursts zusammenfassen
+    EventFilterConfig filter;
+    filter.changeOnly = true;
+    filter.coalesceWindowMs = 500;
+    manager.events().setEventFilter(filter);
+    
     // Event-Monitoring starten
     std::cout << "[INIT] Starte Event-Monitoring..." << std::endl;
     if (!manager.startEventMonitoring(onHeadsetEvent)) {
         std::cerr << "WARNUNG: Event-Monitoring konnte nicht gestartet werden!" << std::endl;
     }
     
+    // Zustand jede Minute per Abfrage auffrischen, falls keine Events kommen
+    manager.startStateRefresh(60000);
+    
     // Begrüßung mit Corsair Blau
     manager.setLEDs(RGBColor(0, 155, 222));
     
@@ -195,17 +209,51 @@ int main() {
             
         case '9': 
             std::cout << "[RGB] LEDs AUS..." << std::endl;
+            manager.rgb().stopEffect();
+            manager.rgb().waitEffect();
             manager.rgb().off(); 
             break;
             
         case 'R': 
-            std::cout << "[EFFEKT] Starte Regenbogen..." << std::endl;
-            manager.rgb().rainbow(10000, 50); 
+            std::cout << "[EFFEKT] Starte Regenbogen (laeuft im Hintergrund)..." << std::endl;
+            manager.rgb().startRainbow(0, 50); 
             break;
             
         case 'P': 
-            std::cout << "[EFFEKT] Starte Puls..." << std::endl;
-            manager.rgb().pulse(RGBColor(255, 0, 0), 3, 30); 
+            std::cout << "[EFFEKT] Starte Puls (laeuft im Hintergrund)..." << std::endl;
+            manager.rgb().startPulse(RGBColor(255, 0, 0), 0, 30); 
+            break;
+            
+        case 'K':
+            {
+                auto library = std::make_shared<KeyframeLibrary>();
+                KeyframeAnimation animation;
+                if (library->open("animations\\beispiele.hs8k")) {
+                    animation = library->find("atmen");
+                }
+                if (animation.valid()) {
+                    std::cout << "[EFFEKT] Starte Keyframe-Animation 'atmen'..." << std::endl;
+                    manager.rgb().startEffect(std::make_shared<KeyframeEffect>(library, animation), 20);
+                } else {
+                    std::cout << "[EFFEKT] Animation nicht gefunden - zuerst HS80_KeyframeTool ausfuehren!" << std::endl;
+                }
+            }
+            break;
+            
+        case 'A':
+            {
+                // Der Effekt hält die Pipeline am Leben; sie endet mit der Datei
+                auto wav = std::unique_ptr<WavFileSource>(new WavFileSource());
+                wav->setRealtime(true);
+                if (wav->open("audio.wav")) {
+                    auto pipeline = std::make_shared<AudioPipeline>();
+                    pipeline->start(std::move(wav));
+                    std::cout << "[EFFEKT] Starte Audio-Effekt (audio.wav)..." << std::endl;
+                    manager.rgb().startEffect(std::make_shared<AudioReactiveEffect>(pipeline), 10);
+                } else {
+                    std::cout << "[EFFEKT] audio.wav nicht gefunden (PCM 16 Bit oder Float)!" << std::endl;
+                }
+            }
             break;
             
         case 'Z':
@@ -271,6 +319,27 @@ int main() {
             }
             break;
             
+        case 'S':
+            {
+                // Aus dem Zustands-Cache, kein Geräte-Roundtrip
+                HeadsetState state = manager.getState();
+                std::cout << "\n[ZUSTAND] Mikrofon: "
+                          << (state.muted < 0 ? "unbekannt" : (state.muted ? "STUMM" : "AKTIV")) << std::endl;
+                std::cout << "[ZUSTAND] Akku:     ";
+                if (state.batteryLevel < 0) std::cout << "unbekannt" << std::endl;
+                else std::cout << state.batteryLevel << "%" << std::endl;
+                std::cout << "[ZUSTAND] Laden:    "
+                          << (state.charging == ChargingState::Charging ? "laedt" :
+                              state.charging == ChargingState::FullyCharged ? "voll" :
+                              state.charging == ChargingState::Discharging ? "entlaedt" : "unbekannt") << std::endl;
+                if (state.hasData()) {
+                    auto age = std::chrono::duration_cast<std::chrono::seconds>(
+                        std::chrono::steady_clock::now() - state.lastUpdate).count();
+                    std::cout << "[ZUSTAND] Letzte Aktualisierung vor " << age << "s" << std::endl;
+                }
+            }
+            break;
+            
         case 'H':
             std::cout << "[SYSTEM] Stelle Hardware-Modus wieder her..." << std::endl;
             manager.rgb().setHardwareMode();
@@ -0,0 +1,141 @@
+#include "HS80_Dither.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace HS80 {
+
+// ============================================================================
+// Ditherer
+// ============================================================================
+
+Ditherer::Ditherer()
+    : m_shift(0)
+    , m_calmFrames(0)
+    , m_hardwareBrightness(-1)
+    , m_statFrames(0)
+    , m_statChanges(0) {
+    memset(m_error, 0, sizeof(m_error));
+}
+
+void Ditherer::setConfig(const DitherConfig& config) {
+    m_config = config;
+    m_config.maxShift = std::max(0, std::min(6, m_config.maxShift));
+    m_config.holdFrames = std::max(0, m_config.holdFrames);
+}
+
+void Ditherer::reset(int hardwareBrightness) {
+    memset(m_error, 0, sizeof(m_error));
+    m_shift = 0;
+    m_calmFrames = 0;
+    m_hardwareBrightness = hardwareBrightness;
+}
+
+void Ditherer::process(const HighResZones& target, int userBrightness, DitherFrame& out) {
+    m_statFrames++;
+    unsigned char* zones = reinterpret_cast<unsigned char*>(&out.zones);
+
+    // Größter Shift, bei dem der hellste Kanal (+ halbe Stufe Rest) noch in 8 Bit
+    // passt und die Hardware-Helligkeit nicht auf 0 fällt
+    int fit = 0;
+    if (m_config.enabled && userBrightness > 1) {
+        uint32_t peak = 0;
+        for (int i = 0; i < 9; i++) {
+            peak = std::max<uint32_t>(peak, target.channel[i]);
+        }
+        while (fit < m_config.maxShift && (peak << (fit + 1)) + 128 <= (255u << 8) &&
+               (userBrightness >> (fit + 1)) > 0) {
+            fit++;
+        }
+    }
+
+    // Heller: sofort (sonst abgeschnitten). Dunkler: erst nach holdFrames
+    if (fit < m_shift) {
+        m_shift = fit;
+        m_calmFrames = 0;
+    } else if (fit > m_shift) {
+        if (++m_calmFrames >= m_config.holdFrames) {
+            m_shift = fit;
+            m_calmFrames = 0;
+        }
+    } else {
+        m_calmFrames = 0;
+    }
+
+    int hardware = userBrightness;
+    if (m_shift > 0) {
+        hardware = std::max(1, (userBrightness + (1 << (m_shift - 1))) >> m_shift);
+    }
+    if (hardware != m_hardwareBrightness) {
+        if (m_hardwareBrightness >= 0) {
+            m_statChanges++;
+        }
+        // Rest gehört zur alten Skalierung
+        memset(m_error, 0, sizeof(m_error));
+        m_hardwareBrightness = hardware;
+    }
+    out.hardwareBrightness = hardware;
+
+    if (!m_config.enabled || hardware <= 0) {
+        for (int i = 0; i < 9; i++) {
+            zones[i] = static_cast<unsigned char>(std::min(255, (target.channel[i] + 128) >> 8));
+        }
+        return;
+    }
+
+    // Exakter Faktor eingestellte/Hardware-Helligkeit (Q16), dann Fehlerdiffusion
+    const uint64_t gain = (static_cast<uint64_t>(userBrightness) << 16) / hardware;
+    for (int i = 0; i < 9; i++) {
+        int32_t value = static_cast<int32_t>((target.channel[i] * gain) >> 16) + m_error[i];
+        int32_t level = std::max(0, std::min(255, (value + 128) >> 8));
+        m_error[i] = std::max(-256, std::min(256, value - (level << 8)));
+        zones[i] = static_cast<unsigned char>(level);
+    }
+}
+
+DitherStats Ditherer::getStats() const {
+    DitherStats stats;
+    stats.frames = m_statFrames;
+    stats.brightnessChanges = m_statChanges;
+    stats.shift = m_shift;
+    stats.hardwareBrightness = m_hardwareBrightness;
+    return stats;
+}
+
+// ============================================================================
+// FadeEffect
+// ============================================================================
+
+FadeEffect::FadeEffect(RGBColor color, double fromLevel, double toLevel, double durationMs, Color::Easing easing, bool repeat)
+    : m_color(color)
+    , m_fromLevel(std::max(0.0, std::min(1.0, fromLevel)))
+    , m_toLevel(std::max(0.0, std::min(1.0, toLevel)))
+    , m_durationMs(durationMs)
+    , m_easing(easing)
+    , m_repeat(repeat) {
+}
+
+EffectStatus FadeEffect::renderHighRes(const FrameContext& frame, HighResZones& zones) {
+    double progress = m_durationMs > 0 ? frame.timeMs / m_durationMs : 1.0;
+    bool finished = false;
+    if (m_repeat) {
+        double cycle = std::fmod(progress, 2.0);
+        progress = cycle <= 1.0 ? cycle : 2.0 - cycle;
+    } else if (progress >= 1.0) {
+        progress = 1.0;
+        finished = true;
+    }
+
+    uint16_t t = Color::ease(m_easing, static_cast<uint16_t>(progress * Color::MIX_ONE + 0.5));
+    double level = m_fromLevel + (m_toLevel - m_fromLevel) * t / Color::MIX_ONE;
+
+    // Gamma 2.2 in Q16, Kanal * Q16 >> 8 = Q8.8
+    uint32_t scale = static_cast<uint32_t>(std::pow(level, 2.2) * 65536.0 + 0.5);
+    const uint8_t rgb[3] = { m_color.r, m_color.g, m_color.b };
+    for (int i = 0; i < 9; i++) {
+        zones.channel[i] = static_cast<uint16_t>((rgb[i % 3] * scale) >> 8);
+    }
+    return finished ? EffectStatus::Finished : EffectStatus::Running;
+}
+
+} // namespace HS80
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "HS80_Animation.h"
+#include "HS80_Color.h"
+
+// ============================================================================
+// HS80 Dither - Mehr als 8 Bit Helligkeit über Hardware-Helligkeit + Dithering
+// ============================================================================
+//
+// Das Farbpaket (0x06) hat 8 Bit pro Kanal; bei Fades nahe Schwarz sind die
+// Stufen 0 -> 1 -> 2 deutlich sichtbar. Zwei Hebel, die sich ergänzen:
+//
+//   1. Hardware-Helligkeit (0-1000, eigenes Paket): Ist der hellste Kanal
+//      dunkel genug, wird die Hardware-Helligkeit halbiert (bis zu maxShift
+//      mal) und die Farbwerte verdoppelt - jede Halbierung ist ein Bit mehr.
+//      Absenken erst nach holdFrames ruhigen Frames, Anheben sofort (kein
+//      Abschneiden): Helligkeitspakete bleiben selten.
+//   2. Fehlerdiffusion über die Zeit: pro Kanal wird der Rundungsrest in den
+//      nächsten Frame getragen. Der Mittelwert über wenige Frames trifft den
+//      Zielwert auf Bruchteile einer Stufe.
+//
+// Annahme: die Hardware skaliert linear (Ausgabe ~ Farbwert * Helligkeit).
+// Beim Wechsel der Hardware-Helligkeit ordnet der RGBController die beiden
+// Pakete so, dass der Zwischenzustand nie heller ist als das Ziel.
+// ============================================================================
+
+namespace HS80 {
+
+struct DitherConfig {
+    bool enabled;               // false = nur runden, Hardware-Helligkeit unverändert
+    int maxShift;               // Höchstens 2^maxShift fach abgesenkt (0-6)
+    int holdFrames;             // Ruhige Frames vor dem Absenken
+
+    DitherConfig() : enabled(true), maxShift(4), holdFrames(8) {}
+};
+
+struct DitherStats {
+    uint64_t frames;
+    uint64_t brightnessChanges;     // Zusätzliche Helligkeitspakete
+    int shift;                      // Aktuelle Absenkung
+    int hardwareBrightness;
+};
+
+// Ein Ausgabe-Frame: Farbpaket + Hardware-Helligkeit
+struct DitherFrame {
+    LEDZones zones;
+    int hardwareBrightness;
+};
+
+class Ditherer {
+private:
+    DitherConfig m_config;
+    int32_t m_error[9];             // Rundungsrest pro Kanal (Q8)
+    int m_shift;
+    int m_calmFrames;               // Frames, in denen ein größerer Shift gepasst hätte
+    int m_hardwareBrightness;       // -1 = unbekannt
+    uint64_t m_statFrames;
+    uint64_t m_statChanges;
+
+public:
+    Ditherer();
+
+    void setConfig(const DitherConfig& config);
+    DitherConfig getConfig() const { return m_config; }
+
+    // Nach setColors()/setBrightness(): Rest verwerfen, Hardware = brightness
+    void reset(int hardwareBrightness);
+
+    // Ziel (Q8.8) bei eingestellter Helligkeit userBrightness (0-1000)
+    void process(const HighResZones& target, int userBrightness, DitherFrame& out);
+
+    DitherStats getStats() const;
+};
+
+// Ein-/Ausblenden einer Farbe in Q8.8, level 0-1 wahrnehmungs-linear
+// (Gamma 2.2 wie PulseEffect). repeat = endlos hin und zurück (Atmen).
+class FadeEffect : public HighResEffect {
+private:
+    RGBColor m_color;
+    double m_fromLevel;
+    double m_toLevel;
+    double m_durationMs;
+    Color::Easing m_easing;
+    bool m_repeat;
+
+public:
+    FadeEffect(RGBColor color, double fromLevel, double toLevel, double durationMs,
+               Color::Easing easing = Color::Easing::Linear, bool repeat = false);
+    EffectStatus renderHighRes(const FrameContext& frame, HighResZones& zones) override;
+};
+
+} // namespace HS80
@@ -0,0 +1,391 @@
+#include "HS80_EffectCache.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+namespace HS80 {
+
+static_assert(sizeof(LEDZones) == 9, "LEDZones wird roh in die Cache-Datei geschrieben");
+
+// ============================================================================
+// Schlüssel
+// ============================================================================
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// Felder mit Länge davor, damit ("ab", "c") und ("a", "bc") verschieden sind
+static uint64_t hashKey(uint64_t seed, const EffectCacheKey& key) {
+    auto field = [](uint64_t hash, const std::string& text) {
+        uint32_t length = static_cast<uint32_t>(text.size());
+        hash = fnv1a(hash, &length, sizeof(length));
+        return fnv1a(hash, text.data(), text.size());
+    };
+    uint64_t hash = field(seed, LIBRARY_VERSION);
+    hash = fnv1a(hash, &EFFECT_CACHE_VERSION, sizeof(EFFECT_CACHE_VERSION));
+    hash = field(hash, key.effect);
+    hash = field(hash, key.parameters);
+    hash = fnv1a(hash, &key.frameIntervalUs, sizeof(key.frameIntervalUs));
+    return fnv1a(hash, &key.maxFrames, sizeof(key.maxFrames));
+}
+
+uint64_t EffectCacheKey::hash() const {
+    return hashKey(0xCBF29CE484222325ULL, *this);
+}
+
+uint64_t EffectCacheKey::checkHash() const {
+    return hashKey(0x84222325CBF29CE4ULL, *this);
+}
+
+// ============================================================================
+// CachedSequence (gemappte Datei)
+// ============================================================================
+
+CachedSequence::CachedSequence()
+    : m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(nullptr)
+    , m_data(nullptr)
+    , m_size(0) {
+}
+
+CachedSequence::~CachedSequence() {
+    close();
+}
+
+uint64_t CachedSequence::checksum(const uint8_t* data, size_t size) {
+    return fnv1a(0xCBF29CE484222325ULL, data, size);
+}
+
+bool CachedSequence::open(const std::string& path, const EffectCacheKey& key, std::string& error) {
+    close();
+
+    // FILE_SHARE_DELETE: Aufräumen darf die Datei löschen, solange sie gemappt ist
+    m_file = CreateFileA(path.c_str(), GENERIC_READ | FILE_WRITE_ATTRIBUTES,
+                         FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        error = "Datei nicht gefunden";
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(EffectCacheHeader)) {
+        error = "Ungueltige Dateigroesse";
+        close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping) {
+        m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (!m_data) {
+        error = "Mapping fehlgeschlagen (Error " + std::to_string(GetLastError()) + ")";
+        close();
+        return false;
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+
+    const EffectCacheHeader* h = header();
+    uint64_t expectedSize = static_cast<uint64_t>(h->frameCount) * sizeof(LEDZones);
+    if (h->magic != EFFECT_CACHE_MAGIC || h->version != EFFECT_CACHE_VERSION) {
+        error = "Kein gueltiges .hs8f-Format";
+    } else if (h->key != key.hash() || h->keyCheck != key.checkHash()) {
+        error = "Schluessel passt nicht";
+    } else if (h->frameCount == 0 || h->dataSize != expectedSize ||
+               h->dataOffset < sizeof(EffectCacheHeader) || h->dataOffset + h->dataSize != m_size) {
+        error = "Groesse passt nicht";
+    } else if (checksum(m_data + h->dataOffset, static_cast<size_t>(h->dataSize)) != h->checksum) {
+        error = "Pruefsumme falsch";
+    } else {
+        // Letzter Zugriff für die LRU-Reihenfolge (NTFS aktualisiert ihn nicht zuverlässig)
+        FILETIME now;
+        GetSystemTimeAsFileTime(&now);
+        SetFileTime(m_file, nullptr, &now, nullptr);
+        return true;
+    }
+
+    close();
+    return false;
+}
+
+void CachedSequence::close() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+    m_size = 0;
+}
+
+// ============================================================================
+// CachedEffect
+// ============================================================================
+
+CachedEffect::CachedEffect(std::shared_ptr<const CachedSequence> sequence)
+    : m_sequence(std::move(sequence)) {
+}
+
+EffectStatus CachedEffect::render(const FrameContext& frame, LEDZones& zones) {
+    uint32_t count = m_sequence->frameCount();
+    double intervalMs = m_sequence->frameIntervalMs();
+
+    // Nach Soll-Zeit, nicht nach frameIndex: gleiche Wiedergabe bei anderem Takt
+    uint64_t index = intervalMs > 0.0 ? static_cast<uint64_t>(frame.timeMs / intervalMs + 0.5) : frame.frameIndex;
+    if (m_sequence->finite()) {
+        if (index + 1 >= count) {
+            zones = m_sequence->frames()[count - 1];
+            return EffectStatus::Finished;
+        }
+    } else {
+        index %= count;
+    }
+    zones = m_sequence->frames()[index];
+    return EffectStatus::Running;
+}
+
+// ============================================================================
+// EffectCache
+// ============================================================================
+
+EffectCache::EffectCache(const std::string& directory, uint64_t maxBytes)
+    : m_directory(directory)
+    , m_maxBytes(maxBytes) {
+    InitializeCriticalSection(&m_lock);
+    memset(&m_stats, 0, sizeof(m_stats));
+    CreateDirectoryA(m_directory.c_str(), nullptr);     // Existiert meist schon
+}
+
+EffectCache::~EffectCache() {
+    DeleteCriticalSection(&m_lock);
+}
+
+std::string EffectCache::pathFor(uint64_t key) const {
+    char name[24];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return m_directory + "\\" + name + ".hs8f";
+}
+
+std::shared_ptr<const CachedSequence> EffectCache::find(const EffectCacheKey& key) {
+    std::string path = pathFor(key.hash());
+
+    LARGE_INTEGER start, end, frequency;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&start);
+
+    auto sequence = std::make_shared<CachedSequence>();
+    std::string error;
+    bool ok = sequence->open(path, key, error);
+
+    QueryPerformanceCounter(&end);
+
+    EnterCriticalSection(&m_lock);
+    if (ok) {
+        m_stats.hits++;
+        m_stats.lastOpenUs = (end.QuadPart - start.QuadPart) * 1e6 / frequency.QuadPart;
+    } else {
+        m_stats.misses++;
+    }
+    LeaveCriticalSection(&m_lock);
+
+    if (ok) {
+        return sequence;
+    }
+
+    // Vorhanden, aber unbrauchbar: verwerfen, damit neu gerendert wird
+    DWORD attributes = GetFileAttributesA(path.c_str());
+    if (attributes != INVALID_FILE_ATTRIBUTES) {
+        std::cerr << "[CACHE] Verworfen (" << error << "): " << path << std::endl;
+        DeleteFileA(path.c_str());
+        EnterCriticalSection(&m_lock);
+        m_stats.corrupt++;
+        LeaveCriticalSection(&m_lock);
+    }
+    return nullptr;
+}
+
+bool EffectCache::writeFile(const EffectCacheKey& key, const std::vector<LEDZones>& frames, bool finite) {
+    EffectCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = EFFECT_CACHE_MAGIC;
+    header.version = EFFECT_CACHE_VERSION;
+    header.flags = finite ? EFFECT_CACHE_FINITE : 0;
+    header.key = key.hash();
+    header.keyCheck = key.checkHash();
+    header.frameCount = static_cast<uint32_t>(frames.size());
+    header.frameIntervalUs = key.frameIntervalUs;
+    header.dataOffset = sizeof(EffectCacheHeader);
+    header.dataSize = frames.size() * sizeof(LEDZones);
+    header.checksum = CachedSequence::checksum(reinterpret_cast<const uint8_t*>(frames.data()),
+                                               static_cast<size_t>(header.dataSize));
+
+    // Erst vollständig schreiben, dann umbenennen: Leser sehen nie halbe Dateien
+    std::string path = pathFor(header.key);
+    std::string tempPath = path + "." + std::to_string(GetCurrentThreadId()) + ".tmp";
+    HANDLE file = CreateFileA(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "[CACHE] Kann nicht schreiben: " << tempPath << " Error: " << GetLastError() << std::endl;
+        return false;
+    }
+
+    DWORD written = 0;
+    bool ok = WriteFile(file, &header, sizeof(header), &written, nullptr) && written == sizeof(header);
+    if (ok) {
+        ok = WriteFile(file, frames.data(), static_cast<DWORD>(header.dataSize), &written, nullptr) &&
+             written == header.dataSize;
+    }
+    CloseHandle(file);
+
+    if (!ok || !MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        std::cerr << "[CACHE] Schreiben fehlgeschlagen: " << path << " Error: " << GetLastError() << std::endl;
+        DeleteFileA(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<const CachedSequence> EffectCache::store(const EffectCacheKey& key, Effect& effect) {
+    if (key.maxFrames == 0 || key.frameIntervalUs == 0) {
+        return nullptr;
+    }
+
+    LARGE_INTEGER start, end, frequency;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&start);
+
+    // Offline rendern: gleiche Soll-Zeiten wie im Animation-Thread, ohne Warten
+    std::vector<LEDZones> frames;
+    frames.reserve(key.maxFrames);
+    FrameContext frame = {};
+    frame.frameIntervalMs = key.frameIntervalUs / 1000.0;
+    bool finite = false;
+    for (uint32_t i = 0; i < key.maxFrames; i++) {
+        frame.frameIndex = i;
+        frame.timeMs = i * frame.frameIntervalMs;
+        LEDZones zones;
+        EffectStatus status = effect.render(frame, zones);
+        frames.push_back(zones);
+        if (status == EffectStatus::Finished) {
+            finite = true;
+            break;
+        }
+    }
+
+    QueryPerformanceCounter(&end);
+
+    if (!writeFile(key, frames, finite)) {
+        return nullptr;
+    }
+
+    EnterCriticalSection(&m_lock);
+    m_stats.rendered++;
+    m_stats.lastRenderMs = (end.QuadPart - start.QuadPart) * 1000.0 / frequency.QuadPart;
+    LeaveCriticalSection(&m_lock);
+
+    evict(m_maxBytes);
+
+    auto sequence = std::make_shared<CachedSequence>();
+    std::string error;
+    if (!sequence->open(pathFor(key.hash()), key, error)) {
+        std::cerr << "[CACHE] Neu geschriebene Datei ungueltig: " << error << std::endl;
+        return nullptr;
+    }
+    return sequence;
+}
+
+std::shared_ptr<Effect> EffectCache::load(const EffectCacheKey& key, const EffectFactory& factory) {
+    auto sequence = find(key);
+    if (sequence) {
+        return std::make_shared<CachedEffect>(sequence);
+    }
+
+    std::shared_ptr<Effect> effect = factory();
+    if (!effect) {
+        return nullptr;
+    }
+    sequence = store(key, *effect);
+    if (sequence) {
+        return std::make_shared<CachedEffect>(sequence);
+    }
+
+    // Cache nicht nutzbar: Effekt frisch erzeugen (der erste wurde schon abgespielt)
+    return factory();
+}
+
+void EffectCache::evict(uint64_t targetBytes) {
+    struct Entry {
+        std::string path;
+        uint64_t size;
+        uint64_t lastAccess;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((m_directory + "\\*.hs8f").c_str(), &data);
+    if (find != INVALID_HANDLE_VALUE) {
+        do {
+            if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+                continue;
+            }
+            Entry entry;
+            entry.path = m_directory + "\\" + data.cFileName;
+            entry.size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+            entry.lastAccess = (static_cast<uint64_t>(data.ftLastAccessTime.dwHighDateTime) << 32) |
+                               data.ftLastAccessTime.dwLowDateTime;
+            total += entry.size;
+            entries.push_back(entry);
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+
+    uint64_t evictions = 0;
+    if (total > targetBytes) {
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            return a.lastAccess < b.lastAccess;
+        });
+        for (const Entry& entry : entries) {
+            if (total <= targetBytes) {
+                break;
+            }
+            // Gemappte Dateien lassen sich dank FILE_SHARE_DELETE löschen,
+            // bleiben aber bis zum Schließen lesbar
+            if (DeleteFileA(entry.path.c_str())) {
+                total -= entry.size;
+                evictions++;
+            }
+        }
+    }
+
+    EnterCriticalSection(&m_lock);
+    m_stats.evictions += evictions;
+    m_stats.bytes = total;
+    LeaveCriticalSection(&m_lock);
+}
+
+void EffectCache::clear() {
+    evict(0);
+}
+
+EffectCacheStats EffectCache::getStats() const {
+    EnterCriticalSection(&m_lock);
+    EffectCacheStats stats = m_stats;
+    LeaveCriticalSection(&m_lock);
+    return stats;
+}
+
+} // namespace HS80
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "HS80_Animation.h"
+#include <string>
+
+// ============================================================================
+// HS80 EffectCache - Vorgerenderte Effekte auf der Platte
+// ============================================================================
+//
+// Aufwendige prozedurale Effekte (Skripte, lange Keyframe-Ketten ...) werden
+// einmal offline gerendert und als Frame-Folge abgelegt. Der Dateiname ist ein
+// 64-Bit-Hash über Bibliotheksversion, Effekt-Art, Parameter, Frame-Abstand
+// und Frame-Zahl (inhaltsadressiert): gleiche Parameter -> gleiche Datei,
+// geänderte Parameter oder eine neue Bibliotheksversion -> neue Datei.
+//
+// Treffer werden gemappt (CreateFileMapping/MapViewOfFile), beim Öffnen werden
+// Größe, Schlüssel und Prüfsumme (FNV-1a 64 über alle Frames) geprüft. Ein
+// CachedEffect liest die Frames direkt aus dem Mapping - der erste Frame kommt
+// ohne Rendern.
+//
+// Layout (Little Endian):
+//
+//   EffectCacheHeader (64 Bytes)
+//   LEDZones[frameCount] ab dataOffset (9 Bytes pro Frame)
+//
+// Neue Dateien entstehen als .tmp und werden erst vollständig umbenannt. Liegt
+// das Verzeichnis über maxBytes, werden die am längsten nicht benutzten
+// Dateien gelöscht (letzter Zugriff wird bei jedem Treffer gesetzt).
+// ============================================================================
+
+namespace HS80 {
+
+constexpr uint32_t EFFECT_CACHE_MAGIC = 0x46385348;     // "HS8F"
+constexpr uint16_t EFFECT_CACHE_VERSION = 1;
+
+#pragma pack(push, 1)
+struct EffectCacheHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;                 // EFFECT_CACHE_FINITE
+    uint64_t key;                   // = Dateiname
+    uint64_t keyCheck;              // Zweiter Hash gegen Kollisionen
+    uint32_t frameCount;
+    uint32_t frameIntervalUs;
+    uint32_t dataOffset;
+    uint32_t reserved0;
+    uint64_t dataSize;
+    uint64_t checksum;              // FNV-1a 64 über die Frames
+    uint32_t reserved[2];
+};
+#pragma pack(pop)
+static_assert(sizeof(EffectCacheHeader) == 64, "EffectCacheHeader muss 64 Bytes groß sein");
+
+constexpr uint16_t EFFECT_CACHE_FINITE = 0x0001;    // Effekt endete innerhalb von maxFrames
+
+// Alles, was das Ergebnis bestimmt
+struct EffectCacheKey {
+    std::string effect;             // Art, z.B. "script"
+    std::string parameters;         // Quelltext, Dateiname + Größe + Zeitstempel ...
+    uint32_t frameIntervalUs;
+    uint32_t maxFrames;             // Endlose Effekte: eine Periode
+
+    EffectCacheKey() : frameIntervalUs(20000), maxFrames(0) {}
+    EffectCacheKey(const std::string& effect, const std::string& parameters, uint32_t frameIntervalUs, uint32_t maxFrames)
+        : effect(effect), parameters(parameters), frameIntervalUs(frameIntervalUs), maxFrames(maxFrames) {}
+
+    uint64_t hash() const;
+    uint64_t checkHash() const;
+};
+
+// Gemappte Frame-Folge (nur lesend)
+class CachedSequence {
+private:
+    HANDLE m_file;
+    HANDLE m_mapping;
+    const uint8_t* m_data;
+    size_t m_size;
+
+    const EffectCacheHeader* header() const { return reinterpret_cast<const EffectCacheHeader*>(m_data); }
+
+public:
+    CachedSequence();
+    ~CachedSequence();
+
+    CachedSequence(const CachedSequence&) = delete;
+    CachedSequence& operator=(const CachedSequence&) = delete;
+
+    // Prüft Größe, Schlüssel und Prüfsumme; setzt den letzten Zugriff
+    bool open(const std::string& path, const EffectCacheKey& key, std::string& error);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    uint32_t frameCount() const { return m_data ? header()->frameCount : 0; }
+    double frameIntervalMs() const { return m_data ? header()->frameIntervalUs / 1000.0 : 0.0; }
+    bool finite() const { return m_data && (header()->flags & EFFECT_CACHE_FINITE); }
+    const LEDZones* frames() const { return m_data ? reinterpret_cast<const LEDZones*>(m_data + header()->dataOffset) : nullptr; }
+    size_t fileSize() const { return m_size; }
+
+    static uint64_t checksum(const uint8_t* data, size_t size);
+};
+
+// Spielt eine CachedSequence ab; endlose Effekte laufen in Schleife
+class CachedEffect : public Effect {
+private:
+    std::shared_ptr<const CachedSequence> m_sequence;   // Hält das Mapping am Leben
+
+public:
+    explicit CachedEffect(std::shared_ptr<const CachedSequence> sequence);
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override;
+};
+
+struct EffectCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t corrupt;               // Verworfene Dateien (Größe/Schlüssel/Prüfsumme)
+    uint64_t rendered;
+    uint64_t evictions;
+    uint64_t bytes;                 // Stand nach der letzten Aufräumrunde
+    double lastOpenUs;              // Mappen + Prüfen
+    double lastRenderMs;
+};
+
+using EffectFactory = std::function<std::shared_ptr<Effect>()>;
+
+class EffectCache {
+private:
+    std::string m_directory;
+    uint64_t m_maxBytes;
+    mutable CRITICAL_SECTION m_lock;
+    EffectCacheStats m_stats;
+
+    std::string pathFor(uint64_t key) const;
+    bool writeFile(const EffectCacheKey& key, const std::vector<LEDZones>& frames, bool finite);
+
+public:
+    EffectCache(const std::string& directory, uint64_t maxBytes = 64ULL * 1024 * 1024);
+    ~EffectCache();
+
+    EffectCache(const EffectCache&) = delete;
+    EffectCache& operator=(const EffectCache&) = delete;
+
+    // Treffer: gemappte Frames; nullptr bei Fehlschlag (defekte Datei wird gelöscht)
+    std::shared_ptr<const CachedSequence> find(const EffectCacheKey& key);
+
+    // Effekt offline rendern (höchstens key.maxFrames) und ablegen
+    std::shared_ptr<const CachedSequence> store(const EffectCacheKey& key, Effect& effect);
+
+    // find(), sonst Effekt aus der Factory rendern und ablegen. Schlägt das
+    // Schreiben fehl, kommt der ungecachte Effekt zurück.
+    std::shared_ptr<Effect> load(const EffectCacheKey& key, const EffectFactory& factory);
+
+    // Älteste Dateien löschen, bis höchstens targetBytes belegt sind
+    void evict(uint64_t targetBytes);
+    void clear();
+
+    EffectCacheStats getStats() const;
+};
+
+} // namespace HS80
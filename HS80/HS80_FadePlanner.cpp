@@ -0,0 +1,152 @@
+#include "HS80_FadePlanner.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace HS80 {
+
+// Größter Kanalfehler des Zustands zones/hardware gegen das Ziel (8-Bit-Stufen)
+static double deviation(const LEDZones& zones, int hardware, const double* target, int userBrightness) {
+    if (userBrightness <= 0) {
+        return 0;   // Eingestellte Helligkeit 0: alles dunkel
+    }
+    const unsigned char* values = reinterpret_cast<const unsigned char*>(&zones);
+    double scale = static_cast<double>(hardware) / userBrightness;
+    double worst = 0;
+    for (int i = 0; i < 9; i++) {
+        worst = std::max(worst, std::abs(values[i] * scale - target[i]));
+    }
+    return worst;
+}
+
+static LEDZones scaledZones(const double* target, double factor) {
+    LEDZones zones;
+    unsigned char* out = reinterpret_cast<unsigned char*>(&zones);
+    for (int i = 0; i < 9; i++) {
+        out[i] = static_cast<unsigned char>(std::min(255.0, std::floor(target[i] * factor + 0.5)));
+    }
+    return zones;
+}
+
+static int peak(const LEDZones& zones) {
+    const unsigned char* values = reinterpret_cast<const unsigned char*>(&zones);
+    return *std::max_element(values, values + 9);
+}
+
+// ============================================================================
+// FadePlanner
+// ============================================================================
+
+FadePlanner::FadePlanner()
+    : m_lastLevel(0) {
+    resetStats();
+}
+
+void FadePlanner::setConfig(const FadePlanConfig& config) {
+    m_config = config;
+    m_config.precision = std::max(0.0, m_config.precision);
+}
+
+void FadePlanner::resetStats() {
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+void FadePlanner::plan(const LEDZones& base, uint32_t level, int userBrightness,
+                       const LEDZones& shown, int shownBrightness, FadeStep& out) {
+    m_stats.frames++;
+
+    const unsigned char* baseValues = reinterpret_cast<const unsigned char*>(&base);
+    double target[9];
+    for (int i = 0; i < 9; i++) {
+        target[i] = baseValues[i] * static_cast<double>(level) / LEVEL_ONE;
+    }
+
+    bool useColors = m_config.mode != FadeMode::Brightness;
+    bool useBrightness = m_config.mode != FadeMode::Color;
+    int basePeak = peak(base);
+
+    // Genauer als der feinere Weg garantiert geht nicht: Farben runden auf eine
+    // halbe Stufe, die Helligkeit auf eine halbe Promille-Stufe der Grundfarbe
+    double achievable = useColors ? 0.5 : 1e9;
+    double brightnessStep = userBrightness > 0 ? basePeak * 0.5 / userBrightness : 0;
+    if (useBrightness) {
+        achievable = std::min(achievable, brightnessStep);
+    }
+    double tolerance = std::max(m_config.precision, achievable) + 1e-9;
+    // Auto: Helligkeitsweg nur, wenn er die Toleranz sicher hält (sonst
+    // Pendeln zwischen beiden Wegen, z.B. bei niedriger eingestellter Helligkeit)
+    if (m_config.mode == FadeMode::Auto && brightnessStep > tolerance) {
+        useBrightness = false;
+    }
+    bool stableBase = memcmp(&base, &m_lastBase, sizeof(LEDZones)) == 0;
+
+    // Kandidaten: nichts senden, Farben, Helligkeit, beides
+    FadeStep candidates[5];
+    int count = 0;
+    auto add = [&](const LEDZones& zones, int hardware) {
+        FadeStep& step = candidates[count++];
+        step.zones = zones;
+        step.hardwareBrightness = std::max(0, std::min(1000, hardware));
+        step.sendColors = memcmp(&zones, &shown, sizeof(LEDZones)) != 0;
+        step.sendBrightness = step.hardwareBrightness != shownBrightness;
+        step.error = deviation(zones, step.hardwareBrightness, target, userBrightness);
+        step.cost = (step.sendColors ? 1 : 0) + (step.sendBrightness ? 1 : 0);
+        if (stableBase && step.cost > 1 && memcmp(&zones, &base, sizeof(LEDZones)) == 0) {
+            step.cost = 1;
+        }
+    };
+
+    add(shown, shownBrightness);
+    if (useColors) {
+        add(scaledZones(target, 1.0), userBrightness);
+        // Abgesenkte Hardware-Helligkeit behalten, Farben entsprechend höher
+        if (useBrightness && shownBrightness > 0 && shownBrightness != userBrightness) {
+            add(scaledZones(target, static_cast<double>(userBrightness) / shownBrightness), shownBrightness);
+        }
+    }
+    if (useBrightness) {
+        // Vorhalt in Richtung der Blende, soweit die Toleranz über der Rundung reicht
+        double leadLevel = static_cast<double>(level) / LEVEL_ONE;
+        double slack = tolerance - 1e-9 - brightnessStep;
+        if (basePeak > 0 && slack > 0 && level != m_lastLevel) {
+            leadLevel += (level > m_lastLevel ? slack : -slack) / basePeak;
+            leadLevel = std::max(0.0, std::min(1.0, leadLevel));
+        }
+        int hardware = static_cast<int>(std::floor(userBrightness * leadLevel + 0.5));
+        add(base, hardware);
+        // Gesendete Farben nur über die Helligkeit nachziehen (hellster Kanal)
+        int shownPeak = peak(shown);
+        if (shownPeak > 0 && memcmp(&shown, &base, sizeof(LEDZones)) != 0) {
+            add(shown, static_cast<int>(std::floor(hardware * static_cast<double>(basePeak) / shownPeak + 0.5)));
+        }
+    }
+    m_lastLevel = level;
+    m_lastBase = base;
+
+    // Innerhalb der Toleranz: wenigste Reports, dann Grundfarbe (kann
+    // vorhalten), dann Genauigkeit. Sonst die genaueste.
+    auto onBase = [&](const FadeStep& step) { return memcmp(&step.zones, &base, sizeof(LEDZones)) == 0; };
+    const FadeStep* best = &candidates[0];
+    for (int i = 1; i < count; i++) {
+        const FadeStep& step = candidates[i];
+        bool stepOk = step.error <= tolerance;
+        bool bestOk = best->error <= tolerance;
+        if (stepOk != bestOk) {
+            if (stepOk) best = &step;
+        } else if (stepOk && step.cost != best->cost) {
+            if (step.cost < best->cost) best = &step;
+        } else if (stepOk && onBase(step) != onBase(*best)) {
+            if (onBase(step)) best = &step;
+        } else if (step.error < best->error) {
+            best = &step;
+        }
+    }
+    out = *best;
+
+    if (out.sendColors) m_stats.colorPackets++;
+    if (out.sendBrightness) m_stats.brightnessPackets++;
+    if (!out.sendColors && !out.sendBrightness) m_stats.skippedFrames++;
+    m_stats.maxError = std::max(m_stats.maxError, out.error);
+}
+
+} // namespace HS80
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "HS80_Animation.h"
+
+// ============================================================================
+// HS80 FadePlanner - Globale Blenden über die Hardware-Helligkeit
+// ============================================================================
+//
+// Ein Puls über Farbpakete schickt pro Frame alle 9 Kanäle neu, jeweils auf
+// 8 Bit gerundet (dunkle Abschnitte verlieren dabei auch den Farbton). Das
+// Helligkeitspaket (0-1000) skaliert alle Kanäle gemeinsam: bei fester
+// Grundfarbe reicht pro Frame ein Helligkeitspaket mit ca. 4x feineren Stufen.
+//
+// Pro Frame eines LevelEffect (Grundfarbe * Pegel) vergleicht der Planer die
+// Möglichkeiten gegen den aktuellen Gerätezustand:
+//
+//   nichts senden (0) | Helligkeit (1) | Farben (1) | Farben + Helligkeit (2)
+//
+// und nimmt die mit den wenigsten Reports, deren Abweichung vom Ziel unter
+// precision bleibt (bei Gleichstand die genauere). Schafft keine die
+// Genauigkeit, gewinnt die genaueste. Frames, die sichtbar nichts ändern,
+// gehen so gar nicht erst raus. Bleibt die Grundfarbe stehen, zählt der
+// Wechsel auf Grundfarbe + Helligkeit wie ein Report (amortisiert sich über
+// die folgenden Frames). Die Helligkeit läuft der Blende um die Toleranz
+// voraus, damit jeder Report das ganze Toleranzband ausnutzt.
+//
+// Abweichung = größter Kanalfehler in 8-Bit-Stufen bei eingestellter
+// Helligkeit, Hardware-Helligkeit als linear angenommen (wie HS80_Dither).
+// ============================================================================
+
+namespace HS80 {
+
+enum class FadeMode {
+    Color,          // Nur Farbpakete, Hardware-Helligkeit bleibt (bisheriges Verhalten)
+    Brightness,     // Grundfarbe einmal, dann nur Helligkeitspakete
+    Auto            // Pro Frame das Günstigste, das die Genauigkeit erreicht
+};
+
+struct FadePlanConfig {
+    FadeMode mode;
+    double precision;           // Erlaubte Abweichung in 8-Bit-Stufen (0.5 = wie gerundete Farben)
+
+    FadePlanConfig() : mode(FadeMode::Auto), precision(0.5) {}
+};
+
+struct FadePlanStats {
+    uint64_t frames;
+    uint64_t colorPackets;
+    uint64_t brightnessPackets;
+    uint64_t skippedFrames;     // Frames ohne Report
+    double maxError;            // Größte Abweichung eines gesendeten Zustands
+};
+
+// Entscheidung für einen Frame
+struct FadeStep {
+    LEDZones zones;             // Zustand danach (Farbpaket)
+    int hardwareBrightness;
+    bool sendColors;
+    bool sendBrightness;
+    double error;
+    int cost;                   // Reports, Wechsel auf die Grundfarbe amortisiert
+};
+
+class FadePlanner {
+private:
+    FadePlanConfig m_config;
+    FadePlanStats m_stats;
+    uint32_t m_lastLevel;       // Pegel des Vorframes (Richtung der Blende)
+    LEDZones m_lastBase;
+
+public:
+    FadePlanner();
+
+    void setConfig(const FadePlanConfig& config);
+    FadePlanConfig getConfig() const { return m_config; }
+
+    // Ziel base * level (Q16) bei eingestellter Helligkeit userBrightness,
+    // ausgehend vom Gerätezustand shown/shownBrightness
+    void plan(const LEDZones& base, uint32_t level, int userBrightness,
+              const LEDZones& shown, int shownBrightness, FadeStep& out);
+
+    FadePlanStats getStats() const { return m_stats; }
+    void resetStats();
+};
+
+} // namespace HS80
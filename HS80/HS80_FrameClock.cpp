@@ -0,0 +1,158 @@
+#include "HS80_FrameClock.h"
+#include <iostream>
+#include <algorithm>
+
+namespace HS80 {
+
+FrameClock::FrameClock()
+    : m_ticks(0)
+{
+    InitializeCriticalSection(&m_lock);
+    QueryPerformanceFrequency(&m_qpcFrequency);
+    m_engine.reset(new AnimationEngine([this](const LEDZones& zones) { return fanOut(zones); }));
+}
+
+FrameClock::~FrameClock() {
+    // Takt-Thread beenden, bevor die Abonnentenliste verschwindet
+    m_engine.reset();
+    DeleteCriticalSection(&m_lock);
+}
+
+bool FrameClock::subscribe(RGBController& controller) {
+    // Zweiter Takt für dasselbe Gerät würde gegen uns schreiben
+    controller.stopEffect();
+    controller.waitEffect();
+
+    EnterCriticalSection(&m_lock);
+    for (const Subscriber& subscriber : m_subscribers) {
+        if (subscriber.controller == &controller) {
+            LeaveCriticalSection(&m_lock);
+            return false;
+        }
+    }
+    Subscriber subscriber = { &controller, 0, 0, 0.0, 0.0 };
+    m_subscribers.push_back(subscriber);
+    LeaveCriticalSection(&m_lock);
+    return true;
+}
+
+bool FrameClock::unsubscribe(RGBController& controller) {
+    EnterCriticalSection(&m_lock);
+    auto it = std::find_if(m_subscribers.begin(), m_subscribers.end(),
+        [&](const Subscriber& subscriber) { return subscriber.controller == &controller; });
+    bool found = it != m_subscribers.end();
+    if (found) {
+        m_subscribers.erase(it);
+    }
+    LeaveCriticalSection(&m_lock);
+    return found;
+}
+
+size_t FrameClock::subscriberCount() const {
+    EnterCriticalSection(&m_lock);
+    size_t count = m_subscribers.size();
+    LeaveCriticalSection(&m_lock);
+    return count;
+}
+
+bool FrameClock::start(std::shared_ptr<Effect> effect, int frameIntervalMs) {
+    if (subscriberCount() == 0) {
+        std::cerr << "[CLOCK] Keine Geraete abonniert!" << std::endl;
+        return false;
+    }
+    return m_engine->start(effect, frameIntervalMs);
+}
+
+void FrameClock::stop() {
+    m_engine->stop();
+}
+
+bool FrameClock::wait(DWORD timeoutMs) {
+    return m_engine->wait(timeoutMs);
+}
+
+// Im Takt-Thread: ein gerenderter Frame, alle Geräte direkt nacheinander
+bool FrameClock::fanOut(const LEDZones& zones) {
+    EnterCriticalSection(&m_lock);
+    if (m_subscribers.empty()) {
+        LeaveCriticalSection(&m_lock);
+        return true;
+    }
+
+    LARGE_INTEGER start;
+    QueryPerformanceCounter(&start);
+
+    // Erst alle Reports anstoßen, dann auf alle warten: die Links arbeiten
+    // parallel, der Versatz hängt nicht von der Summe der Schreibzeiten ab
+    bool allOk = true;
+    m_started.resize(m_subscribers.size());
+    m_doneTicks.resize(m_subscribers.size());
+    for (size_t i = 0; i < m_subscribers.size(); i++) {
+        m_started[i] = m_subscribers[i].controller->beginColors(zones);
+    }
+    for (size_t i = 0; i < m_subscribers.size(); i++) {
+        Subscriber& subscriber = m_subscribers[i];
+        if (!m_started[i] || !subscriber.controller->finishColors()) {
+            subscriber.errors++;
+            allOk = false;
+        }
+        subscriber.frames++;
+
+        LARGE_INTEGER done;
+        QueryPerformanceCounter(&done);
+        m_doneTicks[i] = done.QuadPart;
+    }
+
+    int64_t first = *std::min_element(m_doneTicks.begin(), m_doneTicks.end());
+    int64_t last = *std::max_element(m_doneTicks.begin(), m_doneTicks.end());
+    for (size_t i = 0; i < m_subscribers.size(); i++) {
+        double offsetUs = (m_doneTicks[i] - first) * 1000000.0 / m_qpcFrequency.QuadPart;
+        m_subscribers[i].offsetSumUs += offsetUs;
+        m_subscribers[i].maxOffsetUs = std::max(m_subscribers[i].maxOffsetUs, offsetUs);
+    }
+    LeaveCriticalSection(&m_lock);
+
+    m_skew.record(static_cast<uint64_t>((last - first) * 1000000000LL / m_qpcFrequency.QuadPart));
+    m_fanOutTime.record(static_cast<uint64_t>((last - start.QuadPart) * 1000000000LL / m_qpcFrequency.QuadPart));
+    m_ticks.fetch_add(1, std::memory_order_relaxed);
+    return allOk;
+}
+
+FrameClockStats FrameClock::getStats() const {
+    FrameClockStats stats;
+    stats.ticks = m_ticks.load(std::memory_order_relaxed);
+    stats.skew = m_skew.snapshot();
+    stats.fanOutTime = m_fanOutTime.snapshot();
+    stats.clock = m_engine->getStats();
+
+    EnterCriticalSection(&m_lock);
+    for (const Subscriber& subscriber : m_subscribers) {
+        FrameClockDeviceStats device;
+        device.controller = subscriber.controller;
+        device.frames = subscriber.frames;
+        device.errors = subscriber.errors;
+        device.meanOffsetUs = subscriber.frames > 0 ? subscriber.offsetSumUs / subscriber.frames : 0.0;
+        device.maxOffsetUs = subscriber.maxOffsetUs;
+        stats.devices.push_back(device);
+    }
+    LeaveCriticalSection(&m_lock);
+    return stats;
+}
+
+void FrameClock::resetStats() {
+    m_ticks = 0;
+    m_skew.reset();
+    m_fanOutTime.reset();
+    m_engine->resetStats();
+
+    EnterCriticalSection(&m_lock);
+    for (Subscriber& subscriber : m_subscribers) {
+        subscriber.frames = 0;
+        subscriber.errors = 0;
+        subscriber.offsetSumUs = 0.0;
+        subscriber.maxOffsetUs = 0.0;
+    }
+    LeaveCriticalSection(&m_lock);
+}
+
+} // namespace HS80
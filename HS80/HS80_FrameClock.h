@@ -0,0 +1,94 @@
+#pragma once
+
+#include "HS80_Animation.h"
+#include <vector>
+
+// ============================================================================
+// HS80 FrameClock - Ein Effekt, ein Takt, mehrere Headsets
+// ============================================================================
+//
+// Laufen mehrere RGBController jeweils mit eigenem startEffect(), hat jedes
+// Headset einen eigenen Animation-Thread und eigenen Startzeitpunkt - die
+// Geräte laufen sichtbar phasenversetzt.
+//
+// FrameClock besitzt genau einen AnimationEngine-Thread. Pro Tick wird der
+// Effekt einmal gerendert, dann werden die Reports aller abonnierten Controller
+// direkt nacheinander angestoßen (beginColors, Overlapped-WriteFile) und erst
+// danach abgewartet (finishColors). Die Links arbeiten so parallel; ein Tick
+// dauert so lange wie der langsamste Link, nicht wie die Summe aller.
+//
+// Gemessen werden der Versatz (Skew) zwischen frühestem und spätestem
+// Schreibende eines Ticks und der mittlere Versatz jedes Geräts zum frühesten.
+// Die Backpressure der Engine sieht die Dauer des ganzen Ticks: ein
+// überlasteter Link senkt die Framerate für alle gemeinsam.
+//
+// subscribe()/unsubscribe()/getStats() warten höchstens einen laufenden Tick ab.
+// Ein Controller muss vor seiner Zerstörung abgemeldet werden.
+// ============================================================================
+
+namespace HS80 {
+
+struct FrameClockDeviceStats {
+    RGBController* controller;
+    uint64_t frames;
+    uint64_t errors;
+    double meanOffsetUs;        // Ø Abstand zum frühesten Gerät des Ticks (Schreibende)
+    double maxOffsetUs;
+};
+
+struct FrameClockStats {
+    uint64_t ticks;
+    LatencySnapshot skew;       // Frühestes bis spätestes Schreibende eines Ticks
+    LatencySnapshot fanOutTime; // Alle Writes eines Ticks
+    AnimationStats clock;       // Takt: Jitter, Backpressure
+    std::vector<FrameClockDeviceStats> devices;
+};
+
+class FrameClock {
+private:
+    struct Subscriber {
+        RGBController* controller;
+        uint64_t frames;
+        uint64_t errors;
+        double offsetSumUs;
+        double maxOffsetUs;
+    };
+
+    mutable CRITICAL_SECTION m_lock;
+    std::vector<Subscriber> m_subscribers;  // Reihenfolge = Schreibreihenfolge
+    std::vector<char> m_started;            // Nur im Takt-Thread
+    std::vector<int64_t> m_doneTicks;
+    std::unique_ptr<AnimationEngine> m_engine;
+
+    LARGE_INTEGER m_qpcFrequency;
+    std::atomic<uint64_t> m_ticks;
+    LatencyHistogram m_skew;
+    LatencyHistogram m_fanOutTime;
+
+    bool fanOut(const LEDZones& zones);
+
+public:
+    FrameClock();
+    ~FrameClock();
+
+    FrameClock(const FrameClock&) = delete;
+    FrameClock& operator=(const FrameClock&) = delete;
+
+    // Stoppt den eigenen Effekt des Controllers; false = bereits abonniert
+    bool subscribe(RGBController& controller);
+    bool unsubscribe(RGBController& controller);
+    size_t subscriberCount() const;
+
+    // Wie RGBController::startEffect(), aber für alle Abonnenten
+    bool start(std::shared_ptr<Effect> effect, int frameIntervalMs = 33);
+    void stop();
+    bool isRunning() const { return m_engine->isRunning(); }
+    bool wait(DWORD timeoutMs = INFINITE);
+
+    AnimationEngine& engine() { return *m_engine; }  // Rate-Control
+
+    FrameClockStats getStats() const;
+    void resetStats();
+};
+
+} // namespace HS80
@@ -0,0 +1,210 @@
+#include "HS80_FrameTables.h"
+
+namespace HS80 {
+
+// Laufzeit-Tabellen größer als das lohnen sich nicht (endloser Regenbogen mit
+// unpassender Schrittweite, sehr lange Effekte) -> normaler Effekt
+static constexpr uint32_t MAX_RUNTIME_FRAMES = 4096;
+
+// ============================================================================
+// Statische Tabellen (Standard-Parameter der Library und der Beispielprogramme)
+// ============================================================================
+
+// Endloser Regenbogen, 10s pro Umlauf (RGBController::startRainbow mit durationMs = 0)
+using Rainbow10s20ms  = RainbowTable<10000, 0, 20>;
+using Rainbow10s25ms  = RainbowTable<10000, 0, 25>;
+using Rainbow10s40ms  = RainbowTable<10000, 0, 40>;
+using Rainbow10s50ms  = RainbowTable<10000, 0, 50>;
+using Rainbow10s100ms = RainbowTable<10000, 0, 100>;
+
+// Endloser Puls: eine Periode, gilt für jede Schrittweite
+using PulseRed   = PulseTable<255, 0, 0, 0, 50>;
+using PulseGreen = PulseTable<0, 255, 0, 0, 50>;
+using PulseBlue  = PulseTable<0, 0, 255, 0, 50>;
+using PulseWhite = PulseTable<255, 255, 255, 0, 50>;
+
+static_assert(Rainbow10s50ms::table.rgb[0] == 255 && Rainbow10s50ms::table.rgb[1] == 0, "Regenbogen startet rot");
+static_assert(PulseWhite::table.rgb[18 * 3] == 255, "Puls erreicht in der Mitte volle Helligkeit");
+
+struct StaticRainbow {
+    uint32_t periodMs;
+    FrameTableView view;
+};
+
+struct StaticPulse {
+    uint8_t r, g, b;
+    FrameTableView view;
+};
+
+static const StaticRainbow s_rainbowTables[] = {
+    { 10000, Rainbow10s20ms::table.view() },
+    { 10000, Rainbow10s25ms::table.view() },
+    { 10000, Rainbow10s40ms::table.view() },
+    { 10000, Rainbow10s50ms::table.view() },
+    { 10000, Rainbow10s100ms::table.view() },
+};
+
+static const StaticPulse s_pulseTables[] = {
+    { 255, 0, 0, PulseRed::table.view() },
+    { 0, 255, 0, PulseGreen::table.view() },
+    { 0, 0, 255, PulseBlue::table.view() },
+    { 255, 255, 255, PulseWhite::table.view() },
+};
+
+bool findRainbowTable(uint32_t periodMs, uint32_t durationMs, uint32_t stepMs, FrameTableView& view) {
+    if (durationMs != 0) {
+        return false;
+    }
+    for (const StaticRainbow& entry : s_rainbowTables) {
+        if (entry.periodMs == periodMs && entry.view.intervalMs == stepMs) {
+            view = entry.view;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool findPulseTable(RGBColor color, uint32_t cycles, uint32_t stepMs, FrameTableView& view) {
+    if (cycles != 0 || stepMs == 0) {
+        return false;
+    }
+    for (const StaticPulse& entry : s_pulseTables) {
+        if (entry.r == color.r && entry.g == color.g && entry.b == color.b) {
+            view = entry.view;
+            view.intervalMs = stepMs;   // Puls-Frames sind unabhängig von der Schrittweite
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t staticFrameTableBytes() {
+    size_t bytes = 0;
+    for (const StaticRainbow& entry : s_rainbowTables) {
+        bytes += entry.view.frames * 3;
+    }
+    for (const StaticPulse& entry : s_pulseTables) {
+        bytes += entry.view.frames * 3;
+    }
+    return bytes;
+}
+
+// ============================================================================
+// Laufzeit-Generatoren
+// ============================================================================
+
+bool buildRainbowFrames(uint32_t periodMs, uint32_t durationMs, uint32_t stepMs, std::vector<uint8_t>& rgb) {
+    uint32_t count = frames::rainbowFrameCount(periodMs, durationMs, stepMs);
+    if (count == 0 || count > MAX_RUNTIME_FRAMES) {
+        return false;
+    }
+
+    rgb.resize(count * 3);
+    for (uint32_t i = 0; i < count; i++) {
+        RGBColor color = Color::hueToRgb(frames::rainbowHue(i, periodMs, stepMs));
+        rgb[i * 3 + 0] = color.r;
+        rgb[i * 3 + 1] = color.g;
+        rgb[i * 3 + 2] = color.b;
+    }
+    return true;
+}
+
+void buildPulseFrames(RGBColor color, uint32_t cycles, std::vector<uint8_t>& rgb) {
+    uint32_t count = frames::pulseFrameCount(cycles);
+    rgb.resize(count * 3);
+
+    // Eine Periode berechnen, Zyklen kopieren
+    uint32_t period = count < frames::PULSE_FRAMES_PER_CYCLE ? count : frames::PULSE_FRAMES_PER_CYCLE;
+    for (uint32_t i = 0; i < period; i++) {
+        RGBColor scaled = Color::scale(color, frames::pulseLevel(i));
+        rgb[i * 3 + 0] = scaled.r;
+        rgb[i * 3 + 1] = scaled.g;
+        rgb[i * 3 + 2] = scaled.b;
+    }
+    for (uint32_t i = period; i < count; i++) {
+        rgb[i * 3 + 0] = rgb[(i % period) * 3 + 0];
+        rgb[i * 3 + 1] = rgb[(i % period) * 3 + 1];
+        rgb[i * 3 + 2] = rgb[(i % period) * 3 + 2];
+    }
+
+    // Endliche Pulse enden dunkel
+    if (cycles > 0) {
+        rgb[(count - 1) * 3 + 0] = 0;
+        rgb[(count - 1) * 3 + 1] = 0;
+        rgb[(count - 1) * 3 + 2] = 0;
+    }
+}
+
+// ============================================================================
+// TableEffect
+// ============================================================================
+
+TableEffect::TableEffect(const FrameTableView& view)
+    : m_view(view) {
+}
+
+TableEffect::TableEffect(std::vector<uint8_t> rgb, uint32_t intervalMs, bool loop)
+    : m_owned(std::move(rgb)) {
+    m_view.rgb = m_owned.data();
+    m_view.frames = static_cast<uint32_t>(m_owned.size() / 3);
+    m_view.intervalMs = intervalMs > 0 ? intervalMs : 1;
+    m_view.loop = loop;
+}
+
+EffectStatus TableEffect::render(const FrameContext& frame, LEDZones& zones) {
+    if (m_view.frames == 0) {
+        zones = LEDZones(RGBColor(0, 0, 0));
+        return EffectStatus::Finished;
+    }
+
+    // Zeitbasiert wie die Effekte: übersprungene Frames verschieben nichts
+    uint64_t index = static_cast<uint64_t>(frame.timeMs / m_view.intervalMs);
+    bool finished = false;
+    if (m_view.loop) {
+        index %= m_view.frames;
+    } else if (index >= m_view.frames - 1) {
+        index = m_view.frames - 1;
+        finished = true;
+    }
+
+    const uint8_t* entry = m_view.rgb + index * 3;
+    zones = LEDZones(RGBColor(entry[0], entry[1], entry[2]));
+    return finished ? EffectStatus::Finished : EffectStatus::Running;
+}
+
+// ============================================================================
+// Auswahl: statisch -> Laufzeit-Tabelle -> Effekt
+// ============================================================================
+
+std::shared_ptr<Effect> createRainbowEffect(int periodMs, int durationMs, int stepMs) {
+    if (periodMs > 0 && durationMs >= 0 && stepMs > 0) {
+        FrameTableView view;
+        if (findRainbowTable(periodMs, durationMs, stepMs, view)) {
+            return std::make_shared<TableEffect>(view);
+        }
+
+        std::vector<uint8_t> rgb;
+        if (buildRainbowFrames(periodMs, durationMs, stepMs, rgb)) {
+            return std::make_shared<TableEffect>(std::move(rgb), stepMs, durationMs == 0);
+        }
+    }
+    return std::make_shared<RainbowEffect>(periodMs, durationMs);
+}
+
+std::shared_ptr<Effect> createPulseEffect(RGBColor color, int cycles, int stepMs) {
+    if (cycles >= 0 && stepMs > 0) {
+        FrameTableView view;
+        if (findPulseTable(color, cycles, stepMs, view)) {
+            return std::make_shared<TableEffect>(view);
+        }
+
+        if (static_cast<uint32_t>(cycles) < MAX_RUNTIME_FRAMES / frames::PULSE_FRAMES_PER_CYCLE) {
+            std::vector<uint8_t> rgb;
+            buildPulseFrames(color, cycles, rgb);
+            return std::make_shared<TableEffect>(std::move(rgb), stepMs, cycles == 0);
+        }
+    }
+    return std::make_shared<PulseEffect>(color, frames::PULSE_FRAMES_PER_CYCLE * stepMs, cycles);
+}
+
+} // namespace HS80
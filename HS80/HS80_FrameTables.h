@@ -0,0 +1,165 @@
+#pragma once
+
+#include "HS80_Animation.h"
+#include "HS80_Color.h"
+#include <array>
+#include <vector>
+
+// ============================================================================
+// HS80 FrameTables - Zur Compile-Zeit berechnete Effekt-Frames
+// ============================================================================
+//
+// Für feste Parametersätze (Regenbogen mit bestimmter Periode/Schrittweite,
+// Puls in bestimmter Farbe) erzeugen constexpr-Generatoren die komplette
+// Frame-Folge beim Kompilieren. Zur Laufzeit bleibt pro Frame ein Tabellenzugriff.
+//
+// Die Generatoren rechnen exakt wie RainbowEffect/PulseEffect (gleiche
+// Ganzzahl-Phase, gleiches Gamma), Tabelle und Effekt liefern also identische
+// Frames. Alle anderen Parameter laufen über createRainbowEffect()/
+// createPulseEffect(): Tabelle zur Laufzeit erzeugen oder den normalen Effekt.
+//
+// Jeder Frame ist eine Farbe für alle Zonen (3 Bytes RGB).
+// ============================================================================
+
+namespace HS80 {
+
+// Nicht-besitzende Sicht auf eine Frame-Tabelle
+struct FrameTableView {
+    const uint8_t* rgb;         // frames x RGB
+    uint32_t frames;
+    uint32_t intervalMs;        // Frame-Abstand, für den die Tabelle berechnet ist
+    bool loop;                  // true = endlos wiederholen, sonst letzter Frame = Finished
+};
+
+template <uint32_t N>
+struct FrameTable {
+    std::array<uint8_t, N * 3> rgb;
+    uint32_t intervalMs;
+    bool loop;
+
+    FrameTableView view() const { return FrameTableView{ rgb.data(), N, intervalMs, loop }; }
+};
+
+// ---------------------------------------------------------------------------
+// constexpr-Generatoren (identische Rechnung wie die Effekte)
+// ---------------------------------------------------------------------------
+
+namespace frames {
+
+// Regenbogen: Frame i liegt bei i * stepMs
+constexpr uint16_t rainbowHue(uint32_t frame, uint32_t periodMs, uint32_t stepMs) {
+    uint64_t position = static_cast<uint64_t>(frame) * stepMs % periodMs;
+    return static_cast<uint16_t>(position * Color::HUE_STEPS / periodMs);
+}
+
+// Endlos: eine Periode (nur wenn stepMs die Periode teilt), sonst bis zum Finished-Frame
+constexpr uint32_t rainbowFrameCount(uint32_t periodMs, uint32_t durationMs, uint32_t stepMs) {
+    if (stepMs == 0 || periodMs == 0) {
+        return 0;
+    }
+    if (durationMs == 0) {
+        return periodMs % stepMs == 0 ? periodMs / stepMs : 0;
+    }
+    return (durationMs + stepMs - 1) / stepMs;
+}
+
+// Puls mit Periode 36 * stepMs (RGBController::startPulse): Helligkeit hängt nur
+// vom Frame innerhalb der Periode ab, nicht von stepMs
+constexpr uint32_t PULSE_FRAMES_PER_CYCLE = 36;
+
+constexpr uint16_t pulseLevel(uint32_t frame) {
+    uint32_t phase = (frame % PULSE_FRAMES_PER_CYCLE) * 512 / PULSE_FRAMES_PER_CYCLE;
+    uint32_t level = phase < 256 ? phase : 512 - phase;
+    return static_cast<uint16_t>(level >= Color::BRIGHTNESS_ONE ? Color::BRIGHTNESS_ONE
+                                                                : Color::detail::gamma22(static_cast<int>(level)));
+}
+
+// Endlos: eine Periode, sonst alle Zyklen plus dunkler Schluss-Frame
+constexpr uint32_t pulseFrameCount(uint32_t cycles) {
+    return cycles == 0 ? PULSE_FRAMES_PER_CYCLE : cycles * PULSE_FRAMES_PER_CYCLE + 1;
+}
+
+template <uint32_t PeriodMs, uint32_t DurationMs, uint32_t StepMs>
+constexpr FrameTable<rainbowFrameCount(PeriodMs, DurationMs, StepMs)> buildRainbow() {
+    constexpr uint32_t count = rainbowFrameCount(PeriodMs, DurationMs, StepMs);
+    FrameTable<count> table = {};
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t r = 0, g = 0, b = 0;
+        Color::detail::hueToRgb(rainbowHue(i, PeriodMs, StepMs), r, g, b);
+        table.rgb[i * 3 + 0] = r;
+        table.rgb[i * 3 + 1] = g;
+        table.rgb[i * 3 + 2] = b;
+    }
+    table.intervalMs = StepMs;
+    table.loop = DurationMs == 0;
+    return table;
+}
+
+template <uint8_t R, uint8_t G, uint8_t B, uint32_t Cycles, uint32_t StepMs>
+constexpr FrameTable<pulseFrameCount(Cycles)> buildPulse() {
+    constexpr uint32_t count = pulseFrameCount(Cycles);
+    FrameTable<count> table = {};
+    for (uint32_t i = 0; i < count; i++) {
+        bool last = Cycles > 0 && i == count - 1;
+        uint16_t level = last ? 0 : pulseLevel(i);
+        table.rgb[i * 3 + 0] = Color::detail::scale(R, level);
+        table.rgb[i * 3 + 1] = Color::detail::scale(G, level);
+        table.rgb[i * 3 + 2] = Color::detail::scale(B, level);
+    }
+    table.intervalMs = StepMs;
+    table.loop = Cycles == 0;
+    return table;
+}
+
+} // namespace frames
+
+// Feste Parametersätze: RainbowTable<10000, 0, 50>::table ist eine constexpr-Tabelle
+template <uint32_t PeriodMs, uint32_t DurationMs, uint32_t StepMs>
+struct RainbowTable {
+    static_assert(frames::rainbowFrameCount(PeriodMs, DurationMs, StepMs) > 0,
+                  "Endloser Regenbogen braucht eine Periode, die durch StepMs teilbar ist");
+    static constexpr auto table = frames::buildRainbow<PeriodMs, DurationMs, StepMs>();
+};
+
+template <uint8_t R, uint8_t G, uint8_t B, uint32_t Cycles, uint32_t StepMs>
+struct PulseTable {
+    static constexpr auto table = frames::buildPulse<R, G, B, Cycles, StepMs>();
+};
+
+// ---------------------------------------------------------------------------
+// Wiedergabe
+// ---------------------------------------------------------------------------
+
+// Spielt eine Frame-Tabelle ab (statisch oder zur Laufzeit erzeugt)
+class TableEffect : public Effect {
+private:
+    FrameTableView m_view;
+    std::vector<uint8_t> m_owned;   // Nur bei Laufzeit-Tabellen
+
+public:
+    explicit TableEffect(const FrameTableView& view);
+    TableEffect(std::vector<uint8_t> rgb, uint32_t intervalMs, bool loop);
+
+    TableEffect(const TableEffect&) = delete;
+    TableEffect& operator=(const TableEffect&) = delete;
+
+    const FrameTableView& view() const { return m_view; }
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override;
+};
+
+// Laufzeit-Generatoren (gleiche Rechnung wie die constexpr-Varianten)
+bool buildRainbowFrames(uint32_t periodMs, uint32_t durationMs, uint32_t stepMs, std::vector<uint8_t>& rgb);
+void buildPulseFrames(RGBColor color, uint32_t cycles, std::vector<uint8_t>& rgb);
+
+// Vorberechnete Tabellen für die Standard-Parameter der Library
+bool findRainbowTable(uint32_t periodMs, uint32_t durationMs, uint32_t stepMs, FrameTableView& view);
+bool findPulseTable(RGBColor color, uint32_t cycles, uint32_t stepMs, FrameTableView& view);
+
+// Statische Tabelle, sonst Laufzeit-Tabelle, sonst normaler Effekt
+std::shared_ptr<Effect> createRainbowEffect(int periodMs, int durationMs, int stepMs);
+std::shared_ptr<Effect> createPulseEffect(RGBColor color, int cycles, int stepMs);
+
+// Größe aller statischen Tabellen in Bytes (Benchmark)
+size_t staticFrameTableBytes();
+
+} // namespace HS80
@@ -0,0 +1,70 @@
+// ============================================================================
+// HS80 KeyframeTool - Wandelt Keyframe-Textdateien in das .hs8k-Format um
+// ============================================================================
+//
+//   HS80_KeyframeTool <eingabe.txt> <ausgabe.hs8k>
+//   HS80_KeyframeTool --list <datei.hs8k>
+// ============================================================================
+
+#include "HS80_Keyframes.h"
+#include <iostream>
+
+using namespace HS80;
+
+static void printUsage() {
+    std::cout << "Verwendung:" << std::endl;
+    std::cout << "  HS80_KeyframeTool <eingabe.txt> <ausgabe.hs8k>" << std::endl;
+    std::cout << "  HS80_KeyframeTool --list <datei.hs8k>" << std::endl;
+}
+
+static int listAnimations(const std::string& path) {
+    KeyframeLibrary library;
+    if (!library.open(path)) {
+        return 1;
+    }
+
+    std::cout << path << ": " << library.animationCount() << " Animation(en)" << std::endl;
+    for (size_t i = 0; i < library.animationCount(); i++) {
+        KeyframeAnimation animation = library.find(library.animationName(i));
+        if (!animation.valid()) {
+            std::cout << "  " << library.animationName(i) << " [FEHLERHAFT]" << std::endl;
+            continue;
+        }
+
+        const KeyframeAnimationHeader* header = animation.header;
+        std::cout << "  " << library.animationName(i)
+                  << "  Dauer=" << header->durationMs << "ms"
+                  << "  Keys=" << header->trackKeyCount[0] << "/" << header->trackKeyCount[1]
+                  << "/" << header->trackKeyCount[2] << "/" << header->trackKeyCount[3];
+        if (header->loopEndMs > 0) {
+            std::cout << "  Schleife=" << header->loopStartMs << "-" << header->loopEndMs << "ms, ";
+            if (header->loopCount == 0) {
+                std::cout << "endlos";
+            } else {
+                std::cout << header->loopCount << "x";
+            }
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && std::string(argv[1]) == "--list") {
+        return listAnimations(argv[2]);
+    }
+
+    if (argc != 3) {
+        printUsage();
+        return 1;
+    }
+
+    std::string error;
+    if (!convertKeyframeText(argv[1], argv[2], error)) {
+        std::cerr << "[FEHLER] " << argv[1] << ": " << error << std::endl;
+        return 1;
+    }
+
+    std::cout << "Erstellt: " << argv[2] << std::endl;
+    return listAnimations(argv[2]);
+}
@@ -0,0 +1,446 @@
+#include "HS80_Keyframes.h"
+#include "HS80_Color.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+namespace HS80 {
+
+// ============================================================================
+// KeyframeLibrary (gemappte Datei)
+// ============================================================================
+
+KeyframeLibrary::KeyframeLibrary()
+    : m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(nullptr)
+    , m_data(nullptr)
+    , m_size(0) {
+}
+
+KeyframeLibrary::~KeyframeLibrary() {
+    close();
+}
+
+bool KeyframeLibrary::open(const std::string& path) {
+    close();
+
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        std::cerr << "[KEYFRAME] Datei nicht gefunden: " << path << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(KeyframeFileHeader)) {
+        std::cerr << "[KEYFRAME] Ungueltige Dateigroesse: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping) {
+        m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (!m_data) {
+        std::cerr << "[KEYFRAME] Mapping fehlgeschlagen! Error: " << GetLastError() << std::endl;
+        close();
+        return false;
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+
+    // Nur Header und Index prüfen - unabhängig von der Anzahl der Keyframes.
+    // Grenzen in 64 Bit: size_t ist im Win32-Build 32 Bit und würde überlaufen.
+    const KeyframeFileHeader* header = reinterpret_cast<const KeyframeFileHeader*>(m_data);
+    uint64_t indexEnd = static_cast<uint64_t>(header->indexOffset) +
+                        static_cast<uint64_t>(header->animationCount) * sizeof(KeyframeIndexEntry);
+    if (header->magic != KEYFRAME_MAGIC || header->version != KEYFRAME_VERSION ||
+        header->fileSize != static_cast<uint64_t>(fileSize.QuadPart) || indexEnd > m_size) {
+        std::cerr << "[KEYFRAME] Kein gueltiges .hs8k-Format: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void KeyframeLibrary::close() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+    m_size = 0;
+}
+
+const KeyframeIndexEntry* KeyframeLibrary::index() const {
+    const KeyframeFileHeader* header = reinterpret_cast<const KeyframeFileHeader*>(m_data);
+    return reinterpret_cast<const KeyframeIndexEntry*>(m_data + header->indexOffset);
+}
+
+size_t KeyframeLibrary::animationCount() const {
+    if (!m_data) {
+        return 0;
+    }
+    return reinterpret_cast<const KeyframeFileHeader*>(m_data)->animationCount;
+}
+
+const char* KeyframeLibrary::animationName(size_t i) const {
+    if (i >= animationCount()) {
+        return nullptr;
+    }
+    return index()[i].name;
+}
+
+KeyframeAnimation KeyframeLibrary::find(const char* name) const {
+    KeyframeAnimation animation;
+    size_t count = animationCount();
+    if (count == 0 || !name) {
+        return animation;
+    }
+
+    const KeyframeIndexEntry* entries = index();
+    const KeyframeIndexEntry* end = entries + count;
+    const KeyframeIndexEntry* entry = std::lower_bound(entries, end, name,
+        [](const KeyframeIndexEntry& e, const char* key) {
+            return strncmp(e.name, key, KEYFRAME_NAME_LENGTH) < 0;
+        });
+    if (entry == end || strncmp(entry->name, name, KEYFRAME_NAME_LENGTH) != 0) {
+        return animation;
+    }
+
+    // Grenzen dieser Animation prüfen (64 Bit, siehe open())
+    uint64_t begin = entry->offset;
+    uint64_t limit = begin + entry->size;
+    if (limit > m_size || entry->size < sizeof(KeyframeAnimationHeader)) {
+        return animation;
+    }
+
+    const KeyframeAnimationHeader* header = reinterpret_cast<const KeyframeAnimationHeader*>(m_data + begin);
+    for (int track = 0; track < static_cast<int>(KeyframeTrack::Count); track++) {
+        uint64_t trackBegin = header->trackOffset[track];
+        uint64_t trackEnd = trackBegin + static_cast<uint64_t>(header->trackKeyCount[track]) * sizeof(Keyframe);
+        if (header->trackKeyCount[track] > 0 && (trackBegin < begin || trackEnd > limit)) {
+            return animation;
+        }
+        animation.tracks[track] = reinterpret_cast<const Keyframe*>(m_data + trackBegin);
+    }
+    animation.header = header;
+    return animation;
+}
+
+// ============================================================================
+// KeyframeEffect (Player)
+// ============================================================================
+
+KeyframeEffect::KeyframeEffect(std::shared_ptr<KeyframeLibrary> library, const KeyframeAnimation& animation)
+    : m_library(library)
+    , m_animation(animation) {
+    memset(m_cursor, 0, sizeof(m_cursor));
+}
+
+// Abspielzeit -> Zeit innerhalb der Animation (Schleifen aufgelöst)
+uint32_t KeyframeEffect::localTime(double timeMs, bool& finished) const {
+    const KeyframeAnimationHeader* header = m_animation.header;
+    uint64_t t = static_cast<uint64_t>(timeMs);
+    finished = false;
+
+    if (header->loopEndMs > header->loopStartMs && t >= header->loopEndMs) {
+        uint64_t loopLength = header->loopEndMs - header->loopStartMs;
+        uint64_t pass = (t - header->loopStartMs) / loopLength;
+
+        // loopCount = Anzahl Durchläufe der Schleife insgesamt
+        if (header->loopCount == 0 || pass < header->loopCount) {
+            return static_cast<uint32_t>(header->loopStartMs + (t - header->loopStartMs) % loopLength);
+        }
+        t -= (header->loopCount - 1) * loopLength;
+    }
+
+    if (t >= header->durationMs) {
+        finished = true;
+        return header->durationMs;
+    }
+    return static_cast<uint32_t>(t);
+}
+
+void KeyframeEffect::sampleTrack(int track, uint32_t timeMs, uint8_t out[4]) {
+    uint16_t count = m_animation.header->trackKeyCount[track];
+    if (count == 0) {
+        out[0] = (track == static_cast<int>(KeyframeTrack::Brightness)) ? 255 : 0;
+        out[1] = out[2] = out[3] = 0;
+        return;
+    }
+
+    const Keyframe* keys = m_animation.tracks[track];
+    uint16_t& cursor = m_cursor[track];
+
+    // Cursor läuft mit der Zeit mit; nach Schleifensprung von vorne
+    if (cursor >= count || keys[cursor].timeMs > timeMs) {
+        cursor = 0;
+    }
+    while (cursor + 1 < count && keys[cursor + 1].timeMs <= timeMs) {
+        cursor++;
+    }
+
+    const Keyframe& a = keys[cursor];
+    if (timeMs <= a.timeMs || cursor + 1 >= count ||
+        m_animation.header->interpolation == static_cast<uint8_t>(KeyframeInterpolation::Step)) {
+        memcpy(out, a.value, 4);
+        return;
+    }
+
+    const Keyframe& b = keys[cursor + 1];
+    uint32_t f = ((timeMs - a.timeMs) * 256) / (b.timeMs - a.timeMs);     // Q8
+    if (m_animation.header->interpolation == static_cast<uint8_t>(KeyframeInterpolation::Smooth)) {
+        f = (f * f * (768 - 2 * f)) >> 16;                                   // Smoothstep
+    }
+    for (int i = 0; i < 4; i++) {
+        out[i] = static_cast<uint8_t>((a.value[i] * (256 - f) + b.value[i] * f) >> 8);
+    }
+}
+
+EffectStatus KeyframeEffect::render(const FrameContext& frame, LEDZones& zones) {
+    if (!m_animation.valid()) {
+        zones = LEDZones(RGBColor(0, 0, 0));
+        return EffectStatus::Finished;
+    }
+
+    bool finished = false;
+    uint32_t t = localTime(frame.timeMs, finished);
+
+    uint8_t logo[4], power[4], mic[4], brightness[4];
+    sampleTrack(static_cast<int>(KeyframeTrack::Logo), t, logo);
+    sampleTrack(static_cast<int>(KeyframeTrack::Power), t, power);
+    sampleTrack(static_cast<int>(KeyframeTrack::Mic), t, mic);
+    sampleTrack(static_cast<int>(KeyframeTrack::Brightness), t, brightness);
+
+    uint16_t level = static_cast<uint16_t>(brightness[0] + (brightness[0] >> 7));
+    zones.logo = Color::scale(RGBColor(logo[0], logo[1], logo[2]), level);
+    zones.power = Color::scale(RGBColor(power[0], power[1], power[2]), level);
+    zones.mic = Color::scale(RGBColor(mic[0], mic[1], mic[2]), level);
+
+    return finished ? EffectStatus::Finished : EffectStatus::Running;
+}
+
+// ============================================================================
+// Konverter: Text-Authoring-Format -> .hs8k
+// ============================================================================
+//
+//   # Kommentar
+//   animation <name>
+//   duration <ms>
+//   interpolation step|linear|smooth
+//   loop <startMs> <endMs> [anzahl]          anzahl 0 = endlos
+//   key <logo|power|mic|all> <ms> <r> <g> <b>
+//   key brightness <ms> <prozent>
+//   end
+
+struct AuthoringAnimation {
+    std::string name;
+    KeyframeAnimationHeader header;
+    std::vector<Keyframe> tracks[4];
+};
+
+static bool parseTrack(const std::string& word, int& first, int& last) {
+    if (word == "logo")       { first = last = static_cast<int>(KeyframeTrack::Logo); }
+    else if (word == "power") { first = last = static_cast<int>(KeyframeTrack::Power); }
+    else if (word == "mic")   { first = last = static_cast<int>(KeyframeTrack::Mic); }
+    else if (word == "all")   { first = static_cast<int>(KeyframeTrack::Logo); last = static_cast<int>(KeyframeTrack::Mic); }
+    else if (word == "brightness") { first = last = static_cast<int>(KeyframeTrack::Brightness); }
+    else return false;
+    return true;
+}
+
+static bool parseAuthoringText(std::istream& input, std::vector<AuthoringAnimation>& animations, std::string& error) {
+    AuthoringAnimation* current = nullptr;
+    std::string line;
+    int lineNumber = 0;
+
+    auto fail = [&](const std::string& message) {
+        error = "Zeile " + std::to_string(lineNumber) + ": " + message;
+        return false;
+    };
+
+    while (std::getline(input, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+
+        std::istringstream words(line);
+        std::string command;
+        if (!(words >> command)) {
+            continue;
+        }
+
+        if (command == "animation") {
+            if (current) return fail("'end' fehlt vor neuer Animation");
+            std::string name;
+            if (!(words >> name) || name.size() >= KEYFRAME_NAME_LENGTH) {
+                return fail("Name fehlt oder laenger als " + std::to_string(KEYFRAME_NAME_LENGTH - 1) + " Zeichen");
+            }
+            for (const AuthoringAnimation& other : animations) {
+                if (other.name == name) return fail("Animation '" + name + "' doppelt");
+            }
+            animations.emplace_back();
+            current = &animations.back();
+            current->name = name;
+            memset(&current->header, 0, sizeof(current->header));
+            current->header.interpolation = static_cast<uint8_t>(KeyframeInterpolation::Linear);
+            continue;
+        }
+
+        if (!current) return fail("'" + command + "' ausserhalb einer Animation");
+
+        if (command == "duration") {
+            if (!(words >> current->header.durationMs) || current->header.durationMs == 0) return fail("Ungueltige Dauer");
+        } else if (command == "interpolation") {
+            std::string mode;
+            words >> mode;
+            if (mode == "step") current->header.interpolation = static_cast<uint8_t>(KeyframeInterpolation::Step);
+            else if (mode == "linear") current->header.interpolation = static_cast<uint8_t>(KeyframeInterpolation::Linear);
+            else if (mode == "smooth") current->header.interpolation = static_cast<uint8_t>(KeyframeInterpolation::Smooth);
+            else return fail("Unbekannte Interpolation '" + mode + "'");
+        } else if (command == "loop") {
+            if (!(words >> current->header.loopStartMs >> current->header.loopEndMs) ||
+                current->header.loopEndMs <= current->header.loopStartMs) {
+                return fail("Ungueltige Schleife (Start < Ende)");
+            }
+            unsigned count = 0;
+            words >> count;
+            current->header.loopCount = static_cast<uint16_t>(count);
+        } else if (command == "key") {
+            std::string trackName;
+            uint32_t time = 0;
+            int first = 0, last = 0;
+            if (!(words >> trackName >> time) || !parseTrack(trackName, first, last)) {
+                return fail("Erwartet: key <logo|power|mic|all|brightness> <ms> ...");
+            }
+
+            Keyframe key;
+            key.timeMs = time;
+            memset(key.value, 0, sizeof(key.value));
+            if (first == static_cast<int>(KeyframeTrack::Brightness)) {
+                int percent = 0;
+                if (!(words >> percent) || percent < 0 || percent > 100) return fail("Helligkeit 0-100 erwartet");
+                key.value[0] = static_cast<uint8_t>((percent * 255 + 50) / 100);
+            } else {
+                int r = 0, g = 0, b = 0;
+                if (!(words >> r >> g >> b) || r < 0 || r > 255 || g < 0 || g > 255 || b < 0 || b > 255) {
+                    return fail("RGB 0-255 erwartet");
+                }
+                key.value[0] = static_cast<uint8_t>(r);
+                key.value[1] = static_cast<uint8_t>(g);
+                key.value[2] = static_cast<uint8_t>(b);
+            }
+            for (int track = first; track <= last; track++) {
+                current->tracks[track].push_back(key);
+            }
+        } else if (command == "end") {
+            if (current->header.durationMs == 0) return fail("'duration' fehlt");
+            if (current->header.loopEndMs > current->header.durationMs) return fail("Schleife endet nach der Animation");
+            for (auto& track : current->tracks) {
+                if (track.size() > 0xFFFF) return fail("Zu viele Keyframes");
+                std::stable_sort(track.begin(), track.end(),
+                    [](const Keyframe& a, const Keyframe& b) { return a.timeMs < b.timeMs; });
+            }
+            current = nullptr;
+        } else {
+            return fail("Unbekannter Befehl '" + command + "'");
+        }
+    }
+
+    if (current) {
+        lineNumber++;
+        return fail("'end' fehlt am Dateiende");
+    }
+    return true;
+}
+
+static void appendBytes(std::vector<uint8_t>& out, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+bool convertKeyframeText(const std::string& textPath, const std::string& binaryPath, std::string& error) {
+    std::ifstream input(textPath);
+    if (!input.is_open()) {
+        error = "Kann " + textPath + " nicht oeffnen";
+        return false;
+    }
+
+    std::vector<AuthoringAnimation> animations;
+    if (!parseAuthoringText(input, animations, error)) {
+        return false;
+    }
+    if (animations.size() > 0xFFFF) {
+        error = "Zu viele Animationen";
+        return false;
+    }
+
+    // Index nach Name sortiert (Binärsuche im Player)
+    std::sort(animations.begin(), animations.end(),
+        [](const AuthoringAnimation& a, const AuthoringAnimation& b) { return a.name < b.name; });
+
+    std::vector<uint8_t> out;
+    KeyframeFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = KEYFRAME_MAGIC;
+    header.version = KEYFRAME_VERSION;
+    header.animationCount = static_cast<uint16_t>(animations.size());
+    header.indexOffset = sizeof(KeyframeFileHeader);
+    appendBytes(out, &header, sizeof(header));
+
+    size_t indexPos = out.size();
+    out.resize(out.size() + animations.size() * sizeof(KeyframeIndexEntry));
+
+    for (size_t i = 0; i < animations.size(); i++) {
+        AuthoringAnimation& animation = animations[i];
+        size_t begin = out.size();
+
+        size_t offset = begin + sizeof(KeyframeAnimationHeader);
+        for (int track = 0; track < static_cast<int>(KeyframeTrack::Count); track++) {
+            animation.header.trackOffset[track] = static_cast<uint32_t>(offset);
+            animation.header.trackKeyCount[track] = static_cast<uint16_t>(animation.tracks[track].size());
+            offset += animation.tracks[track].size() * sizeof(Keyframe);
+        }
+        appendBytes(out, &animation.header, sizeof(animation.header));
+        for (const auto& track : animation.tracks) {
+            if (!track.empty()) {
+                appendBytes(out, track.data(), track.size() * sizeof(Keyframe));
+            }
+        }
+
+        KeyframeIndexEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        memcpy(entry.name, animation.name.c_str(), animation.name.size());
+        entry.offset = static_cast<uint32_t>(begin);
+        entry.size = static_cast<uint32_t>(out.size() - begin);
+        memcpy(&out[indexPos + i * sizeof(KeyframeIndexEntry)], &entry, sizeof(entry));
+    }
+
+    reinterpret_cast<KeyframeFileHeader*>(out.data())->fileSize = static_cast<uint32_t>(out.size());
+
+    std::ofstream output(binaryPath, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        error = "Kann " + binaryPath + " nicht schreiben";
+        return false;
+    }
+    output.write(reinterpret_cast<const char*>(out.data()), out.size());
+    if (!output.good()) {
+        error = "Schreibfehler in " + binaryPath;
+        return false;
+    }
+    return true;
+}
+
+} // namespace HS80
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "HS80_Animation.h"
+#include <string>
+
+// ============================================================================
+// HS80 Keyframes - Binäres Keyframe-Format und Player
+// ============================================================================
+//
+// Eine .hs8k-Datei enthält beliebig viele Animationen. Der Player mappt die
+// Datei (CreateFileMapping/MapViewOfFile) und liest Keyframes direkt aus dem
+// Mapping - kein Parsen, keine Heap-Allokation pro Frame. Das Öffnen prüft nur
+// Header und Index, die Startzeit hängt also nicht von der Dateigröße ab.
+//
+// Layout (Little Endian, alle Offsets ab Dateianfang, 4-Byte-ausgerichtet):
+//
+//   KeyframeFileHeader
+//   KeyframeIndexEntry[animationCount]       nach Name sortiert (Binärsuche)
+//   pro Animation:
+//     KeyframeAnimationHeader
+//     Keyframe[keyCount] pro Spur            Spuren: Logo, Power, Mic, Helligkeit
+//
+// Authoring-Format (Text) siehe convertKeyframeText() bzw. LIBRARY_README.md.
+// ============================================================================
+
+namespace HS80 {
+
+constexpr uint32_t KEYFRAME_MAGIC = 0x4B385348;     // "HS8K"
+constexpr uint16_t KEYFRAME_VERSION = 1;
+constexpr size_t KEYFRAME_NAME_LENGTH = 24;
+
+enum class KeyframeTrack : uint8_t {
+    Logo = 0,
+    Power = 1,
+    Mic = 2,
+    Brightness = 3,     // value[0] = 0-255 (255 = 100%), leere Spur = 100%
+    Count = 4
+};
+
+enum class KeyframeInterpolation : uint8_t {
+    Step = 0,           // Wert springt am Keyframe
+    Linear = 1,
+    Smooth = 2          // Smoothstep zwischen zwei Keyframes
+};
+
+#pragma pack(push, 1)
+struct KeyframeFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t animationCount;
+    uint32_t indexOffset;
+    uint32_t fileSize;
+    uint32_t reserved[4];
+};
+
+struct KeyframeIndexEntry {
+    char name[KEYFRAME_NAME_LENGTH];    // Null-terminiert
+    uint32_t offset;                    // -> KeyframeAnimationHeader
+    uint32_t size;
+};
+
+struct KeyframeAnimationHeader {
+    uint32_t durationMs;
+    uint32_t loopStartMs;
+    uint32_t loopEndMs;                 // 0 = keine Schleife
+    uint16_t loopCount;                 // 0 = endlos (wenn loopEndMs > 0)
+    uint8_t interpolation;              // KeyframeInterpolation
+    uint8_t reserved;
+    uint32_t trackOffset[4];            // Ab Dateianfang
+    uint16_t trackKeyCount[4];
+};
+
+struct Keyframe {
+    uint32_t timeMs;
+    uint8_t value[4];                   // RGB-Spuren: r, g, b, 0
+};
+#pragma pack(pop)
+
+static_assert(sizeof(KeyframeFileHeader) == 32, "KeyframeFileHeader: 32 Bytes");
+static_assert(sizeof(KeyframeIndexEntry) == 32, "KeyframeIndexEntry: 32 Bytes");
+static_assert(sizeof(KeyframeAnimationHeader) == 40, "KeyframeAnimationHeader: 40 Bytes");
+static_assert(sizeof(Keyframe) == 8, "Keyframe: 8 Bytes");
+
+// Sicht auf eine Animation im Mapping (nur Zeiger, keine Kopie)
+struct KeyframeAnimation {
+    const KeyframeAnimationHeader* header;
+    const Keyframe* tracks[4];
+
+    KeyframeAnimation() : header(nullptr), tracks() {}
+    bool valid() const { return header != nullptr; }
+};
+
+// Gemappte Animationsbibliothek (eine Datei)
+class KeyframeLibrary {
+private:
+    HANDLE m_file;
+    HANDLE m_mapping;
+    const uint8_t* m_data;
+    size_t m_size;
+
+    const KeyframeIndexEntry* index() const;
+
+public:
+    KeyframeLibrary();
+    ~KeyframeLibrary();
+
+    KeyframeLibrary(const KeyframeLibrary&) = delete;
+    KeyframeLibrary& operator=(const KeyframeLibrary&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    size_t animationCount() const;
+    const char* animationName(size_t i) const;
+
+    // Binärsuche im Index; prüft nur die Grenzen dieser einen Animation
+    KeyframeAnimation find(const char* name) const;
+};
+
+// Spielt eine Animation aus einer KeyframeLibrary ab
+class KeyframeEffect : public Effect {
+private:
+    std::shared_ptr<KeyframeLibrary> m_library;     // Hält das Mapping am Leben
+    KeyframeAnimation m_animation;
+    uint16_t m_cursor[4];                           // Letzter Keyframe pro Spur
+
+    uint32_t localTime(double timeMs, bool& finished) const;
+    void sampleTrack(int track, uint32_t timeMs, uint8_t out[4]);
+
+public:
+    KeyframeEffect(std::shared_ptr<KeyframeLibrary> library, const KeyframeAnimation& animation);
+
+    bool valid() const { return m_animation.valid(); }
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override;
+};
+
+// Text-Authoring-Format -> .hs8k (mehrere Animationen pro Datei)
+bool convertKeyframeText(const std::string& textPath, const std::string& binaryPath, std::string& error);
+
+} // namespace HS80
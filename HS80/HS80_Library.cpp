@@ -1,4 +1,11 @@
 #include "HS80_Library.h"
+#include "HS80_Animation.h"
+#include "HS80_FrameTables.h"
+#include "HS80_Dither.h"
+#include "HS80_FadePlanner.h"
+#include "HS80_Calibration.h"
+#include "HS80_Notification.h"
+#include "HS80_Clock.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -23,25 +30,408 @@ static HANDLE OpenHIDDevice(const std::string& path, bool overlapped) {
                       nullptr);
 }
 
-static bool SendHIDReport(HANDLE device, const unsigned char* data, size_t size) {
+static bool SendHIDReport(HIDTransport& transport, const unsigned char* data, size_t size) {
     // HS80 verwendet direkt 64-Byte Pakete ohne Report-ID
     // (Kein 0x00 Prefix nötig wie bei anderen HID-Geräten)
+    return transport.write(data, size);
+}
+
+// ============================================================================
+// LatencyHistogram
+// ============================================================================
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+int LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < static_cast<uint64_t>(SUB_BUCKET_COUNT)) {
+        return static_cast<int>(value);
+    }
+    
+    int msb = 63;
+    while (!(value & (1ULL << msb))) {
+        msb--;
+    }
+    
+    // Oberste SUB_BUCKET_BITS+1 Bits bestimmen den Bucket innerhalb der Zweierpotenz
+    int shift = msb - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKET_COUNT + static_cast<int>(value >> shift) - SUB_BUCKET_COUNT;
+}
+
+uint64_t LatencyHistogram::bucketMidpoint(int index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return static_cast<uint64_t>(index);
+    }
+    
+    int shift = index / SUB_BUCKET_COUNT - 1;
+    uint64_t lower = static_cast<uint64_t>(index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT) << shift;
+    return lower + ((1ULL << shift) >> 1);
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    m_buckets[bucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+    
+    uint64_t current = m_min.load(std::memory_order_relaxed);
+    while (nanoseconds < current &&
+           !m_min.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed)) {
+    }
+    current = m_max.load(std::memory_order_relaxed);
+    while (nanoseconds > current &&
+           !m_max.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::record(std::chrono::steady_clock::duration duration) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+}
+
+void LatencyHistogram::reset() {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(UINT64_MAX, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double percent) const {
+    uint64_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+    
+    uint64_t target = static_cast<uint64_t>(percent / 100.0 * total + 0.5);
+    if (target < 1) target = 1;
+    if (target > total) target = total;
+    
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            uint64_t value = bucketMidpoint(i);
+            uint64_t maxValue = m_max.load(std::memory_order_relaxed);
+            return value < maxValue ? value : maxValue;
+        }
+    }
+    return m_max.load(std::memory_order_relaxed);
+}
+
+LatencySnapshot LatencyHistogram::snapshot() const {
+    LatencySnapshot snap;
+    snap.count = count();
+    
+    if (snap.count == 0) {
+        snap.minUs = snap.meanUs = snap.p50Us = snap.p90Us = snap.p99Us = snap.p999Us = snap.maxUs = 0.0;
+        return snap;
+    }
+    
+    snap.minUs = m_min.load(std::memory_order_relaxed) / 1000.0;
+    snap.meanUs = (m_sum.load(std::memory_order_relaxed) / 1000.0) / snap.count;
+    snap.p50Us = percentile(50.0) / 1000.0;
+    snap.p90Us = percentile(90.0) / 1000.0;
+    snap.p99Us = percentile(99.0) / 1000.0;
+    snap.p999Us = percentile(99.9) / 1000.0;
+    snap.maxUs = m_max.load(std::memory_order_relaxed) / 1000.0;
+    return snap;
+}
+
+// ============================================================================
+// HeadsetStateCache
+// ============================================================================
+
+static const uint64_t STATE_BATTERY_UNKNOWN = 2047;
+
+HeadsetStateCache::HeadsetStateCache()
+    : m_clock(systemClock().get()) {
+    reset();
+}
+
+void HeadsetStateCache::setClock(Clock* clock) {
+    m_clock.store(clock ? clock : systemClock().get(), std::memory_order_release);
+}
+
+uint64_t HeadsetStateCache::pack(const HeadsetState& state) {
+    uint64_t muted = state.muted < 0 ? 0 : (state.muted ? 2 : 1);
+    uint64_t charging = static_cast<uint64_t>(state.charging) & 0x3;
+    uint64_t sleeping = state.sleeping < 0 ? 0 : (state.sleeping ? 2 : 1);
+    uint64_t battery = state.batteryLevelRaw < 0 ? STATE_BATTERY_UNKNOWN
+                     : static_cast<uint64_t>(state.batteryLevelRaw > 1000 ? 1000 : state.batteryLevelRaw);
+    uint64_t ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        state.lastUpdate.time_since_epoch()).count());
+    
+    return muted | (charging << 2) | (sleeping << 4) | (battery << 6) | (ms << 17);
+}
+
+HeadsetState HeadsetStateCache::unpack(uint64_t packed) {
+    HeadsetState state;
+    uint64_t muted = packed & 0x3;
+    uint64_t sleeping = (packed >> 4) & 0x3;
+    uint64_t battery = (packed >> 6) & 0x7FF;
+    
+    state.muted = muted == 0 ? -1 : (muted == 2 ? 1 : 0);
+    state.charging = static_cast<ChargingState>((packed >> 2) & 0x3);
+    state.sleeping = sleeping == 0 ? -1 : (sleeping == 2 ? 1 : 0);
+    state.batteryLevelRaw = battery == STATE_BATTERY_UNKNOWN ? -1 : static_cast<int>(battery);
+    state.batteryLevel = state.batteryLevelRaw < 0 ? -1 : state.batteryLevelRaw / 10;
+    state.lastUpdate = std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::milliseconds(static_cast<long long>(packed >> 17))));
+    return state;
+}
+
+template <typename Modifier>
+void HeadsetStateCache::modify(Modifier modifier) {
+    uint64_t current = m_packed.load(std::memory_order_relaxed);
+    for (;;) {
+        HeadsetState state = unpack(current);
+        modifier(state);
+        // Mindestens 1ms: Zeitpunkt 0 bedeutet "noch nie aktualisiert" (VirtualClock startet bei 0)
+        state.lastUpdate = std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(std::max<int64_t>(clock().nowNs(), Clock::NS_PER_MS))));
+        if (m_packed.compare_exchange_weak(current, pack(state),
+                                           std::memory_order_release, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+bool HeadsetStateCache::isStale(DWORD ttlMs) const {
+    HeadsetState state = snapshot();
+    if (!state.hasData()) {
+        return true;
+    }
+    auto now = std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::nanoseconds(clock().nowNs())));
+    return now - state.lastUpdate > std::chrono::milliseconds(ttlMs);
+}
+
+void HeadsetStateCache::applyEvent(const HeadsetEvent& event) {
+    switch (event.getActualEventType()) {
+    case EventType::Mute:
+        if (event.dataSize >= 6) {
+            bool muted = event.isMuted();
+            modify([muted](HeadsetState& state) { state.muted = muted ? 1 : 0; state.sleeping = 0; });
+        }
+        break;
+    case EventType::Battery:
+        if (event.dataSize >= 7) {
+            int raw = event.getBatteryLevelRaw();
+            modify([raw](HeadsetState& state) { state.batteryLevelRaw = raw; state.sleeping = 0; });
+        }
+        break;
+    case EventType::Charging:
+        if (event.dataSize >= 6) {
+            // Event meldet nur laedt/laedt nicht; "voll" kennt nur die Abfrage
+            bool charging = event.isCharging();
+            modify([charging](HeadsetState& state) {
+                if (charging) {
+                    state.charging = ChargingState::Charging;
+                } else if (state.charging != ChargingState::FullyCharged) {
+                    state.charging = ChargingState::Discharging;
+                }
+                state.sleeping = 0;
+            });
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void HeadsetStateCache::applyBattery(const BatteryStatus& status) {
+    if (!status.valid) {
+        return;
+    }
+    modify([&status](HeadsetState& state) {
+        state.batteryLevelRaw = status.levelRaw;
+        state.charging = status.state;
+    });
+}
+
+void HeadsetStateCache::applyMuted(bool muted) {
+    modify([muted](HeadsetState& state) { state.muted = muted ? 1 : 0; });
+}
+
+void HeadsetStateCache::applySleeping(bool sleeping) {
+    modify([sleeping](HeadsetState& state) { state.sleeping = sleeping ? 1 : 0; });
+}
+
+void HeadsetStateCache::reset() {
+    HeadsetState state;
+    state.muted = -1;
+    state.batteryLevel = -1;
+    state.batteryLevelRaw = -1;
+    state.charging = ChargingState::Unknown;
+    state.sleeping = -1;
+    state.lastUpdate = std::chrono::steady_clock::time_point();
+    m_packed.store(pack(state), std::memory_order_release);
+}
+
+// ============================================================================
+// Executor
+// ============================================================================
+
+static VOID CALLBACK ThreadPoolCallback(PTP_CALLBACK_INSTANCE, PVOID context) {
+    std::function<void()>* task = static_cast<std::function<void()>*>(context);
+    (*task)();
+    delete task;
+}
+
+void ThreadPoolExecutor::post(std::function<void()> task) {
+    std::function<void()>* heapTask = new std::function<void()>(std::move(task));
+    if (!TrySubmitThreadpoolCallback(ThreadPoolCallback, heapTask, nullptr)) {
+        // Fallback: lieber synchron ausführen als die Fortsetzung verlieren
+        (*heapTask)();
+        delete heapTask;
+    }
+}
+
+// ============================================================================
+// Win32HIDTransport
+// ============================================================================
+
+Win32HIDTransport::Win32HIDTransport(HANDLE device)
+    : m_device(device)
+    , m_readPending(false)
+    , m_writePending(false)
+    , m_writeSize(0) {
+    memset(&m_readOverlapped, 0, sizeof(m_readOverlapped));
+    memset(&m_writeOverlapped, 0, sizeof(m_writeOverlapped));
+    memset(m_readBuffer, 0, sizeof(m_readBuffer));
+    m_readOverlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    m_writeOverlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    InitializeCriticalSection(&m_writeLock);
+}
+
+Win32HIDTransport::~Win32HIDTransport() {
+    if (m_readPending) {
+        // Ausstehenden Read abbrechen und abwarten, bevor der Puffer freigegeben wird
+        DWORD bytesRead = 0;
+        CancelIoEx(m_device, &m_readOverlapped);
+        GetOverlappedResult(m_device, &m_readOverlapped, &bytesRead, TRUE);
+        m_readPending = false;
+    }
+    
+    CloseHandle(m_device);
+    if (m_readOverlapped.hEvent) CloseHandle(m_readOverlapped.hEvent);
+    if (m_writeOverlapped.hEvent) CloseHandle(m_writeOverlapped.hEvent);
+    DeleteCriticalSection(&m_writeLock);
+}
+
+std::shared_ptr<Win32HIDTransport> Win32HIDTransport::open(const std::string& path) {
+    HANDLE device = OpenHIDDevice(path, true);
+    if (device == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    
+    std::shared_ptr<Win32HIDTransport> transport(new Win32HIDTransport(device));
+    if (!transport->m_readOverlapped.hEvent || !transport->m_writeOverlapped.hEvent) {
+        return nullptr;
+    }
+    return transport;
+}
+
+bool Win32HIDTransport::write(const unsigned char* data, size_t size) {
+    return beginWrite(data, size) && finishWrite();
+}
+
+bool Win32HIDTransport::beginWrite(const unsigned char* data, size_t size) {
+    // Bleibt bis finishWrite() gesperrt: andere Threads schreiben erst danach
+    EnterCriticalSection(&m_writeLock);
+    
+    ResetEvent(m_writeOverlapped.hEvent);
+    if (!WriteFile(m_device, data, static_cast<DWORD>(size), nullptr, &m_writeOverlapped) &&
+        GetLastError() != ERROR_IO_PENDING) {
+        std::cerr << "[ERROR] WriteFile failed! Error: " << GetLastError() << std::endl;
+        LeaveCriticalSection(&m_writeLock);
+        return false;
+    }
+    
+    // Sofort fertig oder ausstehend - das Ergebnis liefert in beiden Fällen GetOverlappedResult
+    m_writePending = true;
+    m_writeSize = size;
+    return true;
+}
+
+bool Win32HIDTransport::finishWrite() {
+    if (!m_writePending) {
+        return false;
+    }
+    
+    if (WaitForSingleObject(m_writeOverlapped.hEvent, 1000) != WAIT_OBJECT_0) {
+        CancelIoEx(m_device, &m_writeOverlapped);
+    }
     DWORD bytesWritten = 0;
-    BOOL result = WriteFile(device, data, static_cast<DWORD>(size), &bytesWritten, nullptr);
+    BOOL result = GetOverlappedResult(m_device, &m_writeOverlapped, &bytesWritten, TRUE);
+    DWORD error = result ? ERROR_SUCCESS : GetLastError();
+    size_t expected = m_writeSize;
+    m_writePending = false;
+    
+    LeaveCriticalSection(&m_writeLock);
     
     if (!result) {
-        std::cerr << "[ERROR] WriteFile failed! Error: " << GetLastError() << std::endl;
+        std::cerr << "[ERROR] WriteFile failed! Error: " << error << std::endl;
         return false;
     }
     
-    if (bytesWritten != size) {
-        std::cerr << "[ERROR] Wrote " << bytesWritten << " bytes, expected " << size << std::endl;
+    if (bytesWritten != expected) {
+        std::cerr << "[ERROR] Wrote " << bytesWritten << " bytes, expected " << expected << std::endl;
         return false;
     }
     
     return true;
 }
 
+ReadResult Win32HIDTransport::read(unsigned char* buffer, size_t size, size_t& bytesRead, DWORD timeoutMs) {
+    bytesRead = 0;
+    
+    if (!m_readPending) {
+        ResetEvent(m_readOverlapped.hEvent);
+        DWORD immediate = 0;
+        if (ReadFile(m_device, m_readBuffer, sizeof(m_readBuffer), &immediate, &m_readOverlapped)) {
+            // Report lag bereits im Treiber-Puffer
+            bytesRead = immediate < size ? immediate : size;
+            memcpy(buffer, m_readBuffer, bytesRead);
+            return ReadResult::Ok;
+        }
+        if (GetLastError() != ERROR_IO_PENDING) {
+            return ReadResult::Error;
+        }
+        m_readPending = true;
+    }
+    
+    DWORD waitResult = WaitForSingleObject(m_readOverlapped.hEvent, timeoutMs);
+    if (waitResult == WAIT_TIMEOUT) {
+        return ReadResult::Timeout;
+    }
+    
+    DWORD transferred = 0;
+    BOOL ok = (waitResult == WAIT_OBJECT_0) &&
+              GetOverlappedResult(m_device, &m_readOverlapped, &transferred, FALSE);
+    m_readPending = false;
+    
+    if (!ok) {
+        return ReadResult::Error;
+    }
+    
+    bytesRead = transferred < size ? transferred : size;
+    memcpy(buffer, m_readBuffer, bytesRead);
+    return ReadResult::Ok;
+}
+
+void Win32HIDTransport::flushInput() {
+    HidD_FlushQueue(m_device);
+}
+
+bool Win32HIDTransport::setInputBufferCount(unsigned long count) {
+    return HidD_SetNumInputBuffers(m_device, count) == TRUE;
+}
+
 // ============================================================================
 // Device Discovery
 // ============================================================================
@@ -104,6 +494,9 @@ std::vector<DeviceInfo> enumerateDevices(unsigned short vid, unsigned short pid)
                                 if (HidD_GetProductString(hDevice, buffer, sizeof(buffer))) {
                                     info.product = buffer;
                                 }
+                                if (HidD_GetSerialNumberString(hDevice, buffer, sizeof(buffer))) {
+                                    info.serialNumber = buffer;
+                                }
                                 
                                 devices.push_back(info);
                             }
@@ -140,17 +533,45 @@ bool findDeviceByUsage(unsigned short vid, unsigned short pid,
 // ============================================================================
 
 RGBController::RGBController()
-    : m_device(INVALID_HANDLE_VALUE)
-    , m_isWireless(false)
+    : m_isWireless(false)
     , m_initialized(false)
     , m_keepAliveThread(nullptr)
+    , m_keepAliveStopEvent(CreateEvent(nullptr, FALSE, FALSE, nullptr))
     , m_keepAliveRunning(false)
-    , m_currentBrightness(1000) {  // Standard: 100%
+    , m_keepAliveIntervalMs(5000)
+    , m_clock(systemClock())
+    , m_currentBrightness(1000)  // Standard: 100%
+    , m_micOverride(0)
+    , m_commandThread(nullptr)
+    , m_commandEvent(nullptr)
+    , m_commandRunning(false)
+    , m_hardwareBrightness(1000)
+    , m_notificationMask(0) {
     InitializeCriticalSection(&m_lock);
+    InitializeCriticalSection(&m_sendLock);
+    InitializeCriticalSection(&m_commandLock);
+    InitializeCriticalSection(&m_queryLock);
+    memset(m_pendingPacket, 0, sizeof(m_pendingPacket));
+    m_ditherer.reset(new Ditherer());
+    m_ditherer->reset(m_hardwareBrightness);
+    m_fadePlanner.reset(new FadePlanner());
+    m_calibrationProfile.reset(new CalibrationProfile());
+    m_animation.reset(new AnimationEngine([this](const LEDZones& zones) { return setColors(zones); },
+                                          [this](const HighResZones& zones) { return setColorsHighRes(zones); },
+                                          [this](const LEDZones& base, uint32_t level) { return setColorsLevel(base, level); }));
+    m_notifications.reset(new NotificationQueue([this](uint8_t mask, const LEDZones& zones) { return applyNotification(mask, zones); }));
 }
 
 RGBController::~RGBController() {
     disconnect();
+    m_notifications.reset();
+    m_animation.reset();
+    if (m_keepAliveStopEvent) {
+        CloseHandle(m_keepAliveStopEvent);
+    }
+    DeleteCriticalSection(&m_queryLock);
+    DeleteCriticalSection(&m_commandLock);
+    DeleteCriticalSection(&m_sendLock);
     DeleteCriticalSection(&m_lock);
 }
 
@@ -171,8 +592,8 @@ bool RGBController::connect(unsigned short vid, unsigned short pid) {
     std::cout << "      Usage Page: 0x" << std::hex << rgbDevice.usagePage
               << ", Usage: 0x" << rgbDevice.usage << std::dec << std::endl;
     
-    m_device = OpenHIDDevice(rgbDevice.path, false);
-    if (m_device == INVALID_HANDLE_VALUE) {
+    m_transport = Win32HIDTransport::open(rgbDevice.path);
+    if (!m_transport) {
         std::cerr << "[RGB] Fehler beim Oeffnen! Error: " << GetLastError() << std::endl;
         return false;
     }
@@ -180,19 +601,117 @@ bool RGBController::connect(unsigned short vid, unsigned short pid) {
     m_isWireless = (pid == HS80_WIRELESS_PID);
     std::cout << "[RGB] Verbunden! (Modus: " << (m_isWireless ? "Wireless" : "Wired") << ")" << std::endl;
     
+    // Geräte-ID für das Kalibrierprofil: Seriennummer, sonst VID/PID (dann
+    // teilen sich alle Geräte dieses Typs ein Profil)
+    std::string deviceId;
+    for (wchar_t c : rgbDevice.serialNumber) {
+        if (c > 32 && c < 127) deviceId += static_cast<char>(c);
+    }
+    if (deviceId.empty()) {
+        char fallback[16];
+        snprintf(fallback, sizeof(fallback), "%04X_%04X", rgbDevice.vendorId, rgbDevice.productId);
+        deviceId = fallback;
+    }
+    useDeviceCalibration(deviceId);
+    
+    return true;
+}
+
+bool RGBController::connect(std::shared_ptr<HIDTransport> transport, bool wireless, const std::string& deviceId) {
+    if (isConnected()) {
+        disconnect();
+    }
+    if (!transport) {
+        return false;
+    }
+    
+    m_transport = transport;
+    m_isWireless = wireless;
+    useDeviceCalibration(deviceId);
+    return true;
+}
+
+void RGBController::useDeviceCalibration(const std::string& deviceId) {
+    EnterCriticalSection(&m_sendLock);
+    m_deviceId = deviceId;
+    LeaveCriticalSection(&m_sendLock);
+    
+    // Kein Profil: unkalibriert (auch nach einem Gerätewechsel)
+    std::string error;
+    std::string path = CalibrationProfile::pathFor(CALIBRATION_DIRECTORY, deviceId);
+    if (deviceId.empty() || GetFileAttributesA(path.c_str()) == INVALID_FILE_ATTRIBUTES) {
+        setCalibration(CalibrationProfile());
+    } else if (loadCalibration(CALIBRATION_DIRECTORY, error)) {
+        std::cout << "[RGB] Kalibrierung geladen: " << path << std::endl;
+    } else {
+        std::cerr << "[RGB] Kalibrierung " << path << ": " << error << std::endl;
+    }
+}
+
+void RGBController::setCalibration(const CalibrationProfile& profile) {
+    // Tabellen außerhalb des Locks bauen, nur der Tausch blockiert das Senden
+    std::unique_ptr<CalibrationTables> tables;
+    if (!profile.isIdentity()) {
+        tables.reset(new CalibrationTables(profile));
+    }
+    std::unique_ptr<CalibrationProfile> copy(new CalibrationProfile(profile));
+    
+    EnterCriticalSection(&m_sendLock);
+    m_calibration.swap(tables);
+    m_calibrationProfile.swap(copy);
+    LeaveCriticalSection(&m_sendLock);
+}
+
+CalibrationProfile RGBController::getCalibration() const {
+    EnterCriticalSection(&m_sendLock);
+    CalibrationProfile profile = *m_calibrationProfile;
+    LeaveCriticalSection(&m_sendLock);
+    return profile;
+}
+
+std::string RGBController::deviceId() const {
+    EnterCriticalSection(&m_sendLock);
+    std::string id = m_deviceId;
+    LeaveCriticalSection(&m_sendLock);
+    return id;
+}
+
+bool RGBController::loadCalibration(const std::string& directory, std::string& error) {
+    CalibrationProfile profile;
+    if (!profile.loadFile(CalibrationProfile::pathFor(directory, deviceId()), error)) {
+        setCalibration(CalibrationProfile());
+        return false;
+    }
+    setCalibration(profile);
+    return true;
+}
+
+bool RGBController::saveCalibration(const CalibrationProfile& profile, const std::string& directory, std::string& error) {
+    std::string id = deviceId();
+    if (id.empty()) {
+        error = "Keine Geraete-ID (nicht verbunden?)";
+        return false;
+    }
+    CreateDirectoryA(directory.c_str(), nullptr);
+    if (!profile.saveFile(CalibrationProfile::pathFor(directory, id), error)) {
+        return false;
+    }
+    setCalibration(profile);
     return true;
 }
 
 void RGBController::disconnect() {
+    m_animation->stop();
+    m_animation->wait();
     stopKeepAlive();
+    stopCommandThread();
     
     if (m_initialized) {
         setHardwareMode();
     }
     
     if (isConnected()) {
-        CloseHandle(m_device);
-        m_device = INVALID_HANDLE_VALUE;
+        m_transport.reset();
         m_initialized = false;
         std::cout << "[RGB] Getrennt." << std::endl;
     }
@@ -217,12 +736,12 @@ bool RGBController::initialize() {
     packet1[4] = 0x00;
     packet1[5] = 0x02;
     
-    if (!SendHIDReport(m_device, packet1, 64)) {
+    if (!SendHIDReport(*m_transport, packet1, 64)) {
         std::cerr << "[RGB] Fehler bei Paket 1 (Software-Modus)!" << std::endl;
         return false;
     }
     
-    Sleep(100);
+    m_clock->sleep(100);
     
     // Paket 2: Open lighting endpoint
     unsigned char packet2[64] = {0};
@@ -232,12 +751,12 @@ bool RGBController::initialize() {
     packet2[3] = 0x00;
     packet2[4] = 0x01;
     
-    if (!SendHIDReport(m_device, packet2, 64)) {
+    if (!SendHIDReport(*m_transport, packet2, 64)) {
         std::cerr << "[RGB] Fehler bei Paket 2 (Lighting oeffnen)!" << std::endl;
         return false;
     }
     
-    Sleep(100);
+    m_clock->sleep(100);
     
     // Paket 3: Set Hardware Brightness to 100%
     unsigned char packet3[64] = {0};
@@ -249,12 +768,16 @@ bool RGBController::initialize() {
     packet3[5] = 0xE8; // 1000 = 100% (little endian low byte)
     packet3[6] = 0x03; // high byte
     
-    if (!SendHIDReport(m_device, packet3, 64)) {
+    if (!SendHIDReport(*m_transport, packet3, 64)) {
         std::cerr << "[RGB] Fehler bei Paket 3 (Helligkeit)!" << std::endl;
         return false;
     }
+    EnterCriticalSection(&m_lock);
+    m_hardwareBrightness = 1000;
+    m_ditherer->reset(1000);
+    LeaveCriticalSection(&m_lock);
     
-    Sleep(100);
+    m_clock->sleep(100);
     
     m_initialized = true;
     std::cout << "[RGB] Software-Modus aktiviert!" << std::endl;
@@ -266,9 +789,223 @@ bool RGBController::setColors(const LEDZones& zones) {
     m_currentZones = zones;
     LeaveCriticalSection(&m_lock);
     
+    if (!restoreBrightness()) {
+        return false;
+    }
     return sendColorsInternal(zones);
 }
 
+// Prüfen der Überlagerung, Planen und Senden unter m_sendLock: applyNotification()
+// und setMicOverride() setzen ihren Zustand unter derselben Sperre und können
+// weder zwischen Prüfung und Plan noch zwischen die Pakete eines Frames geraten.
+bool RGBController::setColorsHighRes(const HighResZones& zones) {
+    EnterCriticalSection(&m_sendLock);
+    bool ok;
+    if (overlayActiveLocked()) {
+        // Während Benachrichtigung/Mic-Override volle Hardware-Helligkeit (sonst wird sie mit abgedunkelt)
+        LEDZones rounded;
+        unsigned char* values = reinterpret_cast<unsigned char*>(&rounded);
+        for (int i = 0; i < 9; i++) {
+            values[i] = static_cast<unsigned char>(std::min(255, (zones.channel[i] + 128) >> 8));
+        }
+        ok = sendPlainFrameLocked(rounded);
+    } else {
+        DitherFrame frame;
+        EnterCriticalSection(&m_lock);
+        m_ditherer->process(zones, m_currentBrightness, frame);
+        int previous = m_hardwareBrightness;
+        m_hardwareBrightness = frame.hardwareBrightness;
+        m_currentZones = frame.zones;
+        LeaveCriticalSection(&m_lock);
+        
+        ok = sendFrameInternal(frame.zones, true, frame.hardwareBrightness, previous);
+    }
+    LeaveCriticalSection(&m_sendLock);
+    return ok;
+}
+
+bool RGBController::setColorsLevel(const LEDZones& base, uint32_t level) {
+    EnterCriticalSection(&m_sendLock);
+    bool ok;
+    // Mit Kalibrierung keine reinen Helligkeitsschritte: die Kurve (gamma) hängt
+    // vom sichtbaren Pegel ab und müsste mit jedem Schritt neu angewendet werden
+    if (overlayActiveLocked() || m_calibration) {
+        LEDZones scaled;
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(&base);
+        unsigned char* out = reinterpret_cast<unsigned char*>(&scaled);
+        for (int i = 0; i < 9; i++) {
+            out[i] = static_cast<unsigned char>((in[i] * static_cast<uint64_t>(level) + LEVEL_ONE / 2) / LEVEL_ONE);
+        }
+        ok = sendPlainFrameLocked(scaled);
+    } else {
+        FadeStep step;
+        EnterCriticalSection(&m_lock);
+        m_fadePlanner->plan(base, level, m_currentBrightness, m_currentZones, m_hardwareBrightness, step);
+        int previous = m_hardwareBrightness;
+        m_hardwareBrightness = step.hardwareBrightness;
+        m_currentZones = step.zones;
+        if (step.sendBrightness) {
+            m_ditherer->reset(step.hardwareBrightness);
+        }
+        LeaveCriticalSection(&m_lock);
+        
+        // Nichts Sichtbares zu ändern: kein Report
+        if (!step.sendColors && !step.sendBrightness) {
+            ok = isConnected();
+        } else {
+            ok = sendFrameInternal(step.zones, step.sendColors, step.hardwareBrightness, previous);
+        }
+    }
+    LeaveCriticalSection(&m_sendLock);
+    return ok;
+}
+
+bool RGBController::overlayActiveLocked() const {
+    return m_notificationMask.load(std::memory_order_acquire) != 0 ||
+           (m_micOverride.load(std::memory_order_acquire) & MIC_OVERRIDE_ACTIVE) != 0;
+}
+
+void RGBController::setFadePlanConfig(const FadePlanConfig& config) {
+    EnterCriticalSection(&m_lock);
+    m_fadePlanner->setConfig(config);
+    LeaveCriticalSection(&m_lock);
+}
+
+FadePlanConfig RGBController::getFadePlanConfig() const {
+    EnterCriticalSection(&m_lock);
+    FadePlanConfig config = m_fadePlanner->getConfig();
+    LeaveCriticalSection(&m_lock);
+    return config;
+}
+
+FadePlanStats RGBController::getFadePlanStats() const {
+    EnterCriticalSection(&m_lock);
+    FadePlanStats stats = m_fadePlanner->getStats();
+    LeaveCriticalSection(&m_lock);
+    return stats;
+}
+
+void RGBController::resetFadePlanStats() {
+    EnterCriticalSection(&m_lock);
+    m_fadePlanner->resetStats();
+    LeaveCriticalSection(&m_lock);
+}
+
+// Farben bei eingestellter Hardware-Helligkeit (unter m_sendLock)
+bool RGBController::sendPlainFrameLocked(const LEDZones& zones) {
+    EnterCriticalSection(&m_lock);
+    int previous = m_hardwareBrightness;
+    m_currentZones = zones;
+    if (previous != m_currentBrightness) {
+        m_hardwareBrightness = m_currentBrightness;
+        m_ditherer->reset(m_currentBrightness);
+    }
+    int hardware = m_hardwareBrightness;
+    LeaveCriticalSection(&m_lock);
+    
+    return sendFrameInternal(zones, true, hardware, previous);
+}
+
+bool RGBController::sendFrameInternal(const LEDZones& zones, bool sendColors, int hardware, int previous) {
+    if (hardware == previous) {
+        return !sendColors || sendColorsInternal(zones);
+    }
+    
+    // Reihenfolge so, dass der Zwischenzustand dunkler ist als das Ziel:
+    // dunkler -> erst Helligkeit (alte Farben), heller -> erst Farben (kleinere Werte)
+    if (hardware < previous) {
+        bool ok = sendBrightnessInternal(hardware);
+        return (!sendColors || sendColorsInternal(zones)) && ok;
+    }
+    bool ok = !sendColors || sendColorsInternal(zones);
+    return sendBrightnessInternal(hardware) && ok;
+}
+
+bool RGBController::restoreBrightness() {
+    EnterCriticalSection(&m_lock);
+    bool lowered = m_hardwareBrightness != m_currentBrightness;
+    int brightness = m_currentBrightness;
+    if (lowered) {
+        m_hardwareBrightness = brightness;
+        m_ditherer->reset(brightness);
+    }
+    LeaveCriticalSection(&m_lock);
+    
+    return !lowered || sendBrightnessInternal(brightness);
+}
+
+// m_currentZones sind Gerätewerte zur Hardware-Helligkeit (bei Dithering bis 16x
+// hochskaliert, bei einer Blende über die Helligkeit die volle Grundfarbe).
+// Sichtbar bei eingestellter Helligkeit ist Wert * Hardware / eingestellt.
+LEDZones RGBController::userZonesLocked() const {
+    LEDZones zones = m_currentZones;
+    if (m_hardwareBrightness != m_currentBrightness && m_currentBrightness > 0) {
+        unsigned char* values = reinterpret_cast<unsigned char*>(&zones);
+        for (int i = 0; i < 9; i++) {
+            values[i] = static_cast<unsigned char>((values[i] * m_hardwareBrightness + m_currentBrightness / 2) / m_currentBrightness);
+        }
+    }
+    return zones;
+}
+
+LEDZones RGBController::getColors() const {
+    EnterCriticalSection(&m_lock);
+    LEDZones zones = userZonesLocked();
+    LeaveCriticalSection(&m_lock);
+    return zones;
+}
+
+void RGBController::setDitherConfig(const DitherConfig& config) {
+    EnterCriticalSection(&m_lock);
+    m_ditherer->setConfig(config);
+    LeaveCriticalSection(&m_lock);
+}
+
+DitherConfig RGBController::getDitherConfig() const {
+    EnterCriticalSection(&m_lock);
+    DitherConfig config = m_ditherer->getConfig();
+    LeaveCriticalSection(&m_lock);
+    return config;
+}
+
+DitherStats RGBController::getDitherStats() const {
+    EnterCriticalSection(&m_lock);
+    DitherStats stats = m_ditherer->getStats();
+    LeaveCriticalSection(&m_lock);
+    return stats;
+}
+
+bool RGBController::beginColors(const LEDZones& zones) {
+    if (!isConnected()) {
+        return false;
+    }
+    
+    if (!m_initialized && !initialize()) {
+        return false;
+    }
+    
+    EnterCriticalSection(&m_lock);
+    m_currentZones = zones;
+    LeaveCriticalSection(&m_lock);
+    
+    if (!restoreBrightness()) {
+        return false;
+    }
+    
+    EnterCriticalSection(&m_sendLock);
+    buildColorPacket(zones, m_pendingPacket);
+    bool ok = m_transport->beginWrite(m_pendingPacket, sizeof(m_pendingPacket));
+    LeaveCriticalSection(&m_sendLock);
+    return ok;
+}
+
+bool RGBController::finishColors() {
+    if (!isConnected()) {
+        return false;
+    }
+    return m_transport->finishWrite();
+}
+
 bool RGBController::sendColorsInternal(const LEDZones& zones) {
     if (!isConnected()) {
         return false;
@@ -278,9 +1015,18 @@ bool RGBController::sendColorsInternal(const LEDZones& zones) {
         return false;
     }
     
+    unsigned char packet[64];
+    EnterCriticalSection(&m_sendLock);
+    buildColorPacket(zones, packet);
+    bool ok = SendHIDReport(*m_transport, packet, 64);
+    LeaveCriticalSection(&m_sendLock);
+    return ok;
+}
+
+void RGBController::buildColorPacket(const LEDZones& zones, unsigned char* packet) const {
     const unsigned char headsetMode = m_isWireless ? 0x09 : 0x08;
     
-    unsigned char packet[64] = {0};
+    memset(packet, 0, 64);
     packet[0] = 0x02;
     packet[1] = headsetMode;
     packet[2] = 0x06;
@@ -308,7 +1054,37 @@ bool RGBController::sendColorsInternal(const LEDZones& zones) {
     packet[15] = zones.power.b; // LED_POWER_B
     packet[16] = zones.mic.b;   // LED_MIC_B
     
-    return SendHIDReport(m_device, packet, 64);
+    // Benachrichtigung über dem Grundzustand (Maske = LEDZone-Bits)
+    uint8_t notification = m_notificationMask.load(std::memory_order_acquire);
+    if (notification) {
+        const RGBColor* colors[3] = { &m_notificationZones.logo, &m_notificationZones.power, &m_notificationZones.mic };
+        for (int z = 0; z < 3; z++) {
+            if (notification & (1 << z)) {
+                packet[8 + z] = colors[z]->r;
+                packet[11 + z] = colors[z]->g;
+                packet[14 + z] = colors[z]->b;
+            }
+        }
+    }
+    
+    // Mute-Reflex hat Vorrang vor Effekt, Benachrichtigung und gesetzter Mic-Farbe
+    uint32_t micOverride = m_micOverride.load(std::memory_order_acquire);
+    if (micOverride & MIC_OVERRIDE_ACTIVE) {
+        packet[10] = static_cast<unsigned char>(micOverride >> 16);
+        packet[13] = static_cast<unsigned char>(micOverride >> 8);
+        packet[16] = static_cast<unsigned char>(micOverride);
+    }
+    
+    // Kalibrierung zuletzt, damit sie auch für den Mic-Override gilt. Die Kurve
+    // wirkt auf die sichtbaren Werte (bezogen auf die eingestellte Helligkeit),
+    // nicht auf die gegen abgesenkte Hardware-Helligkeit hochskalierten Bytes.
+    if (m_calibration) {
+        EnterCriticalSection(&m_lock);
+        int hardware = m_hardwareBrightness;
+        int user = m_currentBrightness;
+        LeaveCriticalSection(&m_lock);
+        m_calibration->apply(packet + 8, hardware, user);
+    }
 }
 
 bool RGBController::setColor(RGBColor color) {
@@ -322,6 +1098,10 @@ bool RGBController::setColor(RGBColor color) {
 bool RGBController::setZone(LEDZone zone, RGBColor color) {
     EnterCriticalSection(&m_lock);
     
+    // Sonst bliebe die neue Zone bei abgesenkter Hardware-Helligkeit zu dunkel
+    int previous = m_hardwareBrightness;
+    normalizeBrightnessLocked();
+    
     switch (zone) {
     case LEDZone::Logo:
         m_currentZones.logo = color;
@@ -340,9 +1120,20 @@ bool RGBController::setZone(LEDZone zone, RGBColor color) {
     }
     
     LEDZones zones = m_currentZones;
+    int hardware = m_hardwareBrightness;
     LeaveCriticalSection(&m_lock);
     
-    return sendColorsInternal(zones);
+    return sendFrameInternal(zones, true, hardware, previous);
+}
+
+// Abgesenkte Hardware-Helligkeit (Dithering, Blende): Zonen auf die eingestellte
+// Helligkeit umrechnen, sichtbar bleibt dasselbe (unter m_lock)
+void RGBController::normalizeBrightnessLocked() {
+    if (m_hardwareBrightness != m_currentBrightness && m_currentBrightness > 0) {
+        m_currentZones = userZonesLocked();
+        m_hardwareBrightness = m_currentBrightness;
+        m_ditherer->reset(m_currentBrightness);
+    }
 }
 
 bool RGBController::setLogoColor(RGBColor color) {
@@ -357,6 +1148,68 @@ bool RGBController::setMicColor(RGBColor color) {
     return setZone(LEDZone::Mic, color);
 }
 
+bool RGBController::setMicOverride(RGBColor color) {
+    // Wie applyNotification(): abgesenkte Hardware-Helligkeit (Blende, Dithering)
+    // würde die Mic-LED mit abdunkeln, bei pulse() bis auf 0
+    EnterCriticalSection(&m_sendLock);
+    m_micOverride.store(MIC_OVERRIDE_ACTIVE | (color.r << 16) | (color.g << 8) | color.b, std::memory_order_release);
+    
+    EnterCriticalSection(&m_lock);
+    int previous = m_hardwareBrightness;
+    normalizeBrightnessLocked();
+    LEDZones zones = m_currentZones;
+    int hardware = m_hardwareBrightness;
+    LeaveCriticalSection(&m_lock);
+    
+    bool ok = sendFrameInternal(zones, true, hardware, previous);
+    LeaveCriticalSection(&m_sendLock);
+    return ok;
+}
+
+bool RGBController::clearMicOverride() {
+    EnterCriticalSection(&m_sendLock);
+    m_micOverride.store(0, std::memory_order_release);
+    
+    EnterCriticalSection(&m_lock);
+    LEDZones zones = m_currentZones;
+    LeaveCriticalSection(&m_lock);
+    bool ok = sendColorsInternal(zones);
+    LeaveCriticalSection(&m_sendLock);
+    return ok;
+}
+
+// ============================================================================
+// Benachrichtigungen
+// ============================================================================
+
+bool RGBController::notify(const Notification& notification) {
+    return isConnected() && m_notifications->post(notification);
+}
+
+// Im Notification-Thread: neue Überlagerung (mask = 0 = Ende) sofort senden
+bool RGBController::applyNotification(uint8_t mask, const LEDZones& zones) {
+    // Maske, Normalisierung und Pakete unter m_sendLock: ein gleichzeitiger
+    // Effekt-Frame plant davor (und wird hier normalisiert) oder danach (und
+    // sieht die Maske) - er kann die Helligkeit nicht wieder absenken
+    EnterCriticalSection(&m_sendLock);
+    
+    // Abgesenkte Hardware-Helligkeit würde die Benachrichtigung mit abdunkeln
+    EnterCriticalSection(&m_lock);
+    int previous = m_hardwareBrightness;
+    if (mask) {
+        normalizeBrightnessLocked();
+    }
+    LEDZones base = m_currentZones;
+    int hardware = m_hardwareBrightness;
+    LeaveCriticalSection(&m_lock);
+    
+    m_notificationZones = zones;
+    m_notificationMask.store(mask, std::memory_order_release);
+    bool ok = sendFrameInternal(base, true, hardware, previous);
+    LeaveCriticalSection(&m_sendLock);
+    return ok;
+}
+
 // ============================================================================
 // Helligkeit (Brightness)
 // ============================================================================
@@ -376,6 +1229,8 @@ bool RGBController::setBrightnessRaw(int brightness) {
     
     EnterCriticalSection(&m_lock);
     m_currentBrightness = brightness;
+    m_hardwareBrightness = brightness;
+    m_ditherer->reset(brightness);
     LeaveCriticalSection(&m_lock);
     
     return sendBrightnessInternal(brightness);
@@ -404,7 +1259,7 @@ bool RGBController::sendBrightnessInternal(int brightness) {
     packet[5] = brightness & 0xFF;        // Low byte
     packet[6] = (brightness >> 8) & 0xFF; // High byte
     
-    return SendHIDReport(m_device, packet, 64);
+    return SendHIDReport(*m_transport, packet, 64);
 }
 
 int RGBController::getBrightness() const {
@@ -433,79 +1288,263 @@ bool RGBController::setHardwareMode() {
     packet[4] = 0x00;
     packet[5] = 0x01; // Hardware mode
     
-    bool result = SendHIDReport(m_device, packet, 64);
+    bool result = SendHIDReport(*m_transport, packet, 64);
     m_initialized = false;
     
-    Sleep(100);
+    m_clock->sleep(100);
     
     return result;
 }
 
 bool RGBController::rainbow(int durationMs, int stepMs) {
+    if (durationMs <= 0) {
+        return isConnected();
+    }
+    if (!startRainbow(durationMs, stepMs)) {
+        return false;
+    }
+    return waitEffect();
+}
+
+bool RGBController::pulse(RGBColor color, int cycles, int stepMs) {
+    if (cycles <= 0) {
+        return isConnected();
+    }
+    if (!startPulse(color, cycles, stepMs)) {
+        return false;
+    }
+    return waitEffect();
+}
+
+bool RGBController::startEffect(std::shared_ptr<Effect> effect, int frameIntervalMs) {
     if (!isConnected()) {
         return false;
     }
     
+    // Einmalige Initialisierung vorab, damit sie nicht in den ersten Frame fällt
+    if (!m_initialized && !initialize()) {
+        return false;
+    }
+    return m_animation->start(effect, frameIntervalMs);
+}
+
+bool RGBController::startRainbow(int durationMs, int stepMs) {
     std::cout << "[RGB] Starte Regenbogen-Animation..." << std::endl;
     
-    int steps = durationMs / stepMs;
-    for (int i = 0; i < steps; i++) {
-        float hue = (i * 360.0f) / steps;
-        
-        // HSV zu RGB
-        float r = 0, g = 0, b = 0;
-        if (hue < 60) { r = 255; g = (hue / 60) * 255; }
-        else if (hue < 120) { r = ((120 - hue) / 60) * 255; g = 255; }
-        else if (hue < 180) { g = 255; b = ((hue - 120) / 60) * 255; }
-        else if (hue < 240) { g = ((240 - hue) / 60) * 255; b = 255; }
-        else if (hue < 300) { b = 255; r = ((hue - 240) / 60) * 255; }
-        else { b = ((360 - hue) / 60) * 255; r = 255; }
+    // Ein Farbkreis über die ganze Dauer (wie bisher), endlos: 10s pro Umlauf
+    int periodMs = durationMs > 0 ? durationMs : 10000;
+    // Standard-Parameter aus vorberechneten Tabellen, sonst Laufzeit-Tabelle/Effekt
+    return startEffect(createRainbowEffect(periodMs, durationMs, stepMs), stepMs);
+}
+
+bool RGBController::startPulse(RGBColor color, int cycles, int stepMs) {
+    std::cout << "[RGB] Starte Puls-Animation..." << std::endl;
+    
+    // Bisherige Schleife: 18 Schritte Einblenden + 18 Schritte Ausblenden pro Zyklus.
+    // Nur reine Farbpakete nutzen die vorberechneten Tabellen, sonst plant der
+    // FadePlanner über den Pegel des PulseEffect
+    if (m_fadePlanner->getConfig().mode == FadeMode::Color) {
+        return startEffect(createPulseEffect(color, cycles, stepMs), stepMs);
+    }
+    int periodMs = static_cast<int>(frames::PULSE_FRAMES_PER_CYCLE) * (stepMs > 0 ? stepMs : 1);
+    return startEffect(std::make_shared<PulseEffect>(color, periodMs, cycles), stepMs);
+}
+
+void RGBController::stopEffect() {
+    m_animation->stop();
+}
+
+bool RGBController::isEffectRunning() const {
+    return m_animation->isRunning();
+}
+
+bool RGBController::waitEffect(DWORD timeoutMs) {
+    return m_animation->wait(timeoutMs);
+}
+
+bool RGBController::off() {
+    return setColor(RGBColor(0, 0, 0));
+}
+
+// ============================================================================
+// Geräte-Abfragen
+// ============================================================================
+
+bool RGBController::queryProperty(unsigned char property, unsigned char* response, size_t size, DWORD timeoutMs) {
+    if (!isConnected()) {
+        return false;
+    }
+    
+    const unsigned char headsetMode = m_isWireless ? 0x09 : 0x08;
+    
+    // Get-Kommando wie im SignalRGB-Plugin: [0x02][Mode][0x02][Property][0x00]
+    unsigned char packet[64] = {0};
+    packet[0] = 0x02;
+    packet[1] = headsetMode;
+    packet[2] = 0x02;
+    packet[3] = property;
+    packet[4] = 0x00;
+    
+    EnterCriticalSection(&m_queryLock);
+    
+    m_transport->flushInput();
+    bool ok = SendHIDReport(*m_transport, packet, 64);
+    
+    size_t bytesRead = 0;
+    if (ok) {
+        ok = m_transport->read(response, size, bytesRead, timeoutMs) == ReadResult::Ok && bytesRead >= 7;
+    }
+    
+    LeaveCriticalSection(&m_queryLock);
+    
+    if (!ok) {
+        std::cerr << "[RGB] Keine Antwort auf Abfrage 0x" << std::hex << (int)property << std::dec << std::endl;
+    }
+    return ok;
+}
+
+bool RGBController::queryBattery(BatteryStatus& status, DWORD timeoutMs) {
+    unsigned char levelData[65] = {0};
+    unsigned char stateData[65] = {0};
+    
+    if (!queryProperty(0x0F, levelData, sizeof(levelData), timeoutMs) ||
+        !queryProperty(0x10, stateData, sizeof(stateData), timeoutMs)) {
+        status = BatteryStatus();
+        return false;
+    }
+    
+    // Akku: Bytes 4-6 Little Endian (0-1000), Status: Byte 4
+    status.levelRaw = levelData[4] | (levelData[5] << 8) | (levelData[6] << 16);
+    status.level = status.levelRaw / 10;
+    status.state = stateData[4] <= 3 ? static_cast<ChargingState>(stateData[4]) : ChargingState::Unknown;
+    status.valid = true;
+    return true;
+}
+
+bool RGBController::queryMicStatus(bool& muted, DWORD timeoutMs) {
+    unsigned char data[65] = {0};
+    if (!queryProperty(0xA6, data, sizeof(data), timeoutMs)) {
+        return false;
+    }
+    
+    // Wie im SignalRGB-Plugin: steht der Property-Code an Index 3, ist die
+    // Antwort ungültig (Headset schläft o.ä.), sonst Index 4: 1=stumm
+    if (data[3] == 0xA6) {
+        return false;
+    }
+    muted = data[4] == 0x01;
+    return true;
+}
+
+bool RGBController::querySleepStatus(bool& sleeping, DWORD timeoutMs) {
+    unsigned char data[65] = {0};
+    if (!queryProperty(0x10, data, sizeof(data), timeoutMs)) {
+        return false;
+    }
+    
+    // SignalRGB-Plugin: Byte 0 == 2 bedeutet "Headset schläft"
+    sleeping = data[0] == 0x02;
+    return true;
+}
+
+// ============================================================================
+// Asynchrone Kommandos
+// ============================================================================
+
+bool RGBController::submitCommand(std::function<void()> command) {
+    if (!isConnected()) {
+        return false;
+    }
+    
+    EnterCriticalSection(&m_commandLock);
+    
+    if (!m_commandRunning) {
+        // Worker wird beim ersten asynchronen Kommando gestartet
+        m_commandEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        m_commandRunning = true;
+        m_commandThread = m_commandEvent ? CreateThread(nullptr, 0, CommandThreadProc, this, 0, nullptr) : nullptr;
         
-        setColor(RGBColor((unsigned char)r, (unsigned char)g, (unsigned char)b));
-        Sleep(stepMs);
+        if (!m_commandThread) {
+            std::cerr << "[RGB] Fehler beim Erstellen des Command-Threads!" << std::endl;
+            m_commandRunning = false;
+            if (m_commandEvent) {
+                CloseHandle(m_commandEvent);
+                m_commandEvent = nullptr;
+            }
+            LeaveCriticalSection(&m_commandLock);
+            return false;
+        }
     }
     
+    m_commandQueue.push_back(std::move(command));
+    SetEvent(m_commandEvent);
+    
+    LeaveCriticalSection(&m_commandLock);
     return true;
 }
 
-bool RGBController::pulse(RGBColor color, int cycles, int stepMs) {
-    if (!isConnected()) {
-        return false;
-    }
-    
-    std::cout << "[RGB] Starte Puls-Animation..." << std::endl;
-    
-    for (int c = 0; c < cycles; c++) {
-        // Fade in
-        for (int i = 0; i <= 255; i += 15) {
-            float factor = i / 255.0f;
-            RGBColor faded(
-                (unsigned char)(color.r * factor),
-                (unsigned char)(color.g * factor),
-                (unsigned char)(color.b * factor)
-            );
-            setColor(faded);
-            Sleep(stepMs);
-        }
+void RGBController::stopCommandThread() {
+    EnterCriticalSection(&m_commandLock);
+    if (!m_commandRunning) {
+        LeaveCriticalSection(&m_commandLock);
+        return;
+    }
+    m_commandRunning = false;
+    SetEvent(m_commandEvent);
+    LeaveCriticalSection(&m_commandLock);
+    
+    // Worker arbeitet die Queue noch ab, damit jede Completion genau einmal feuert
+    WaitForSingleObject(m_commandThread, INFINITE);
+    CloseHandle(m_commandThread);
+    CloseHandle(m_commandEvent);
+    m_commandThread = nullptr;
+    m_commandEvent = nullptr;
+}
+
+DWORD WINAPI RGBController::CommandThreadProc(LPVOID param) {
+    RGBController* controller = static_cast<RGBController*>(param);
+    controller->commandLoop();
+    return 0;
+}
+
+void RGBController::commandLoop() {
+    for (;;) {
+        WaitForSingleObject(m_commandEvent, INFINITE);
         
-        // Fade out
-        for (int i = 255; i >= 0; i -= 15) {
-            float factor = i / 255.0f;
-            RGBColor faded(
-                (unsigned char)(color.r * factor),
-                (unsigned char)(color.g * factor),
-                (unsigned char)(color.b * factor)
-            );
-            setColor(faded);
-            Sleep(stepMs);
+        for (;;) {
+            EnterCriticalSection(&m_commandLock);
+            if (m_commandQueue.empty()) {
+                bool running = m_commandRunning;
+                LeaveCriticalSection(&m_commandLock);
+                if (!running) {
+                    return;
+                }
+                break;
+            }
+            std::function<void()> command = std::move(m_commandQueue.front());
+            m_commandQueue.pop_front();
+            LeaveCriticalSection(&m_commandLock);
+            
+            command();
         }
     }
-    
-    return true;
 }
 
-bool RGBController::off() {
-    return setColor(RGBColor(0, 0, 0));
+bool RGBController::setColorsAsync(const LEDZones& zones, Executor& executor, CommandCompletion completion) {
+    Executor* ex = &executor;
+    return submitCommand([this, zones, ex, completion]() {
+        bool ok = setColors(zones);
+        ex->post([completion, ok]() { completion(ok); });
+    });
+}
+
+bool RGBController::queryBatteryAsync(Executor& executor, BatteryCompletion completion) {
+    Executor* ex = &executor;
+    return submitCommand([this, ex, completion]() {
+        BatteryStatus status;
+        bool ok = queryBattery(status);
+        ex->post([completion, ok, status]() { completion(ok, status); });
+    });
 }
 
 // ============================================================================
@@ -526,27 +1565,29 @@ bool RGBController::startKeepAlive(int intervalMs) {
     std::cout << "[RGB] Starte Keep-Alive Thread (Intervall: " << intervalMs << "ms)..." << std::endl;
     
     m_keepAliveRunning = true;
+    m_keepAliveIntervalMs = intervalMs;
     
     // Erstelle Keep-Alive Thread
     struct ThreadParams {
         RGBController* controller;
         int intervalMs;
+        std::shared_ptr<Clock> clock;
+        int ticket;
     };
     
-    ThreadParams* params = new ThreadParams{this, intervalMs};
+    ThreadParams* params = new ThreadParams{this, intervalMs, m_clock, m_clock->threadCreated()};
     
     m_keepAliveThread = CreateThread(nullptr, 0, 
         [](LPVOID param) -> DWORD {
             ThreadParams* p = static_cast<ThreadParams*>(param);
             RGBController* controller = p->controller;
-            int interval = p->intervalMs;
+            int64_t intervalNs = static_cast<int64_t>(p->intervalMs) * Clock::NS_PER_MS;
+            std::shared_ptr<Clock> clock = p->clock;
+            ClockThreadScope scope(*clock, p->ticket);
             delete p;
             
-            while (controller->m_keepAliveRunning) {
-                Sleep(interval);
-                
-                if (!controller->m_keepAliveRunning) break;
-                
+            // Endet nur über das Stop-Event, damit kein gesetztes Event den nächsten Start beendet
+            while (clock->waitUntil(clock->nowNs() + intervalNs, controller->m_keepAliveStopEvent)) {
                 // Sende aktuelle Farben erneut
                 EnterCriticalSection(&controller->m_lock);
                 LEDZones zones = controller->m_currentZones;
@@ -563,6 +1604,8 @@ bool RGBController::startKeepAlive(int intervalMs) {
     
     if (m_keepAliveThread == nullptr) {
         std::cerr << "[RGB] Fehler beim Erstellen des Keep-Alive Threads!" << std::endl;
+        m_clock->threadCancelled();
+        delete params;
         m_keepAliveRunning = false;
         return false;
     }
@@ -578,6 +1621,7 @@ void RGBController::stopKeepAlive() {
     
     std::cout << "[RGB] Stoppe Keep-Alive Thread..." << std::endl;
     m_keepAliveRunning = false;
+    m_clock->signal(m_keepAliveStopEvent);
     
     if (m_keepAliveThread != nullptr) {
         WaitForSingleObject(m_keepAliveThread, 10000); // Max 10 Sekunden warten
@@ -588,20 +1632,55 @@ void RGBController::stopKeepAlive() {
     std::cout << "[RGB] Keep-Alive gestoppt." << std::endl;
 }
 
+// ============================================================================
+// Zeitquelle
+// ============================================================================
+
+void RGBController::setClock(std::shared_ptr<Clock> clock) {
+    if (!clock || clock == m_clock) {
+        return;
+    }
+    
+    bool keepAlive = m_keepAliveRunning;
+    stopKeepAlive();
+    m_animation->setClock(clock);
+    m_notifications->setClock(clock);
+    m_clock = clock;
+    
+    if (keepAlive) {
+        startKeepAlive(m_keepAliveIntervalMs);
+    }
+}
+
 // ============================================================================
 // EventMonitor Implementation
 // ============================================================================
 
 EventMonitor::EventMonitor()
-    : m_device(INVALID_HANDLE_VALUE)
-    , m_readThread(nullptr)
-    , m_running(false) {
-    memset(&m_overlapped, 0, sizeof(m_overlapped));
+    : m_readThread(nullptr)
+    , m_running(false)
+    , m_inputBufferCount(DEFAULT_INPUT_BUFFERS)
+    , m_drainReports(true)
+    , m_statWakeups(0)
+    , m_statReports(0)
+    , m_statMaxBatch(0)
+    , m_acceptWaiters(false)
+    , m_statReceived(0)
+    , m_statDelivered(0)
+    , m_statDuplicates(0)
+    , m_statCoalesced(0) {
     memset(m_buffer, 0, sizeof(m_buffer));
+    m_readBatch.reserve(MAX_EVENT_BATCH);
+    m_deliverBatch.reserve(MAX_EVENT_BATCH + 3);
+    InitializeCriticalSection(&m_waiterLock);
+    InitializeCriticalSection(&m_filterLock);
+    resetFilterState();
 }
 
 EventMonitor::~EventMonitor() {
     disconnect();
+    DeleteCriticalSection(&m_filterLock);
+    DeleteCriticalSection(&m_waiterLock);
 }
 
 bool EventMonitor::connect(unsigned short vid, unsigned short pid) {
@@ -621,34 +1700,56 @@ bool EventMonitor::connect(unsigned short vid, unsigned short pid) {
     std::cout << "        Usage Page: 0x" << std::hex << eventDevice.usagePage
               << ", Usage: 0x" << eventDevice.usage << std::dec << std::endl;
     
-    m_device = OpenHIDDevice(eventDevice.path, true); // Mit OVERLAPPED für async Reading
-    if (m_device == INVALID_HANDLE_VALUE) {
+    m_transport = Win32HIDTransport::open(eventDevice.path); // Mit OVERLAPPED für async Reading
+    if (!m_transport) {
         std::cerr << "[EVENT] Fehler beim Oeffnen! Error: " << GetLastError() << std::endl;
         return false;
     }
     
-    m_overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
-    if (!m_overlapped.hEvent) {
-        CloseHandle(m_device);
-        m_device = INVALID_HANDLE_VALUE;
-        return false;
+    // Größerer Treiberpuffer, damit Bursts (z.B. Mute + Battery + Charging beim Aufwachen) nicht überlaufen
+    if (!m_transport->setInputBufferCount(m_inputBufferCount)) {
+        std::cerr << "[EVENT] Input-Puffer konnte nicht vergroessert werden!" << std::endl;
     }
     
     std::cout << "[EVENT] Verbunden!" << std::endl;
     return true;
 }
 
-void EventMonitor::disconnect() {
-    stopMonitoring();
+bool EventMonitor::connect(std::shared_ptr<HIDTransport> transport) {
+    if (isConnected()) {
+        disconnect();
+    }
+    if (!transport) {
+        return false;
+    }
     
-    if (m_overlapped.hEvent) {
-        CloseHandle(m_overlapped.hEvent);
-        m_overlapped.hEvent = nullptr;
+    m_transport = transport;
+    m_transport->setInputBufferCount(m_inputBufferCount);
+    return true;
+}
+
+bool EventMonitor::setReflex(EventReflex reflex) {
+    if (m_running) {
+        return false;
+    }
+    m_reflex = reflex;
+    return true;
+}
+
+bool EventMonitor::setInputBufferCount(unsigned long count) {
+    m_inputBufferCount = count;
+    if (isConnected()) {
+        return m_transport->setInputBufferCount(count);
     }
+    return true;
+}
+
+void EventMonitor::disconnect() {
+    stopMonitoring();
+    cancelWaiters();
     
     if (isConnected()) {
-        CloseHandle(m_device);
-        m_device = INVALID_HANDLE_VALUE;
+        m_transport.reset();
         std::cout << "[EVENT] Getrennt." << std::endl;
     }
 }
@@ -665,11 +1766,38 @@ bool EventMonitor::startMonitoring(EventCallback callback) {
     }
     
     m_callback = callback;
+    m_batchCallback = nullptr;
+    return startReadThread();
+}
+
+bool EventMonitor::startBatchMonitoring(EventBatchCallback callback) {
+    if (!isConnected()) {
+        std::cerr << "[EVENT] Nicht verbunden!" << std::endl;
+        return false;
+    }
+    
+    if (m_running) {
+        std::cerr << "[EVENT] Monitoring laeuft bereits!" << std::endl;
+        return false;
+    }
+    
+    m_callback = nullptr;
+    m_batchCallback = callback;
+    return startReadThread();
+}
+
+bool EventMonitor::startReadThread() {
     m_running = true;
+    resetFilterState();
+    
+    EnterCriticalSection(&m_waiterLock);
+    m_acceptWaiters = true;
+    LeaveCriticalSection(&m_waiterLock);
     
     m_readThread = CreateThread(nullptr, 0, ReadThreadProc, this, 0, nullptr);
     if (!m_readThread) {
         m_running = false;
+        cancelWaiters();
         return false;
     }
     
@@ -687,6 +1815,7 @@ void EventMonitor::stopMonitoring() {
             m_readThread = nullptr;
         }
         
+        cancelWaiters();
         std::cout << "[EVENT] Monitoring gestoppt." << std::endl;
     }
 }
@@ -701,49 +1830,343 @@ void EventMonitor::readLoop() {
     std::cout << "[EVENT] Read-Loop gestartet..." << std::endl;
     
     while (m_running) {
-        ResetEvent(m_overlapped.hEvent);
+        size_t bytesRead = 0;
+        DWORD timeout = nextFilterTimeout(std::chrono::steady_clock::now());
+        ReadResult result = m_transport->read(m_buffer, sizeof(m_buffer), bytesRead, timeout);
+        auto readComplete = std::chrono::steady_clock::now();
         
-        DWORD bytesRead = 0;
-        BOOL result = ReadFile(m_device, m_buffer, sizeof(m_buffer), &bytesRead, &m_overlapped);
+        if (result == ReadResult::Error) {
+            break;
+        }
         
-        if (!result && GetLastError() == ERROR_IO_PENDING) {
-            DWORD waitResult = WaitForSingleObject(m_overlapped.hEvent, 1000);
-            
-            if (waitResult == WAIT_OBJECT_0) {
-                if (GetOverlappedResult(m_device, &m_overlapped, &bytesRead, FALSE)) {
-                    result = TRUE;
+        // Alle bereits im Treiber gepufferten Reports in einem Durchgang abholen
+        m_readBatch.clear();
+        while (result == ReadResult::Ok) {
+            if (bytesRead > 0) {
+                HeadsetEvent event;
+                event.type = static_cast<EventType>(m_buffer[0]);
+                event.dataSize = bytesRead;
+                memcpy(event.data, m_buffer, bytesRead);
+                event.timestamp = readComplete;
+                m_readBatch.push_back(event);
+                
+                // Sofort, nicht erst nach dem Abholen der übrigen Reports
+                if (m_reflex) {
+                    m_reflex(event);
                 }
-            } else if (waitResult == WAIT_TIMEOUT) {
-                CancelIo(m_device);
-                continue;
-            } else {
+            }
+            
+            if (!m_drainReports || m_readBatch.size() >= MAX_EVENT_BATCH) {
                 break;
             }
+            result = m_transport->read(m_buffer, sizeof(m_buffer), bytesRead, 0);
+            readComplete = std::chrono::steady_clock::now();
         }
         
-        if (result && bytesRead > 0 && m_callback) {
-            HeadsetEvent event;
-            event.type = static_cast<EventType>(m_buffer[0]);
-            event.dataSize = bytesRead;
-            memcpy(event.data, m_buffer, bytesRead);
-            
-            m_callback(event);
+        if (!m_readBatch.empty()) {
+            uint64_t batchSize = m_readBatch.size();
+            m_statWakeups.fetch_add(1, std::memory_order_relaxed);
+            m_statReports.fetch_add(batchSize, std::memory_order_relaxed);
+            if (batchSize > m_statMaxBatch.load(std::memory_order_relaxed)) {
+                m_statMaxBatch.store(batchSize, std::memory_order_relaxed);
+            }
+        }
+        
+        EnterCriticalSection(&m_filterLock);
+        EventFilterConfig config = m_filterConfig;
+        LeaveCriticalSection(&m_filterLock);
+        
+        for (const HeadsetEvent& event : m_readBatch) {
+            m_state.applyEvent(event);
+            processEvent(event, config);
+        }
+        flushCoalesced(std::chrono::steady_clock::now(), config);
+        
+        dispatchBatch();
+        
+        if (result == ReadResult::Error) {
+            break;
         }
     }
     
+    // Auch bei Lesefehler: niemand liefert mehr Events an wartende Coroutines
+    cancelWaiters();
     std::cout << "[EVENT] Read-Loop beendet." << std::endl;
 }
 
+void EventMonitor::dispatchBatch() {
+    if (m_deliverBatch.empty()) {
+        return;
+    }
+    
+    auto dispatch = std::chrono::steady_clock::now();
+    
+    if (m_batchCallback) {
+        m_batchCallback(m_deliverBatch.data(), m_deliverBatch.size());
+        auto handlerReturn = std::chrono::steady_clock::now();
+        
+        for (const HeadsetEvent& event : m_deliverBatch) {
+            m_readToDispatch.record(dispatch - event.timestamp);
+            m_dispatchToReturn.record(handlerReturn - dispatch);
+            m_readToReturn.record(handlerReturn - event.timestamp);
+        }
+    } else if (m_callback) {
+        for (const HeadsetEvent& event : m_deliverBatch) {
+            dispatch = std::chrono::steady_clock::now();
+            m_callback(event);
+            auto handlerReturn = std::chrono::steady_clock::now();
+            
+            m_readToDispatch.record(dispatch - event.timestamp);
+            m_dispatchToReturn.record(handlerReturn - dispatch);
+            m_readToReturn.record(handlerReturn - event.timestamp);
+        }
+    }
+    
+    for (const HeadsetEvent& event : m_deliverBatch) {
+        dispatchWaiters(event);
+    }
+    m_deliverBatch.clear();
+}
+
+// Slot-Index und Zustandswert eines Status-Events (-1 = kein Status-Event)
+static int FilterSlotIndex(const HeadsetEvent& event, int& value) {
+    switch (event.getActualEventType()) {
+    case EventType::Mute:
+        if (event.dataSize >= 6) { value = event.data[5]; return 0; }
+        break;
+    case EventType::Battery:
+        if (event.dataSize >= 7) { value = event.getBatteryLevelRaw(); return 1; }
+        break;
+    case EventType::Charging:
+        if (event.dataSize >= 6) { value = event.data[5]; return 2; }
+        break;
+    default:
+        break;
+    }
+    return -1;
+}
+
+void EventMonitor::processEvent(const HeadsetEvent& event, const EventFilterConfig& config) {
+    m_statReceived.fetch_add(1, std::memory_order_relaxed);
+    
+    int value = 0;
+    int index = FilterSlotIndex(event, value);
+    if (index < 0) {
+        queueDelivery(event);
+        return;
+    }
+    
+    FilterSlot& slot = m_filterSlots[index];
+    
+    // Mute wird nie verzögert, nur Battery/Charging werden zusammengefasst
+    bool coalesce = config.coalesceWindowMs > 0 && index != 0;
+    if (coalesce && slot.pending) {
+        m_statCoalesced.fetch_add(1, std::memory_order_relaxed);
+        slot.pendingEvent = event;
+        return;
+    }
+    if (coalesce && event.timestamp < slot.windowEnd) {
+        slot.pending = true;
+        slot.pendingEvent = event;
+        return;
+    }
+    
+    if (config.changeOnly && slot.known && slot.lastValue == value) {
+        m_statDuplicates.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    slot.known = true;
+    slot.lastValue = value;
+    if (coalesce) {
+        // Führende Flanke sofort, weitere Events bis Fensterende zurückhalten
+        slot.windowEnd = event.timestamp + std::chrono::milliseconds(config.coalesceWindowMs);
+    }
+    queueDelivery(event);
+}
+
+void EventMonitor::flushCoalesced(std::chrono::steady_clock::time_point now, const EventFilterConfig& config) {
+    for (int i = 0; i < 3; i++) {
+        FilterSlot& slot = m_filterSlots[i];
+        if (!slot.pending || now < slot.windowEnd) {
+            continue;
+        }
+        
+        slot.pending = false;
+        int value = 0;
+        FilterSlotIndex(slot.pendingEvent, value);
+        
+        if (config.changeOnly && slot.known && slot.lastValue == value) {
+            m_statDuplicates.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        
+        // Nachlaufende Flanke: letzter Wert des Bursts, neues Fenster beginnt
+        slot.known = true;
+        slot.lastValue = value;
+        slot.windowEnd = now + std::chrono::milliseconds(config.coalesceWindowMs);
+        queueDelivery(slot.pendingEvent);
+    }
+}
+
+DWORD EventMonitor::nextFilterTimeout(std::chrono::steady_clock::time_point now) const {
+    DWORD timeout = 1000;
+    for (int i = 0; i < 3; i++) {
+        if (!m_filterSlots[i].pending) {
+            continue;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            m_filterSlots[i].windowEnd - now).count() + 1;
+        if (remaining < 0) remaining = 0;
+        if (static_cast<DWORD>(remaining) < timeout) {
+            timeout = static_cast<DWORD>(remaining);
+        }
+    }
+    return timeout;
+}
+
+void EventMonitor::queueDelivery(const HeadsetEvent& event) {
+    m_statDelivered.fetch_add(1, std::memory_order_relaxed);
+    m_deliverBatch.push_back(event);
+}
+
+void EventMonitor::resetFilterState() {
+    for (int i = 0; i < 3; i++) {
+        m_filterSlots[i].known = false;
+        m_filterSlots[i].lastValue = 0;
+        m_filterSlots[i].pending = false;
+        m_filterSlots[i].windowEnd = std::chrono::steady_clock::time_point();
+    }
+}
+
+void EventMonitor::setEventFilter(const EventFilterConfig& config) {
+    EnterCriticalSection(&m_filterLock);
+    m_filterConfig = config;
+    LeaveCriticalSection(&m_filterLock);
+}
+
+EventFilterConfig EventMonitor::getEventFilter() const {
+    EnterCriticalSection(&m_filterLock);
+    EventFilterConfig config = m_filterConfig;
+    LeaveCriticalSection(&m_filterLock);
+    return config;
+}
+
+EventReadStats EventMonitor::getReadStats() const {
+    EventReadStats stats;
+    stats.wakeups = m_statWakeups.load(std::memory_order_relaxed);
+    stats.reports = m_statReports.load(std::memory_order_relaxed);
+    stats.maxBatch = m_statMaxBatch.load(std::memory_order_relaxed);
+    stats.inputBuffers = m_inputBufferCount;
+    return stats;
+}
+
+EventFilterStats EventMonitor::getFilterStats() const {
+    EventFilterStats stats;
+    stats.received = m_statReceived.load(std::memory_order_relaxed);
+    stats.delivered = m_statDelivered.load(std::memory_order_relaxed);
+    stats.suppressedDuplicates = m_statDuplicates.load(std::memory_order_relaxed);
+    stats.coalesced = m_statCoalesced.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool EventMonitor::nextEventAsync(EventType type, Executor& executor, EventCompletion completion) {
+    EventWaiter waiter;
+    waiter.type = type;
+    waiter.executor = &executor;
+    waiter.completion = std::move(completion);
+    
+    // Prüfung und Einreihen unter derselben Sperre wie cancelWaiters(): ein
+    // Warter kann nicht nach dem letzten Abbruch liegen bleiben
+    EnterCriticalSection(&m_waiterLock);
+    bool accepted = m_acceptWaiters;
+    if (accepted) {
+        m_waiters.push_back(std::move(waiter));
+    }
+    LeaveCriticalSection(&m_waiterLock);
+    
+    if (!accepted) {
+        std::cerr << "[EVENT] nextEventAsync: Monitoring laeuft nicht!" << std::endl;
+    }
+    return accepted;
+}
+
+void EventMonitor::dispatchWaiters(const HeadsetEvent& event) {
+    EventType actualType = event.getActualEventType();
+    std::vector<EventWaiter> ready;
+    
+    EnterCriticalSection(&m_waiterLock);
+    for (size_t i = 0; i < m_waiters.size(); ) {
+        if (m_waiters[i].type == EventType::Unknown || m_waiters[i].type == actualType) {
+            ready.push_back(std::move(m_waiters[i]));
+            m_waiters[i] = std::move(m_waiters.back());
+            m_waiters.pop_back();
+        } else {
+            i++;
+        }
+    }
+    LeaveCriticalSection(&m_waiterLock);
+    
+    for (auto& waiter : ready) {
+        EventCompletion completion = std::move(waiter.completion);
+        waiter.executor->post([completion, event]() { completion(true, event); });
+    }
+}
+
+EventLatencyStats EventMonitor::getLatencyStats() const {
+    EventLatencyStats stats;
+    stats.readToDispatch = m_readToDispatch.snapshot();
+    stats.dispatchToReturn = m_dispatchToReturn.snapshot();
+    stats.readToReturn = m_readToReturn.snapshot();
+    return stats;
+}
+
+void EventMonitor::resetLatencyStats() {
+    m_readToDispatch.reset();
+    m_dispatchToReturn.reset();
+    m_readToReturn.reset();
+}
+
+void EventMonitor::cancelWaiters() {
+    std::vector<EventWaiter> cancelled;
+    
+    EnterCriticalSection(&m_waiterLock);
+    m_acceptWaiters = false;
+    cancelled.swap(m_waiters);
+    LeaveCriticalSection(&m_waiterLock);
+    
+    HeadsetEvent empty;
+    empty.type = EventType::Unknown;
+    empty.dataSize = 0;
+    memset(empty.data, 0, sizeof(empty.data));
+    
+    for (auto& waiter : cancelled) {
+        EventCompletion completion = std::move(waiter.completion);
+        waiter.executor->post([completion, empty]() { completion(false, empty); });
+    }
+}
+
 // ============================================================================
 // HeadsetManager Implementation
 // ============================================================================
 
 HeadsetManager::HeadsetManager()
-    : m_autoReconnect(false) {
+    : m_autoReconnect(false)
+    , m_refreshThread(nullptr)
+    , m_refreshStopEvent(nullptr)
+    , m_refreshTtlMs(60000)
+    , m_clock(systemClock())
+    , m_refreshClockTicket(0)
+    , m_reflexMuted(-1)
+    , m_reflexTriggered(0)
+    , m_reflexErrors(0) {
+    InitializeCriticalSection(&m_reflexLock);
+    m_events.setReflex([this](const HeadsetEvent& event) { onReflexEvent(event); });
 }
 
 HeadsetManager::~HeadsetManager() {
     disconnect();
+    DeleteCriticalSection(&m_reflexLock);
 }
 
 bool HeadsetManager::connect(bool autoReconnect) {
@@ -766,6 +2189,7 @@ bool HeadsetManager::connect(bool autoReconnect) {
 }
 
 void HeadsetManager::disconnect() {
+    stopStateRefresh();
     m_events.stopMonitoring();
     m_events.disconnect();
     m_rgb.disconnect();
@@ -775,18 +2199,29 @@ bool HeadsetManager::isConnected() const {
     return m_rgb.isConnected() && m_events.isConnected();
 }
 
+// Feste Farben beenden einen laufenden Effekt (sonst überschreibt ihn der nächste Frame)
 bool HeadsetManager::setLEDs(RGBColor color) {
+    endEffect();
     return m_rgb.setColor(color);
 }
 
 bool HeadsetManager::setLEDs(const LEDZones& zones) {
+    endEffect();
     return m_rgb.setColors(zones);
 }
 
 bool HeadsetManager::setZone(LEDZone zone, RGBColor color) {
+    endEffect();
     return m_rgb.setZone(zone, color);
 }
 
+void HeadsetManager::endEffect() {
+    if (m_rgb.isEffectRunning()) {
+        m_rgb.stopEffect();
+    }
+    m_rgb.waitEffect();  // Höchstens ein laufender Frame
+}
+
 bool HeadsetManager::setBrightness(int percent) {
     return m_rgb.setBrightness(percent);
 }
@@ -795,4 +2230,227 @@ bool HeadsetManager::startEventMonitoring(EventCallback callback) {
     return m_events.startMonitoring(callback);
 }
 
+// ============================================================================
+// Mute-Reflex
+// ============================================================================
+
+void HeadsetManager::setMuteReflex(const MuteReflexConfig& config) {
+    EnterCriticalSection(&m_reflexLock);
+    bool wasEnabled = m_reflexConfig.enabled;
+    m_reflexConfig = config;
+    m_reflexMuted = -1;     // Nächstes Mute-Event neu anzeigen
+    LeaveCriticalSection(&m_reflexLock);
+    
+    if (wasEnabled && !config.enabled) {
+        m_rgb.clearMicOverride();
+    }
+}
+
+MuteReflexConfig HeadsetManager::getMuteReflex() const {
+    EnterCriticalSection(&m_reflexLock);
+    MuteReflexConfig config = m_reflexConfig;
+    LeaveCriticalSection(&m_reflexLock);
+    return config;
+}
+
+MuteReflexStats HeadsetManager::getMuteReflexStats() const {
+    MuteReflexStats stats;
+    stats.triggered = m_reflexTriggered.load(std::memory_order_relaxed);
+    stats.sendErrors = m_reflexErrors.load(std::memory_order_relaxed);
+    stats.eventToPacket = m_reflexLatency.snapshot();
+    return stats;
+}
+
+void HeadsetManager::resetMuteReflexStats() {
+    m_reflexTriggered = 0;
+    m_reflexErrors = 0;
+    m_reflexLatency.reset();
+}
+
+// Im Read-Thread: Mic-Zone direkt setzen (Override gilt auch für laufende Effekte)
+void HeadsetManager::onReflexEvent(const HeadsetEvent& event) {
+    if (event.getActualEventType() != EventType::Mute || event.dataSize < 6) {
+        return;
+    }
+    
+    EnterCriticalSection(&m_reflexLock);
+    MuteReflexConfig config = m_reflexConfig;
+    int muted = event.isMuted() ? 1 : 0;
+    int previous = m_reflexMuted;
+    bool changed = muted != previous;
+    if (config.enabled) {
+        m_reflexMuted = muted;
+    }
+    LeaveCriticalSection(&m_reflexLock);
+    
+    // Wiederholte Reports mit gleichem Zustand nicht erneut senden
+    if (!config.enabled || !changed) {
+        return;
+    }
+    
+    bool ok;
+    if (muted) {
+        ok = m_rgb.setMicOverride(config.mutedColor);
+    } else if (config.showUnmuted) {
+        ok = m_rgb.setMicOverride(config.unmutedColor);
+    } else {
+        ok = m_rgb.clearMicOverride();
+    }
+    
+    m_reflexLatency.record(std::chrono::steady_clock::now() - event.timestamp);
+    m_reflexTriggered.fetch_add(1, std::memory_order_relaxed);
+    if (!ok) {
+        m_reflexErrors.fetch_add(1, std::memory_order_relaxed);
+        
+        // Nicht angezeigt: der nächste Report mit gleichem Zustand versucht es erneut
+        // (außer setMuteReflex() hat den Zustand inzwischen zurückgesetzt)
+        EnterCriticalSection(&m_reflexLock);
+        if (m_reflexMuted == muted) {
+            m_reflexMuted = previous;
+        }
+        LeaveCriticalSection(&m_reflexLock);
+    }
+}
+
+bool HeadsetManager::nextEventAsync(EventType type, Executor& executor, EventCompletion completion) {
+    return m_events.nextEventAsync(type, executor, std::move(completion));
+}
+
+bool HeadsetManager::setColorsAsync(const LEDZones& zones, Executor& executor, CommandCompletion completion) {
+    return m_rgb.setColorsAsync(zones, executor, std::move(completion));
+}
+
+bool HeadsetManager::queryBatteryAsync(Executor& executor, BatteryCompletion completion) {
+    HeadsetStateCache* cache = &m_events.stateCache();
+    return m_rgb.queryBatteryAsync(executor, [cache, completion](bool ok, const BatteryStatus& status) {
+        if (ok) {
+            cache->applyBattery(status);
+        }
+        completion(ok, status);
+    });
+}
+
+// ============================================================================
+// Zustands-Aktualisierung (TTL)
+// ============================================================================
+
+bool HeadsetManager::refreshState() {
+    if (!m_rgb.isConnected()) {
+        return false;
+    }
+    
+    HeadsetStateCache& cache = m_events.stateCache();
+    
+    bool sleeping = false;
+    if (m_rgb.querySleepStatus(sleeping)) {
+        cache.applySleeping(sleeping);
+        if (sleeping) {
+            // Schlafendes Headset beantwortet keine weiteren Abfragen
+            return true;
+        }
+    }
+    
+    bool ok = true;
+    BatteryStatus battery;
+    if (m_rgb.queryBattery(battery)) {
+        cache.applyBattery(battery);
+    } else {
+        ok = false;
+    }
+    
+    bool muted = false;
+    if (m_rgb.queryMicStatus(muted)) {
+        cache.applyMuted(muted);
+    } else {
+        ok = false;
+    }
+    
+    return ok;
+}
+
+bool HeadsetManager::startStateRefresh(DWORD ttlMs) {
+    if (m_refreshThread) {
+        return true;
+    }
+    
+    m_refreshTtlMs = ttlMs > 0 ? ttlMs : 1;
+    m_refreshStopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    if (!m_refreshStopEvent) {
+        return false;
+    }
+    
+    m_refreshClockTicket = m_clock->threadCreated();
+    m_refreshThread = CreateThread(nullptr, 0, RefreshThreadProc, this, 0, nullptr);
+    if (!m_refreshThread) {
+        m_clock->threadCancelled();
+        CloseHandle(m_refreshStopEvent);
+        m_refreshStopEvent = nullptr;
+        return false;
+    }
+    
+    std::cout << "[STATE] Hintergrund-Aktualisierung gestartet (TTL: " << m_refreshTtlMs << "ms)" << std::endl;
+    return true;
+}
+
+void HeadsetManager::stopStateRefresh() {
+    if (!m_refreshThread) {
+        return;
+    }
+    
+    // Ohne Timeout: der Thread benutzt das Stop-Event bis zuletzt (refreshState, waitUntil)
+    m_clock->signal(m_refreshStopEvent);
+    WaitForSingleObject(m_refreshThread, INFINITE);
+    CloseHandle(m_refreshThread);
+    CloseHandle(m_refreshStopEvent);
+    m_refreshThread = nullptr;
+    m_refreshStopEvent = nullptr;
+}
+
+DWORD WINAPI HeadsetManager::RefreshThreadProc(LPVOID param) {
+    HeadsetManager* manager = static_cast<HeadsetManager*>(param);
+    ClockThreadScope scope(*manager->m_clock, manager->m_refreshClockTicket);
+    manager->refreshLoop();
+    return 0;
+}
+
+void HeadsetManager::refreshLoop() {
+    int64_t ttlNs = static_cast<int64_t>(m_refreshTtlMs) * Clock::NS_PER_MS;
+    for (;;) {
+        // Schlafen, bis der Zustand veraltet ist (Events verschieben den Zeitpunkt)
+        HeadsetState state = m_events.getState();
+        int64_t deadline = m_clock->nowNs();
+        if (state.hasData()) {
+            int64_t updateNs = std::chrono::duration_cast<std::chrono::nanoseconds>(state.lastUpdate.time_since_epoch()).count();
+            deadline = std::max(deadline, updateNs + ttlNs);
+        }
+        
+        if (!m_clock->waitUntil(deadline, m_refreshStopEvent)) {
+            break;
+        }
+        
+        if (m_events.stateCache().isStale(m_refreshTtlMs) && !refreshState()) {
+            // Bei Fehlern nicht im Kreis abfragen
+            if (!m_clock->waitUntil(m_clock->nowNs() + ttlNs, m_refreshStopEvent)) {
+                break;
+            }
+        }
+    }
+}
+
+void HeadsetManager::setClock(std::shared_ptr<Clock> clock) {
+    if (!clock || clock == m_clock) {
+        return;
+    }
+    
+    bool refresh = m_refreshThread != nullptr;
+    stopStateRefresh();
+    m_rgb.setClock(clock);
+    m_events.stateCache().setClock(clock.get());
+    m_clock = clock;
+    
+    if (refresh) {
+        startStateRefresh(m_refreshTtlMs);
+    }
+}
+
 } // namespace HS80
@@ -6,6 +6,11 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <deque>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <cstdio>
 
 // ============================================================================
@@ -15,6 +20,7 @@
 namespace HS80 {
 
 // Konstanten
+constexpr const char* LIBRARY_VERSION = "1.0";      // Teil jedes Effekt-Cache-Schlüssels
 constexpr unsigned short CORSAIR_VID = 0x1B1C;
 constexpr unsigned short HS80_WIRELESS_PID = 0x0A6B;
 
@@ -23,6 +29,10 @@ constexpr unsigned short RGB_USAGE_PAGE = 0xFF42;
 constexpr unsigned short RGB_USAGE = 0x0001;        // Interface 6
 constexpr unsigned short EVENT_USAGE = 0x0002;      // Interface 7
 
+// Event-Lesepfad
+constexpr unsigned long DEFAULT_INPUT_BUFFERS = 128; // HID-Treiberpuffer (Windows-Standard: 32, max. 512)
+constexpr size_t MAX_EVENT_BATCH = 64;               // Max. Reports pro Wakeup
+
 // RGB-Struktur
 struct RGBColor {
     unsigned char r, g, b;
@@ -41,6 +51,18 @@ struct LEDZones {
     LEDZones(RGBColor all) : logo(all), power(all), mic(all) {}
 };
 
+// LED-Zonen mit Nachkommastellen (Q8.8: 256 = eine 8-Bit-Stufe, 65280 = 255),
+// Reihenfolge wie LEDZones. Wird per Dithering ausgegeben (HS80_Dither.h).
+struct HighResZones {
+    uint16_t channel[9];
+    
+    HighResZones() : channel{} {}
+    explicit HighResZones(const LEDZones& zones)
+        : channel{ static_cast<uint16_t>(zones.logo.r << 8), static_cast<uint16_t>(zones.logo.g << 8), static_cast<uint16_t>(zones.logo.b << 8),
+                   static_cast<uint16_t>(zones.power.r << 8), static_cast<uint16_t>(zones.power.g << 8), static_cast<uint16_t>(zones.power.b << 8),
+                   static_cast<uint16_t>(zones.mic.r << 8), static_cast<uint16_t>(zones.mic.g << 8), static_cast<uint16_t>(zones.mic.b << 8) } {}
+};
+
 // Einzelne LED-Zonen (für gezielte Updates)
 enum class LEDZone {
     Logo = 0,
@@ -63,6 +85,7 @@ struct HeadsetEvent {
     EventType type;
     unsigned char data[64];
     size_t dataSize;
+    std::chrono::steady_clock::time_point timestamp;  // Zeitpunkt, an dem der Read abgeschlossen war
     
     // Event-Analyse (HS80 Format: [0x03][0x01][0x01][EventCode][Data...])
     EventType getActualEventType() const {
@@ -157,27 +180,325 @@ private:
 
 // Event-Callback
 using EventCallback = std::function<void(const HeadsetEvent&)>;
+using EventBatchCallback = std::function<void(const HeadsetEvent* events, size_t count)>;
+using EventReflex = std::function<void(const HeadsetEvent& event)>;
+
+// Lade-Status (wie im SignalRGB-Plugin: 1=Laedt, 2=Entlaedt, 3=Voll)
+enum class ChargingState {
+    Unknown = 0,
+    Charging = 1,
+    Discharging = 2,
+    FullyCharged = 3
+};
+
+// Ergebnis einer Akku-Abfrage (Get-Kommandos 0x0F / 0x10)
+struct BatteryStatus {
+    bool valid;
+    int level;          // 0-100%
+    int levelRaw;       // 0-1000
+    ChargingState state;
+    
+    BatteryStatus() : valid(false), level(-1), levelRaw(-1), state(ChargingState::Unknown) {}
+};
+
+// ============================================================================
+// Headset-Zustand (aus Events gespeist, ohne Geräte-Roundtrip lesbar)
+// ============================================================================
+struct HeadsetState {
+    int muted;                  // 1=stumm, 0=aktiv, -1=unbekannt
+    int batteryLevel;           // 0-100%, -1=unbekannt
+    int batteryLevelRaw;        // 0-1000, -1=unbekannt
+    ChargingState charging;
+    int sleeping;               // 1=schläft, 0=wach, -1=unbekannt
+    std::chrono::steady_clock::time_point lastUpdate;  // Default-Wert = noch nie aktualisiert
+    
+    bool hasData() const { return lastUpdate != std::chrono::steady_clock::time_point(); }
+};
+
+// Zeitquelle (HS80_Clock.h)
+class Clock;
+
+// Wait-free Zustands-Cache: der gesamte Zustand ist in ein 64-Bit-Wort gepackt,
+// Lesen ist ein einzelner atomarer Load (Nanosekunden, aus jedem Thread).
+class HeadsetStateCache {
+private:
+    // Bits 0-1 Mute, 2-3 Charging, 4-5 Sleeping, 6-16 Akku raw (2047=unbekannt),
+    // 17-63 Zeitpunkt der letzten Aktualisierung in ms (Clock, Standard steady_clock)
+    std::atomic<uint64_t> m_packed;
+    std::atomic<Clock*> m_clock;
+    
+    static uint64_t pack(const HeadsetState& state);
+    static HeadsetState unpack(uint64_t packed);
+    
+    template <typename Modifier>
+    void modify(Modifier modifier);
+
+public:
+    HeadsetStateCache();
+    
+    HeadsetState snapshot() const { return unpack(m_packed.load(std::memory_order_acquire)); }
+    bool isStale(DWORD ttlMs) const;
+    
+    // Zeitquelle für lastUpdate; muss den Cache überleben (HeadsetManager::setClock)
+    void setClock(Clock* clock);
+    Clock& clock() const { return *m_clock.load(std::memory_order_acquire); }
+    
+    // Schreiber (Read-Thread, Refresh-Thread)
+    void applyEvent(const HeadsetEvent& event);
+    void applyBattery(const BatteryStatus& status);
+    void applyMuted(bool muted);
+    void applySleeping(bool sleeping);
+    void reset();
+};
+
+// Completion-Handler für asynchrone Operationen (ok=false bei Abbruch/Fehler)
+using EventCompletion = std::function<void(bool ok, const HeadsetEvent& event)>;
+using CommandCompletion = std::function<void(bool ok)>;
+using BatteryCompletion = std::function<void(bool ok, const BatteryStatus& status)>;
+
+// ============================================================================
+// Latenz-Histogramm (HDR-Stil: log-lineare Buckets, ~3% Auflösung)
+// ============================================================================
+struct LatencySnapshot {
+    uint64_t count;
+    double minUs;
+    double meanUs;
+    double p50Us;
+    double p90Us;
+    double p99Us;
+    double p999Us;
+    double maxUs;
+};
+
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;                          // 32 Sub-Buckets pro Zweierpotenz
+    static constexpr int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static constexpr int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+private:
+    std::atomic<uint64_t> m_buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_min;
+    std::atomic<uint64_t> m_max;
+    
+    static int bucketIndex(uint64_t value);
+    static uint64_t bucketMidpoint(int index);
+
+public:
+    LatencyHistogram();
+    
+    // Lock-free, aus jedem Thread aufrufbar
+    void record(uint64_t nanoseconds);
+    void record(std::chrono::steady_clock::duration duration);
+    void reset();
+    
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    uint64_t percentile(double percent) const;  // in ns, percent 0-100
+    LatencySnapshot snapshot() const;
+};
+
+// Latenzen vom abgeschlossenen Read bis zur Rückkehr des Event-Handlers
+struct EventLatencyStats {
+    LatencySnapshot readToDispatch;    // Read fertig → Callback-Aufruf
+    LatencySnapshot dispatchToReturn;  // Callback-Aufruf → Callback zurück
+    LatencySnapshot readToReturn;      // Gesamt
+};
+
+// Zustandsfilter für Status-Events (Mute, Battery, Charging)
+struct EventFilterConfig {
+    bool changeOnly;           // Nur echte Zustandswechsel melden, Wiederholungen verwerfen
+    DWORD coalesceWindowMs;    // 0 = aus; Battery/Charging-Bursts im Fenster zusammenfassen
+    
+    EventFilterConfig() : changeOnly(false), coalesceWindowMs(0) {}
+};
+
+// Statistik des Lesepfads
+struct EventReadStats {
+    uint64_t wakeups;       // Abgeschlossene Wartevorgänge mit mindestens einem Report
+    uint64_t reports;       // Gelesene Reports insgesamt
+    uint64_t maxBatch;      // Größte Anzahl Reports pro Wakeup
+    unsigned long inputBuffers;  // Konfigurierte Tiefe des HID-Treiberpuffers
+};
+
+struct EventFilterStats {
+    uint64_t received;              // Alle gelesenen Reports
+    uint64_t delivered;             // An Callback/Warter ausgeliefert
+    uint64_t suppressedDuplicates;  // Verworfen: Wert unverändert
+    uint64_t coalesced;             // Verworfen: im Fenster durch neueren Wert ersetzt
+};
+
+// ============================================================================
+// Executor - Ausführungskontext für asynchrone Fortsetzungen
+// ============================================================================
+class Executor {
+public:
+    virtual ~Executor() {}
+    virtual void post(std::function<void()> task) = 0;
+};
+
+// Führt die Fortsetzung direkt im auslösenden Thread aus (Read- bzw. Command-Thread)
+class InlineExecutor : public Executor {
+public:
+    void post(std::function<void()> task) override { task(); }
+};
+
+// Führt die Fortsetzung im Windows-Threadpool aus
+class ThreadPoolExecutor : public Executor {
+public:
+    void post(std::function<void()> task) override;
+};
+
+// ============================================================================
+// HID-Transport (Overlapped I/O mit Timeouts)
+// ============================================================================
+enum class ReadResult {
+    Ok,
+    Timeout,
+    Error
+};
+
+class HIDTransport {
+public:
+    virtual ~HIDTransport() {}
+    
+    virtual bool write(const unsigned char* data, size_t size) = 0;
+    
+    // Geteiltes Schreiben: beginWrite() stößt an, finishWrite() wartet auf das
+    // Ende (mehrere Geräte parallel, z.B. FrameClock). data muss bis
+    // finishWrite() gültig bleiben; beide Aufrufe aus demselben Thread.
+    // false von beginWrite() = Fehler, dann kein finishWrite(). Standard: synchron.
+    virtual bool beginWrite(const unsigned char* data, size_t size) { return write(data, size); }
+    virtual bool finishWrite() { return true; }
+    
+    // Liest einen Input-Report. Nur ein Leser gleichzeitig!
+    // Ein nach Timeout noch ausstehender Read bleibt aktiv und wird beim
+    // nächsten Aufruf fortgesetzt (es geht kein Report verloren).
+    virtual ReadResult read(unsigned char* buffer, size_t size, size_t& bytesRead, DWORD timeoutMs) = 0;
+    
+    // Verwirft gepufferte Input-Reports (wie device.clearReadBuffer() im JS)
+    virtual void flushInput() = 0;
+    
+    // Tiefe des Input-Report-Puffers im Treiber (HidD_SetNumInputBuffers)
+    virtual bool setInputBufferCount(unsigned long count) = 0;
+};
+
+class Win32HIDTransport : public HIDTransport {
+private:
+    HANDLE m_device;
+    OVERLAPPED m_readOverlapped;
+    OVERLAPPED m_writeOverlapped;
+    bool m_readPending;
+    bool m_writePending;            // beginWrite() ohne finishWrite(), hält m_writeLock
+    size_t m_writeSize;
+    unsigned char m_readBuffer[65];
+    CRITICAL_SECTION m_writeLock;
+    
+    Win32HIDTransport(HANDLE device);
+
+public:
+    ~Win32HIDTransport();
+    
+    static std::shared_ptr<Win32HIDTransport> open(const std::string& path);
+    
+    bool write(const unsigned char* data, size_t size) override;
+    bool beginWrite(const unsigned char* data, size_t size) override;
+    bool finishWrite() override;
+    ReadResult read(unsigned char* buffer, size_t size, size_t& bytesRead, DWORD timeoutMs) override;
+    void flushInput() override;
+    bool setInputBufferCount(unsigned long count) override;
+    
+    HANDLE handle() const { return m_device; }
+};
+
+// Animation (HS80_Animation.h)
+class AnimationEngine;
+class Effect;
+class Ditherer;
+class FadePlanner;
+struct CalibrationProfile;
+class CalibrationTables;
+struct DitherConfig;
+struct DitherStats;
+struct FadePlanConfig;
+struct FadePlanStats;
+class NotificationQueue;
+struct Notification;
 
 // ============================================================================
 // RGB-Controller
 // ============================================================================
 class RGBController {
 private:
-    HANDLE m_device;
+    std::shared_ptr<HIDTransport> m_transport;
     bool m_isWireless;
     bool m_initialized;
     
     // Keep-Alive für Software-Modus
     HANDLE m_keepAliveThread;
+    HANDLE m_keepAliveStopEvent;
     bool m_keepAliveRunning;
+    int m_keepAliveIntervalMs;
+    
+    // Zeitquelle für Keep-Alive, Effekte, Benachrichtigungen und Init-Pausen
+    std::shared_ptr<Clock> m_clock;
     LEDZones m_currentZones;
     int m_currentBrightness;  // 0-1000 (0-100%)
-    CRITICAL_SECTION m_lock;
+    mutable CRITICAL_SECTION m_lock;
+    unsigned char m_pendingPacket[64];  // Zwischen beginColors() und finishColors()
+    mutable CRITICAL_SECTION m_sendLock;  // Paket bauen + senden: spätere Pakete gehen später raus.
+                                          // Reihenfolge: m_sendLock vor m_lock, nie umgekehrt
+    std::atomic<uint32_t> m_micOverride;  // Bit 24 = aktiv, darunter RGB (lock-free gelesen)
+    
+    // Asynchrone Kommandos (ein Worker-Thread pro Controller)
+    std::deque<std::function<void()>> m_commandQueue;
+    HANDLE m_commandThread;
+    HANDLE m_commandEvent;
+    bool m_commandRunning;
+    CRITICAL_SECTION m_commandLock;
+    CRITICAL_SECTION m_queryLock;
+    
+    // Effekte laufen im Animation-Thread (driftfreies Frame-Timing)
+    std::unique_ptr<AnimationEngine> m_animation;
     
     static DWORD WINAPI KeepAliveThreadProc(LPVOID param);
     void keepAliveLoop();
     bool sendColorsInternal(const LEDZones& zones);
+    void buildColorPacket(const LEDZones& zones, unsigned char* packet) const;
     bool sendBrightnessInternal(int brightness);
+    
+    // Dithering (HS80_Dither.h): Hardware-Helligkeit kann unter der
+    // eingestellten liegen, solange HighRes-Frames laufen
+    std::unique_ptr<Ditherer> m_ditherer;
+    int m_hardwareBrightness;           // Zuletzt gesendet (unter m_lock)
+    bool restoreBrightness();           // Nach Dithering: eingestellte Helligkeit zurück
+    LEDZones userZonesLocked() const;   // m_currentZones auf die eingestellte Helligkeit umgerechnet
+    bool sendFrameInternal(const LEDZones& zones, bool sendColors, int hardware, int previous);
+    bool sendPlainFrameLocked(const LEDZones& zones);  // Ohne Absenkung (unter m_sendLock)
+    bool overlayActiveLocked() const;   // Benachrichtigung oder Mic-Override (unter m_sendLock)
+    
+    // Globale Blenden über die Hardware-Helligkeit (HS80_FadePlanner.h)
+    std::unique_ptr<FadePlanner> m_fadePlanner;
+    
+    // Farbkorrektur pro Gerät (HS80_Calibration.h), unter m_sendLock
+    std::string m_deviceId;
+    std::unique_ptr<CalibrationProfile> m_calibrationProfile;
+    std::unique_ptr<CalibrationTables> m_calibration;   // nullptr = Identität
+    void useDeviceCalibration(const std::string& deviceId);
+    
+    // Benachrichtigungen (HS80_Notification.h): Überlagerung beim Paketbau,
+    // m_currentZones bleibt der Grundzustand. Zonen unter m_sendLock.
+    std::unique_ptr<NotificationQueue> m_notifications;
+    std::atomic<uint8_t> m_notificationMask;
+    LEDZones m_notificationZones;
+    bool applyNotification(uint8_t mask, const LEDZones& zones);
+    void normalizeBrightnessLocked();   // Abgesenkte Hardware-Helligkeit -> eingestellte
+    
+    static DWORD WINAPI CommandThreadProc(LPVOID param);
+    void commandLoop();
+    bool submitCommand(std::function<void()> command);
+    void stopCommandThread();
 
 public:
     RGBController();
@@ -185,13 +506,43 @@ public:
     
     // Verbindung
     bool connect(unsigned short vid = CORSAIR_VID, unsigned short pid = HS80_WIRELESS_PID);
+    bool connect(std::shared_ptr<HIDTransport> transport, bool wireless = true,
+                 const std::string& deviceId = "");   // z.B. SimulatedDevice
     void disconnect();
-    bool isConnected() const { return m_device != INVALID_HANDLE_VALUE; }
+    bool isConnected() const { return m_transport != nullptr; }
     
     // RGB-Kontrolle
     bool initialize();
     bool setColors(const LEDZones& zones);
     bool setColor(RGBColor color);
+    LEDZones getColors() const;                // Sichtbare Farben bei eingestellter Helligkeit
+    
+    // Mehr als 8 Bit pro Kanal: Hardware-Helligkeit + zeitliches Dithering
+    bool setColorsHighRes(const HighResZones& zones);
+    void setDitherConfig(const DitherConfig& config);
+    DitherConfig getDitherConfig() const;
+    DitherStats getDitherStats() const;
+    
+    // Grundfarbe * Pegel (Q16, LEVEL_ONE = 1.0): Farb- oder Helligkeitspaket,
+    // je nachdem, was mit weniger Reports genau genug ist
+    bool setColorsLevel(const LEDZones& base, uint32_t level);
+    void setFadePlanConfig(const FadePlanConfig& config);
+    FadePlanConfig getFadePlanConfig() const;
+    FadePlanStats getFadePlanStats() const;
+    void resetFadePlanStats();
+    
+    // Farbkorrektur pro Zone, angewendet beim Bau jedes Farbpakets (konstante
+    // Kosten). connect() lädt das Profil des Geräts aus CALIBRATION_DIRECTORY.
+    std::string deviceId() const;                               // HID-Seriennummer
+    void setCalibration(const CalibrationProfile& profile);     // Identität = aus
+    CalibrationProfile getCalibration() const;
+    bool loadCalibration(const std::string& directory, std::string& error);
+    bool saveCalibration(const CalibrationProfile& profile, const std::string& directory, std::string& error);
+    
+    // Geteiltes Senden (FrameClock): Report anstoßen, später auf das Ende warten.
+    // Nur ein Aufrufer gleichzeitig; false von beginColors() = kein finishColors()
+    bool beginColors(const LEDZones& zones);
+    bool finishColors();
     bool setHardwareMode();
     
     // Einzelne Zonen-Kontrolle
@@ -200,6 +551,21 @@ public:
     bool setPowerColor(RGBColor color);
     bool setMicColor(RGBColor color);
     
+    // Mic-Override (Mute-Reflex): ersetzt die Mic-Zone in jedem Report bis
+    // clearMicOverride(). Sendet sofort, ohne auf den nächsten Frame zu warten;
+    // ein laufender Effekt behält die übrigen Zonen. Solange er aktiv ist, bleibt
+    // die Hardware-Helligkeit auf der eingestellten (Blenden/Dithering über Farbpakete).
+    bool setMicOverride(RGBColor color);
+    bool clearMicOverride();
+    bool hasMicOverride() const { return (m_micOverride.load() & MIC_OVERRIDE_ACTIVE) != 0; }
+    static constexpr uint32_t MIC_OVERRIDE_ACTIVE = 0x01000000;
+    
+    // Benachrichtigungen über dem laufenden Effekt / den gesetzten Farben
+    // (Priorität, Dauer, Wiederholungen). Kehrt sofort zurück; danach ist der
+    // Grundzustand unverändert wieder sichtbar.
+    bool notify(const Notification& notification);
+    NotificationQueue& notifications() { return *m_notifications; }  // cancel/Statistik
+    
     // Helligkeit (0-100% oder 0-1000)
     bool setBrightness(int percent);           // 0-100%
     bool setBrightnessRaw(int brightness);     // 0-1000 (raw value)
@@ -211,10 +577,34 @@ public:
     void stopKeepAlive();
     bool isKeepAliveRunning() const { return m_keepAliveRunning; }
     
-    // Vordefinierte Effekte
+    // Zeitquelle (HS80_Clock.h, Standard: systemClock()). Stoppt laufende Effekte,
+    // Keep-Alive läuft mit der neuen Uhr weiter. VirtualClock: siehe HS80_OfflineRenderer.h
+    void setClock(std::shared_ptr<Clock> clock);
+    Clock& clock() { return *m_clock; }
+    
+    // Vordefinierte Effekte (blockierend bis zum Ende)
     bool rainbow(int durationMs = 10000, int stepMs = 100);
     bool pulse(RGBColor color, int cycles = 3, int stepMs = 50);
     bool off();
+    
+    // Effekte im Hintergrund (kehren sofort zurück, ersetzen laufende Effekte)
+    bool startEffect(std::shared_ptr<Effect> effect, int frameIntervalMs = 33);
+    bool startRainbow(int durationMs = 0, int stepMs = 33);             // 0 = endlos
+    bool startPulse(RGBColor color, int cycles = 0, int stepMs = 50);   // 0 = endlos
+    void stopEffect();
+    bool isEffectRunning() const;
+    bool waitEffect(DWORD timeoutMs = INFINITE);
+    AnimationEngine& animation() { return *m_animation; }  // Jitter-Statistik
+    
+    // Geräte-Abfragen (Get-Kommando + Antwort, blockierend mit Timeout)
+    bool queryProperty(unsigned char property, unsigned char* response, size_t size, DWORD timeoutMs = 500);
+    bool queryBattery(BatteryStatus& status, DWORD timeoutMs = 500);
+    bool queryMicStatus(bool& muted, DWORD timeoutMs = 500);
+    bool querySleepStatus(bool& sleeping, DWORD timeoutMs = 500);
+    
+    // Asynchrone Varianten: laufen im Command-Thread, Completion über den Executor
+    bool setColorsAsync(const LEDZones& zones, Executor& executor, CommandCompletion completion);
+    bool queryBatteryAsync(Executor& executor, BatteryCompletion completion);
 };
 
 // ============================================================================
@@ -222,15 +612,68 @@ public:
 // ============================================================================
 class EventMonitor {
 private:
-    HANDLE m_device;
+    std::shared_ptr<HIDTransport> m_transport;
     HANDLE m_readThread;
-    OVERLAPPED m_overlapped;
     bool m_running;
     EventCallback m_callback;
+    EventBatchCallback m_batchCallback;
+    EventReflex m_reflex;
     unsigned char m_buffer[65];
+    
+    // Batch-Lesepfad: alle gepufferten Reports pro Wakeup abholen
+    unsigned long m_inputBufferCount;
+    bool m_drainReports;
+    std::vector<HeadsetEvent> m_readBatch;      // Roh-Reports dieses Wakeups
+    std::vector<HeadsetEvent> m_deliverBatch;   // Nach Filterung auszuliefern
+    std::atomic<uint64_t> m_statWakeups;
+    std::atomic<uint64_t> m_statReports;
+    std::atomic<uint64_t> m_statMaxBatch;
+    
+    // Einmalige Warter für nextEventAsync()
+    struct EventWaiter {
+        EventType type;
+        Executor* executor;
+        EventCompletion completion;
+    };
+    std::vector<EventWaiter> m_waiters;
+    bool m_acceptWaiters;                   // Read-Thread läuft (unter m_waiterLock)
+    CRITICAL_SECTION m_waiterLock;
+    
+    // Latenz-Messung pro Event
+    LatencyHistogram m_readToDispatch;
+    LatencyHistogram m_dispatchToReturn;
+    LatencyHistogram m_readToReturn;
+    
+    // Zustands-Cache (wird von jedem Report aktualisiert, auch von Duplikaten)
+    HeadsetStateCache m_state;
+    
+    // Zustandsfilter (nur im Read-Thread benutzt, Konfiguration unter m_filterLock)
+    struct FilterSlot {
+        bool known;          // Bereits ein Wert ausgeliefert?
+        int lastValue;       // Zuletzt ausgelieferter Wert
+        bool pending;        // Im Fenster zurückgehaltenes Event vorhanden?
+        HeadsetEvent pendingEvent;
+        std::chrono::steady_clock::time_point windowEnd;
+    };
+    FilterSlot m_filterSlots[3];  // Mute, Battery, Charging
+    EventFilterConfig m_filterConfig;
+    mutable CRITICAL_SECTION m_filterLock;
+    std::atomic<uint64_t> m_statReceived;
+    std::atomic<uint64_t> m_statDelivered;
+    std::atomic<uint64_t> m_statDuplicates;
+    std::atomic<uint64_t> m_statCoalesced;
 
     static DWORD WINAPI ReadThreadProc(LPVOID param);
     void readLoop();
+    bool startReadThread();
+    void dispatchBatch();
+    void processEvent(const HeadsetEvent& event, const EventFilterConfig& config);
+    void flushCoalesced(std::chrono::steady_clock::time_point now, const EventFilterConfig& config);
+    DWORD nextFilterTimeout(std::chrono::steady_clock::time_point now) const;
+    void queueDelivery(const HeadsetEvent& event);
+    void resetFilterState();
+    void dispatchWaiters(const HeadsetEvent& event);
+    void cancelWaiters();
 
 public:
     EventMonitor();
@@ -238,23 +681,95 @@ public:
     
     // Verbindung
     bool connect(unsigned short vid = CORSAIR_VID, unsigned short pid = HS80_WIRELESS_PID);
+    bool connect(std::shared_ptr<HIDTransport> transport);  // z.B. SimulatedDevice
     void disconnect();
-    bool isConnected() const { return m_device != INVALID_HANDLE_VALUE; }
+    bool isConnected() const { return m_transport != nullptr; }
     
     // Event-Monitoring
     bool startMonitoring(EventCallback callback);
+    bool startBatchMonitoring(EventBatchCallback callback);  // Ein Aufruf pro Wakeup
     void stopMonitoring();
     bool isMonitoring() const { return m_running; }
+    
+    // Lesepfad-Konfiguration (vor startMonitoring setzen)
+    bool setInputBufferCount(unsigned long count);
+    void setDrainReports(bool drain) { m_drainReports = drain; }  // false = ein Report pro Wakeup
+    
+    // Reflex: läuft im Read-Thread direkt nach jedem Read - vor Filter, Callbacks
+    // und Wartern, ohne deren Locks. Muss kurz sein. Nicht während des Monitorings
+    // änderbar (HeadsetManager belegt ihn für den Mute-Reflex).
+    bool setReflex(EventReflex reflex);
+    EventReadStats getReadStats() const;
+    
+    // Wartet (ohne blockierenden Thread) auf das nächste Event des Typs.
+    // EventType::Unknown wartet auf ein beliebiges Event.
+    // Bei stopMonitoring()/disconnect() oder Ende des Read-Threads wird mit
+    // ok=false abgeschlossen. false = Monitoring läuft nicht, kein Aufruf folgt.
+    bool nextEventAsync(EventType type, Executor& executor, EventCompletion completion);
+    
+    // Latenz-Statistik (zur Laufzeit lesbar)
+    EventLatencyStats getLatencyStats() const;
+    void resetLatencyStats();
+    
+    // Zustandsfilter: nur Änderungen melden, Status-Bursts zusammenfassen
+    void setEventFilter(const EventFilterConfig& config);
+    EventFilterConfig getEventFilter() const;
+    EventFilterStats getFilterStats() const;
+    
+    // Zustands-Cache (wait-free)
+    HeadsetState getState() const { return m_state.snapshot(); }
+    HeadsetStateCache& stateCache() { return m_state; }
+    const HeadsetStateCache& stateCache() const { return m_state; }
 };
 
 // ============================================================================
 // Headset-Manager (High-Level Interface)
 // ============================================================================
+struct MuteReflexConfig {
+    bool enabled;
+    RGBColor mutedColor;        // Mic-Zone bei Mute
+    bool showUnmuted;           // true = unmutedColor bei Unmute, sonst normale Mic-Farbe
+    RGBColor unmutedColor;
+    
+    MuteReflexConfig() : enabled(false), mutedColor(255, 0, 0), showUnmuted(false), unmutedColor(0, 255, 0) {}
+};
+
+struct MuteReflexStats {
+    uint64_t triggered;         // Gesendete Reflex-Reports (nur Zustandswechsel)
+    uint64_t sendErrors;        // Fehlgeschlagen, beim nächsten Mute-Report wiederholt
+    // Read abgeschlossen -> Report geschrieben. Der Reflex wartet im Read-Thread
+    // auf die Sende-Sperre: schreibt gerade ein Effekt oder der FrameClock
+    // (finishColors()), im schlimmsten Fall bis zum Write-Timeout des Transports
+    // (1 s pro ausstehendem Report). So lange verzögert sich auch die Zustellung
+    // aller Events.
+    LatencySnapshot eventToPacket;
+};
+
 class HeadsetManager {
 private:
     RGBController m_rgb;
     EventMonitor m_events;
     bool m_autoReconnect;
+    
+    // TTL-basierte Hintergrund-Aktualisierung des Zustands
+    HANDLE m_refreshThread;
+    HANDLE m_refreshStopEvent;
+    DWORD m_refreshTtlMs;
+    std::shared_ptr<Clock> m_clock;
+    int m_refreshClockTicket;
+    
+    // Mute-Reflex (Konfiguration unter m_reflexLock, Rest nur im Read-Thread)
+    MuteReflexConfig m_reflexConfig;
+    mutable CRITICAL_SECTION m_reflexLock;
+    int m_reflexMuted;                  // Zuletzt angezeigter Zustand, -1 = unbekannt
+    std::atomic<uint64_t> m_reflexTriggered;
+    std::atomic<uint64_t> m_reflexErrors;
+    LatencyHistogram m_reflexLatency;
+    
+    static DWORD WINAPI RefreshThreadProc(LPVOID param);
+    void refreshLoop();
+    void endEffect();
+    void onReflexEvent(const HeadsetEvent& event);
 
 public:
     HeadsetManager();
@@ -279,6 +794,29 @@ public:
     bool setZone(LEDZone zone, RGBColor color);
     bool setBrightness(int percent);  // 0-100%
     bool startEventMonitoring(EventCallback callback);
+    
+    // Mute-Reflex: Mute-Event (0xA6) -> Mic-Farbe direkt aus dem Read-Thread,
+    // ohne auf Effekt-Frame oder Event-Callbacks zu warten (Events müssen überwacht werden)
+    void setMuteReflex(const MuteReflexConfig& config);
+    MuteReflexConfig getMuteReflex() const;
+    MuteReflexStats getMuteReflexStats() const;
+    void resetMuteReflexStats();
+    
+    // Asynchrone API (Coroutine-Awaitables siehe HS80_Async.h)
+    bool nextEventAsync(EventType type, Executor& executor, EventCompletion completion);
+    bool setColorsAsync(const LEDZones& zones, Executor& executor, CommandCompletion completion);
+    bool queryBatteryAsync(Executor& executor, BatteryCompletion completion);
+    
+    // Zustand ohne Geräte-Roundtrip (wait-free)
+    HeadsetState getState() const { return m_events.getState(); }
+    
+    // Fragt Mute/Akku per Get-Kommando ab, sobald der Zustand älter als ttlMs ist
+    bool startStateRefresh(DWORD ttlMs = 60000);
+    void stopStateRefresh();
+    bool refreshState();  // Sofortige Abfrage (blockierend)
+    
+    // Zeitquelle für RGB-Controller, Zustands-Cache und Aktualisierung (vor connect() setzen)
+    void setClock(std::shared_ptr<Clock> clock);
 };
 
 // ============================================================================
@@ -292,6 +830,7 @@ struct DeviceInfo {
     unsigned short usage;
     std::wstring manufacturer;
     std::wstring product;
+    std::wstring serialNumber;
 };
 
 std::vector<DeviceInfo> enumerateDevices(unsigned short vid = 0, unsigned short pid = 0);
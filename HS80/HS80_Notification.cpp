@@ -0,0 +1,314 @@
+#include "HS80_Notification.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace HS80 {
+
+// ============================================================================
+// NotificationQueue
+// ============================================================================
+
+NotificationQueue::NotificationQueue(NotificationSink sink)
+    : m_sink(sink)
+    , m_thread(nullptr)
+    , m_wakeEvent(CreateEvent(nullptr, FALSE, FALSE, nullptr))
+    , m_shutdown(false)
+    , m_nextSequence(0)
+    , m_shown(-1)
+    , m_clock(systemClock())
+    , m_clockTicket(0) {
+    InitializeCriticalSection(&m_lock);
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+NotificationQueue::~NotificationQueue() {
+    shutdown();
+    if (m_wakeEvent) {
+        CloseHandle(m_wakeEvent);
+    }
+    DeleteCriticalSection(&m_lock);
+}
+
+// Unter m_lock: mehrere gleichzeitige post() starten nur einen Thread
+bool NotificationQueue::ensureThread() {
+    if (m_thread) {
+        return true;
+    }
+
+    m_clockTicket = m_clock->threadCreated();
+    m_thread = CreateThread(nullptr, 0, NotificationThreadProc, this, 0, nullptr);
+    if (!m_thread) {
+        m_clock->threadCancelled();
+        std::cerr << "[NOTIFY] Fehler beim Erstellen des Notification-Threads!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void NotificationQueue::shutdown() {
+    if (!m_thread) {
+        return;
+    }
+
+    EnterCriticalSection(&m_lock);
+    m_shutdown = true;
+    LeaveCriticalSection(&m_lock);
+    m_clock->signal(m_wakeEvent);
+
+    WaitForSingleObject(m_thread, INFINITE);
+    CloseHandle(m_thread);
+    m_thread = nullptr;
+}
+
+void NotificationQueue::setClock(std::shared_ptr<Clock> clock) {
+    if (!clock || clock == m_clock) {
+        return;
+    }
+    shutdown();
+
+    // Sichtbare Zeit mit der alten Uhr abschließen, die neue zählt ab jetzt
+    EnterCriticalSection(&m_lock);
+    double now = nowMs();
+    for (Entry& entry : m_entries) {
+        if (entry.shownSinceMs >= 0) {
+            entry.elapsedMs += now - entry.shownSinceMs;
+            entry.shownSinceMs = -1;
+        }
+    }
+    m_shown = -1;
+    m_shutdown = false;
+    m_clock = clock;
+    bool restart = !m_entries.empty() && ensureThread();
+    LeaveCriticalSection(&m_lock);
+
+    if (restart) {
+        m_clock->signal(m_wakeEvent);
+    }
+}
+
+double NotificationQueue::nowMs() const {
+    return m_clock->nowMs();
+}
+
+int NotificationQueue::findKind(const std::string& kind) const {
+    if (kind.empty()) {
+        return -1;  // Ohne Art wird nichts zusammengefasst
+    }
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        if (m_entries[i].notification.kind == kind) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void NotificationQueue::removeLocked(int index) {
+    m_entries.erase(m_entries.begin() + index);
+    if (m_shown == index) {
+        m_shown = -1;
+    } else if (m_shown > index) {
+        m_shown--;
+    }
+}
+
+bool NotificationQueue::post(const Notification& notification) {
+    if (notification.periodMs <= 0 || notification.repeat < 0 || (notification.zoneMask & ZONE_MASK_ALL) == 0) {
+        return false;
+    }
+
+    EnterCriticalSection(&m_lock);
+    m_stats.posted++;
+    int index = findKind(notification.kind);
+    if (index >= 0) {
+        // Gleiche Art: Parameter übernehmen und von vorn, Platz in der Reihe bleibt
+        Entry& entry = m_entries[index];
+        entry.notification = notification;
+        entry.elapsedMs = 0;
+        if (entry.shownSinceMs >= 0) {
+            entry.shownSinceMs = nowMs();
+        }
+        m_stats.coalesced++;
+    } else {
+        Entry entry;
+        entry.notification = notification;
+        entry.sequence = m_nextSequence++;
+        entry.elapsedMs = 0;
+        entry.shownSinceMs = -1;
+        m_entries.push_back(entry);
+    }
+    bool started = ensureThread();
+    LeaveCriticalSection(&m_lock);
+
+    m_clock->signal(m_wakeEvent);
+    return started;
+}
+
+bool NotificationQueue::cancel(const std::string& kind) {
+    EnterCriticalSection(&m_lock);
+    int index = findKind(kind);
+    if (index >= 0) {
+        removeLocked(index);
+        m_stats.cancelled++;
+    }
+    LeaveCriticalSection(&m_lock);
+
+    if (index >= 0) {
+        m_clock->signal(m_wakeEvent);
+    }
+    return index >= 0;
+}
+
+void NotificationQueue::clear() {
+    EnterCriticalSection(&m_lock);
+    m_stats.cancelled += m_entries.size();
+    m_entries.clear();
+    m_shown = -1;
+    LeaveCriticalSection(&m_lock);
+    m_clock->signal(m_wakeEvent);
+}
+
+size_t NotificationQueue::pending() const {
+    EnterCriticalSection(&m_lock);
+    size_t count = m_entries.size();
+    LeaveCriticalSection(&m_lock);
+    return count;
+}
+
+std::string NotificationQueue::current() const {
+    EnterCriticalSection(&m_lock);
+    std::string kind = m_shown >= 0 ? m_entries[m_shown].notification.kind : "";
+    LeaveCriticalSection(&m_lock);
+    return kind;
+}
+
+DWORD NotificationQueue::updateLocked(double now, uint8_t& mask, LEDZones& zones) {
+    mask = 0;
+
+    while (!m_entries.empty()) {
+        // Höchste Priorität, bei Gleichstand die älteste
+        int best = 0;
+        for (int i = 1; i < static_cast<int>(m_entries.size()); i++) {
+            const Entry& entry = m_entries[i];
+            const Entry& leader = m_entries[best];
+            if (entry.notification.priority > leader.notification.priority ||
+                (entry.notification.priority == leader.notification.priority && entry.sequence < leader.sequence)) {
+                best = i;
+            }
+        }
+
+        if (best != m_shown) {
+            if (m_shown >= 0) {
+                // Verdrängt: Restlaufzeit anhalten
+                Entry& previous = m_entries[m_shown];
+                previous.elapsedMs += now - previous.shownSinceMs;
+                previous.shownSinceMs = -1;
+                m_stats.preempted++;
+            }
+            m_entries[best].shownSinceMs = now;
+            m_shown = best;
+        }
+
+        const Entry& entry = m_entries[best];
+        const Notification& notification = entry.notification;
+        double timeMs = entry.elapsedMs + (now - entry.shownSinceMs);
+        double remainingMs = notification.repeat > 0 ?
+            static_cast<double>(notification.periodMs) * notification.repeat - timeMs : 1e12;
+        if (remainingMs <= 0) {
+            removeLocked(best);
+            m_stats.completed++;
+            continue;
+        }
+
+        double phaseMs = std::fmod(timeMs, static_cast<double>(notification.periodMs));
+        double halfMs = notification.periodMs / 2.0;
+        double level = 1.0;
+        double waitMs = remainingMs;
+        switch (notification.pattern) {
+        case NotificationPattern::Solid:
+            break;
+        case NotificationPattern::Blink:
+            level = phaseMs < halfMs ? 1.0 : 0.0;
+            waitMs = std::min(waitMs, phaseMs < halfMs ? halfMs - phaseMs : notification.periodMs - phaseMs);
+            break;
+        case NotificationPattern::Pulse: {
+            double x = phaseMs / notification.periodMs;
+            level = std::pow(x < 0.5 ? 2.0 * x : 2.0 - 2.0 * x, 2.2);
+            waitMs = std::min(waitMs, static_cast<double>(PULSE_FRAME_MS));
+            break;
+        }
+        }
+
+        RGBColor color(static_cast<uint8_t>(notification.color.r * level + 0.5),
+                       static_cast<uint8_t>(notification.color.g * level + 0.5),
+                       static_cast<uint8_t>(notification.color.b * level + 0.5));
+        mask = notification.zoneMask & ZONE_MASK_ALL;
+        zones = LEDZones(RGBColor(0, 0, 0));
+        if (mask & ZONE_MASK_LOGO) zones.logo = color;
+        if (mask & ZONE_MASK_POWER) zones.power = color;
+        if (mask & ZONE_MASK_MIC) zones.mic = color;
+        return static_cast<DWORD>(std::max(1.0, std::ceil(std::min(waitMs, 3600000.0))));
+    }
+    return INFINITE;
+}
+
+DWORD WINAPI NotificationQueue::NotificationThreadProc(LPVOID param) {
+    NotificationQueue* queue = static_cast<NotificationQueue*>(param);
+    ClockThreadScope scope(*queue->m_clock, queue->m_clockTicket);
+    queue->notificationLoop();
+    return 0;
+}
+
+void NotificationQueue::notificationLoop() {
+    uint8_t sentMask = 0;
+    LEDZones sentZones;
+
+    while (true) {
+        uint8_t mask;
+        LEDZones zones;
+        EnterCriticalSection(&m_lock);
+        if (m_shutdown) {
+            LeaveCriticalSection(&m_lock);
+            break;
+        }
+        int64_t now = m_clock->nowNs();
+        DWORD timeout = updateLocked(now / static_cast<double>(Clock::NS_PER_MS), mask, zones);
+        LeaveCriticalSection(&m_lock);
+
+        // Nur Änderungen senden; mask = 0 nach dem Ende stellt den Grundzustand her
+        if (mask != sentMask || (mask && memcmp(&zones, &sentZones, sizeof(LEDZones)) != 0)) {
+            bool ok = m_sink && m_sink(mask, zones);
+            sentMask = mask;
+            sentZones = zones;
+
+            EnterCriticalSection(&m_lock);
+            m_stats.frames++;
+            if (!ok) {
+                m_stats.sendErrors++;
+            }
+            LeaveCriticalSection(&m_lock);
+        }
+
+        m_clock->waitUntil(timeout == INFINITE ? Clock::FOREVER : now + timeout * Clock::NS_PER_MS, m_wakeEvent);
+    }
+}
+
+// ============================================================================
+// Statistik
+// ============================================================================
+
+NotificationStats NotificationQueue::getStats() const {
+    EnterCriticalSection(&m_lock);
+    NotificationStats stats = m_stats;
+    LeaveCriticalSection(&m_lock);
+    return stats;
+}
+
+void NotificationQueue::resetStats() {
+    EnterCriticalSection(&m_lock);
+    memset(&m_stats, 0, sizeof(m_stats));
+    LeaveCriticalSection(&m_lock);
+}
+
+} // namespace HS80
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "HS80_Compositor.h"
+#include "HS80_Clock.h"
+#include <vector>
+
+// ============================================================================
+// HS80 Notification - Kurze Hinweise über dem laufenden Effekt
+// ============================================================================
+//
+// Eine Benachrichtigung (Anruf, Akku schwach, Nachricht ...) überschreibt für
+// repeat * periodMs die Zonen ihrer Maske. Danach ist sofort wieder sichtbar,
+// was ohne sie zu sehen wäre:
+//
+//   - Die Überlagerung wirkt wie der Mic-Override erst beim Bau des
+//     Farbpakets. Effekte, setColors() usw. laufen ungestört weiter und
+//     schreiben den Grundzustand; nach dem Ende wird nur dieser neu gesendet.
+//   - Es ist immer genau eine Benachrichtigung sichtbar: die mit der höchsten
+//     Priorität, bei Gleichstand die älteste. Eine höhere verdrängt die
+//     laufende; deren Restlaufzeit wird angehalten und läuft später weiter.
+//   - Gleiche Art (kind) wird zusammengefasst: eine neue Meldung ersetzt
+//     Parameter und startet die vorhandene neu, statt sich anzustellen.
+//
+// post() hält nur kurz die Sperre und weckt den eigenen Notification-Thread;
+// Zeitsteuerung und Senden laufen dort. Kein Aufrufer wartet auf das Gerät.
+// ============================================================================
+
+namespace HS80 {
+
+enum class NotificationPattern {
+    Solid,      // Durchgehend an
+    Blink,      // Erste Hälfte jeder Periode an, zweite aus
+    Pulse       // Ein-/Ausblenden pro Periode (Gamma 2.2)
+};
+
+struct Notification {
+    std::string kind;               // Gleiche Art wird zusammengefasst
+    RGBColor color;
+    NotificationPattern pattern;
+    int periodMs;                   // Dauer einer Wiederholung
+    int repeat;                     // Wiederholungen, 0 = bis cancel()
+    int priority;                   // Höher verdrängt niedriger
+    uint8_t zoneMask;               // ZONE_MASK_*
+
+    Notification(const std::string& kind = "", RGBColor color = RGBColor(255, 255, 255),
+                 NotificationPattern pattern = NotificationPattern::Blink, int periodMs = 500,
+                 int repeat = 3, int priority = 0, uint8_t zoneMask = ZONE_MASK_ALL)
+        : kind(kind), color(color), pattern(pattern), periodMs(periodMs), repeat(repeat)
+        , priority(priority), zoneMask(zoneMask) {}
+};
+
+struct NotificationStats {
+    uint64_t posted;
+    uint64_t coalesced;             // In eine vorhandene gleicher Art zusammengefasst
+    uint64_t preempted;             // Von einer höheren Priorität verdrängt
+    uint64_t completed;
+    uint64_t cancelled;
+    uint64_t frames;                // Übergebene Überlagerungen (inkl. Ende)
+    uint64_t sendErrors;
+};
+
+// Ausgabe der Überlagerung: Zonen aus mask ersetzen, mask = 0 = keine
+using NotificationSink = std::function<bool(uint8_t mask, const LEDZones& zones)>;
+
+class NotificationQueue {
+private:
+    struct Entry {
+        Notification notification;
+        uint64_t sequence;          // Reihenfolge bei gleicher Priorität
+        double elapsedMs;           // Bereits sichtbare Zeit
+        double shownSinceMs;        // < 0 = gerade nicht sichtbar
+    };
+
+    static constexpr int PULSE_FRAME_MS = 20;
+
+    NotificationSink m_sink;
+    HANDLE m_thread;
+    HANDLE m_wakeEvent;             // Auto-Reset: Warteschlange geändert
+    mutable CRITICAL_SECTION m_lock;
+    bool m_shutdown;
+
+    std::vector<Entry> m_entries;   // Unter m_lock
+    uint64_t m_nextSequence;
+    int m_shown;                    // Index der sichtbaren, -1 = keine
+    NotificationStats m_stats;
+    std::shared_ptr<Clock> m_clock;
+    int m_clockTicket;
+
+    static DWORD WINAPI NotificationThreadProc(LPVOID param);
+    void notificationLoop();
+    bool ensureThread();
+    void shutdown();
+    double nowMs() const;
+    int findKind(const std::string& kind) const;
+    void removeLocked(int index);
+
+    // Sichtbare Benachrichtigung zum Zeitpunkt now bestimmen; Rückgabe:
+    // Wartezeit bis zur nächsten Änderung (INFINITE = keine aktiv)
+    DWORD updateLocked(double now, uint8_t& mask, LEDZones& zones);
+
+public:
+    explicit NotificationQueue(NotificationSink sink);
+    ~NotificationQueue();
+
+    NotificationQueue(const NotificationQueue&) = delete;
+    NotificationQueue& operator=(const NotificationQueue&) = delete;
+
+    // Nicht-blockierend; false = ungültig (periodMs <= 0, leere Maske)
+    bool post(const Notification& notification);
+    bool cancel(const std::string& kind);
+    void clear();
+
+    size_t pending() const;             // Aktive + wartende
+    bool isActive() const { return pending() > 0; }
+    std::string current() const;        // Art der sichtbaren, "" = keine
+
+    // Zeitquelle (Standard: systemClock()); laufende Hinweise behalten ihre Restzeit
+    void setClock(std::shared_ptr<Clock> clock);
+
+    NotificationStats getStats() const;
+    void resetStats();
+};
+
+} // namespace HS80
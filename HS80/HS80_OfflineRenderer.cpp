@@ -0,0 +1,181 @@
+#include "HS80_OfflineRenderer.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace HS80 {
+
+// ============================================================================
+// OfflineRenderer
+// ============================================================================
+
+OfflineRenderer::OfflineRenderer(bool wireless)
+    : m_clock(std::make_shared<VirtualClock>())
+    , m_device(std::make_shared<SimulatedDevice>())
+    , m_wireless(wireless)
+    , m_recording(false)
+    , m_startNs(0) {
+    InitializeCriticalSection(&m_lock);
+    m_device->setWriteObserver([this](const unsigned char* data, size_t size) { record(data, size); });
+    m_rgb.setClock(m_clock);
+}
+
+OfflineRenderer::~OfflineRenderer() {
+    // Threads des Controllers beenden, solange Clock und Observer noch gültig sind
+    m_rgb.disconnect();
+    m_device->setWriteObserver(nullptr);
+    DeleteCriticalSection(&m_lock);
+}
+
+bool OfflineRenderer::open() {
+    if (!m_rgb.connect(m_device, m_wireless) || !m_rgb.initialize()) {
+        std::cerr << "[RENDER] Initialisierung am simulierten Gerät fehlgeschlagen!" << std::endl;
+        return false;
+    }
+
+    EnterCriticalSection(&m_lock);
+    m_frames.clear();
+    m_recording = true;
+    m_startNs = m_clock->nowNs();
+    LeaveCriticalSection(&m_lock);
+    return true;
+}
+
+void OfflineRenderer::record(const unsigned char* data, size_t size) {
+    RenderedFrame frame = {};
+    if (size >= 17 && data[2] == 0x06) {
+        frame.kind = 'C';
+        frame.zones.logo = RGBColor(data[8], data[11], data[14]);
+        frame.zones.power = RGBColor(data[9], data[12], data[15]);
+        frame.zones.mic = RGBColor(data[10], data[13], data[16]);
+    } else if (size >= 7 && data[2] == 0x01 && data[3] == 0x02) {
+        frame.kind = 'B';
+        frame.brightness = data[5] | (data[6] << 8);
+    } else {
+        frame.kind = 'P';
+        memcpy(frame.header, data, std::min(size, sizeof(frame.header)));
+    }
+
+    // Sende-Threads laufen an der VirtualClock einzeln: die Zeit steht während des Sendens
+    EnterCriticalSection(&m_lock);
+    if (m_recording) {
+        frame.timeNs = m_clock->nowNs() - m_startNs;
+        m_frames.push_back(frame);
+    }
+    LeaveCriticalSection(&m_lock);
+}
+
+void OfflineRenderer::run(double ms) {
+    m_clock->advanceMs(ms);
+}
+
+double OfflineRenderer::elapsedMs() const {
+    EnterCriticalSection(&m_lock);
+    int64_t start = m_startNs;
+    LeaveCriticalSection(&m_lock);
+    return (m_clock->nowNs() - start) / static_cast<double>(Clock::NS_PER_MS);
+}
+
+std::vector<RenderedFrame> OfflineRenderer::frames() const {
+    EnterCriticalSection(&m_lock);
+    std::vector<RenderedFrame> frames = m_frames;
+    LeaveCriticalSection(&m_lock);
+    return frames;
+}
+
+size_t OfflineRenderer::frameCount() const {
+    EnterCriticalSection(&m_lock);
+    size_t count = m_frames.size();
+    LeaveCriticalSection(&m_lock);
+    return count;
+}
+
+void OfflineRenderer::clear() {
+    EnterCriticalSection(&m_lock);
+    m_frames.clear();
+    LeaveCriticalSection(&m_lock);
+}
+
+uint64_t OfflineRenderer::checksum() const {
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+
+    EnterCriticalSection(&m_lock);
+    for (const RenderedFrame& frame : m_frames) {
+        mix(&frame.timeNs, sizeof(frame.timeNs));
+        mix(&frame.kind, 1);
+        if (frame.kind == 'C') {
+            const RGBColor colors[3] = { frame.zones.logo, frame.zones.power, frame.zones.mic };
+            for (const RGBColor& color : colors) {
+                mix(&color.r, 1);
+                mix(&color.g, 1);
+                mix(&color.b, 1);
+            }
+        } else if (frame.kind == 'B') {
+            mix(&frame.brightness, sizeof(frame.brightness));
+        } else {
+            mix(frame.header, sizeof(frame.header));
+        }
+    }
+    LeaveCriticalSection(&m_lock);
+    return hash;
+}
+
+void OfflineRenderer::write(std::ostream& output) const {
+    std::vector<RenderedFrame> frames = this->frames();
+    std::ios::fmtflags flags = output.flags();
+    char fill = output.fill();
+
+    output << "# HS80 Offline-Render: " << frames.size() << " Pakete, Pruefsumme "
+           << std::hex << std::setw(16) << std::setfill('0') << checksum() << std::dec << std::setfill(' ') << "\n";
+    output << "# zeit_ms  C logo power mic | B helligkeit | P bytes\n";
+
+    auto hex = [&output](unsigned value, int width) {
+        output << std::hex << std::uppercase << std::setw(width) << std::setfill('0') << value
+               << std::dec << std::nouppercase << std::setfill(' ');
+    };
+    for (const RenderedFrame& frame : frames) {
+        output << std::fixed << std::setprecision(3) << frame.timeNs / static_cast<double>(Clock::NS_PER_MS) << " " << frame.kind;
+        if (frame.kind == 'C') {
+            const RGBColor colors[3] = { frame.zones.logo, frame.zones.power, frame.zones.mic };
+            for (const RGBColor& color : colors) {
+                output << " ";
+                hex((color.r << 16) | (color.g << 8) | color.b, 6);
+            }
+        } else if (frame.kind == 'B') {
+            output << " " << frame.brightness;
+        } else {
+            for (unsigned char byte : frame.header) {
+                output << " ";
+                hex(byte, 2);
+            }
+        }
+        output << "\n";
+    }
+
+    output.flags(flags);
+    output.fill(fill);
+}
+
+bool OfflineRenderer::dump(const std::string& path, std::string& error) const {
+    std::ofstream output(path, std::ios::trunc);
+    if (!output.is_open()) {
+        error = "Kann " + path + " nicht schreiben";
+        return false;
+    }
+    write(output);
+    if (!output.good()) {
+        error = "Fehler beim Schreiben von " + path;
+        return false;
+    }
+    return true;
+}
+
+} // namespace HS80
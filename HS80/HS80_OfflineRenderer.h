@@ -0,0 +1,85 @@
+#pragma once
+
+#include "HS80_Clock.h"
+#include "HS80_Simulation.h"
+#include <iosfwd>
+#include <vector>
+
+// ============================================================================
+// HS80 OfflineRenderer - Effekte ohne Gerät und ohne echte Zeit abspielen
+// ============================================================================
+//
+// RGBController an einem SimulatedDevice, alle Threads an einer VirtualClock.
+// run() spielt beliebig lange Abschnitte (Effekte, Keep-Alive, Benachrichti-
+// gungen) in dem Tempo ab, in dem die Threads rechnen können, und zeichnet
+// jedes gesendete Paket mit seiner virtuellen Sendezeit auf:
+//
+//   OfflineRenderer renderer;
+//   renderer.open();
+//   renderer.rgb().startRainbow(10000, 20);
+//   renderer.rgb().startKeepAlive(5000);
+//   renderer.run(3600000);                       // 1 Stunde
+//   renderer.dump("rainbow.txt", error);
+//
+// Bei gleicher Eingabe sind Frames und checksum() bei jedem Lauf identisch.
+// Die Init-Pakete aus open() werden nicht aufgezeichnet; Zeiten zählen ab
+// dem Ende von open().
+// ============================================================================
+
+namespace HS80 {
+
+struct RenderedFrame {
+    int64_t timeNs;             // Virtuelle Sendezeit ab dem Ende von open()
+    char kind;                  // 'C' Farben, 'B' Helligkeit, 'P' sonstiges Paket
+    LEDZones zones;             // Bei 'C'
+    int brightness;             // Bei 'B' (0-1000)
+    unsigned char header[8];    // Bei 'P': erste Bytes des Reports
+};
+
+class OfflineRenderer {
+private:
+    std::shared_ptr<VirtualClock> m_clock;
+    std::shared_ptr<SimulatedDevice> m_device;
+    RGBController m_rgb;
+    bool m_wireless;
+
+    mutable CRITICAL_SECTION m_lock;
+    std::vector<RenderedFrame> m_frames;    // Unter m_lock (Observer läuft im Sende-Thread)
+    bool m_recording;
+    int64_t m_startNs;
+
+    void record(const unsigned char* data, size_t size);
+
+public:
+    explicit OfflineRenderer(bool wireless = true);
+    ~OfflineRenderer();
+
+    OfflineRenderer(const OfflineRenderer&) = delete;
+    OfflineRenderer& operator=(const OfflineRenderer&) = delete;
+
+    // Verbindet und initialisiert (300ms virtuell), danach beginnt die Aufzeichnung
+    bool open();
+
+    RGBController& rgb() { return m_rgb; }
+    VirtualClock& clock() { return *m_clock; }
+    SimulatedDevice& device() { return *m_device; }
+
+    // Virtuelle Zeit vorstellen; kehrt zurück, wenn alle Threads wieder warten
+    void run(double ms);
+    double elapsedMs() const;
+
+    std::vector<RenderedFrame> frames() const;
+    size_t frameCount() const;
+    void clear();                           // Aufzeichnung verwerfen, Zeit läuft weiter
+
+    // FNV-1a über alle Frames (Zeit, Art, Inhalt): gleicher Wert = gleicher Strom
+    uint64_t checksum() const;
+
+    // Textformat, eine Zeile pro Paket:  <zeit_ms> C <logo> <power> <mic>  (RRGGBB)
+    //                                    <zeit_ms> B <helligkeit 0-1000>
+    //                                    <zeit_ms> P <erste 8 Bytes>
+    void write(std::ostream& output) const;
+    bool dump(const std::string& path, std::string& error) const;
+};
+
+} // namespace HS80
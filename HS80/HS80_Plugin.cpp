@@ -0,0 +1,399 @@
+#include "HS80_Plugin.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace HS80 {
+
+// ============================================================================
+// PluginModule
+// ============================================================================
+
+PluginModule::PluginModule()
+    : m_module(nullptr)
+    , m_descriptor(nullptr) {
+}
+
+PluginModule::~PluginModule() {
+    if (m_module) {
+        FreeLibrary(m_module);
+    }
+    if (!m_loadedPath.empty()) {
+        DeleteFileA(m_loadedPath.c_str());
+    }
+}
+
+std::shared_ptr<PluginModule> PluginModule::load(const std::string& path, std::string& error) {
+    static std::atomic<uint32_t> s_copies(0);
+
+    // Kopie laden: die Original-DLL bleibt unbelegt und kann neu gebaut werden
+    char tempDirectory[MAX_PATH];
+    DWORD length = GetTempPathA(MAX_PATH, tempDirectory);
+    if (length == 0 || length >= MAX_PATH) {
+        error = "Kein Temp-Verzeichnis (Fehler " + std::to_string(GetLastError()) + ")";
+        return nullptr;
+    }
+    size_t slash = path.find_last_of("\\/");
+    std::string file = slash == std::string::npos ? path : path.substr(slash + 1);
+    std::string copy = std::string(tempDirectory) + "HS80_" + std::to_string(GetCurrentProcessId()) + "_" +
+                       std::to_string(s_copies.fetch_add(1)) + "_" + file;
+    if (!CopyFileA(path.c_str(), copy.c_str(), FALSE)) {
+        error = "Kann " + path + " nicht kopieren (Fehler " + std::to_string(GetLastError()) + ")";
+        return nullptr;
+    }
+
+    std::shared_ptr<PluginModule> module(new PluginModule());
+    module->m_path = path;
+    module->m_loadedPath = copy;
+    module->m_module = LoadLibraryA(copy.c_str());
+    if (!module->m_module) {
+        error = "Kann " + path + " nicht laden (Fehler " + std::to_string(GetLastError()) + ")";
+        return nullptr;
+    }
+
+    HS80PluginEntry entry = reinterpret_cast<HS80PluginEntry>(GetProcAddress(module->m_module, HS80_PLUGIN_ENTRY));
+    if (!entry) {
+        error = path + " exportiert kein " + HS80_PLUGIN_ENTRY;
+        return nullptr;
+    }
+    const HS80PluginDescriptor* descriptor = entry();
+    if (!descriptor) {
+        error = path + ": " + HS80_PLUGIN_ENTRY + "() liefert keinen Deskriptor";
+        return nullptr;
+    }
+    if (descriptor->abiVersion != HS80_PLUGIN_ABI_VERSION) {
+        error = path + ": ABI-Version " + std::to_string(descriptor->abiVersion) +
+                ", erwartet " + std::to_string(HS80_PLUGIN_ABI_VERSION);
+        return nullptr;
+    }
+    // Ältere Plugins mit kürzerem Deskriptor bleiben gültig, solange er die 1.0-Felder enthält
+    if (descriptor->size < HS80_PLUGIN_DESCRIPTOR_V1_SIZE || !descriptor->create || !descriptor->destroy || !descriptor->render) {
+        error = path + ": Deskriptor unvollständig";
+        return nullptr;
+    }
+
+    module->m_descriptor = descriptor;
+    module->m_name = descriptor->name ? descriptor->name : file;
+    return module;
+}
+
+// ============================================================================
+// PluginEffect
+// ============================================================================
+
+PluginEffect::Instance::~Instance() {
+    module->descriptor().destroy(handle);
+}
+
+PluginEffect::PluginEffect(const HeadsetStateCache* state)
+    : m_state(state)
+    , m_watchThread(nullptr)
+    , m_stopEvent(nullptr)
+    , m_pollMs(500)
+    , m_watchSize(0) {
+    InitializeCriticalSection(&m_lock);
+    QueryPerformanceFrequency(&m_qpcFrequency);
+    memset(m_rgb, 0, sizeof(m_rgb));
+    memset(&m_watchTime, 0, sizeof(m_watchTime));
+    resetStats();
+}
+
+PluginEffect::~PluginEffect() {
+    stopWatching();
+    m_instance.reset();
+    DeleteCriticalSection(&m_lock);
+}
+
+bool PluginEffect::load(std::shared_ptr<PluginModule> module, const std::string& args, std::string& error) {
+    if (!module) {
+        error = "Kein Plugin-Modul";
+        return false;
+    }
+
+    void* handle = module->descriptor().create(args.c_str());
+    if (!handle) {
+        error = "create() von '" + module->name() + "' fehlgeschlagen (Argumente: '" + args + "')";
+        return false;
+    }
+
+    std::shared_ptr<Instance> instance = std::make_shared<Instance>();
+    instance->module = module;
+    instance->handle = handle;
+    instance->averageUs = 0;
+    instance->stride = 1;
+    instance->skip = 0;
+    instance->stopped = false;
+
+    // Die alte Instanz wird hier oder nach ihrem letzten Frame im Animation-Thread freigegeben
+    std::shared_ptr<Instance> previous;
+    EnterCriticalSection(&m_lock);
+    previous = m_instance;
+    m_instance = instance;
+    if (previous) {
+        m_statSwaps++;
+    }
+    m_statStride = 1;
+    m_statStopped = false;
+    m_statAverageUs = 0;
+    LeaveCriticalSection(&m_lock);
+    return true;
+}
+
+bool PluginEffect::loadFile(const std::string& path, const std::string& args, std::string& error) {
+    std::shared_ptr<PluginModule> module = PluginModule::load(path, error);
+    return module && load(module, args, error);
+}
+
+void PluginEffect::unload() {
+    std::shared_ptr<Instance> previous;
+    EnterCriticalSection(&m_lock);
+    previous = m_instance;
+    m_instance.reset();
+    LeaveCriticalSection(&m_lock);
+}
+
+std::string PluginEffect::name() const {
+    EnterCriticalSection(&m_lock);
+    std::string name = m_instance ? m_instance->module->name() : "";
+    LeaveCriticalSection(&m_lock);
+    return name;
+}
+
+void PluginEffect::setBudget(const PluginBudget& budget) {
+    EnterCriticalSection(&m_lock);
+    m_budget = budget;
+    m_budget.maxStride = std::max(1, budget.maxStride);
+    LeaveCriticalSection(&m_lock);
+}
+
+PluginBudget PluginEffect::getBudget() const {
+    EnterCriticalSection(&m_lock);
+    PluginBudget budget = m_budget;
+    LeaveCriticalSection(&m_lock);
+    return budget;
+}
+
+EffectStatus PluginEffect::render(const FrameContext& frame, LEDZones& zones) {
+    EnterCriticalSection(&m_lock);
+    std::shared_ptr<Instance> instance = m_instance;
+    PluginBudget budget = m_budget;
+    LeaveCriticalSection(&m_lock);
+
+    int32_t result = HS80_PLUGIN_RUNNING;
+    bool called = false;
+    bool held = false;
+    bool stoppedNow = false;
+    double callUs = 0;
+
+    if (!instance) {
+        memset(m_rgb, 0, sizeof(m_rgb));
+    } else if (instance->stopped) {
+        held = true;
+    } else if (instance->skip > 0) {
+        instance->skip--;
+        held = true;
+    } else {
+        HS80PluginFrame input;
+        memset(&input, 0, sizeof(input));
+        input.size = sizeof(input);
+        input.frameIndex = frame.frameIndex;
+        input.timeMs = frame.timeMs;
+        input.frameIntervalMs = frame.frameIntervalMs;
+        input.muted = input.battery = input.sleeping = -1;
+        if (m_state) {
+            HeadsetState state = m_state->snapshot();
+            input.muted = state.muted;
+            input.battery = state.batteryLevel;
+            input.charging = static_cast<int32_t>(state.charging);
+            input.sleeping = state.sleeping;
+        }
+        memcpy(input.rgb, m_rgb, sizeof(m_rgb));
+
+        LARGE_INTEGER start, end;
+        QueryPerformanceCounter(&start);
+        result = instance->module->descriptor().render(instance->handle, &input);
+        QueryPerformanceCounter(&end);
+        called = true;
+
+        int64_t ns = (end.QuadPart - start.QuadPart) * 1000000000LL / m_qpcFrequency.QuadPart;
+        m_callTime.record(static_cast<uint64_t>(ns));
+        callUs = ns / 1000.0;
+        instance->averageUs = instance->averageUs == 0 ? callUs : instance->averageUs * 0.9 + callUs * 0.1;
+
+        // Aufrufabstand so wählen, dass im Mittel höchstens frameUs pro Frame anfallen
+        if (budget.frameUs > 0) {
+            instance->stride = std::max(1, std::min(budget.maxStride, static_cast<int>(std::ceil(instance->averageUs / budget.frameUs))));
+        } else {
+            instance->stride = 1;
+        }
+        instance->skip = instance->stride - 1;
+        if (budget.stopUs > 0 && callUs > budget.stopUs) {
+            instance->stopped = true;
+            stoppedNow = true;
+        }
+
+        if (result >= 0) {
+            memcpy(m_rgb, input.rgb, sizeof(m_rgb));
+        }
+    }
+
+    zones.logo = RGBColor(m_rgb[0], m_rgb[1], m_rgb[2]);
+    zones.power = RGBColor(m_rgb[3], m_rgb[4], m_rgb[5]);
+    zones.mic = RGBColor(m_rgb[6], m_rgb[7], m_rgb[8]);
+
+    EnterCriticalSection(&m_lock);
+    m_statFrames++;
+    if (called) {
+        m_statCalls++;
+        if (result < 0) {
+            m_statErrors++;
+        }
+    }
+    if (held) {
+        m_statHeld++;
+    }
+    if (instance && instance == m_instance) {
+        m_statStride = instance->stride;
+        m_statStopped = instance->stopped;
+        m_statAverageUs = instance->averageUs;
+    }
+    LeaveCriticalSection(&m_lock);
+
+    if (stoppedNow) {
+        std::cerr << "[PLUGIN] '" << instance->module->name() << "' angehalten: Aufruf " << static_cast<int>(callUs)
+                  << " us > " << static_cast<int>(budget.stopUs) << " us" << std::endl;
+    }
+    return result == HS80_PLUGIN_FINISHED ? EffectStatus::Finished : EffectStatus::Running;
+}
+
+// ============================================================================
+// Hot-Reload
+// ============================================================================
+
+bool PluginEffect::startWatching(const std::string& path, const std::string& args, DWORD pollMs) {
+    if (m_watchThread) {
+        return false;
+    }
+
+    m_watchPath = path;
+    m_watchArgs = args;
+    m_pollMs = pollMs > 0 ? pollMs : 1;
+    memset(&m_watchTime, 0, sizeof(m_watchTime));
+    m_watchSize = 0;
+    watchedFileChanged();   // Stand merken, nicht sofort neu laden
+
+    m_stopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    if (!m_stopEvent) {
+        return false;
+    }
+    m_watchThread = CreateThread(nullptr, 0, WatchThreadProc, this, 0, nullptr);
+    if (!m_watchThread) {
+        CloseHandle(m_stopEvent);
+        m_stopEvent = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void PluginEffect::stopWatching() {
+    if (!m_watchThread) {
+        return;
+    }
+
+    SetEvent(m_stopEvent);
+    WaitForSingleObject(m_watchThread, INFINITE);
+    CloseHandle(m_watchThread);
+    CloseHandle(m_stopEvent);
+    m_watchThread = nullptr;
+    m_stopEvent = nullptr;
+}
+
+bool PluginEffect::watchedFileChanged() {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(m_watchPath.c_str(), GetFileExInfoStandard, &data)) {
+        return false;
+    }
+    bool changed = data.ftLastWriteTime.dwLowDateTime != m_watchTime.dwLowDateTime ||
+                   data.ftLastWriteTime.dwHighDateTime != m_watchTime.dwHighDateTime ||
+                   data.nFileSizeLow != m_watchSize;
+    m_watchTime = data.ftLastWriteTime;
+    m_watchSize = data.nFileSizeLow;
+    return changed;
+}
+
+void PluginEffect::reloadWatched() {
+    std::string error;
+    if (!loadFile(m_watchPath, m_watchArgs, error)) {
+        // Laufende Instanz bleibt stehen
+        std::cerr << "[PLUGIN] " << m_watchPath << " nicht geladen: " << error << std::endl;
+        EnterCriticalSection(&m_lock);
+        m_lastError = error;
+        m_statLoadErrors++;
+        LeaveCriticalSection(&m_lock);
+        return;
+    }
+
+    std::cout << "[PLUGIN] " << m_watchPath << " neu geladen ('" << name() << "')" << std::endl;
+    EnterCriticalSection(&m_lock);
+    m_lastError.clear();
+    LeaveCriticalSection(&m_lock);
+}
+
+DWORD WINAPI PluginEffect::WatchThreadProc(LPVOID param) {
+    static_cast<PluginEffect*>(param)->watchLoop();
+    return 0;
+}
+
+void PluginEffect::watchLoop() {
+    while (WaitForSingleObject(m_stopEvent, m_pollMs) == WAIT_TIMEOUT) {
+        if (watchedFileChanged()) {
+            reloadWatched();
+        }
+    }
+}
+
+// ============================================================================
+// Statistik
+// ============================================================================
+
+std::string PluginEffect::lastError() const {
+    EnterCriticalSection(&m_lock);
+    std::string error = m_lastError;
+    LeaveCriticalSection(&m_lock);
+    return error;
+}
+
+PluginEffectStats PluginEffect::getStats() const {
+    PluginEffectStats stats;
+    EnterCriticalSection(&m_lock);
+    stats.frames = m_statFrames;
+    stats.calls = m_statCalls;
+    stats.held = m_statHeld;
+    stats.errors = m_statErrors;
+    stats.swaps = m_statSwaps;
+    stats.loadErrors = m_statLoadErrors;
+    stats.stride = m_statStride;
+    stats.stopped = m_statStopped;
+    stats.averageUs = m_statAverageUs;
+    LeaveCriticalSection(&m_lock);
+    stats.callTime = m_callTime.snapshot();
+    return stats;
+}
+
+void PluginEffect::resetStats() {
+    EnterCriticalSection(&m_lock);
+    m_statFrames = 0;
+    m_statCalls = 0;
+    m_statHeld = 0;
+    m_statErrors = 0;
+    m_statSwaps = 0;
+    m_statLoadErrors = 0;
+    m_statStride = 1;
+    m_statStopped = false;
+    m_statAverageUs = 0;
+    LeaveCriticalSection(&m_lock);
+    m_callTime.reset();
+}
+
+} // namespace HS80
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "HS80_Animation.h"
+#include "HS80_PluginApi.h"
+#include <string>
+
+// ============================================================================
+// HS80 Plugin - Native Effekte aus DLLs, im laufenden Betrieb austauschbar
+// ============================================================================
+//
+// Ein Plugin ist eine DLL mit der C-Schnittstelle aus HS80_PluginApi.h. Sie
+// wird ohne Neubau der Library oder der Anwendung geladen:
+//
+//   auto effect = std::make_shared<PluginEffect>(&manager.events().stateCache());
+//   effect->loadFile("plugins\\komet.dll", "period=2000", error);
+//   manager.rgb().startEffect(effect, 20);
+//   effect->startWatching("plugins\\komet.dll", "period=2000");   // Hot-Reload
+//
+// - Geladen wird eine Kopie im Temp-Verzeichnis: die DLL selbst bleibt frei
+//   und kann neu gebaut werden, während der Effekt läuft.
+// - load()/loadFile() tauschen die Plugin-Instanz unter einer kurzen Sperre.
+//   Der Animation-Thread läuft weiter; der laufende Frame endet mit der alten
+//   Instanz, der nächste kommt von der neuen. Zeit und letzter Frame laufen
+//   durch, die alte Instanz und ihre DLL werden nach ihrem letzten Frame
+//   freigegeben.
+// - Jeder Aufruf wird gemessen (QueryPerformanceCounter, echte CPU-Zeit auch
+//   an einer VirtualClock). Liegt der Mittelwert über PluginBudget::frameUs,
+//   wird das Plugin nur noch jeden n-ten Frame aufgerufen und dazwischen der
+//   letzte Frame gehalten. Ein einzelner Aufruf über stopUs hält die Instanz
+//   an (letzter Frame bleibt stehen) bis zum nächsten load().
+//
+// Ein Plugin läuft im Prozess: Absturz oder Endlosschleife im Plugin treffen
+// die Anwendung. Das Budget schützt die Framerate, nicht den Prozess.
+// ============================================================================
+
+namespace HS80 {
+
+// Geladene Plugin-DLL (geprüfter Deskriptor). Freigabe mit dem letzten shared_ptr.
+class PluginModule {
+private:
+    HMODULE m_module;
+    std::string m_path;             // Original
+    std::string m_loadedPath;       // Kopie im Temp-Verzeichnis
+    std::string m_name;
+    const HS80PluginDescriptor* m_descriptor;
+
+    PluginModule();
+
+public:
+    ~PluginModule();
+
+    PluginModule(const PluginModule&) = delete;
+    PluginModule& operator=(const PluginModule&) = delete;
+
+    // nullptr + error bei fehlender Datei, fehlendem Export, falscher ABI-Version
+    static std::shared_ptr<PluginModule> load(const std::string& path, std::string& error);
+
+    const std::string& path() const { return m_path; }
+    const std::string& name() const { return m_name; }
+    const HS80PluginDescriptor& descriptor() const { return *m_descriptor; }
+};
+
+struct PluginBudget {
+    double frameUs;             // Mittlere Plugin-Zeit pro Frame, 0 = unbegrenzt
+    double stopUs;              // Einzelner Aufruf darüber: Instanz anhalten, 0 = nie
+    int maxStride;              // Höchstens jeder n-te Frame wird gerechnet
+
+    PluginBudget() : frameUs(1000), stopUs(20000), maxStride(8) {}
+};
+
+struct PluginEffectStats {
+    uint64_t frames;            // render() des Effekts
+    uint64_t calls;             // Davon an das Plugin weitergegeben
+    uint64_t held;              // Wegen Budget mit dem letzten Frame beantwortet
+    uint64_t errors;            // Negative Rückgabe des Plugins
+    uint64_t swaps;             // Instanz-Tausch im laufenden Effekt
+    uint64_t loadErrors;        // Fehlgeschlagene Hot-Reloads
+    int stride;                 // Aktuell: jeder n-te Frame
+    bool stopped;               // stopUs überschritten
+    double averageUs;           // Gleitender Mittelwert pro Aufruf
+    LatencySnapshot callTime;
+};
+
+// Effekt, der seine Frames von einer Plugin-Instanz bezieht
+class PluginEffect : public Effect {
+private:
+    struct Instance {
+        std::shared_ptr<PluginModule> module;
+        void* handle;
+        // Nur im Animation-Thread
+        double averageUs;
+        int stride;
+        int skip;               // Bis zum nächsten Aufruf zu haltende Frames
+        bool stopped;
+
+        ~Instance();
+    };
+
+    mutable CRITICAL_SECTION m_lock;
+    std::shared_ptr<Instance> m_instance;       // Unter m_lock
+    PluginBudget m_budget;                      // Unter m_lock
+    const HeadsetStateCache* m_state;
+    unsigned char m_rgb[9];                     // Letzter Frame (Animation-Thread)
+    LARGE_INTEGER m_qpcFrequency;
+    LatencyHistogram m_callTime;
+
+    // Statistik unter m_lock
+    uint64_t m_statFrames;
+    uint64_t m_statCalls;
+    uint64_t m_statHeld;
+    uint64_t m_statErrors;
+    uint64_t m_statSwaps;
+    uint64_t m_statLoadErrors;
+    int m_statStride;
+    bool m_statStopped;
+    double m_statAverageUs;
+
+    // Hot-Reload (Datei-Überwachung wie RuleEngine)
+    HANDLE m_watchThread;
+    HANDLE m_stopEvent;
+    std::string m_watchPath;
+    std::string m_watchArgs;
+    DWORD m_pollMs;
+    FILETIME m_watchTime;
+    DWORD m_watchSize;
+    std::string m_lastError;
+
+    bool watchedFileChanged();
+    void reloadWatched();
+    static DWORD WINAPI WatchThreadProc(LPVOID param);
+    void watchLoop();
+
+public:
+    explicit PluginEffect(const HeadsetStateCache* state = nullptr);
+    ~PluginEffect();
+
+    PluginEffect(const PluginEffect&) = delete;
+    PluginEffect& operator=(const PluginEffect&) = delete;
+
+    // Neue Instanz anlegen (create(args)) und tauschen; bei Fehler bleibt die alte
+    bool load(std::shared_ptr<PluginModule> module, const std::string& args, std::string& error);
+    bool loadFile(const std::string& path, const std::string& args, std::string& error);
+    void unload();                              // Schwarz bis zum nächsten load()
+    std::string name() const;                   // "" = keine Instanz
+
+    void setBudget(const PluginBudget& budget);
+    PluginBudget getBudget() const;
+
+    // Lädt die DLL neu, sobald sie sich ändert (eigener Thread, pollMs)
+    bool startWatching(const std::string& path, const std::string& args = "", DWORD pollMs = 500);
+    void stopWatching();
+    std::string lastError() const;
+
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override;
+
+    PluginEffectStats getStats() const;
+    void resetStats();
+};
+
+} // namespace HS80
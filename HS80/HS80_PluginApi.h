@@ -0,0 +1,99 @@
+#pragma once
+
+/*
+ * ============================================================================
+ * HS80 Plugin-ABI - Effekte als DLL, ohne die Library neu zu bauen
+ * ============================================================================
+ *
+ * Reines C, keine Abhängigkeit von der Library: ein Plugin bindet nur diese
+ * Datei ein und exportiert eine Funktion, die seinen Deskriptor liefert:
+ *
+ *   static const HS80PluginDescriptor descriptor = {
+ *       HS80_PLUGIN_ABI_VERSION, sizeof(HS80PluginDescriptor), "Komet",
+ *       cometCreate, cometDestroy, cometRender
+ *   };
+ *   HS80_PLUGIN_EXPORT const HS80PluginDescriptor* HS80_GetPlugin(void) { return &descriptor; }
+ *
+ * Regeln (gelten für alle Versionen 1.x):
+ *   - create() läuft im Thread des Ladenden, render() im Animation-Thread,
+ *     destroy() in dem Thread, der die Instanz zuletzt benutzt hat. Eine
+ *     Instanz wird nie gleichzeitig aus zwei Threads benutzt.
+ *   - render() füllt frame->rgb und kehrt schnell zurück: keine Sperren,
+ *     kein I/O, kein Warten. Die Laufzeit wird gemessen und begrenzt
+ *     (PluginBudget in HS80_Plugin.h).
+ *   - Neue Felder kommen nur am Ende der Strukturen dazu; size gibt an,
+ *     wie viel davon der Host bzw. das Plugin kennt. Felder nach der
+ *     Version-1-Größe nur lesen, wenn HS80_PLUGIN_HAS_FIELD() sie abdeckt.
+ * ============================================================================
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HS80_PLUGIN_ABI_VERSION 1
+#define HS80_PLUGIN_ENTRY "HS80_GetPlugin"
+
+#ifdef __cplusplus
+#define HS80_PLUGIN_EXTERN_C extern "C"
+#else
+#define HS80_PLUGIN_EXTERN_C
+#endif
+
+#ifdef _WIN32
+#define HS80_PLUGIN_EXPORT HS80_PLUGIN_EXTERN_C __declspec(dllexport)
+#else
+#define HS80_PLUGIN_EXPORT HS80_PLUGIN_EXTERN_C __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Rückgabe von render(); negative Werte = Fehler, der Frame wird verworfen */
+enum {
+    HS80_PLUGIN_RUNNING = 0,
+    HS80_PLUGIN_FINISHED = 1    /* Letzter Frame: wird noch gesendet */
+};
+
+typedef struct HS80PluginFrame {
+    uint32_t size;              /* sizeof(HS80PluginFrame) des Hosts */
+    uint32_t reserved;
+    uint64_t frameIndex;        /* Seit Effekt-Start, läuft beim Tausch weiter */
+    double timeMs;              /* Soll-Zeit des Frames seit Effekt-Start */
+    double frameIntervalMs;
+
+    /* Headset-Zustand (-1 = unbekannt) */
+    int32_t muted;              /* 1 stumm, 0 aktiv */
+    int32_t battery;            /* 0-100 */
+    int32_t charging;           /* 0 unbekannt, 1 lädt, 2 entlädt, 3 voll */
+    int32_t sleeping;           /* 1 schläft, 0 wach */
+
+    /* Ausgabe: Logo RGB, Power RGB, Mic RGB. Beim Aufruf steht hier der
+       zuletzt ausgegebene Frame (auch einer vorherigen Instanz; Anfang: schwarz). */
+    uint8_t rgb[9];
+} HS80PluginFrame;
+
+typedef struct HS80PluginDescriptor {
+    uint32_t abiVersion;        /* HS80_PLUGIN_ABI_VERSION */
+    uint32_t size;              /* sizeof(HS80PluginDescriptor) des Plugins */
+    const char* name;
+
+    /* args: frei wählbarer Text des Aufrufers ("" wenn keiner); nullptr = Fehler */
+    void* (*create)(const char* args);
+    void (*destroy)(void* instance);
+    int32_t (*render)(void* instance, HS80PluginFrame* frame);
+} HS80PluginDescriptor;
+
+typedef const HS80PluginDescriptor* (*HS80PluginEntry)(void);
+
+/* Kleinste gültige Größen (Stand ABI 1.0); spätere 1.x-Hosts prüfen dagegen */
+#define HS80_PLUGIN_DESCRIPTOR_V1_SIZE (offsetof(HS80PluginDescriptor, render) + sizeof(void*))
+#define HS80_PLUGIN_FRAME_V1_SIZE (offsetof(HS80PluginFrame, rgb) + 9)
+
+/* Deckt size (der Gegenseite) das Feld ab? z.B. HS80_PLUGIN_HAS_FIELD(desc, HS80PluginDescriptor, render) */
+#define HS80_PLUGIN_HAS_FIELD(ptr, type, field) \
+    ((ptr)->size >= offsetof(type, field) + sizeof(((type*)0)->field))
+
+#ifdef __cplusplus
+}
+#endif
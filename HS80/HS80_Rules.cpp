@@ -0,0 +1,703 @@
+#include "HS80_Rules.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+namespace HS80 {
+
+RuleTrigger ruleTrigger(EventType type) {
+    switch (type) {
+    case EventType::Mute:     return RuleTrigger::Mute;
+    case EventType::Battery:  return RuleTrigger::Battery;
+    case EventType::Charging: return RuleTrigger::Charging;
+    default:                  return RuleTrigger::None;
+    }
+}
+
+// Zustand -> Tabellen-Koordinaten
+static int muteIndex(int muted) {
+    return muted < 0 ? 0 : (muted == 0 ? 1 : 2);
+}
+
+static int chargingIndex(ChargingState state) {
+    int index = static_cast<int>(state);
+    return index >= 0 && index < 4 ? index : 0;
+}
+
+// Hart an/aus (Warnungen); an in der ersten Hälfte jeder Periode
+class BlinkEffect : public Effect {
+private:
+    RGBColor m_color;
+    uint64_t m_periodUs;
+
+public:
+    BlinkEffect(RGBColor color, uint32_t periodMs)
+        : m_color(color), m_periodUs(periodMs > 0 ? periodMs * 1000ULL : 1000000ULL) {}
+
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override {
+        uint64_t timeUs = static_cast<uint64_t>(frame.timeMs * 1000.0);
+        bool on = (timeUs % m_periodUs) < m_periodUs / 2;
+        zones = LEDZones(on ? m_color : RGBColor(0, 0, 0));
+        return EffectStatus::Running;
+    }
+};
+
+// ============================================================================
+// RuleSet - Parsen
+// ============================================================================
+//
+// Text-Format (ein Befehl pro Zeile, '#' leitet Kommentare ein):
+//
+//   layer <name> <order> <logo|power|mic|all> [alpha|add|multiply|max] [deckkraft]
+//   rule <name> <layer>
+//     muted <yes|no|unknown>...
+//     charging <unknown|charging|discharging|full>...
+//     battery <min> <max>                 Prozent, inklusive
+//     on <mute|battery|charging>...       Event-Regel (braucht hold)
+//     hold <ms>
+//     color <r> <g> <b> | blink <r> <g> <b> <ms> | breathe <r> <g> <b> <ms> | off
+//   end
+//
+// Pro Ebene gewinnt die erste passende Regel in Dateireihenfolge.
+
+RuleSet::RuleSet()
+    : m_cellCount(0)
+{
+    memset(m_batteryBucket, 0, sizeof(m_batteryBucket));
+}
+
+static bool parseColor(std::istream& words, RGBColor& color) {
+    int r = 0, g = 0, b = 0;
+    if (!(words >> r >> g >> b) || r < 0 || r > 255 || g < 0 || g > 255 || b < 0 || b > 255) {
+        return false;
+    }
+    color = RGBColor(static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b));
+    return true;
+}
+
+bool RuleSet::parse(std::istream& input, std::string& error) {
+    *this = RuleSet();
+
+    Rule* current = nullptr;
+    bool hasAction = false;
+    std::string line;
+    int lineNumber = 0;
+
+    auto fail = [&](const std::string& message) {
+        error = "Zeile " + std::to_string(lineNumber) + ": " + message;
+        *this = RuleSet();
+        return false;
+    };
+
+    while (std::getline(input, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+
+        std::istringstream words(line);
+        std::string command;
+        if (!(words >> command)) {
+            continue;
+        }
+
+        if (command == "layer") {
+            if (current) return fail("'end' fehlt vor 'layer'");
+            RuleLayer layer;
+            std::string zone, mode;
+            if (!(words >> layer.name >> layer.order >> zone)) {
+                return fail("Erwartet: layer <name> <order> <logo|power|mic|all> [modus] [deckkraft]");
+            }
+            for (const RuleLayer& other : m_layers) {
+                if (other.name == layer.name) return fail("Ebene '" + layer.name + "' doppelt");
+            }
+            if (m_layers.size() >= RULE_MAX_LAYERS) return fail("Mehr als " + std::to_string(RULE_MAX_LAYERS) + " Ebenen");
+
+            if (zone == "logo")       layer.mask = ZONE_MASK_LOGO;
+            else if (zone == "power") layer.mask = ZONE_MASK_POWER;
+            else if (zone == "mic")   layer.mask = ZONE_MASK_MIC;
+            else if (zone == "all")   layer.mask = ZONE_MASK_ALL;
+            else return fail("Unbekannte Zone '" + zone + "'");
+
+            layer.mode = BlendMode::Alpha;
+            if (words >> mode) {
+                if (mode == "alpha")         layer.mode = BlendMode::Alpha;
+                else if (mode == "add")      layer.mode = BlendMode::Add;
+                else if (mode == "multiply") layer.mode = BlendMode::Multiply;
+                else if (mode == "max")      layer.mode = BlendMode::Max;
+                else return fail("Unbekannter Modus '" + mode + "'");
+            }
+            // Leerraum am Zeilenende (z.B. vor einem entfernten Kommentar) ist keine Deckkraft
+            int opacity = 255;
+            words >> std::ws;
+            if (!words.eof() && (!(words >> opacity) || opacity < 0 || opacity > 255)) {
+                return fail("Deckkraft 0-255 erwartet");
+            }
+            layer.opacity = static_cast<uint8_t>(opacity);
+            m_layers.push_back(layer);
+            continue;
+        }
+
+        if (command == "rule") {
+            if (current) return fail("'end' fehlt vor neuer Regel");
+            std::string name, layerName;
+            if (!(words >> name >> layerName)) return fail("Erwartet: rule <name> <layer>");
+            auto layer = std::find_if(m_layers.begin(), m_layers.end(),
+                [&](const RuleLayer& other) { return other.name == layerName; });
+            if (layer == m_layers.end()) return fail("Ebene '" + layerName + "' nicht definiert");
+            if (m_rules.size() >= RULE_NONE) return fail("Zu viele Regeln");
+
+            Rule rule;
+            rule.name = name;
+            rule.layer = static_cast<uint16_t>(layer - m_layers.begin());
+            rule.muteMask = 0x07;
+            rule.chargingMask = 0x0F;
+            rule.triggerMask = 0;
+            rule.batteryMin = -1;
+            rule.batteryMax = -1;
+            rule.action.type = RuleActionType::Off;
+            rule.action.color = RGBColor(0, 0, 0);
+            rule.action.periodMs = 0;
+            rule.action.holdMs = 0;
+            m_rules.push_back(rule);
+            current = &m_rules.back();
+            hasAction = false;
+            continue;
+        }
+
+        if (!current) return fail("'" + command + "' ausserhalb einer Regel");
+
+        if (command == "muted") {
+            current->muteMask = 0;
+            std::string word;
+            while (words >> word) {
+                if (word == "unknown")  current->muteMask |= 1 << 0;
+                else if (word == "no")  current->muteMask |= 1 << 1;
+                else if (word == "yes") current->muteMask |= 1 << 2;
+                else return fail("Erwartet: muted <yes|no|unknown>...");
+            }
+            if (current->muteMask == 0) return fail("Erwartet: muted <yes|no|unknown>...");
+        } else if (command == "charging") {
+            current->chargingMask = 0;
+            std::string word;
+            while (words >> word) {
+                if (word == "unknown")          current->chargingMask |= 1 << static_cast<int>(ChargingState::Unknown);
+                else if (word == "charging")    current->chargingMask |= 1 << static_cast<int>(ChargingState::Charging);
+                else if (word == "discharging") current->chargingMask |= 1 << static_cast<int>(ChargingState::Discharging);
+                else if (word == "full")        current->chargingMask |= 1 << static_cast<int>(ChargingState::FullyCharged);
+                else return fail("Erwartet: charging <unknown|charging|discharging|full>...");
+            }
+            if (current->chargingMask == 0) return fail("Erwartet: charging <unknown|charging|discharging|full>...");
+        } else if (command == "battery") {
+            if (!(words >> current->batteryMin >> current->batteryMax) ||
+                current->batteryMin < 0 || current->batteryMax > 100 || current->batteryMin > current->batteryMax) {
+                return fail("Akku-Bereich 0-100 erwartet (min <= max)");
+            }
+        } else if (command == "on") {
+            std::string word;
+            while (words >> word) {
+                if (word == "mute")          current->triggerMask |= 1 << static_cast<int>(RuleTrigger::Mute);
+                else if (word == "battery")  current->triggerMask |= 1 << static_cast<int>(RuleTrigger::Battery);
+                else if (word == "charging") current->triggerMask |= 1 << static_cast<int>(RuleTrigger::Charging);
+                else return fail("Erwartet: on <mute|battery|charging>...");
+            }
+            if (current->triggerMask == 0) return fail("Erwartet: on <mute|battery|charging>...");
+        } else if (command == "hold") {
+            if (!(words >> current->action.holdMs) || current->action.holdMs == 0) return fail("Ungueltige Haltezeit");
+        } else if (command == "color" || command == "blink" || command == "breathe" || command == "off") {
+            if (hasAction) return fail("Mehr als eine Aktion in Regel '" + current->name + "'");
+            hasAction = true;
+            RuleAction& action = current->action;
+            if (command == "off") {
+                action.type = RuleActionType::Off;
+            } else {
+                if (!parseColor(words, action.color)) return fail("RGB 0-255 erwartet");
+                if (command == "color") {
+                    action.type = RuleActionType::Color;
+                } else {
+                    action.type = command == "blink" ? RuleActionType::Blink : RuleActionType::Breathe;
+                    if (!(words >> action.periodMs) || action.periodMs == 0) return fail("Periode in ms erwartet");
+                }
+            }
+        } else if (command == "end") {
+            if (!hasAction) return fail("Regel '" + current->name + "' ohne Aktion");
+            if (current->triggerMask != 0 && current->action.holdMs == 0) return fail("Event-Regel braucht 'hold'");
+            if (current->triggerMask == 0 && current->action.holdMs != 0) return fail("'hold' nur mit 'on'");
+            current = nullptr;
+        } else {
+            return fail("Unbekannter Befehl '" + command + "'");
+        }
+    }
+
+    if (current) {
+        lineNumber++;
+        return fail("'end' fehlt am Dateiende");
+    }
+    return compile(error);
+}
+
+bool RuleSet::loadFile(const std::string& path, std::string& error) {
+    std::ifstream input(path);
+    if (!input.is_open()) {
+        error = "Kann " + path + " nicht oeffnen";
+        *this = RuleSet();
+        return false;
+    }
+    return parse(input, error);
+}
+
+// ============================================================================
+// RuleSet - Kompilieren
+// ============================================================================
+
+bool RuleSet::matches(const Rule& rule, int mute, int charging, int batteryLevel) {
+    if (!(rule.muteMask & (1 << mute)) || !(rule.chargingMask & (1 << charging))) {
+        return false;
+    }
+    if (rule.batteryMin >= 0) {
+        return batteryLevel >= rule.batteryMin && batteryLevel <= rule.batteryMax;
+    }
+    return true;
+}
+
+bool RuleSet::compile(std::string& error) {
+    // Akku-Bereiche: eine Grenze an jedem min und max+1 aller Regeln.
+    // Bereich 0 = unbekannt, danach lückenlos 0-100
+    bool cut[102] = {};
+    for (const Rule& rule : m_rules) {
+        if (rule.batteryMin >= 0) {
+            cut[rule.batteryMin] = true;
+            cut[rule.batteryMax + 1] = true;
+        }
+    }
+    m_bucketLevel.assign(1, -1);
+    m_batteryBucket[0] = 0;
+    for (int level = 0; level <= 100; level++) {
+        if (level == 0 || cut[level]) {
+            m_bucketLevel.push_back(level);
+        }
+        m_batteryBucket[level + 1] = static_cast<uint8_t>(m_bucketLevel.size() - 1);
+    }
+
+    const size_t buckets = m_bucketLevel.size();
+    const size_t layers = m_layers.size();
+    m_cellCount = 3 * 4 * buckets;
+    m_stateTable.assign(m_cellCount * layers, RULE_NONE);
+    m_eventTable.assign(static_cast<size_t>(RuleTrigger::Count) * m_cellCount * layers, RULE_NONE);
+
+    for (size_t cell = 0; cell < m_cellCount; cell++) {
+        int mute = static_cast<int>(cell / (4 * buckets));
+        int charging = static_cast<int>((cell / buckets) % 4);
+        int level = m_bucketLevel[cell % buckets];
+
+        for (size_t r = 0; r < m_rules.size(); r++) {
+            const Rule& rule = m_rules[r];
+            if (!matches(rule, mute, charging, level)) {
+                continue;
+            }
+            if (rule.triggerMask == 0) {
+                uint16_t& slot = m_stateTable[cell * layers + rule.layer];
+                if (slot == RULE_NONE) slot = static_cast<uint16_t>(r);
+                continue;
+            }
+            for (int trigger = 1; trigger < static_cast<int>(RuleTrigger::Count); trigger++) {
+                if (rule.triggerMask & (1 << trigger)) {
+                    uint16_t& slot = m_eventTable[(trigger * m_cellCount + cell) * layers + rule.layer];
+                    if (slot == RULE_NONE) slot = static_cast<uint16_t>(r);
+                }
+            }
+        }
+    }
+
+    error.clear();
+    return true;
+}
+
+size_t RuleSet::cellIndex(const HeadsetState& state) const {
+    int level = state.batteryLevel < 0 ? -1 : std::min(state.batteryLevel, 100);
+    size_t buckets = m_bucketLevel.size();
+    return (muteIndex(state.muted) * 4 + chargingIndex(state.charging)) * buckets + m_batteryBucket[level + 1];
+}
+
+void RuleSet::resolveLinear(const HeadsetState& state, RuleTrigger trigger, uint16_t* stateOut, uint16_t* eventOut) const {
+    int mute = muteIndex(state.muted);
+    int charging = chargingIndex(state.charging);
+    int level = state.batteryLevel < 0 ? -1 : std::min(state.batteryLevel, 100);
+
+    std::fill(stateOut, stateOut + m_layers.size(), RULE_NONE);
+    std::fill(eventOut, eventOut + m_layers.size(), RULE_NONE);
+    for (size_t r = 0; r < m_rules.size(); r++) {
+        const Rule& rule = m_rules[r];
+        if (!matches(rule, mute, charging, level)) {
+            continue;
+        }
+        if (rule.triggerMask == 0) {
+            if (stateOut[rule.layer] == RULE_NONE) stateOut[rule.layer] = static_cast<uint16_t>(r);
+        } else if (rule.triggerMask & (1 << static_cast<int>(trigger))) {
+            if (eventOut[rule.layer] == RULE_NONE) eventOut[rule.layer] = static_cast<uint16_t>(r);
+        }
+    }
+}
+
+// ============================================================================
+// RuleEngine
+// ============================================================================
+
+RuleEngine::RuleEngine(Compositor& compositor)
+    : m_compositor(compositor)
+    , m_rules(std::make_shared<RuleSet>())
+    , m_thread(nullptr)
+    , m_stopEvent(nullptr)
+    , m_wakeEvent(nullptr)
+    , m_pollMs(500)
+    , m_watchSize(0)
+    , m_statEvents(0)
+    , m_statLayerUpdates(0)
+    , m_statHolds(0)
+    , m_statReloads(0)
+    , m_statReloadErrors(0)
+{
+    InitializeCriticalSection(&m_lock);
+    QueryPerformanceFrequency(&m_qpcFrequency);
+    memset(&m_watchTime, 0, sizeof(m_watchTime));
+}
+
+RuleEngine::~RuleEngine() {
+    stop();
+    EnterCriticalSection(&m_lock);
+    clearLayersLocked();
+    LeaveCriticalSection(&m_lock);
+    DeleteCriticalSection(&m_lock);
+}
+
+void RuleEngine::clearLayersLocked() {
+    for (const LayerState& layer : m_layerStates) {
+        m_compositor.removeLayer(layer.layerId);
+    }
+    m_layerStates.clear();
+}
+
+void RuleEngine::setRules(std::shared_ptr<const RuleSet> rules) {
+    if (!rules) {
+        rules = std::make_shared<RuleSet>();
+    }
+
+    // Neue Ebenen zuerst anlegen (unsichtbar), dann die alten entfernen
+    std::vector<LayerState> layerStates;
+    for (size_t i = 0; i < rules->layerCount(); i++) {
+        const RuleLayer& info = rules->layer(i);
+        LayerState layer;
+        layer.layerId = m_compositor.addLayer(info.order, info.mode, info.mask);
+        layer.shown = RULE_NONE;
+        layer.stateRule = RULE_NONE;
+        layer.holdRule = RULE_NONE;
+        layer.holdUntil = 0;
+        m_compositor.setLayerOpacity(layer.layerId, info.opacity);
+        m_compositor.setLayerVisible(layer.layerId, false);
+        layerStates.push_back(layer);
+    }
+
+    std::vector<std::shared_ptr<Effect>> effects(rules->ruleCount());
+    for (size_t r = 0; r < rules->ruleCount(); r++) {
+        const RuleAction& action = rules->action(static_cast<uint16_t>(r));
+        if (action.type == RuleActionType::Blink) {
+            effects[r] = std::make_shared<BlinkEffect>(action.color, action.periodMs);
+        } else if (action.type == RuleActionType::Breathe) {
+            effects[r] = std::make_shared<PulseEffect>(action.color, static_cast<int>(action.periodMs), 0);
+        }
+    }
+
+    EnterCriticalSection(&m_lock);
+    clearLayersLocked();
+    m_rules = rules;
+    m_layerStates.swap(layerStates);
+    m_effects.swap(effects);
+    evaluateLocked(RuleTrigger::None);
+    LeaveCriticalSection(&m_lock);
+}
+
+bool RuleEngine::loadFile(const std::string& path, std::string& error) {
+    auto rules = std::make_shared<RuleSet>();
+    if (!rules->loadFile(path, error)) {
+        return false;
+    }
+    setRules(rules);
+    return true;
+}
+
+std::shared_ptr<const RuleSet> RuleEngine::rules() const {
+    EnterCriticalSection(&m_lock);
+    std::shared_ptr<const RuleSet> rules = m_rules;
+    LeaveCriticalSection(&m_lock);
+    return rules;
+}
+
+// Nur bei Wechsel der Regel wird der Compositor angefasst
+void RuleEngine::showLocked(LayerState& layer, uint16_t rule) {
+    if (layer.shown == rule) {
+        return;
+    }
+    layer.shown = rule;
+    m_statLayerUpdates++;
+
+    if (rule == RULE_NONE || m_rules->action(rule).type == RuleActionType::Off) {
+        m_compositor.setLayerVisible(layer.layerId, false);
+        m_compositor.setLayerSource(layer.layerId, nullptr);
+        return;
+    }
+    m_compositor.setLayerSource(layer.layerId, m_effects[rule]);
+    m_compositor.setLayerColor(layer.layerId, m_rules->action(rule).color);
+    m_compositor.setLayerVisible(layer.layerId, true);
+}
+
+void RuleEngine::evaluateLocked(RuleTrigger trigger) {
+    const RuleSet& rules = *m_rules;
+    if (rules.layerCount() == 0) {
+        return;
+    }
+
+    size_t cell = rules.cellIndex(m_state.snapshot());
+    const uint16_t* stateRow = rules.stateRow(cell);
+    const uint16_t* eventRow = trigger != RuleTrigger::None ? rules.eventRow(trigger, cell) : nullptr;
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    bool holdStarted = false;
+
+    for (size_t i = 0; i < m_layerStates.size(); i++) {
+        LayerState& layer = m_layerStates[i];
+        layer.stateRule = stateRow[i];
+        if (eventRow && eventRow[i] != RULE_NONE) {
+            layer.holdRule = eventRow[i];
+            layer.holdUntil = now.QuadPart + rules.action(eventRow[i]).holdMs * m_qpcFrequency.QuadPart / 1000;
+            m_statHolds++;
+            holdStarted = true;
+        }
+        if (layer.holdRule != RULE_NONE && now.QuadPart >= layer.holdUntil) {
+            layer.holdRule = RULE_NONE;
+        }
+        showLocked(layer, layer.holdRule != RULE_NONE ? layer.holdRule : layer.stateRule);
+    }
+
+    // Thread soll seine Wartezeit auf den neuen Ablauf verkürzen
+    if (holdStarted && m_wakeEvent) {
+        SetEvent(m_wakeEvent);
+    }
+}
+
+DWORD RuleEngine::expireLocked() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    DWORD next = INFINITE;
+
+    for (LayerState& layer : m_layerStates) {
+        if (layer.holdRule == RULE_NONE) {
+            continue;
+        }
+        if (now.QuadPart >= layer.holdUntil) {
+            layer.holdRule = RULE_NONE;
+            showLocked(layer, layer.stateRule);
+            continue;
+        }
+        int64_t remainingMs = ((layer.holdUntil - now.QuadPart) * 1000 + m_qpcFrequency.QuadPart - 1) / m_qpcFrequency.QuadPart;
+        next = std::min(next, static_cast<DWORD>(remainingMs));
+    }
+    return next;
+}
+
+void RuleEngine::onEvent(const HeadsetEvent& event) {
+    RuleTrigger trigger = ruleTrigger(event.getActualEventType());
+    if (trigger == RuleTrigger::None) {
+        return;
+    }
+
+    LARGE_INTEGER start, end;
+    QueryPerformanceCounter(&start);
+
+    EnterCriticalSection(&m_lock);
+    m_state.applyEvent(event);
+    evaluateLocked(trigger);
+    m_statEvents++;
+    LeaveCriticalSection(&m_lock);
+
+    QueryPerformanceCounter(&end);
+    m_evalTime.record(static_cast<uint64_t>((end.QuadPart - start.QuadPart) * 1000000000LL / m_qpcFrequency.QuadPart));
+}
+
+void RuleEngine::setState(const HeadsetState& state) {
+    EnterCriticalSection(&m_lock);
+    m_state.reset();
+    if (state.muted >= 0) {
+        m_state.applyMuted(state.muted == 1);
+    }
+    if (state.sleeping >= 0) {
+        m_state.applySleeping(state.sleeping == 1);
+    }
+    BatteryStatus battery;
+    battery.valid = true;
+    battery.level = state.batteryLevel;
+    battery.levelRaw = state.batteryLevelRaw;
+    battery.state = state.charging;
+    m_state.applyBattery(battery);
+    evaluateLocked(RuleTrigger::None);
+    LeaveCriticalSection(&m_lock);
+}
+
+// ============================================================================
+// Hintergrund-Thread
+// ============================================================================
+
+bool RuleEngine::start(const std::string& watchPath, DWORD pollMs) {
+    if (m_thread) {
+        return false;
+    }
+
+    m_watchPath = watchPath;
+    m_pollMs = pollMs > 0 ? pollMs : 1;
+    if (!m_watchPath.empty()) {
+        memset(&m_watchTime, 0, sizeof(m_watchTime));
+        m_watchSize = 0;
+        watchedFileChanged();   // Stand merken, nicht sofort neu laden
+    }
+
+    m_stopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    m_wakeEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!m_stopEvent || !m_wakeEvent) {
+        stop();
+        return false;
+    }
+
+    m_thread = CreateThread(nullptr, 0, RuleThreadProc, this, 0, nullptr);
+    if (!m_thread) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void RuleEngine::stop() {
+    if (m_thread) {
+        SetEvent(m_stopEvent);
+        WaitForSingleObject(m_thread, INFINITE);
+        CloseHandle(m_thread);
+        m_thread = nullptr;
+    }
+
+    EnterCriticalSection(&m_lock);
+    if (m_stopEvent) {
+        CloseHandle(m_stopEvent);
+        m_stopEvent = nullptr;
+    }
+    if (m_wakeEvent) {
+        CloseHandle(m_wakeEvent);
+        m_wakeEvent = nullptr;
+    }
+    LeaveCriticalSection(&m_lock);
+}
+
+bool RuleEngine::watchedFileChanged() {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(m_watchPath.c_str(), GetFileExInfoStandard, &data)) {
+        return false;
+    }
+    bool changed = data.ftLastWriteTime.dwLowDateTime != m_watchTime.dwLowDateTime ||
+                   data.ftLastWriteTime.dwHighDateTime != m_watchTime.dwHighDateTime ||
+                   data.nFileSizeLow != m_watchSize;
+    m_watchTime = data.ftLastWriteTime;
+    m_watchSize = data.nFileSizeLow;
+    return changed;
+}
+
+void RuleEngine::reloadWatched() {
+    auto rules = std::make_shared<RuleSet>();
+    std::string error;
+    if (!rules->loadFile(m_watchPath, error)) {
+        // Aktiver Regelsatz bleibt stehen
+        std::cerr << "[RULES] " << m_watchPath << " nicht geladen: " << error << std::endl;
+        EnterCriticalSection(&m_lock);
+        m_lastError = error;
+        m_statReloadErrors++;
+        LeaveCriticalSection(&m_lock);
+        return;
+    }
+
+    setRules(rules);
+    std::cout << "[RULES] " << m_watchPath << " neu geladen (" << rules->ruleCount() << " Regeln, "
+              << rules->cellCount() << " Zellen)" << std::endl;
+    EnterCriticalSection(&m_lock);
+    m_lastError.clear();
+    m_statReloads++;
+    LeaveCriticalSection(&m_lock);
+}
+
+DWORD WINAPI RuleEngine::RuleThreadProc(LPVOID param) {
+    static_cast<RuleEngine*>(param)->ruleLoop();
+    return 0;
+}
+
+void RuleEngine::ruleLoop() {
+    HANDLE handles[2] = { m_stopEvent, m_wakeEvent };
+    ULONGLONG nextPoll = GetTickCount64() + m_pollMs;
+
+    while (true) {
+        EnterCriticalSection(&m_lock);
+        DWORD timeout = expireLocked();
+        LeaveCriticalSection(&m_lock);
+
+        if (!m_watchPath.empty()) {
+            ULONGLONG now = GetTickCount64();
+            DWORD untilPoll = nextPoll > now ? static_cast<DWORD>(nextPoll - now) : 0;
+            timeout = std::min(timeout, untilPoll);
+        }
+
+        if (WaitForMultipleObjects(2, handles, FALSE, timeout) == WAIT_OBJECT_0) {
+            break;
+        }
+
+        if (!m_watchPath.empty() && GetTickCount64() >= nextPoll) {
+            nextPoll = GetTickCount64() + m_pollMs;
+            if (watchedFileChanged()) {
+                reloadWatched();
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Statistik
+// ============================================================================
+
+std::string RuleEngine::lastError() const {
+    EnterCriticalSection(&m_lock);
+    std::string error = m_lastError;
+    LeaveCriticalSection(&m_lock);
+    return error;
+}
+
+RuleEngineStats RuleEngine::getStats() const {
+    RuleEngineStats stats;
+    EnterCriticalSection(&m_lock);
+    stats.events = m_statEvents;
+    stats.layerUpdates = m_statLayerUpdates;
+    stats.holdsStarted = m_statHolds;
+    stats.reloads = m_statReloads;
+    stats.reloadErrors = m_statReloadErrors;
+    LeaveCriticalSection(&m_lock);
+    stats.evalTime = m_evalTime.snapshot();
+    return stats;
+}
+
+void RuleEngine::resetStats() {
+    EnterCriticalSection(&m_lock);
+    m_statEvents = 0;
+    m_statLayerUpdates = 0;
+    m_statHolds = 0;
+    m_statReloads = 0;
+    m_statReloadErrors = 0;
+    LeaveCriticalSection(&m_lock);
+    m_evalTime.reset();
+}
+
+} // namespace HS80
@@ -0,0 +1,208 @@
+#pragma once
+
+#include "HS80_Compositor.h"
+#include <string>
+#include <istream>
+
+// ============================================================================
+// HS80 Rules - Deklarative Regeln Event/Zustand -> Beleuchtung
+// ============================================================================
+//
+// Statt pro Fall einen Callback zu schreiben ("Akku < 15% -> Power-LED rot
+// blinken", "lädt -> grünes Atmen"), beschreibt eine Textdatei Regeln auf
+// Event-Typ, Wertebereiche und Zustandskombinationen. Jede Regel steuert eine
+// benannte Ebene (layer) eines Compositors.
+//
+// Beim Laden wird der Regelsatz einmal in flache Entscheidungstabellen
+// übersetzt. Der Zustand wird dafür quantisiert: Mute (3 Werte) x Charging
+// (4 Werte) x Akku-Bereich (Grenzen aller battery-Bedingungen, höchstens 2 pro
+// Regel). Pro Zelle und Ebene steht die erste passende Regel fest - ein Event
+// kostet einen Tabellen-Lookup plus eine Schleife über die Ebenen, unabhängig
+// von der Zahl der Regeln.
+//
+// Zwei Arten von Regeln:
+//   Zustandsregeln   gelten, solange der Zustand passt
+//   Event-Regeln     ("on <typ>") feuern bei jedem Event dieses Typs und
+//                    überdecken die Ebene für "hold" Millisekunden
+//
+// Text-Format siehe RuleSet::parse() bzw. LIBRARY_README.md. Die Datei kann im
+// laufenden Betrieb neu geladen werden (RuleEngine::start mit Dateipfad); ein
+// fehlerhafter Regelsatz ersetzt den aktiven nicht.
+// ============================================================================
+
+namespace HS80 {
+
+constexpr size_t RULE_MAX_LAYERS = 16;
+constexpr uint16_t RULE_NONE = 0xFFFF;          // Keine Regel -> Ebene ausgeblendet
+
+// Auslöser einer Auswertung (Tabellen-Dimension der Event-Regeln)
+enum class RuleTrigger : uint8_t {
+    None = 0,           // Zustand gesetzt/Regeln neu geladen
+    Mute = 1,
+    Battery = 2,
+    Charging = 3,
+    Count = 4
+};
+
+RuleTrigger ruleTrigger(EventType type);
+
+enum class RuleActionType : uint8_t {
+    Off,                // Ebene ausblenden
+    Color,
+    Blink,              // Hart an/aus, periodMs pro Zyklus
+    Breathe             // PulseEffect
+};
+
+struct RuleAction {
+    RuleActionType type;
+    RGBColor color;
+    uint32_t periodMs;
+    uint32_t holdMs;    // Nur Event-Regeln
+};
+
+struct RuleLayer {
+    std::string name;
+    int order;
+    BlendMode mode;
+    uint8_t mask;
+    uint8_t opacity;
+};
+
+// Kompilierter Regelsatz (unveränderlich nach dem Laden)
+class RuleSet {
+private:
+    // Bedingungen einer Regel (nur während des Kompilierens)
+    struct Rule {
+        std::string name;
+        uint16_t layer;
+        uint8_t muteMask;           // Bit 0 unbekannt, 1 aktiv, 2 stumm
+        uint8_t chargingMask;       // Bits nach ChargingState
+        uint8_t triggerMask;        // Bits nach RuleTrigger, 0 = Zustandsregel
+        int batteryMin;             // -1 = beliebig (auch unbekannt)
+        int batteryMax;
+        RuleAction action;
+    };
+
+    std::vector<RuleLayer> m_layers;
+    std::vector<Rule> m_rules;              // Dateireihenfolge = Priorität
+    uint8_t m_batteryBucket[102];           // Akku -1..100 -> Bereich
+    std::vector<int> m_bucketLevel;         // Kleinster Akkuwert pro Bereich (-1 = unbekannt)
+    size_t m_cellCount;
+    std::vector<uint16_t> m_stateTable;     // [Zelle][Ebene]
+    std::vector<uint16_t> m_eventTable;     // [Trigger][Zelle][Ebene]
+
+    bool compile(std::string& error);
+    static bool matches(const Rule& rule, int mute, int charging, int batteryLevel);
+
+public:
+    RuleSet();
+
+    // Text parsen und kompilieren; bei Fehler bleibt der Regelsatz leer
+    bool parse(std::istream& input, std::string& error);
+    bool loadFile(const std::string& path, std::string& error);
+
+    size_t layerCount() const { return m_layers.size(); }
+    const RuleLayer& layer(size_t i) const { return m_layers[i]; }
+    size_t ruleCount() const { return m_rules.size(); }
+    const std::string& ruleName(uint16_t rule) const { return m_rules[rule].name; }
+    const RuleAction& action(uint16_t rule) const { return m_rules[rule].action; }
+    size_t cellCount() const { return m_cellCount; }
+    size_t tableBytes() const { return (m_stateTable.size() + m_eventTable.size()) * sizeof(uint16_t); }
+
+    // Zelle des Zustands (konstante Zeit)
+    size_t cellIndex(const HeadsetState& state) const;
+
+    // Pro Ebene: gültige Zustandsregel bzw. gefeuerte Event-Regel (RULE_NONE)
+    const uint16_t* stateRow(size_t cell) const { return &m_stateTable[cell * m_layers.size()]; }
+    const uint16_t* eventRow(RuleTrigger trigger, size_t cell) const {
+        return &m_eventTable[(static_cast<size_t>(trigger) * m_cellCount + cell) * m_layers.size()];
+    }
+
+    // Referenz ohne Tabelle: alle Regeln der Reihe nach prüfen (Benchmark/Abgleich)
+    void resolveLinear(const HeadsetState& state, RuleTrigger trigger, uint16_t* stateOut, uint16_t* eventOut) const;
+};
+
+struct RuleEngineStats {
+    uint64_t events;            // onEvent()-Aufrufe mit bekanntem Typ
+    uint64_t layerUpdates;      // Tatsächlich geänderte Ebenen
+    uint64_t holdsStarted;      // Gefeuerte Event-Regeln
+    uint64_t reloads;
+    uint64_t reloadErrors;
+    LatencySnapshot evalTime;   // Zustand -> Ebenen aktualisiert
+};
+
+// Bindet einen Regelsatz an einen Compositor und wertet Events aus
+class RuleEngine {
+private:
+    struct LayerState {
+        int layerId;                // Compositor-Ebene
+        uint16_t shown;             // Angezeigte Regel
+        uint16_t stateRule;         // Aktuell gültige Zustandsregel
+        uint16_t holdRule;          // Laufende Event-Regel
+        int64_t holdUntil;          // QPC-Ticks
+    };
+
+    Compositor& m_compositor;
+    mutable CRITICAL_SECTION m_lock;
+    std::shared_ptr<const RuleSet> m_rules;
+    std::vector<LayerState> m_layerStates;
+    std::vector<std::shared_ptr<Effect>> m_effects;     // Pro Regel (Blink/Breathe)
+    HeadsetStateCache m_state;
+
+    // Hintergrund-Thread: Hold-Ablauf und Datei-Überwachung
+    HANDLE m_thread;
+    HANDLE m_stopEvent;
+    HANDLE m_wakeEvent;
+    std::string m_watchPath;
+    DWORD m_pollMs;
+    FILETIME m_watchTime;
+    DWORD m_watchSize;
+    std::string m_lastError;
+
+    LARGE_INTEGER m_qpcFrequency;
+    uint64_t m_statEvents;
+    uint64_t m_statLayerUpdates;
+    uint64_t m_statHolds;
+    uint64_t m_statReloads;
+    uint64_t m_statReloadErrors;
+    LatencyHistogram m_evalTime;
+
+    void clearLayersLocked();
+    void showLocked(LayerState& layer, uint16_t rule);
+    void evaluateLocked(RuleTrigger trigger);
+    DWORD expireLocked();                   // Liefert ms bis zum nächsten Ablauf
+    bool watchedFileChanged();
+    void reloadWatched();
+
+    static DWORD WINAPI RuleThreadProc(LPVOID param);
+    void ruleLoop();
+
+public:
+    explicit RuleEngine(Compositor& compositor);
+    ~RuleEngine();
+
+    RuleEngine(const RuleEngine&) = delete;
+    RuleEngine& operator=(const RuleEngine&) = delete;
+
+    // Legt die Ebenen des Regelsatzes an (alte werden entfernt) und wertet aus
+    void setRules(std::shared_ptr<const RuleSet> rules);
+    bool loadFile(const std::string& path, std::string& error);
+    std::shared_ptr<const RuleSet> rules() const;
+
+    // Aus dem Event-Callback (oder EventMonitor-Reflex)
+    void onEvent(const HeadsetEvent& event);
+    // Ausgangszustand (z.B. HeadsetManager::getState()), ohne Event-Regeln
+    void setState(const HeadsetState& state);
+    HeadsetState getState() const { return m_state.snapshot(); }
+
+    // Thread für Hold-Ablauf; mit watchPath zusätzlich Hot-Reload der Datei
+    bool start(const std::string& watchPath = "", DWORD pollMs = 500);
+    void stop();
+    bool isRunning() const { return m_thread != nullptr; }
+
+    std::string lastError() const;
+    RuleEngineStats getStats() const;
+    void resetStats();
+};
+
+} // namespace HS80
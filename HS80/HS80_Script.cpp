@@ -0,0 +1,523 @@
+#include "HS80_Script.h"
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <cmath>
+#include <cctype>
+
+namespace HS80 {
+
+// ============================================================================
+// Befehle
+// ============================================================================
+
+// Interpreter-Schleife; der switch steht direkt in der Schleife (ein
+// indirekter Sprung pro Befehl, kein Funktionsaufruf)
+static void executeCode(const ScriptInstruction* code, size_t count, float* regs) {
+    for (size_t i = 0; i < count; i++) {
+        const ScriptInstruction& instruction = code[i];
+        const float a = regs[instruction.a];
+        const float b = regs[instruction.b];
+        const float c = regs[instruction.c];
+        float result = 0.0f;
+        switch (instruction.op) {
+        case ScriptOp::Move:         result = a; break;
+        case ScriptOp::Add:          result = a + b; break;
+        case ScriptOp::Sub:          result = a - b; break;
+        case ScriptOp::Mul:          result = a * b; break;
+        case ScriptOp::Div:          result = b != 0.0f ? a / b : 0.0f; break;
+        case ScriptOp::Mod:          result = b != 0.0f ? a - b * floorf(a / b) : 0.0f; break;
+        case ScriptOp::Neg:          result = -a; break;
+        case ScriptOp::Less:         result = a < b ? 1.0f : 0.0f; break;
+        case ScriptOp::LessEqual:    result = a <= b ? 1.0f : 0.0f; break;
+        case ScriptOp::Greater:      result = a > b ? 1.0f : 0.0f; break;
+        case ScriptOp::GreaterEqual: result = a >= b ? 1.0f : 0.0f; break;
+        case ScriptOp::Equal:        result = a == b ? 1.0f : 0.0f; break;
+        case ScriptOp::NotEqual:     result = a != b ? 1.0f : 0.0f; break;
+        case ScriptOp::And:          result = a != 0.0f && b != 0.0f ? 1.0f : 0.0f; break;
+        case ScriptOp::Or:           result = a != 0.0f || b != 0.0f ? 1.0f : 0.0f; break;
+        case ScriptOp::Not:          result = a == 0.0f ? 1.0f : 0.0f; break;
+        case ScriptOp::Select:       result = a != 0.0f ? b : c; break;
+        case ScriptOp::Min:          result = a < b ? a : b; break;
+        case ScriptOp::Max:          result = a > b ? a : b; break;
+        case ScriptOp::Abs:          result = fabsf(a); break;
+        case ScriptOp::Floor:        result = floorf(a); break;
+        case ScriptOp::Frac:         result = a - floorf(a); break;
+        case ScriptOp::Sqrt:         result = a > 0.0f ? sqrtf(a) : 0.0f; break;
+        case ScriptOp::Sin:          result = sinf(a); break;
+        case ScriptOp::Cos:          result = cosf(a); break;
+        case ScriptOp::Step:         result = b >= a ? 1.0f : 0.0f; break;
+        case ScriptOp::Wave: {
+            float f = a - floorf(a);
+            result = f < 0.5f ? 2.0f * f : 2.0f - 2.0f * f;
+            break;
+        }
+        case ScriptOp::Noise: {
+            // Integer-Hash des ganzzahligen Anteils
+            float whole = floorf(a);
+            uint32_t x = fabsf(whole) < 2.0e9f ? static_cast<uint32_t>(static_cast<int32_t>(whole)) : 0u;
+            x ^= x >> 16; x *= 0x7FEB352Du;
+            x ^= x >> 15; x *= 0x846CA68Bu;
+            x ^= x >> 16;
+            result = (x >> 8) * (1.0f / 16777216.0f);
+            break;
+        }
+        case ScriptOp::Clamp:        result = a < b ? b : (a > c ? c : a); break;
+        case ScriptOp::Mix:          result = a + (b - a) * c; break;
+        case ScriptOp::Smooth: {
+            if (b == a) {
+                result = c >= b ? 1.0f : 0.0f;
+                break;
+            }
+            float t = (c - a) / (b - a);
+            t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+            result = t * t * (3.0f - 2.0f * t);
+            break;
+        }
+        }
+        regs[instruction.dst] = result;
+    }
+}
+
+float ScriptProgram::execute(ScriptOp op, float a, float b, float c) {
+    float regs[4] = { a, b, c, 0.0f };
+    ScriptInstruction instruction = { op, 3, 0, 1, 2 };
+    executeCode(&instruction, 1, regs);
+    return regs[3];
+}
+
+// ============================================================================
+// Compiler
+// ============================================================================
+//
+// Rekursiver Abstieg, Code wird direkt beim Parsen erzeugt. Jeder Wert ist
+// entweder eine Konstante (noch ohne Register) oder ein Register; "zone" markiert
+// Werte, die sich pro Zone ändern und daher in den Zonen-Code gehören.
+
+namespace {
+
+struct Operand {
+    bool constant;
+    float value;
+    uint8_t reg;
+    bool perZone;
+};
+
+struct Function {
+    const char* name;
+    int arity;
+    ScriptOp op;
+};
+
+const Function FUNCTIONS[] = {
+    { "sin", 1, ScriptOp::Sin },     { "cos", 1, ScriptOp::Cos },
+    { "abs", 1, ScriptOp::Abs },     { "floor", 1, ScriptOp::Floor },
+    { "frac", 1, ScriptOp::Frac },   { "sqrt", 1, ScriptOp::Sqrt },
+    { "wave", 1, ScriptOp::Wave },   { "noise", 1, ScriptOp::Noise },
+    { "min", 2, ScriptOp::Min },     { "max", 2, ScriptOp::Max },
+    { "step", 2, ScriptOp::Step },
+    { "clamp", 3, ScriptOp::Clamp }, { "mix", 3, ScriptOp::Mix },
+    { "smooth", 3, ScriptOp::Smooth },
+};
+
+class ScriptCompiler {
+private:
+    std::vector<ScriptInstruction>& m_frameCode;
+    std::vector<ScriptInstruction>& m_zoneCode;
+    std::vector<float>& m_registers;
+    std::map<std::string, Operand> m_names;
+    std::map<float, uint8_t> m_constants;
+
+    std::string m_line;
+    size_t m_pos;
+    std::string m_error;
+    bool m_assigned[3];             // r, g, b
+
+    bool fail(const std::string& message) {
+        if (m_error.empty()) m_error = message;
+        return false;
+    }
+
+    void skipSpace() {
+        while (m_pos < m_line.size() && isspace(static_cast<unsigned char>(m_line[m_pos]))) m_pos++;
+    }
+
+    bool accept(const char* token) {
+        skipSpace();
+        size_t length = strlen(token);
+        if (m_line.compare(m_pos, length, token) != 0) return false;
+        // "<" darf nicht den Anfang von "<=" schlucken
+        if (length == 1 && m_pos + 1 < m_line.size() && m_line[m_pos + 1] == '=' && strchr("<>=!", token[0])) return false;
+        m_pos += length;
+        return true;
+    }
+
+    bool identifier(std::string& name) {
+        skipSpace();
+        size_t start = m_pos;
+        if (m_pos < m_line.size() && (isalpha(static_cast<unsigned char>(m_line[m_pos])) || m_line[m_pos] == '_')) {
+            while (m_pos < m_line.size() && (isalnum(static_cast<unsigned char>(m_line[m_pos])) || m_line[m_pos] == '_')) m_pos++;
+        }
+        name = m_line.substr(start, m_pos - start);
+        return !name.empty();
+    }
+
+    bool allocate(uint8_t& reg, float initial) {
+        if (m_registers.size() >= SCRIPT_MAX_REGISTERS) {
+            return fail("Mehr als " + std::to_string(SCRIPT_MAX_REGISTERS) + " Register");
+        }
+        reg = static_cast<uint8_t>(m_registers.size());
+        m_registers.push_back(initial);
+        return true;
+    }
+
+    bool materialize(Operand& operand) {
+        if (!operand.constant) return true;
+        if (operand.value != operand.value) operand.value = 0.0f;   // NaN als Map-Schlüssel vermeiden
+        auto it = m_constants.find(operand.value);
+        if (it != m_constants.end()) {
+            operand.reg = it->second;
+            return true;
+        }
+        if (!allocate(operand.reg, operand.value)) return false;
+        m_constants[operand.value] = operand.reg;
+        return true;
+    }
+
+    // Befehl erzeugen oder - nur Konstanten - direkt ausrechnen
+    bool emit(ScriptOp op, Operand* args, int count, Operand& result) {
+        bool allConstant = true;
+        bool perZone = false;
+        for (int i = 0; i < count; i++) {
+            allConstant = allConstant && args[i].constant;
+            perZone = perZone || args[i].perZone;
+        }
+        if (allConstant) {
+            float values[3] = { 0.0f, 0.0f, 0.0f };
+            for (int i = 0; i < count; i++) values[i] = args[i].value;
+            result = Operand{ true, ScriptProgram::execute(op, values[0], values[1], values[2]), 0, false };
+            return true;
+        }
+
+        ScriptInstruction instruction = { op, 0, 0, 0, 0 };
+        uint8_t* fields[3] = { &instruction.a, &instruction.b, &instruction.c };
+        for (int i = 0; i < count; i++) {
+            if (!materialize(args[i])) return false;
+            *fields[i] = args[i].reg;
+        }
+        if (!allocate(instruction.dst, 0.0f)) return false;
+        (perZone ? m_zoneCode : m_frameCode).push_back(instruction);
+        result = Operand{ false, 0.0f, instruction.dst, perZone };
+        return true;
+    }
+
+    bool binary(ScriptOp op, Operand left, Operand right, Operand& result) {
+        Operand args[2] = { left, right };
+        return emit(op, args, 2, result);
+    }
+
+    // ternary := or ['?' expr ':' expr]
+    bool expression(Operand& result) {
+        if (!logicalOr(result)) return false;
+        if (!accept("?")) return true;
+        Operand args[3] = { result, {}, {} };
+        if (!expression(args[1])) return false;
+        if (!accept(":")) return fail("':' erwartet");
+        if (!expression(args[2])) return false;
+        return emit(ScriptOp::Select, args, 3, result);
+    }
+
+    bool logicalOr(Operand& result) {
+        if (!logicalAnd(result)) return false;
+        while (accept("||")) {
+            Operand right;
+            if (!logicalAnd(right) || !binary(ScriptOp::Or, result, right, result)) return false;
+        }
+        return true;
+    }
+
+    bool logicalAnd(Operand& result) {
+        if (!comparison(result)) return false;
+        while (accept("&&")) {
+            Operand right;
+            if (!comparison(right) || !binary(ScriptOp::And, result, right, result)) return false;
+        }
+        return true;
+    }
+
+    bool comparison(Operand& result) {
+        if (!additive(result)) return false;
+        static const struct { const char* token; ScriptOp op; } ops[] = {
+            { "<=", ScriptOp::LessEqual }, { ">=", ScriptOp::GreaterEqual },
+            { "==", ScriptOp::Equal },     { "!=", ScriptOp::NotEqual },
+            { "<", ScriptOp::Less },       { ">", ScriptOp::Greater },
+        };
+        for (const auto& candidate : ops) {
+            if (accept(candidate.token)) {
+                Operand right;
+                return additive(right) && binary(candidate.op, result, right, result);
+            }
+        }
+        return true;
+    }
+
+    bool additive(Operand& result) {
+        if (!multiplicative(result)) return false;
+        while (true) {
+            ScriptOp op;
+            if (accept("+")) op = ScriptOp::Add;
+            else if (accept("-")) op = ScriptOp::Sub;
+            else return true;
+            Operand right;
+            if (!multiplicative(right) || !binary(op, result, right, result)) return false;
+        }
+    }
+
+    bool multiplicative(Operand& result) {
+        if (!unary(result)) return false;
+        while (true) {
+            ScriptOp op;
+            if (accept("*")) op = ScriptOp::Mul;
+            else if (accept("/")) op = ScriptOp::Div;
+            else if (accept("%")) op = ScriptOp::Mod;
+            else return true;
+            Operand right;
+            if (!unary(right) || !binary(op, result, right, result)) return false;
+        }
+    }
+
+    bool unary(Operand& result) {
+        if (accept("-")) {
+            return unary(result) && emit(ScriptOp::Neg, &result, 1, result);
+        }
+        if (accept("!")) {
+            return unary(result) && emit(ScriptOp::Not, &result, 1, result);
+        }
+        return primary(result);
+    }
+
+    bool primary(Operand& result) {
+        skipSpace();
+        if (accept("(")) {
+            if (!expression(result)) return false;
+            return accept(")") || fail("')' erwartet");
+        }
+
+        if (m_pos < m_line.size() && (isdigit(static_cast<unsigned char>(m_line[m_pos])) || m_line[m_pos] == '.')) {
+            const char* begin = m_line.c_str() + m_pos;
+            char* end = nullptr;
+            float value = strtof(begin, &end);
+            if (end == begin) return fail("Zahl erwartet");
+            m_pos += end - begin;
+            result = Operand{ true, value, 0, false };
+            return true;
+        }
+
+        std::string name;
+        if (!identifier(name)) {
+            return fail(m_pos < m_line.size() ? "Unerwartetes Zeichen '" + std::string(1, m_line[m_pos]) + "'"
+                                              : "Ausdruck unvollstaendig");
+        }
+
+        if (accept("(")) {
+            const Function* function = nullptr;
+            for (const Function& candidate : FUNCTIONS) {
+                if (name == candidate.name) function = &candidate;
+            }
+            if (!function) return fail("Unbekannte Funktion '" + name + "'");
+
+            Operand args[3];
+            for (int i = 0; i < function->arity; i++) {
+                if (i > 0 && !accept(",")) return fail(name + "() erwartet " + std::to_string(function->arity) + " Argumente");
+                if (!expression(args[i])) return false;
+            }
+            if (!accept(")")) return fail(name + "() erwartet " + std::to_string(function->arity) + " Argumente");
+            return emit(function->op, args, function->arity, result);
+        }
+
+        auto it = m_names.find(name);
+        if (it == m_names.end()) return fail("Unbekannter Name '" + name + "'");
+        result = it->second;
+        return true;
+    }
+
+    // Ergebnis in ein festes Ausgaberegister. Nur eine Zuweisung pro Kanal:
+    // Konstanten landen im Startwert, Frame- und Zonen-Code laufen getrennt -
+    // eine zweite Zuweisung würde nicht in Quelltext-Reihenfolge wirken.
+    bool assignOutput(uint8_t target, Operand value) {
+        bool& assigned = m_assigned[target - ScriptProgram::RegRed];
+        if (assigned) {
+            static const char* names[] = { "r", "g", "b" };
+            return fail("'" + std::string(names[target - ScriptProgram::RegRed]) + "' ist bereits zugewiesen");
+        }
+        assigned = true;
+        if (value.constant) {
+            m_registers[target] = value.value;
+            return true;
+        }
+        ScriptInstruction instruction = { ScriptOp::Move, target, value.reg, 0, 0 };
+        (value.perZone ? m_zoneCode : m_frameCode).push_back(instruction);
+        return true;
+    }
+
+public:
+    ScriptCompiler(std::vector<ScriptInstruction>& frameCode, std::vector<ScriptInstruction>& zoneCode,
+                   std::vector<float>& registers)
+        : m_frameCode(frameCode), m_zoneCode(zoneCode), m_registers(registers), m_pos(0)
+        , m_assigned{ false, false, false }
+    {
+        m_registers.assign(ScriptProgram::RegFirstFree, 0.0f);
+        m_names["t"]        = Operand{ false, 0.0f, ScriptProgram::RegTime, false };
+        m_names["frame"]    = Operand{ false, 0.0f, ScriptProgram::RegFrame, false };
+        m_names["zone"]     = Operand{ false, 0.0f, ScriptProgram::RegZone, true };
+        m_names["muted"]    = Operand{ false, 0.0f, ScriptProgram::RegMuted, false };
+        m_names["battery"]  = Operand{ false, 0.0f, ScriptProgram::RegBattery, false };
+        m_names["charging"] = Operand{ false, 0.0f, ScriptProgram::RegCharging, false };
+        m_names["pi"]       = Operand{ true, 3.14159265f, 0, false };
+    }
+
+    // statement := 'let' name '=' expr | ('r'|'g'|'b') '=' expr
+    bool statement(const std::string& line) {
+        m_line = line;
+        m_pos = 0;
+
+        std::string name;
+        if (!identifier(name)) return fail("Anweisung erwartet");
+        bool isLet = name == "let";
+        if (isLet && !identifier(name)) return fail("Name nach 'let' erwartet");
+        if (!accept("=")) return fail("'=' erwartet");
+
+        Operand value;
+        if (!expression(value)) return false;
+        skipSpace();
+        if (m_pos < m_line.size()) return fail("Unerwartetes Zeichen '" + std::string(1, m_line[m_pos]) + "'");
+
+        if (isLet) {
+            static const char* inputs[] = { "t", "frame", "zone", "muted", "battery", "charging" };
+            for (const char* input : inputs) {
+                if (name == input) return fail("'" + name + "' ist eine Eingabe");
+            }
+            for (const Function& function : FUNCTIONS) {
+                if (name == function.name) return fail("'" + name + "' ist eine Funktion");
+            }
+            m_names[name] = value;
+            return true;
+        }
+        if (name == "r") return assignOutput(ScriptProgram::RegRed, value);
+        if (name == "g") return assignOutput(ScriptProgram::RegGreen, value);
+        if (name == "b") return assignOutput(ScriptProgram::RegBlue, value);
+        return fail("Nur r, g, b oder 'let' zuweisbar");
+    }
+
+    const std::string& error() const { return m_error; }
+};
+
+} // namespace
+
+bool ScriptProgram::compile(const std::string& source, std::string& error) {
+    m_frameCode.clear();
+    m_zoneCode.clear();
+    ScriptCompiler compiler(m_frameCode, m_zoneCode, m_registers);
+
+    std::istringstream input(source);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        if (!compiler.statement(line)) {
+            error = "Zeile " + std::to_string(lineNumber) + ": " + compiler.error();
+            m_frameCode.clear();
+            m_zoneCode.clear();
+            m_registers.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ScriptProgram::loadFile(const std::string& path, std::string& error) {
+    std::ifstream input(path);
+    if (!input.is_open()) {
+        error = "Kann " + path + " nicht oeffnen";
+        m_frameCode.clear();
+        m_zoneCode.clear();
+        m_registers.clear();
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << input.rdbuf();
+    return compile(buffer.str(), error);
+}
+
+// ============================================================================
+// Interpreter
+// ============================================================================
+
+static uint8_t toChannel(float value) {
+    // NaN scheitert am Vergleich und wird 0, ebenso ±Inf (Überlauf ist kein Weiß)
+    if (!(value > 0.0f) || std::isinf(value)) return 0;
+    if (value >= 255.0f) return 255;
+    return static_cast<uint8_t>(value + 0.5f);
+}
+
+void ScriptProgram::run(const ScriptInputs& inputs, LEDZones& zones) const {
+    if (m_registers.empty()) {
+        zones = LEDZones(RGBColor(0, 0, 0));
+        return;
+    }
+
+    float regs[SCRIPT_MAX_REGISTERS];
+    memcpy(regs, m_registers.data(), m_registers.size() * sizeof(float));
+    regs[RegTime] = inputs.timeSeconds;
+    regs[RegFrame] = inputs.frame;
+    regs[RegZone] = 0.0f;
+    regs[RegMuted] = inputs.muted;
+    regs[RegBattery] = inputs.battery;
+    regs[RegCharging] = inputs.charging;
+    executeCode(m_frameCode.data(), m_frameCode.size(), regs);
+
+    RGBColor* outputs[3] = { &zones.logo, &zones.power, &zones.mic };
+    for (int zone = 0; zone < 3; zone++) {
+        regs[RegZone] = static_cast<float>(zone);
+        executeCode(m_zoneCode.data(), m_zoneCode.size(), regs);
+        *outputs[zone] = RGBColor(toChannel(regs[RegRed]), toChannel(regs[RegGreen]), toChannel(regs[RegBlue]));
+    }
+}
+
+// ============================================================================
+// ScriptEffect
+// ============================================================================
+
+ScriptEffect::ScriptEffect(std::shared_ptr<const ScriptProgram> program, const HeadsetStateCache* state)
+    : m_program(program)
+    , m_state(state)
+{
+}
+
+EffectStatus ScriptEffect::render(const FrameContext& frame, LEDZones& zones) {
+    ScriptInputs inputs;
+    inputs.timeSeconds = static_cast<float>(frame.timeMs / 1000.0);
+    inputs.frame = static_cast<float>(frame.frameIndex);
+    if (m_state) {
+        HeadsetState state = m_state->snapshot();
+        inputs.muted = static_cast<float>(state.muted);
+        inputs.battery = static_cast<float>(state.batteryLevel);
+        inputs.charging = static_cast<float>(static_cast<int>(state.charging));
+    }
+
+    if (m_program) {
+        m_program->run(inputs, zones);
+    } else {
+        zones = LEDZones(RGBColor(0, 0, 0));
+    }
+    return EffectStatus::Running;
+}
+
+} // namespace HS80
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "HS80_Animation.h"
+#include <string>
+
+// ============================================================================
+// HS80 Script - Effekte als Ausdrücke, kompiliert in Register-Bytecode
+// ============================================================================
+//
+// Ein Effekt-Skript beschreibt pro Zone die Kanäle r, g, b (0-255) als
+// Ausdrücke über Zeit, Zone und Headset-Zustand - ohne C++ und ohne Neubau.
+//
+//   # Regenbogen, Zonen um je 1/3 versetzt
+//   let h = frac(t / 10 + zone / 3)
+//   r = 255 * clamp(abs(h * 6 - 3) - 1, 0, 1)
+//   g = 255 * clamp(2 - abs(h * 6 - 2), 0, 1)
+//   b = 255 * clamp(2 - abs(h * 6 - 4), 0, 1)
+//
+// Eingaben:   t (Sekunden), frame, zone (0 Logo, 1 Power, 2 Mic),
+//             muted (-1/0/1), battery (0-100, -1), charging (0-3), pi
+// Operatoren: + - * / % < <= > >= == != && || ! ?:
+// Funktionen: sin cos abs floor frac sqrt min max step wave noise
+//             clamp(x, lo, hi) mix(a, b, t) smooth(lo, hi, x)
+//
+// r, g und b dürfen je nur einmal zugewiesen werden (sonst Fehler beim
+// Kompilieren), Zwischenwerte über 'let'.
+//
+// Der Compiler faltet Konstanten und teilt den Code in einen Teil pro Frame
+// (hängt nicht von zone ab, läuft einmal) und einen Teil pro Zone (läuft
+// dreimal). Jedes Zwischenergebnis bekommt ein eigenes Register (höchstens
+// 256), es gibt weder Sprünge noch Speicherzugriffe: die Laufzeit ist durch die
+// Programmlänge begrenzt, ein Skript kann nichts außer seinen Registern
+// berühren. Division durch 0 liefert 0, NaN/Inf am Ausgang werden zu 0.
+//
+// Der Interpreter arbeitet auf einem Register-Array im Stack und allokiert nie.
+// ============================================================================
+
+namespace HS80 {
+
+constexpr size_t SCRIPT_MAX_REGISTERS = 256;
+
+enum class ScriptOp : uint8_t {
+    Move, Add, Sub, Mul, Div, Mod, Neg,
+    Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual, And, Or, Not,
+    Select,             // dst = a != 0 ? b : c
+    Min, Max, Abs, Floor, Frac, Sqrt, Sin, Cos,
+    Step,               // dst = b >= a ? 1 : 0
+    Wave,               // Dreieck 0 -> 1 -> 0 pro Einheit
+    Noise,              // Hash 0-1
+    Clamp, Mix, Smooth
+};
+
+struct ScriptInstruction {
+    ScriptOp op;
+    uint8_t dst;
+    uint8_t a;
+    uint8_t b;
+    uint8_t c;
+};
+
+// Eingaben eines Durchlaufs (zone setzt run() selbst)
+struct ScriptInputs {
+    float timeSeconds;
+    float frame;
+    float muted;
+    float battery;
+    float charging;
+
+    ScriptInputs() : timeSeconds(0), frame(0), muted(-1), battery(-1), charging(0) {}
+};
+
+class ScriptProgram {
+private:
+    std::vector<ScriptInstruction> m_frameCode;     // Einmal pro Frame
+    std::vector<ScriptInstruction> m_zoneCode;      // Pro Zone
+    std::vector<float> m_registers;                 // Startwerte (Konstanten), Länge = Registerzahl
+
+public:
+    // Feste Register
+    enum Register : uint8_t {
+        RegTime = 0, RegFrame, RegZone, RegMuted, RegBattery, RegCharging,
+        RegRed, RegGreen, RegBlue,
+        RegFirstFree
+    };
+
+    // Quelltext übersetzen; bei Fehler bleibt das Programm leer (schwarz)
+    bool compile(const std::string& source, std::string& error);
+    bool loadFile(const std::string& path, std::string& error);
+
+    // Drei Zonen berechnen, ohne Allokation
+    void run(const ScriptInputs& inputs, LEDZones& zones) const;
+
+    size_t frameInstructions() const { return m_frameCode.size(); }
+    size_t zoneInstructions() const { return m_zoneCode.size(); }
+    size_t registerCount() const { return m_registers.size(); }
+
+    // Ein Befehl (auch für das Falten von Konstanten im Compiler)
+    static float execute(ScriptOp op, float a, float b, float c);
+};
+
+// Skript als Effekt (läuft endlos); Zustand optional aus einem HeadsetStateCache
+class ScriptEffect : public Effect {
+private:
+    std::shared_ptr<const ScriptProgram> m_program;
+    const HeadsetStateCache* m_state;
+
+public:
+    ScriptEffect(std::shared_ptr<const ScriptProgram> program, const HeadsetStateCache* state = nullptr);
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override;
+};
+
+} // namespace HS80
@@ -0,0 +1,347 @@
+#include "HS80_Simulation.h"
+#include <iostream>
+#include <algorithm>
+
+namespace HS80 {
+
+// Report-Länge wie beim Event-Interface (64 Bytes Payload)
+static const size_t SIM_REPORT_SIZE = 64;
+
+size_t buildEventReport(EventType type, int value, unsigned char* buffer, size_t size) {
+    if (size < 7) {
+        return 0;
+    }
+
+    size_t length = std::min(size, SIM_REPORT_SIZE);
+    memset(buffer, 0, length);
+    buffer[0] = 0x03;
+    buffer[1] = 0x01;
+    buffer[2] = 0x01;
+    buffer[3] = static_cast<unsigned char>(type);
+    buffer[4] = 0x00;
+
+    if (type == EventType::Battery) {
+        // Rohwert 0-1000, Little Endian
+        buffer[5] = value & 0xFF;
+        buffer[6] = (value >> 8) & 0xFF;
+    } else {
+        buffer[5] = static_cast<unsigned char>(value);
+    }
+    return length;
+}
+
+// ============================================================================
+// SimulatedDevice
+// ============================================================================
+
+SimulatedDevice::SimulatedDevice(size_t inputBuffers)
+    : m_inputEvent(nullptr)
+    , m_inputCapacity(inputBuffers > 0 ? inputBuffers : 1)
+    , m_injected(0)
+    , m_dropped(0)
+    , m_recordWrites(false)
+    , m_writeCount(0)
+    , m_writeLatencyUs(0)
+    , m_writeJitterUs(0)
+    , m_jitterSeed(0x1234567u)
+    , m_writePending(false)
+    , m_pendingDueTicks(0)
+    , m_burstThread(nullptr)
+    , m_burstStopEvent(nullptr)
+    , m_burstSequence(0)
+{
+    InitializeCriticalSection(&m_lock);
+    QueryPerformanceFrequency(&m_qpcFrequency);
+    m_inputEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+}
+
+SimulatedDevice::~SimulatedDevice() {
+    stopBurstGenerator();
+    if (m_inputEvent) {
+        CloseHandle(m_inputEvent);
+    }
+    DeleteCriticalSection(&m_lock);
+}
+
+void SimulatedDevice::setWriteLatency(DWORD latencyUs, DWORD jitterUs) {
+    EnterCriticalSection(&m_lock);
+    m_writeLatencyUs = latencyUs;
+    m_writeJitterUs = jitterUs < latencyUs ? jitterUs : latencyUs;
+    LeaveCriticalSection(&m_lock);
+}
+
+DWORD SimulatedDevice::writeLatencyUs() const {
+    EnterCriticalSection(&m_lock);
+    DWORD value = m_writeLatencyUs;
+    LeaveCriticalSection(&m_lock);
+    return value;
+}
+
+// Fertigstellungszeitpunkt eines jetzt begonnenen Writes (QPC-Ticks)
+int64_t SimulatedDevice::writeDueTicks() {
+    EnterCriticalSection(&m_lock);
+    int64_t latencyUs = m_writeLatencyUs;
+    if (m_writeJitterUs > 0) {
+        m_jitterSeed = m_jitterSeed * 1664525u + 1013904223u;
+        latencyUs += static_cast<int64_t>((m_jitterSeed >> 8) % (2 * m_writeJitterUs + 1)) - m_writeJitterUs;
+    }
+    LeaveCriticalSection(&m_lock);
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart + (latencyUs > 0 ? latencyUs * m_qpcFrequency.QuadPart / 1000000 : 0);
+}
+
+void SimulatedDevice::waitForTicks(int64_t dueTicks) {
+    // Sleep für den groben Teil, Rest per QPC (Sleep allein ist zu ungenau)
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    int64_t remainingUs = (dueTicks - now.QuadPart) * 1000000 / m_qpcFrequency.QuadPart;
+    if (remainingUs > 2000) {
+        Sleep(static_cast<DWORD>(remainingUs / 1000 - 1));
+    }
+    while (now.QuadPart < dueTicks) {
+        QueryPerformanceCounter(&now);
+    }
+}
+
+void SimulatedDevice::simulateWriteLatency() {
+    waitForTicks(writeDueTicks());
+}
+
+bool SimulatedDevice::write(const unsigned char* data, size_t size) {
+    // Außerhalb des Locks: Input-Seite bleibt während der Latenz bedienbar
+    simulateWriteLatency();
+    completeWrite(data, size);
+    return true;
+}
+
+bool SimulatedDevice::beginWrite(const unsigned char* data, size_t size) {
+    m_pendingWrite.assign(data, data + size);
+    m_pendingDueTicks = writeDueTicks();
+    m_writePending = true;
+    return true;
+}
+
+bool SimulatedDevice::finishWrite() {
+    if (!m_writePending) {
+        return false;
+    }
+    waitForTicks(m_pendingDueTicks);
+    m_writePending = false;
+    completeWrite(m_pendingWrite.data(), m_pendingWrite.size());
+    return true;
+}
+
+void SimulatedDevice::completeWrite(const unsigned char* data, size_t size) {
+    EnterCriticalSection(&m_lock);
+    m_writeCount++;
+    if (m_recordWrites) {
+        m_written.emplace_back(data, data + size);
+    }
+    WriteObserver observer = m_writeObserver;
+    LeaveCriticalSection(&m_lock);
+
+    if (observer) {
+        observer(data, size);
+    }
+}
+
+void SimulatedDevice::setWriteObserver(WriteObserver observer) {
+    EnterCriticalSection(&m_lock);
+    m_writeObserver = observer;
+    LeaveCriticalSection(&m_lock);
+}
+
+ReadResult SimulatedDevice::read(unsigned char* buffer, size_t size, size_t& bytesRead, DWORD timeoutMs) {
+    bytesRead = 0;
+
+    if (WaitForSingleObject(m_inputEvent, timeoutMs) != WAIT_OBJECT_0) {
+        return ReadResult::Timeout;
+    }
+
+    EnterCriticalSection(&m_lock);
+    if (m_input.empty()) {
+        ResetEvent(m_inputEvent);
+        LeaveCriticalSection(&m_lock);
+        return ReadResult::Timeout;
+    }
+
+    const Report& report = m_input.front();
+    bytesRead = std::min(size, report.size());
+    memcpy(buffer, report.data(), bytesRead);
+    m_input.pop_front();
+    if (m_input.empty()) {
+        ResetEvent(m_inputEvent);
+    }
+    LeaveCriticalSection(&m_lock);
+
+    return ReadResult::Ok;
+}
+
+void SimulatedDevice::flushInput() {
+    EnterCriticalSection(&m_lock);
+    m_input.clear();
+    ResetEvent(m_inputEvent);
+    LeaveCriticalSection(&m_lock);
+}
+
+bool SimulatedDevice::setInputBufferCount(unsigned long count) {
+    // Gleiche Grenzen wie HidD_SetNumInputBuffers
+    if (count < 2 || count > 512) {
+        return false;
+    }
+
+    EnterCriticalSection(&m_lock);
+    m_inputCapacity = count;
+    while (m_input.size() > m_inputCapacity) {
+        m_input.pop_front();
+        m_dropped++;
+    }
+    LeaveCriticalSection(&m_lock);
+    return true;
+}
+
+void SimulatedDevice::injectReport(const unsigned char* data, size_t size) {
+    EnterCriticalSection(&m_lock);
+    if (m_input.size() >= m_inputCapacity) {
+        // Treiberpuffer voll: ältester Report geht verloren
+        m_input.pop_front();
+        m_dropped++;
+    }
+    m_input.emplace_back(data, data + size);
+    m_injected++;
+    SetEvent(m_inputEvent);
+    LeaveCriticalSection(&m_lock);
+}
+
+void SimulatedDevice::injectEvent(EventType type, int value) {
+    unsigned char report[SIM_REPORT_SIZE];
+    size_t length = buildEventReport(type, value, report, sizeof(report));
+    if (length > 0) {
+        injectReport(report, length);
+    }
+}
+
+// ============================================================================
+// Burst-Generator
+// ============================================================================
+
+bool SimulatedDevice::startBurstGenerator(const BurstConfig& config) {
+    if (m_burstThread) {
+        return false;
+    }
+
+    m_burstConfig = config;
+    m_burstSequence = 0;
+    m_burstStopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    if (!m_burstStopEvent) {
+        return false;
+    }
+
+    m_burstThread = CreateThread(nullptr, 0, BurstThreadProc, this, 0, nullptr);
+    if (!m_burstThread) {
+        CloseHandle(m_burstStopEvent);
+        m_burstStopEvent = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void SimulatedDevice::stopBurstGenerator() {
+    if (!m_burstThread) {
+        return;
+    }
+
+    SetEvent(m_burstStopEvent);
+    WaitForSingleObject(m_burstThread, INFINITE);
+    CloseHandle(m_burstThread);
+    CloseHandle(m_burstStopEvent);
+    m_burstThread = nullptr;
+    m_burstStopEvent = nullptr;
+}
+
+bool SimulatedDevice::waitBurstGenerator(DWORD timeoutMs) {
+    if (!m_burstThread) {
+        return true;
+    }
+    return WaitForSingleObject(m_burstThread, timeoutMs) == WAIT_OBJECT_0;
+}
+
+DWORD WINAPI SimulatedDevice::BurstThreadProc(LPVOID param) {
+    static_cast<SimulatedDevice*>(param)->burstLoop();
+    return 0;
+}
+
+void SimulatedDevice::burstLoop() {
+    for (int burst = 0; burst < m_burstConfig.bursts; burst++) {
+        for (int i = 0; i < m_burstConfig.reportsPerBurst; i++) {
+            // Wechselnde Werte, damit ein Change-Only-Filter nichts verwirft
+            uint32_t seq = m_burstSequence++;
+            switch (seq % 3) {
+            case 0:  injectEvent(EventType::Battery, static_cast<int>(seq % 1001)); break;
+            case 1:  injectEvent(EventType::Mute, (seq / 3) & 1); break;
+            default: injectEvent(EventType::Charging, (seq / 3) & 1); break;
+            }
+        }
+
+        if (WaitForSingleObject(m_burstStopEvent, m_burstConfig.intervalMs) == WAIT_OBJECT_0) {
+            break;
+        }
+    }
+}
+
+// ============================================================================
+// Statistik
+// ============================================================================
+
+uint64_t SimulatedDevice::injectedReports() const {
+    EnterCriticalSection(&m_lock);
+    uint64_t value = m_injected;
+    LeaveCriticalSection(&m_lock);
+    return value;
+}
+
+uint64_t SimulatedDevice::droppedReports() const {
+    EnterCriticalSection(&m_lock);
+    uint64_t value = m_dropped;
+    LeaveCriticalSection(&m_lock);
+    return value;
+}
+
+size_t SimulatedDevice::pendingReports() const {
+    EnterCriticalSection(&m_lock);
+    size_t value = m_input.size();
+    LeaveCriticalSection(&m_lock);
+    return value;
+}
+
+void SimulatedDevice::resetStats() {
+    EnterCriticalSection(&m_lock);
+    m_injected = 0;
+    m_dropped = 0;
+    m_writeCount = 0;
+    LeaveCriticalSection(&m_lock);
+}
+
+std::vector<std::vector<unsigned char>> SimulatedDevice::writtenReports() const {
+    EnterCriticalSection(&m_lock);
+    std::vector<Report> copy = m_written;
+    LeaveCriticalSection(&m_lock);
+    return copy;
+}
+
+uint64_t SimulatedDevice::writeCount() const {
+    EnterCriticalSection(&m_lock);
+    uint64_t value = m_writeCount;
+    LeaveCriticalSection(&m_lock);
+    return value;
+}
+
+void SimulatedDevice::clearWritten() {
+    EnterCriticalSection(&m_lock);
+    m_written.clear();
+    LeaveCriticalSection(&m_lock);
+}
+
+} // namespace HS80
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "HS80_Library.h"
+#include <vector>
+#include <deque>
+
+// ============================================================================
+// HS80 Simulation - Simuliertes Headset für Tests ohne Hardware
+// ============================================================================
+//
+// SimulatedDevice implementiert HIDTransport und kann statt Win32HIDTransport
+// an RGBController::connect() bzw. EventMonitor::connect() übergeben werden.
+//
+// Input-Seite: begrenzter Ringpuffer wie im HID-Klassentreiber. Ist er voll,
+// wird der älteste Report verworfen und als Drop gezählt.
+// Output-Seite: geschriebene Reports werden aufgezeichnet. Optional blockiert
+// write() eine einstellbare Zeit (Link-Latenz, z.B. Funk vs. Kabel).
+// ============================================================================
+
+namespace HS80 {
+
+// Burst-Generator: reportsPerBurst Reports direkt hintereinander, dann Pause
+struct BurstConfig {
+    int bursts;             // Anzahl Bursts
+    int reportsPerBurst;    // Reports pro Burst
+    DWORD intervalMs;       // Pause zwischen Bursts
+
+    BurstConfig() : bursts(100), reportsPerBurst(40), intervalMs(10) {}
+};
+
+// Wird bei jedem write() aufgerufen (Thread des Schreibers, nach der Latenz)
+using WriteObserver = std::function<void(const unsigned char* data, size_t size)>;
+
+class SimulatedDevice : public HIDTransport {
+private:
+    using Report = std::vector<unsigned char>;
+
+    mutable CRITICAL_SECTION m_lock;
+    HANDLE m_inputEvent;                // Signalisiert = Input-Puffer nicht leer
+    std::deque<Report> m_input;
+    size_t m_inputCapacity;
+    uint64_t m_injected;
+    uint64_t m_dropped;
+
+    bool m_recordWrites;
+    std::vector<Report> m_written;
+    uint64_t m_writeCount;
+    WriteObserver m_writeObserver;
+
+    // Simulierte Schreiblatenz
+    DWORD m_writeLatencyUs;
+    DWORD m_writeJitterUs;
+    uint32_t m_jitterSeed;
+    LARGE_INTEGER m_qpcFrequency;
+
+    // Geteiltes Schreiben (nur der Thread zwischen beginWrite und finishWrite)
+    bool m_writePending;
+    Report m_pendingWrite;
+    int64_t m_pendingDueTicks;
+
+    int64_t writeDueTicks();
+    void waitForTicks(int64_t dueTicks);
+    void simulateWriteLatency();
+    void completeWrite(const unsigned char* data, size_t size);
+
+    // Burst-Generator
+    HANDLE m_burstThread;
+    HANDLE m_burstStopEvent;
+    BurstConfig m_burstConfig;
+    uint32_t m_burstSequence;
+
+    static DWORD WINAPI BurstThreadProc(LPVOID param);
+    void burstLoop();
+
+public:
+    explicit SimulatedDevice(size_t inputBuffers = 32);
+    ~SimulatedDevice();
+
+    SimulatedDevice(const SimulatedDevice&) = delete;
+    SimulatedDevice& operator=(const SimulatedDevice&) = delete;
+
+    // HIDTransport
+    bool write(const unsigned char* data, size_t size) override;
+    bool beginWrite(const unsigned char* data, size_t size) override;   // Latenz läuft ab hier
+    bool finishWrite() override;
+    ReadResult read(unsigned char* buffer, size_t size, size_t& bytesRead, DWORD timeoutMs) override;
+    void flushInput() override;
+    bool setInputBufferCount(unsigned long count) override;
+
+    // Input-Reports einspeisen (wie vom Headset gesendet)
+    void injectReport(const unsigned char* data, size_t size);
+    void injectEvent(EventType type, int value);  // Battery: Rohwert 0-1000
+
+    // Burst-Generator (eigener Thread, blockiert nicht)
+    bool startBurstGenerator(const BurstConfig& config);
+    void stopBurstGenerator();
+    bool waitBurstGenerator(DWORD timeoutMs = INFINITE);
+
+    // Statistik
+    uint64_t injectedReports() const;
+    uint64_t droppedReports() const;
+    size_t pendingReports() const;
+    void resetStats();
+
+    // Jeder write() blockiert latencyUs +/- jitterUs (gleichverteilt), 0 = sofort
+    void setWriteLatency(DWORD latencyUs, DWORD jitterUs = 0);
+    DWORD writeLatencyUs() const;
+
+    // Zeitpunkt-Messungen am "Gerät" (z.B. Ende-zu-Ende-Latenz)
+    void setWriteObserver(WriteObserver observer);
+
+    // Aufgezeichnete Output-Reports (Standard: aus, wächst sonst unbegrenzt)
+    void setRecordWrites(bool record) { m_recordWrites = record; }
+    std::vector<std::vector<unsigned char>> writtenReports() const;
+    uint64_t writeCount() const;
+    void clearWritten();
+};
+
+// Baut einen Event-Report im Geräteformat [0x03][0x01][0x01][code][0x00][wert...]
+size_t buildEventReport(EventType type, int value, unsigned char* buffer, size_t size);
+
+} // namespace HS80
@@ -0,0 +1,125 @@
+#include "HS80_Transition.h"
+
+namespace HS80 {
+
+// ============================================================================
+// TransitionEffect
+// ============================================================================
+
+static void zonesToLab(const LEDZones& zones, Color::OkLab* lab) {
+    lab[0] = Color::toOkLab(zones.logo);
+    lab[1] = Color::toOkLab(zones.power);
+    lab[2] = Color::toOkLab(zones.mic);
+}
+
+TransitionEffect::TransitionEffect(TransitionSource from, TransitionSource to, double durationMs, Color::Easing easing)
+    : m_from(std::move(from))
+    , m_to(std::move(to))
+    , m_durationMs(durationMs)
+    , m_easing(easing)
+    , m_fromFinished(false)
+    , m_toFinished(false) {
+    if (!m_from.effect) {
+        zonesToLab(m_from.zones, m_fromLab);
+    }
+    if (!m_to.effect) {
+        zonesToLab(m_to.zones, m_toLab);
+    }
+}
+
+bool TransitionEffect::renderSource(TransitionSource& source, bool& finished, const FrameContext& frame, LEDZones& zones) {
+    if (!source.effect) {
+        return false;
+    }
+    if (!finished) {
+        FrameContext shifted = frame;
+        shifted.timeMs = frame.timeMs + source.timeOffsetMs;
+        if (source.effect->render(shifted, source.zones) == EffectStatus::Finished) {
+            finished = true;
+        }
+    }
+    zones = source.zones;
+    return true;
+}
+
+EffectStatus TransitionEffect::render(const FrameContext& frame, LEDZones& zones) {
+    // Überblendung vorbei: nur noch das Ziel
+    if (frame.timeMs >= m_durationMs) {
+        if (!m_to.effect) {
+            zones = m_to.zones;
+            return EffectStatus::Finished;
+        }
+        renderSource(m_to, m_toFinished, frame, zones);
+        return m_toFinished ? EffectStatus::Finished : EffectStatus::Running;
+    }
+
+    uint16_t progress = static_cast<uint16_t>(frame.timeMs * Color::MIX_ONE / m_durationMs);
+    uint16_t t = Color::ease(m_easing, progress);
+
+    // Laufende Effekte pro Frame umrechnen, feste Zustände aus dem Konstruktor
+    LEDZones current;
+    Color::OkLab fromFrame[3];
+    Color::OkLab toFrame[3];
+    const Color::OkLab* from = m_fromLab;
+    const Color::OkLab* to = m_toLab;
+    if (renderSource(m_from, m_fromFinished, frame, current)) {
+        zonesToLab(current, fromFrame);
+        from = fromFrame;
+    }
+    if (renderSource(m_to, m_toFinished, frame, current)) {
+        zonesToLab(current, toFrame);
+        to = toFrame;
+    }
+
+    zones.logo = Color::fromOkLab(Color::mix(from[0], to[0], t));
+    zones.power = Color::fromOkLab(Color::mix(from[1], to[1], t));
+    zones.mic = Color::fromOkLab(Color::mix(from[2], to[2], t));
+    return EffectStatus::Running;
+}
+
+TransitionSource TransitionEffect::settled(std::shared_ptr<Effect> self, double timeMs) const {
+    if (timeMs < m_durationMs) {
+        return TransitionSource(self, timeMs);
+    }
+    if (!m_to.effect) {
+        return TransitionSource(m_to.zones);
+    }
+    return TransitionSource(m_to.effect, timeMs + m_to.timeOffsetMs);
+}
+
+// ============================================================================
+// Controller
+// ============================================================================
+
+// Aktueller Zustand: laufender Effekt ab seinem nächsten Frame, sonst Farben
+static TransitionSource currentSource(RGBController& rgb) {
+    double timeMs = 0;
+    std::shared_ptr<Effect> effect = rgb.animation().current(timeMs);
+    if (!effect) {
+        return TransitionSource(rgb.getColors());
+    }
+    if (auto transition = std::dynamic_pointer_cast<TransitionEffect>(effect)) {
+        return transition->settled(effect, timeMs);
+    }
+    return TransitionSource(effect, timeMs);
+}
+
+bool startTransition(RGBController& rgb, const LEDZones& to, int durationMs, Color::Easing easing, int stepMs) {
+    // Auch ohne Dauer über den Animation-Thread: ersetzt einen laufenden Effekt sauber
+    if (durationMs < 0) {
+        durationMs = 0;
+    }
+    return rgb.startEffect(std::make_shared<TransitionEffect>(currentSource(rgb), TransitionSource(to), durationMs, easing), stepMs);
+}
+
+bool startTransition(RGBController& rgb, std::shared_ptr<Effect> to, int durationMs, Color::Easing easing, int stepMs) {
+    if (!to) {
+        return false;
+    }
+    if (durationMs <= 0) {
+        return rgb.startEffect(to, stepMs);
+    }
+    return rgb.startEffect(std::make_shared<TransitionEffect>(currentSource(rgb), TransitionSource(to), durationMs, easing), stepMs);
+}
+
+} // namespace HS80
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "HS80_Animation.h"
+#include "HS80_Color.h"
+
+// ============================================================================
+// HS80 Transition - Überblendungen in OKLab
+// ============================================================================
+//
+// setColors() springt sofort, ein Fade in sRGB wirkt ungleichmäßig (dunkle
+// Abschnitte springen, helle kriechen) und braucht viele kleine Schritte.
+// TransitionEffect blendet zwischen zwei Zuständen in OKLab über, mit einer
+// Easing-Kurve. Jeder Zustand ist entweder ein fester LEDZones-Wert oder ein
+// laufender Effekt (beide laufen während der Überblendung weiter).
+//
+// Gleiche Schritte in OKLab sind gleich große sichtbare Schritte, damit kommt
+// eine Überblendung mit weniger Frames (= HID-Paketen) ohne sichtbare Sprünge
+// aus. Gerechnet wird in Festkomma über die Tabellen aus HS80_Color; feste
+// Zustände werden nur einmal umgerechnet.
+// ============================================================================
+
+namespace HS80 {
+
+class RGBController;
+
+// Start- oder Zielzustand einer Überblendung
+struct TransitionSource {
+    std::shared_ptr<Effect> effect;     // nullptr = feste Farben
+    LEDZones zones;
+    double timeOffsetMs;                // Effekt-Zeit beim Start der Überblendung
+
+    TransitionSource(const LEDZones& zones) : zones(zones), timeOffsetMs(0) {}
+    TransitionSource(std::shared_ptr<Effect> effect, double timeOffsetMs = 0)
+        : effect(std::move(effect)), timeOffsetMs(timeOffsetMs) {}
+};
+
+// Endet mit dem Ziel: feste Farben -> Finished, Effekt -> läuft als Ziel weiter
+class TransitionEffect : public Effect {
+private:
+    TransitionSource m_from;
+    TransitionSource m_to;
+    double m_durationMs;
+    Color::Easing m_easing;
+
+    Color::OkLab m_fromLab[3];          // Nur für feste Zustände
+    Color::OkLab m_toLab[3];
+    bool m_fromFinished;                // Beendeter Effekt: letzter Frame bleibt stehen
+    bool m_toFinished;
+
+    bool renderSource(TransitionSource& source, bool& finished, const FrameContext& frame, LEDZones& zones);
+
+public:
+    TransitionEffect(TransitionSource from, TransitionSource to, double durationMs,
+                     Color::Easing easing = Color::Easing::EaseInOut);
+
+    EffectStatus render(const FrameContext& frame, LEDZones& zones) override;
+
+    // Zustand ab timeMs: während der Überblendung der Effekt selbst, danach
+    // das Ziel (verhindert Ketten aus Überblendungen)
+    TransitionSource settled(std::shared_ptr<Effect> self, double timeMs) const;
+};
+
+// Überblendung vom aktuellen Zustand des Controllers (laufender Effekt oder
+// zuletzt gesendete Farben) zu neuen Farben bzw. einem Effekt. Kehrt sofort
+// zurück; stepMs ist der Frame-Abstand der Überblendung.
+bool startTransition(RGBController& rgb, const LEDZones& to, int durationMs = 400,
+                     Color::Easing easing = Color::Easing::EaseInOut, int stepMs = 40);
+bool startTransition(RGBController& rgb, std::shared_ptr<Effect> to, int durationMs = 400,
+                     Color::Easing easing = Color::Easing::EaseInOut, int stepMs = 33);
+
+} // namespace HS80
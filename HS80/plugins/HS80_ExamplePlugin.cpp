@@ -0,0 +1,132 @@
+// ============================================================================
+// HS80 Beispiel-Plugin "Komet" - Vorlage für eigene Effekt-DLLs
+// ============================================================================
+//
+// Ein heller Punkt läuft Logo -> Power -> Mic und zieht einen abklingenden
+// Schweif hinter sich her. Ist das Mikrofon stumm, bleibt die Mic-LED rot.
+// Braucht nur HS80_PluginApi.h, nicht die Library.
+//
+// Argumente (durch Leerzeichen getrennt, alle optional):
+//   period=<ms>        Umlauf, Standard 1500
+//   color=<RRGGBB>     Farbe, Standard 00A0FF
+//   cost=<us>          Künstliche Rechenzeit pro Aufruf (Budget testen)
+//   stall=<us>         Einmalige Rechenzeit beim 10. Aufruf (Anhalten testen)
+//
+// Bauen: cl /LD /EHsc /I HS80 HS80\plugins\HS80_ExamplePlugin.cpp
+// ============================================================================
+
+#include "HS80_PluginApi.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+
+struct Comet {
+    double periodMs;
+    unsigned char color[3];
+    double costUs;
+    double stallUs;
+    uint64_t calls;
+    double trail[3];            // Helligkeit pro Zone (0-1), klingt ab
+};
+
+void busyWait(double us) {
+    if (us <= 0) return;
+    auto end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(static_cast<long long>(us * 1000));
+    while (std::chrono::steady_clock::now() < end) {
+    }
+}
+
+void* cometCreate(const char* args) {
+    Comet* comet = new (std::nothrow) Comet();
+    if (!comet) return nullptr;
+    comet->periodMs = 1500;
+    comet->color[0] = 0x00;
+    comet->color[1] = 0xA0;
+    comet->color[2] = 0xFF;
+
+    // key=value-Paare
+    const char* p = args ? args : "";
+    while (*p) {
+        while (*p == ' ') p++;
+        char key[16] = { 0 };
+        char value[32] = { 0 };
+        int consumed = 0;
+        if (sscanf(p, "%15[^= ]=%31s%n", key, value, &consumed) != 2) {
+            if (*p) { delete comet; return nullptr; }   // Unbekanntes Format
+            break;
+        }
+        p += consumed;
+
+        unsigned int rgb = 0;
+        if (strcmp(key, "period") == 0) {
+            comet->periodMs = atof(value);
+        } else if (strcmp(key, "color") == 0 && sscanf(value, "%6x", &rgb) == 1) {
+            comet->color[0] = static_cast<unsigned char>(rgb >> 16);
+            comet->color[1] = static_cast<unsigned char>(rgb >> 8);
+            comet->color[2] = static_cast<unsigned char>(rgb);
+        } else if (strcmp(key, "cost") == 0) {
+            comet->costUs = atof(value);
+        } else if (strcmp(key, "stall") == 0) {
+            comet->stallUs = atof(value);
+        } else {
+            delete comet;
+            return nullptr;
+        }
+    }
+    if (comet->periodMs <= 0) {
+        delete comet;
+        return nullptr;
+    }
+    return comet;
+}
+
+void cometDestroy(void* instance) {
+    delete static_cast<Comet*>(instance);
+}
+
+int32_t cometRender(void* instance, HS80PluginFrame* frame) {
+    Comet* comet = static_cast<Comet*>(instance);
+    comet->calls++;
+    busyWait(comet->costUs);
+    if (comet->calls == 10) {
+        busyWait(comet->stallUs);
+    }
+
+    // Kopf: Zone 0-2 nach Phase, Schweif klingt mit ~300ms Halbwertszeit ab
+    double phase = std::fmod(frame->timeMs / comet->periodMs, 1.0);
+    int head = static_cast<int>(phase * 3) % 3;
+    double decay = std::pow(0.5, frame->frameIntervalMs / 300.0);
+    for (int zone = 0; zone < 3; zone++) {
+        comet->trail[zone] = zone == head ? 1.0 : comet->trail[zone] * decay;
+        for (int c = 0; c < 3; c++) {
+            frame->rgb[zone * 3 + c] = static_cast<uint8_t>(comet->color[c] * comet->trail[zone] + 0.5);
+        }
+    }
+
+    if (frame->muted == 1) {
+        frame->rgb[6] = 255;
+        frame->rgb[7] = 0;
+        frame->rgb[8] = 0;
+    }
+    return HS80_PLUGIN_RUNNING;
+}
+
+const HS80PluginDescriptor g_descriptor = {
+    HS80_PLUGIN_ABI_VERSION,
+    sizeof(HS80PluginDescriptor),
+    "Komet",
+    cometCreate,
+    cometDestroy,
+    cometRender
+};
+
+} // namespace
+
+HS80_PLUGIN_EXPORT const HS80PluginDescriptor* HS80_GetPlugin(void) {
+    return &g_descriptor;
+}
@@ -39,7 +39,7 @@ REM Erstelle Debug-Verzeichnis
 if not exist "HS80\Debug" mkdir "HS80\Debug"
 
 REM Kompiliere Library
-echo [1/4] Kompiliere HS80_Library.cpp...
+echo [1/8] Kompiliere Library-Quellen...
 cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Library.obj" HS80\HS80_Library.cpp
 if %ERRORLEVEL% NEQ 0 (
     echo [FEHLER] Library-Kompilierung fehlgeschlagen!
@@ -47,9 +47,149 @@ if %ERRORLEVEL% NEQ 0 (
     exit /b 1
 )
 
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Simulation.obj" HS80\HS80_Simulation.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Animation.obj" HS80\HS80_Animation.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Color.obj" HS80\HS80_Color.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Compositor.obj" HS80\HS80_Compositor.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Keyframes.obj" HS80\HS80_Keyframes.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_FrameTables.obj" HS80\HS80_FrameTables.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Audio.obj" HS80\HS80_Audio.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Canvas.obj" HS80\HS80_Canvas.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_FrameClock.obj" HS80\HS80_FrameClock.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Rules.obj" HS80\HS80_Rules.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Script.obj" HS80\HS80_Script.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_EffectCache.obj" HS80\HS80_EffectCache.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Transition.obj" HS80\HS80_Transition.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Dither.obj" HS80\HS80_Dither.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_FadePlanner.obj" HS80\HS80_FadePlanner.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Calibration.obj" HS80\HS80_Calibration.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Notification.obj" HS80\HS80_Notification.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Clock.obj" HS80\HS80_Clock.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_OfflineRenderer.obj" HS80\HS80_OfflineRenderer.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
+cl.exe /c /EHsc /std:c++17 /Zi /Od /Fo"HS80\Debug\HS80_Plugin.obj" HS80\HS80_Plugin.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [FEHLER] Library-Kompilierung fehlgeschlagen!
+    pause
+    exit /b 1
+)
+
 REM Erstelle statische Library
-echo [2/4] Erstelle HS80_Lib.lib...
-lib.exe /OUT:"HS80\Debug\HS80_Lib.lib" "HS80\Debug\HS80_Library.obj"
+echo [2/8] Erstelle HS80_Lib.lib...
+lib.exe /OUT:"HS80\Debug\HS80_Lib.lib" "HS80\Debug\HS80_Library.obj" "HS80\Debug\HS80_Simulation.obj" "HS80\Debug\HS80_Animation.obj" "HS80\Debug\HS80_Color.obj" "HS80\Debug\HS80_Compositor.obj" "HS80\Debug\HS80_Keyframes.obj" "HS80\Debug\HS80_FrameTables.obj" "HS80\Debug\HS80_Audio.obj" "HS80\Debug\HS80_Canvas.obj" "HS80\Debug\HS80_FrameClock.obj" "HS80\Debug\HS80_Rules.obj" "HS80\Debug\HS80_Script.obj" "HS80\Debug\HS80_EffectCache.obj" "HS80\Debug\HS80_Transition.obj" "HS80\Debug\HS80_Dither.obj" "HS80\Debug\HS80_FadePlanner.obj" "HS80\Debug\HS80_Calibration.obj" "HS80\Debug\HS80_Notification.obj" "HS80\Debug\HS80_Clock.obj" "HS80\Debug\HS80_OfflineRenderer.obj" "HS80\Debug\HS80_Plugin.obj"
 if %ERRORLEVEL% NEQ 0 (
     echo [FEHLER] Library-Erstellung fehlgeschlagen!
     pause
@@ -57,7 +197,7 @@ if %ERRORLEVEL% NEQ 0 (
 )
 
 REM Kompiliere HS80.exe (Original)
-echo [3/4] Kompiliere HS80.exe...
+echo [3/8] Kompiliere HS80.exe...
 cl.exe /EHsc /std:c++17 /Zi /Od /Fe"HS80\Debug\HS80.exe" HS80\HS80.cpp "HS80\Debug\HS80_Lib.lib" hid.lib setupapi.lib
 if %ERRORLEVEL% NEQ 0 (
     echo [FEHLER] HS80.exe Kompilierung fehlgeschlagen!
@@ -66,19 +206,40 @@ if %ERRORLEVEL% NEQ 0 (
 )
 
 REM Kompiliere HS80_Demo.exe
-echo [4/4] Kompiliere HS80_Demo.exe...
+echo [4/8] Kompiliere HS80_Demo.exe...
 cl.exe /EHsc /std:c++17 /Zi /Od /Fe"HS80\Debug\HS80_Demo.exe" HS80\HS80_Demo.cpp "HS80\Debug\HS80_Lib.lib" hid.lib setupapi.lib
 if %ERRORLEVEL% NEQ 0 (
     echo [WARNUNG] HS80_Demo.exe Kompilierung fehlgeschlagen!
 )
 
 REM Kompiliere HS80_Analyzer.exe
-echo [5/5] Kompiliere HS80_Analyzer.exe...
+echo [5/8] Kompiliere HS80_Analyzer.exe...
 cl.exe /EHsc /std:c++17 /Zi /Od /Fe"HS80\Debug\HS80_Analyzer.exe" HS80\HS80_Analyzer.cpp "HS80\Debug\HS80_Lib.lib" hid.lib setupapi.lib
 if %ERRORLEVEL% NEQ 0 (
     echo [WARNUNG] HS80_Analyzer.exe Kompilierung fehlgeschlagen!
 )
 
+REM Kompiliere HS80_KeyframeTool.exe
+echo [6/8] Kompiliere HS80_KeyframeTool.exe...
+cl.exe /EHsc /std:c++17 /Zi /Od /Fe"HS80\Debug\HS80_KeyframeTool.exe" HS80\HS80_KeyframeTool.cpp "HS80\Debug\HS80_Lib.lib" hid.lib setupapi.lib
+if %ERRORLEVEL% NEQ 0 (
+    echo [WARNUNG] HS80_KeyframeTool.exe Kompilierung fehlgeschlagen!
+)
+
+REM Kompiliere Beispiel-Plugin (DLL, ohne Library)
+echo [7/8] Kompiliere HS80_ExamplePlugin.dll...
+cl.exe /LD /EHsc /std:c++17 /Zi /Od /I HS80 /Fe"HS80\Debug\HS80_ExamplePlugin.dll" HS80\plugins\HS80_ExamplePlugin.cpp
+if %ERRORLEVEL% NEQ 0 (
+    echo [WARNUNG] HS80_ExamplePlugin.dll Kompilierung fehlgeschlagen!
+)
+
+REM Kompiliere HS80_AsyncDemo.exe (C++20 Coroutines)
+echo [8/8] Kompiliere HS80_AsyncDemo.exe...
+cl.exe /EHsc /std:c++20 /Zi /Od /Fe"HS80\Debug\HS80_AsyncDemo.exe" HS80\HS80_AsyncDemo.cpp "HS80\Debug\HS80_Lib.lib" hid.lib setupapi.lib
+if %ERRORLEVEL% NEQ 0 (
+    echo [WARNUNG] HS80_AsyncDemo.exe Kompilierung fehlgeschlagen!
+)
+
 REM Aufräumen
 del *.obj 2>nul
 
@@ -100,10 +261,21 @@ if exist "HS80\Debug\HS80_Demo.exe" (
 if exist "HS80\Debug\HS80_Analyzer.exe" (
     for %%F in ("HS80\Debug\HS80_Analyzer.exe") do echo   - HS80_Analyzer.exe   : %%~zF bytes
 )
+if exist "HS80\Debug\HS80_KeyframeTool.exe" (
+    for %%F in ("HS80\Debug\HS80_KeyframeTool.exe") do echo   - HS80_KeyframeTool.exe: %%~zF bytes
+)
+if exist "HS80\Debug\HS80_AsyncDemo.exe" (
+    for %%F in ("HS80\Debug\HS80_AsyncDemo.exe") do echo   - HS80_AsyncDemo.exe  : %%~zF bytes
+)
+if exist "HS80\Debug\HS80_ExamplePlugin.dll" (
+    for %%F in ("HS80\Debug\HS80_ExamplePlugin.dll") do echo   - HS80_ExamplePlugin.dll: %%~zF bytes
+)
 echo.
 echo Zum Testen:
 echo   HS80\Debug\HS80.exe          - Original Programm
 echo   HS80\Debug\HS80_Demo.exe     - High-Level Demo
 echo   HS80\Debug\HS80_Analyzer.exe - Analyse-Tool
+echo   HS80\Debug\HS80_AsyncDemo.exe - Coroutines (C++20)
+echo   HS80\Debug\HS80_KeyframeTool.exe HS80\animations\beispiele.txt HS80\animations\beispiele.hs8k
 echo.
 pause